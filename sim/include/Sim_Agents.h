@@ -0,0 +1,181 @@
+#ifndef SIM_AGENTS_H_
+#define SIM_AGENTS_H_
+
+/*******************************************************************************
+ * Include
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "Sim_Kernel.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/** @defgroup Simulated node class
+  * @{
+  */
+#define SIM_NODE_CLASS_DISTANCE 0u
+#define SIM_NODE_CLASS_ROTATION 1u
+#define SIM_NODE_CLASS_NUM      2u
+/**
+  * @}
+  */
+
+/* Sensor nodes of all classes, indexed in creation order */
+#define SIM_NODE_NUM            16u
+
+/* Node name: class name, then the instance from 2 on ("distance", "distance2" ...) */
+#define SIM_NODE_NAME_MAX       16u
+
+/* Resolution and range of the latency histograms */
+#define SIM_LATENCY_BUCKET_NS   (10u * SIM_NS_PER_US)
+#define SIM_LATENCY_BUCKET_NUM  10000u
+
+/* Traffic generators on the sensor bus */
+#define SIM_TRAFFIC_MAX         16u
+
+/* Result of one sensor node, from its CAN frames to the UART lines of the PC */
+typedef struct
+{
+    bool       Created;
+    char       Name[SIM_NODE_NAME_MAX];
+    uint32_t   Sent;            /* Data frames queued by the node */
+    uint32_t   Forwarded;       /* Samples of the node received by the PC */
+    uint32_t   Unknown;         /* Samples the node never sent, or received twice */
+    uint32_t   Confirms;        /* Data confirmations received from the forwarder */
+    uint32_t   Pings;           /* Pings answered */
+    uint32_t   Stops;           /* Stop commands received */
+    uint32_t   Disconnects;     /* Disconnection notices received by the PC */
+    Sim_Time_t LatencyP50;      /* Node send request to last byte of the UART line */
+    Sim_Time_t LatencyP99;
+    Sim_Time_t LatencyMax;
+} Sim_NodeResult_t;
+
+/* Result of the PC agent */
+typedef struct
+{
+    uint32_t   Lines;           /* Lines received */
+    uint32_t   BadLines;        /* Lines not of the form "<id>-<data>" */
+    uint32_t   LinesSent;       /* Lines sent to the forwarder */
+    uint32_t   ConnectConfirms; /* Connection confirmations of the forwarder and of the nodes */
+    uint32_t   Captures;        /* Capture dumps written to the capture file */
+    uint32_t   ReportNodes;     /* Node blocks of the statistics reports, STATS_NODE_INDEX_ID lines */
+    uint32_t   ReportTasks;     /* Task blocks of the statistics reports, TASK_INDEX_ID lines */
+} Sim_PcResult_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/**
+  * @brief      Seed the pseudo random generator of the agents
+  * @param[in]  Seed: Any value but 0
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_Agents_Seed(uint32_t Seed);
+
+/**
+  * @brief      Attach the next sensor node of a class to the sensor bus
+  * @note       The node answers the connection, stop, wake up and ping commands of the forwarder
+  *             and, once connected, sends a counter as its sample. The nodes of a class take the
+  *             instances from CAN_NODE_INST_DEFAULT on, the forwarder serves them by node index.
+  * @param[in]  Class: it can be a value of @defgroup Simulated node class
+  * @param[in]  Period: Time between two data frames
+  * @param[in]  Jitter: Random delay added to every period, 0 for none
+  * @param[out] None
+  * @retval     false if SIM_NODE_NUM nodes exist, or the identifier format has one node per class
+  */
+bool Sim_Node_Create(uint8_t Class, Sim_Time_t Period, Sim_Time_t Jitter);
+
+/**
+  * @brief      Get a sensor node from its name
+  * @param[in]  Name: Node name, refer to SIM_NODE_NAME_MAX
+  * @param[out] Node: Index of the node
+  * @retval     false if no node has this name
+  */
+bool Sim_Node_Find(const char *Name, uint8_t *Node);
+
+/**
+  * @brief      Make a sensor node deaf and silent for a while
+  * @param[in]  Node: Index of the node
+  * @param[in]  Duration: Time the node ignores the bus
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_Node_Mute(uint8_t Node, Sim_Time_t Duration);
+
+/**
+  * @brief      Get the result of a sensor node
+  * @param[in]  Node: Index of the node, Created is false beyond the nodes created
+  * @param[out] Result: Counters and latency percentiles
+  * @retval     None
+  */
+void Sim_Node_GetResult(uint8_t Node, Sim_NodeResult_t *Result);
+
+/**
+  * @brief      Attach a periodic traffic generator to the sensor bus
+  * @param[in]  Id: Identifier of its frames
+  * @param[in]  Ext: Extended identifier
+  * @param[in]  Period: Time between two frames
+  * @param[in]  Dlc: Data length of its frames
+  * @param[out] None
+  * @retval     false if SIM_TRAFFIC_MAX generators already exist
+  */
+bool Sim_Traffic_Create(uint32_t Id, bool Ext, Sim_Time_t Period, uint8_t Dlc);
+
+/**
+  * @brief      Connect the PC agent to the UART of the forwarder
+  * @param[in]  ConfirmDelay: Delay of the data confirmation of the PC Tool, 0 to never confirm
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_Pc_Init(Sim_Time_t ConfirmDelay);
+
+/**
+  * @brief      Send a line "<id>-<data>" to the forwarder
+  * @param[in]  Id: UART frame ID
+  * @param[in]  Data: Value
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_Pc_SendLine(uint32_t Id, uint32_t Data);
+
+/**
+  * @brief      Send random bytes to the forwarder, a newline ends them
+  * @param[in]  Length: Number of random bytes
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_Pc_SendGarbage(uint32_t Length);
+
+/**
+  * @brief      Write the capture dumps of the forwarder to a file, refer to @defgroup Capture Message ID
+  * @note       Every complete dump replaces the file, it can be given to Sim_Replay_Load()
+  * @param[in]  Path: Capture file
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_Pc_SetCaptureFile(const char *Path);
+
+/**
+  * @brief      Get the result of the PC agent
+  * @param[out] Result: Counters
+  * @retval     None
+  */
+void Sim_Pc_GetResult(Sim_PcResult_t *Result);
+
+/**
+  * @brief      Get the last value the forwarder sent with a UART frame ID
+  * @param[in]  Id: UART frame ID
+  * @param[out] Value: Last value
+  * @retval     false if no line with this ID was received
+  */
+bool Sim_Pc_GetLastValue(uint32_t Id, uint32_t *Value);
+
+#endif /* SIM_AGENTS_H_ */
+
+/*******************************************************************************
+ * End Of File
+ ******************************************************************************/
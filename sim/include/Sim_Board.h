@@ -0,0 +1,36 @@
+#ifndef SIM_BOARD_H_
+#define SIM_BOARD_H_
+
+/*******************************************************************************
+ * Include
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/**
+  * @brief      Get the output level of a GPIO pin
+  * @param[in]  Port: Port index (PORTA = 0 ...)
+  * @param[in]  Pin: Pin number
+  * @param[out] None
+  * @retval     true if driven high
+  */
+bool Sim_Board_GetPinLevel(uint8_t Port, uint8_t Pin);
+
+/**
+  * @brief      Get the number of level changes of a GPIO pin
+  * @param[in]  Port: Port index (PORTA = 0 ...)
+  * @param[in]  Pin: Pin number
+  * @param[out] None
+  * @retval     Level changes since power-on
+  */
+uint32_t Sim_Board_GetPinChanges(uint8_t Port, uint8_t Pin);
+
+#endif /* SIM_BOARD_H_ */
+
+/*******************************************************************************
+ * End Of File
+ ******************************************************************************/
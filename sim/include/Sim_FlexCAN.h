@@ -0,0 +1,114 @@
+#ifndef SIM_FLEXCAN_H_
+#define SIM_FLEXCAN_H_
+
+/*******************************************************************************
+ * Include
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "Sim_Kernel.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/* Agents attached to one bus, besides the FlexCAN controller */
+#define SIM_CAN_AGENT_MAX       32u
+
+/* Frames an agent may have waiting for the bus, refer to Sim_CAN_AgentSend() */
+#define SIM_CAN_AGENT_TX_MAX    8u
+
+/* One frame on the bus */
+typedef struct
+{
+    uint32_t Id;        /* 11-bit or 29-bit identifier */
+    uint8_t  Ext;       /* 1: extended identifier */
+    uint8_t  Rtr;       /* 1: remote request */
+    uint8_t  Dlc;       /* 0..8 */
+    uint8_t  Data[8];
+} Sim_CanFrame_t;
+
+/* Frame seen by an agent, called at the end of frame */
+typedef void (*Sim_CanReceive_t)(void *Context, const Sim_CanFrame_t *Frame);
+
+/* Counters of one bus */
+typedef struct
+{
+    uint32_t   Frames;          /* Frames completed on the bus */
+    uint32_t   ControllerTx;    /* Frames sent by the FlexCAN controller */
+    uint32_t   ControllerRx;    /* Frames stored in a message buffer */
+    uint32_t   Overrun;         /* Frames stored over an unread one (CODE = OVERRUN) */
+    uint32_t   Unmatched;       /* Data frames no message buffer accepted */
+    uint32_t   AgentDropped;    /* Frames refused, the queue of the agent was full */
+    uint32_t   Aborted;         /* Transmit requests withdrawn by the firmware */
+    uint32_t   BusOffCnt;       /* Bus-off entries of the controller */
+    Sim_Time_t BusyTime;        /* Virtual time the bus carried frames */
+} Sim_CanStats_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/**
+  * @brief      Attach an agent to a bus
+  * @param[in]  Bus: FlexCAN instance whose bus the agent joins
+  * @param[in]  Receive: Called for every frame sent by another node
+  * @param[in]  Context: Passed to Receive
+  * @param[out] None
+  * @retval     Agent index, 0xFF if the bus is full
+  */
+uint8_t Sim_CAN_AttachAgent(uint8_t Bus, Sim_CanReceive_t Receive, void *Context);
+
+/**
+  * @brief      Queue a frame of an agent for arbitration
+  * @param[in]  Bus: FlexCAN instance
+  * @param[in]  Agent: Index from Sim_CAN_AttachAgent()
+  * @param[in]  Frame: Frame to send
+  * @param[out] None
+  * @retval     false if SIM_CAN_AGENT_TX_MAX frames are already waiting, the frame is dropped
+  */
+bool Sim_CAN_AgentSend(uint8_t Bus, uint8_t Agent, const Sim_CanFrame_t *Frame);
+
+/**
+  * @brief      Set the bitrate the other nodes of a bus use
+  * @note       A controller configured at another bitrate sees form errors only
+  * @param[in]  Bus: FlexCAN instance
+  * @param[in]  Bitrate: bit/s, 0 to follow the controller
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_CAN_SetBitrate(uint8_t Bus, uint32_t Bitrate);
+
+/**
+  * @brief      Destroy frames of the controller with error frames
+  * @note       Every error adds 8 to the transmit error counter, past 255 the controller goes bus-off
+  * @param[in]  Bus: FlexCAN instance
+  * @param[in]  Count: Number of errors
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_CAN_InjectErrors(uint8_t Bus, uint32_t Count);
+
+/**
+  * @brief      Leave the frames of the controller unacknowledged for a while, as if alone on the bus
+  * @note       Unacknowledged frames are repeated, the transmit error counter stops at error passive
+  * @param[in]  Bus: FlexCAN instance
+  * @param[in]  Duration: Time without acknowledge from now
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_CAN_SetNoAck(uint8_t Bus, Sim_Time_t Duration);
+
+/**
+  * @brief      Get the counters of a bus
+  * @param[in]  Bus: FlexCAN instance
+  * @param[out] Stats: Counters
+  * @retval     None
+  */
+void Sim_CAN_GetStats(uint8_t Bus, Sim_CanStats_t *Stats);
+
+#endif /* SIM_FLEXCAN_H_ */
+
+/*******************************************************************************
+ * End Of File
+ ******************************************************************************/
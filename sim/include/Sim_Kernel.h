@@ -0,0 +1,199 @@
+#ifndef SIM_KERNEL_H_
+#define SIM_KERNEL_H_
+
+/*******************************************************************************
+ * Include
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "S32K144.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/* Virtual time in nanoseconds since the simulated power-on */
+typedef uint64_t Sim_Time_t;
+
+#define SIM_NS_PER_US   1000u
+#define SIM_NS_PER_MS   1000000u
+#define SIM_NS_PER_S    1000000000u
+
+/* Largest number of interrupt lines a model may register */
+#define SIM_IRQ_LINE_MAX    20u
+
+/* Interrupts dispatched back to back without the main context running, then the
+ * simulation stops: an interrupt flag the firmware never clears */
+#define SIM_IRQ_STORM_LIMIT 100000u
+
+/* Work of a model or an agent at a point of virtual time */
+typedef void (*Sim_EventHandler_t)(void *Context, uint32_t Arg);
+
+/* Level of an interrupt line, computed from the state of its peripheral model */
+typedef bool (*Sim_IrqPending_t)(void);
+
+/* Vector of an interrupt line, the model of the driver interrupt handler */
+typedef void (*Sim_IrqHandler_t)(void);
+
+/* Called once when the end of the scenario is reached, before the process exits */
+typedef void (*Sim_EndHook_t)(void);
+
+/* Counters of one interrupt line */
+typedef struct
+{
+    const char *Name;       /* Vector name */
+    uint32_t    DispatchCnt;/* Handler runs */
+} Sim_IrqStats_t;
+
+/* Counters of the virtual CPU */
+typedef struct
+{
+    Sim_Time_t Now;         /* Current virtual time */
+    Sim_Time_t SleepTime;   /* Virtual time spent in STANDBY() */
+    uint32_t   WakeupCnt;   /* STANDBY() calls that slept */
+    uint64_t   AccessCnt;   /* Driver calls, each charged the access cost */
+    uint64_t   EventCnt;    /* Model and agent events run */
+    uint8_t    IrqNum;      /* Valid entries of Irq */
+    Sim_IrqStats_t Irq[SIM_IRQ_LINE_MAX];
+} Sim_KernelStats_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/**
+  * @brief      Reset the virtual clock, the event queue and the interrupt lines
+  * @param[in]  AccessCost: Virtual CPU time charged for every driver call
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_Kernel_Init(Sim_Time_t AccessCost);
+
+/**
+  * @brief      Change the virtual CPU time charged for every driver call
+  * @param[in]  AccessCost: Cost of one driver call
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_Kernel_SetAccessCost(Sim_Time_t AccessCost);
+
+/**
+  * @brief      Set the end of the scenario
+  * @param[in]  EndTime: Virtual time the simulation stops at
+  * @param[in]  Hook: Called once at the end, NULL if none
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_Kernel_SetEnd(Sim_Time_t EndTime, Sim_EndHook_t Hook);
+
+/**
+  * @brief      Stop the simulation now: run the end hook and exit the process
+  * @param[in]  ExitCode: Process exit code
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_Kernel_Stop(int ExitCode);
+
+/**
+  * @brief      Get the current virtual time
+  * @param[in]  None
+  * @param[out] None
+  * @retval     Virtual time (ns)
+  */
+Sim_Time_t Sim_Now(void);
+
+/**
+  * @brief      Schedule work of a model or an agent
+  * @note       Events due at the same time run in the order they were scheduled
+  * @param[in]  At: Virtual time, the current time if in the past
+  * @param[in]  Handler: Work to run
+  * @param[in]  Context: Passed to Handler
+  * @param[in]  Arg: Passed to Handler
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_Schedule(Sim_Time_t At, Sim_EventHandler_t Handler, void *Context, uint32_t Arg);
+
+/**
+  * @brief      Let virtual time pass, running the events due meanwhile
+  * @note       Interrupts are not dispatched, the caller is busy
+  * @param[in]  Duration: Virtual time to add
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_Advance(Sim_Time_t Duration);
+
+/**
+  * @brief      Account one driver call: charge the access cost, then take pending interrupts
+  * @param[in]  None
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_Access(void);
+
+/**
+  * @brief      Register an interrupt line of a peripheral model
+  * @param[in]  Irq: Interrupt number, lower numbers are served first
+  * @param[in]  Name: Vector name used in the report
+  * @param[in]  IsPending: Level of the line
+  * @param[in]  Handler: Model of the driver interrupt handler
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_Irq_Register(IRQn_Type Irq, const char *Name, Sim_IrqPending_t IsPending, Sim_IrqHandler_t Handler);
+
+/**
+  * @brief      Enable or disable an interrupt line in the NVIC model
+  * @param[in]  Irq: Interrupt number
+  * @param[in]  Enabled: true to enable
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_Irq_SetEnabled(IRQn_Type Irq, bool Enabled);
+
+/**
+  * @brief      Model of "cpsid i"
+  * @param[in]  None
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_Irq_Disable(void);
+
+/**
+  * @brief      Model of "cpsie i", pending interrupts run at once
+  * @param[in]  None
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_Irq_Enable(void);
+
+/**
+  * @brief      Model of "mrs primask"
+  * @param[in]  None
+  * @param[out] None
+  * @retval     1 if interrupts are masked, 0 otherwise
+  */
+uint32_t Sim_Irq_GetPrimask(void);
+
+/**
+  * @brief      Model of "wfi": jump to the next event until an enabled interrupt is pending
+  * @note       Stops the simulation if no event is left
+  * @param[in]  None
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_Cpu_Standby(void);
+
+/**
+  * @brief      Get the counters of the virtual CPU
+  * @param[in]  None
+  * @param[out] Stats: Counters
+  * @retval     None
+  */
+void Sim_Kernel_GetStats(Sim_KernelStats_t *Stats);
+
+#endif /* SIM_KERNEL_H_ */
+
+/*******************************************************************************
+ * End Of File
+ ******************************************************************************/
@@ -0,0 +1,71 @@
+#ifndef SIM_LPUART_H_
+#define SIM_LPUART_H_
+
+/*******************************************************************************
+ * Include
+ ******************************************************************************/
+#include <stdint.h>
+#include "Sim_Kernel.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/* Byte sent by the firmware, called once its stop bit is on the line */
+typedef void (*Sim_LpuartReceive_t)(void *Context, uint8_t Byte);
+
+/* Counters of one LPUART instance */
+typedef struct
+{
+    uint32_t   TxBytes;         /* Bytes sent by the firmware */
+    uint32_t   RxBytes;         /* Bytes taken by the firmware */
+    uint32_t   RxOverrun;       /* Bytes lost, RDRF was still set (STAT[OR]) */
+    uint32_t   TxOverwrite;     /* Bytes written while TDRE was clear, the previous one is lost */
+    Sim_Time_t TxBusyTime;      /* Virtual time the transmitter was shifting */
+} Sim_LpuartStats_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/**
+  * @brief      Connect the TX line of an instance to an agent
+  * @param[in]  Instance: LPUART instance
+  * @param[in]  Receive: Called for every byte sent by the firmware
+  * @param[in]  Context: Passed to Receive
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_LPUART_Attach(uint8_t Instance, Sim_LpuartReceive_t Receive, void *Context);
+
+/**
+  * @brief      A byte has been received completely on the RX line of an instance
+  * @note       The agent paces its bytes with Sim_LPUART_GetCharTime()
+  * @param[in]  Instance: LPUART instance
+  * @param[in]  Byte: Byte received
+  * @param[out] None
+  * @retval     None
+  */
+void Sim_LPUART_Inject(uint8_t Instance, uint8_t Byte);
+
+/**
+  * @brief      Get the duration of one character at the configured format and baud rate
+  * @param[in]  Instance: LPUART instance
+  * @param[out] None
+  * @retval     Character time, 0 until DRV_LPUART_Init()
+  */
+Sim_Time_t Sim_LPUART_GetCharTime(uint8_t Instance);
+
+/**
+  * @brief      Get the counters of an instance
+  * @param[in]  Instance: LPUART instance
+  * @param[out] Stats: Counters
+  * @retval     None
+  */
+void Sim_LPUART_GetStats(uint8_t Instance, Sim_LpuartStats_t *Stats);
+
+#endif /* SIM_LPUART_H_ */
+
+/*******************************************************************************
+ * End Of File
+ ******************************************************************************/
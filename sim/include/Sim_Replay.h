@@ -0,0 +1,59 @@
+#ifndef SIM_REPLAY_H_
+#define SIM_REPLAY_H_
+
+/*******************************************************************************
+ * Include
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "Sim_Kernel.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/* CAN frames and UART bytes a replay holds at most */
+#define SIM_REPLAY_RECORD_MAX   65536u
+
+/* Result of a replay */
+typedef struct
+{
+    bool       Loaded;
+    uint32_t   Records;         /* CAN frames and UART bytes in the capture */
+    uint32_t   CanFrames;       /* Frames put on the sensor bus */
+    uint32_t   UartBytes;       /* Bytes put on the UART line */
+    uint32_t   Late;            /* Records sent after their time, the bus or the line was busy */
+    Sim_Time_t LateMax;         /* Worst delay of a record past its time */
+    Sim_Time_t Span;            /* Time from the first to the last record of the capture */
+} Sim_ReplayResult_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/**
+  * @brief      Load a capture of the forwarder and schedule its records
+  * @note       The file holds the bytes sent as CAPTURE_DATA_ID words, refer to @defgroup Capture record.
+  *             CAN frames are sent by an agent of the sensor bus, UART bytes reach the receiver of the
+  *             forwarder as if the PC Tool sent them. Records keep their order: one waiting for the bus
+  *             or the line delays the next ones.
+  * @param[in]  Path: Capture file
+  * @param[in]  Start: Time of the first record
+  * @param[in]  Speed: Time scale, 1 for the original timing, 10 to play it ten times faster
+  * @param[out] None
+  * @retval     false if the file cannot be read or holds a truncated record
+  */
+bool Sim_Replay_Load(const char *Path, Sim_Time_t Start, uint32_t Speed);
+
+/**
+  * @brief      Get the result of the replay
+  * @param[out] Result: Counters
+  * @retval     None
+  */
+void Sim_Replay_GetResult(Sim_ReplayResult_t *Result);
+
+#endif /* SIM_REPLAY_H_ */
+
+/*******************************************************************************
+ * End Of File
+ ******************************************************************************/
@@ -0,0 +1,57 @@
+/*
+ * Host build replacement of the Cortex-M4 core header.
+ *
+ * It comes first on the include path of the simulator and shadows include/s32_core_cm4.h:
+ * the core instructions used by the firmware become calls into the virtual CPU of
+ * Sim_Kernel.c, the other macros keep their meaning on the host.
+ */
+
+#if !defined (CORE_CM4_H)
+#define CORE_CM4_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Virtual CPU, refer to Sim_Kernel.h */
+void Sim_Irq_Enable(void);
+void Sim_Irq_Disable(void);
+uint32_t Sim_Irq_GetPrimask(void);
+void Sim_Cpu_Standby(void);
+
+#define BKPT_ASM                abort()
+
+#define ENABLE_INTERRUPTS()     Sim_Irq_Enable()
+#define DISABLE_INTERRUPTS()    Sim_Irq_Disable()
+#define STANDBY()               Sim_Cpu_Standby()
+#define NOP()                   do { } while (0)
+
+/* Read PRIMASK, the core header has no macro for it, the firmware falls back to "mrs" */
+#define GET_PRIMASK(primask)    ((primask) = Sim_Irq_GetPrimask())
+
+#define REV_BYTES_32(a, b)      (b = ((a & 0xFF000000U) >> 24U) | ((a & 0xFF0000U) >> 8U) \
+                                    | ((a & 0xFF00U) << 8U) | ((a & 0xFFU) << 24U))
+#define REV_BYTES_16(a, b)      (b = ((a & 0xFF000000U) >> 8U) | ((a & 0xFF0000U) << 8U) \
+                                    | ((a & 0xFF00U) >> 8U) | ((a & 0xFFU) << 8U))
+
+#define START_FUNCTION_DECLARATION_RAMSECTION
+#define END_FUNCTION_DECLARATION_RAMSECTION        ;
+#define START_FUNCTION_DEFINITION_RAMSECTION
+#define END_FUNCTION_DEFINITION_RAMSECTION
+#define DISABLE_CHECK_RAMSECTION_FUNCTION_CALL
+#define ENABLE_CHECK_RAMSECTION_FUNCTION_CALL
+
+#define GET_CORE_ID()           0U
+#define ALIGNED(x)              __attribute__((aligned(x)))
+#define PLACE_IN_SECTION(x)
+
+#define CORE_LITTLE_ENDIAN
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORE_CM4_H */
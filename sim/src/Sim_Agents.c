@@ -0,0 +1,864 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "MID_CAN_Interface.h"
+#include "MID_UART_Interface.h"
+#include "Sim_Kernel.h"
+#include "Sim_FlexCAN.h"
+#include "Sim_LPUART.h"
+#include "Sim_Agents.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/* USR_LPUART_INS of MID_UART_Interface.c, the PC Tool port */
+#define SIM_PC_LPUART           1u
+
+/* Bytes the PC agent may have waiting for its UART line */
+#define SIM_PC_TX_SIZE          4096u
+
+/* Longest line accepted by the PC agent */
+#define SIM_PC_LINE_MAX         32u
+
+/* Largest capture the PC agent collects, and length of its file name */
+#define SIM_PC_CAPTURE_MAX      (1u << 20u)
+#define SIM_PC_PATH_MAX         256u
+
+/* Retry period of a PC agent whose UART is not initialized yet */
+#define SIM_PC_RETRY_NS         SIM_NS_PER_MS
+
+/* Samples are a counter, SENSOR_DISCONNECT_DATA is never sent */
+#define SIM_NODE_VALUE_NUM      0xFFFFu
+
+/* Frames of the nodes use the identifier format of the forwarder */
+#define SIM_NODE_EXT            ((CAN_ID_FORMAT == CAN_ID_EXTENDED) ? 1u : 0u)
+
+/* Message types and UART IDs of a node class */
+typedef struct
+{
+    const char *Name;
+    uint8_t     CanClass;       /* Node class of the CAN IDs, refer to @defgroup Node addressing */
+    uint8_t     ConnectType;
+    uint8_t     ConfirmType;
+    uint8_t     StopType;
+    uint8_t     StopConfirmType;
+    uint8_t     PingType;
+    uint8_t     PingConfirmType;
+    uint8_t     DataType;
+    uint8_t     DataConfirmType;
+    uint32_t    UartDataId;     /* UART data ID of the first node, the next nodes follow it */
+    uint32_t    UartConnectId;
+} SIM_NodeClass_t;
+
+/* Description of a simulated sensor node, the IDs the forwarder uses for it */
+typedef struct
+{
+    uint8_t  Index;             /* Position of the node within its class */
+    uint32_t ConnectId;
+    uint32_t ConfirmId;
+    uint32_t StopId;
+    uint32_t StopConfirmId;
+    uint32_t PingId;
+    uint32_t PingConfirmId;
+    uint32_t DataId;
+    uint32_t DataConfirmId;
+    uint32_t UartDataId;
+    uint32_t UartConnectId;
+} SIM_NodeDesc_t;
+
+/* Runtime state of a simulated sensor node */
+typedef struct
+{
+    uint8_t     Agent;
+    bool        Running;            /* Data event chain started */
+    bool        Connected;
+    bool        Stopped;
+    Sim_Time_t  MuteUntil;
+    Sim_Time_t  Period;
+    Sim_Time_t  Jitter;
+    uint16_t    Value;              /* Next sample */
+    uint16_t    LastValue;          /* Last sample sent */
+    Sim_Time_t  SendTime[SIM_NODE_VALUE_NUM];   /* Send time + 1 of every sample in flight, 0 if none */
+    uint32_t    Histogram[SIM_LATENCY_BUCKET_NUM + 1u];
+    Sim_NodeResult_t Result;
+} SIM_Node_t;
+
+/* Periodic traffic generator */
+typedef struct
+{
+    uint8_t        Agent;
+    Sim_Time_t     Period;
+    Sim_CanFrame_t Frame;
+} SIM_Traffic_t;
+
+/* PC Tool on the other end of the UART */
+typedef struct
+{
+    Sim_Time_t  ConfirmDelay;
+    bool        ConfirmPending[SIM_NODE_NUM];
+    uint8_t     Tx[SIM_PC_TX_SIZE];
+    uint32_t    TxHead;
+    uint32_t    TxCount;
+    bool        TxRunning;
+    char        Line[SIM_PC_LINE_MAX];
+    uint32_t    LineLength;
+    bool        LineOverflow;
+    uint32_t    LastValue[256];
+    bool        LastValid[256];
+    char        CapturePath[SIM_PC_PATH_MAX];   /* File written once a capture dump is complete, empty if none */
+    uint8_t     Capture[SIM_PC_CAPTURE_MAX];
+    uint32_t    CaptureSize;                    /* Bytes announced by CAPTURE_SIZE_ID */
+    uint32_t    CaptureLength;                  /* Bytes received, collecting while below CaptureSize */
+    Sim_PcResult_t Result;
+} SIM_Pc_t;
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+static uint32_t SIM_Random(void);
+static void SIM_SendWord(uint8_t Agent, uint32_t Id, uint8_t Dlc, uint32_t Word);
+static uint32_t SIM_FrameWord(const Sim_CanFrame_t *Frame);
+static void SIM_NodeReceive(void *Context, const Sim_CanFrame_t *Frame);
+static void SIM_NodeTick(void *Context, uint32_t Arg);
+static void SIM_NodeSendSample(SIM_Node_t *Node, uint32_t Id);
+static void SIM_NodeForwarded(uint8_t Node, uint32_t Value);
+static void SIM_IgnoreFrame(void *Context, const Sim_CanFrame_t *Frame);
+static void SIM_TrafficTick(void *Context, uint32_t Arg);
+static void SIM_PcReceive(void *Context, uint8_t Byte);
+static void SIM_PcLine(void);
+static void SIM_PcPush(uint8_t Byte);
+static void SIM_PcTxTick(void *Context, uint32_t Arg);
+static void SIM_PcConfirm(void *Context, uint32_t Arg);
+static void SIM_PcCapture(uint32_t Id, uint32_t Value);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static const SIM_NodeClass_t Node_Class[SIM_NODE_CLASS_NUM] =
+{
+    [SIM_NODE_CLASS_DISTANCE] =
+    {
+        .Name            = "distance",
+        .CanClass        = CAN_NODE_CLASS_DISTANCE,
+        .ConnectType     = TX_RQ_CONNECT_DISTANCE_NODE_TYPE,
+        .ConfirmType     = RX_CONFIRM_FROM_DISTANCE_NODE_TYPE,
+        .StopType        = TX_STOPOPR_DISTANCE_NODE_TYPE,
+        .StopConfirmType = RX_CONFIRM_STOPOPR_DNODE_TYPE,
+        .PingType        = TX_PING_DISTANCE_NODE_TYPE,
+        .PingConfirmType = RX_CONFIRM_PING_DISTANCE_NODE_TYPE,
+        .DataType        = RX_DISTANCE_DATA_TYPE,
+        .DataConfirmType = TX_CONFIRM_DISTANCE_DATA_TYPE,
+        .UartDataId      = DISTANCE_DATA_ID,
+        .UartConnectId   = PC_CONNECT_DISTANCE_SENSOR_ID
+    },
+    [SIM_NODE_CLASS_ROTATION] =
+    {
+        .Name            = "rotation",
+        .CanClass        = CAN_NODE_CLASS_ROTATION,
+        .ConnectType     = TX_RQ_CONNECT_ROTATION_NODE_TYPE,
+        .ConfirmType     = RX_CONFIRM_FROM_ROTATION_NODE_TYPE,
+        .StopType        = TX_STOPOPR_ROTATION_NODE_TYPE,
+        .StopConfirmType = RX_CONFIRM_STOPOPR_RNODE_TYPE,
+        .PingType        = TX_PING_ROTATION_NODE_TYPE,
+        .PingConfirmType = RX_CONFIRM_PING_ROTATION_NODE_TYPE,
+        .DataType        = RX_ROTATION_DATA_TYPE,
+        .DataConfirmType = TX_CONFIRM_ROTATION_DATA_TYPE,
+        .UartDataId      = ROTATION_DATA_ID,
+        .UartConnectId   = PC_CONNECT_ROTATION_SENSOR_ID
+    }
+};
+
+static SIM_NodeDesc_t Node_Desc[SIM_NODE_NUM];
+static SIM_Node_t Node[SIM_NODE_NUM];
+static uint8_t Node_Num = 0u;
+static uint8_t Class_Node_Num[SIM_NODE_CLASS_NUM];
+static SIM_Traffic_t Traffic[SIM_TRAFFIC_MAX];
+static uint8_t Traffic_Num = 0u;
+static SIM_Pc_t Pc;
+static uint32_t Random_State = 1u;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+void Sim_Agents_Seed(uint32_t Seed)
+{
+    Random_State = (Seed != 0u) ? Seed : 1u;
+}
+
+bool Sim_Node_Create(uint8_t Class, Sim_Time_t Period, Sim_Time_t Jitter)
+{
+    const SIM_NodeClass_t *nodeClass = &Node_Class[Class];
+    SIM_NodeDesc_t *desc = &Node_Desc[Node_Num];
+    SIM_Node_t *node = &Node[Node_Num];
+    uint8_t index = Class_Node_Num[Class];
+    uint8_t inst = (uint8_t)(CAN_NODE_INST_DEFAULT + index);
+    bool created = false;
+
+    /* The standard format carries no instance, a second node of the class would share the IDs */
+    if ((Node_Num < SIM_NODE_NUM) && ((index == 0u) || (CAN_NODE_INST_STEP != 0u)) && (inst <= CAN_NODE_INST_MAX))
+    {
+        desc->Index         = index;
+        desc->ConnectId     = CAN_NODE_ID(nodeClass->CanClass, inst, nodeClass->ConnectType);
+        desc->ConfirmId     = CAN_NODE_ID(nodeClass->CanClass, inst, nodeClass->ConfirmType);
+        desc->StopId        = CAN_NODE_ID(nodeClass->CanClass, inst, nodeClass->StopType);
+        desc->StopConfirmId = CAN_NODE_ID(nodeClass->CanClass, inst, nodeClass->StopConfirmType);
+        desc->PingId        = CAN_NODE_ID(nodeClass->CanClass, inst, nodeClass->PingType);
+        desc->PingConfirmId = CAN_NODE_ID(nodeClass->CanClass, inst, nodeClass->PingConfirmType);
+        desc->DataId        = CAN_NODE_ID(nodeClass->CanClass, inst, nodeClass->DataType);
+        desc->DataConfirmId = CAN_NODE_ID(nodeClass->CanClass, inst, nodeClass->DataConfirmType);
+        desc->UartDataId    = nodeClass->UartDataId + index;
+        desc->UartConnectId = nodeClass->UartConnectId;
+
+        if (index == 0u)
+        {
+            (void)snprintf(node->Result.Name, sizeof(node->Result.Name), "%s", nodeClass->Name);
+        }
+        else
+        {
+            (void)snprintf(node->Result.Name, sizeof(node->Result.Name), "%s%u", nodeClass->Name, (unsigned)(index + 1u));
+        }
+
+        node->Agent = Sim_CAN_AttachAgent(CAN_SENSOR_BUS, SIM_NodeReceive, node);
+        node->Period = Period;
+        node->Jitter = Jitter;
+        node->Result.Created = (node->Agent != 0xFFu);
+        Class_Node_Num[Class]++;
+        Node_Num++;
+        created = node->Result.Created;
+    }
+
+    return created;
+}
+
+bool Sim_Node_Find(const char *Name, uint8_t *Index)
+{
+    uint8_t index = 0u;
+    bool found = false;
+
+    for (index = 0u; (index < Node_Num) && (found == false); index++)
+    {
+        if (strcmp(Node[index].Result.Name, Name) == 0)
+        {
+            *Index = index;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+void Sim_Node_Mute(uint8_t Index, Sim_Time_t Duration)
+{
+    Node[Index].MuteUntil = Sim_Now() + Duration;
+}
+
+void Sim_Node_GetResult(uint8_t Index, Sim_NodeResult_t *Result)
+{
+    const SIM_Node_t *node = &Node[Index];
+    uint64_t total = 0u;
+    uint64_t count = 0u;
+    uint32_t bucket = 0u;
+
+    *Result = node->Result;
+
+    for (bucket = 0u; bucket <= SIM_LATENCY_BUCKET_NUM; bucket++)
+    {
+        total += node->Histogram[bucket];
+    }
+
+    for (bucket = 0u; (bucket <= SIM_LATENCY_BUCKET_NUM) && (total != 0u); bucket++)
+    {
+        count += node->Histogram[bucket];
+
+        /* Upper bound of the bucket */
+        if ((Result->LatencyP50 == 0u) && ((count * 100u) >= (total * 50u)))
+        {
+            Result->LatencyP50 = (Sim_Time_t)(bucket + 1u) * SIM_LATENCY_BUCKET_NS;
+        }
+
+        if ((Result->LatencyP99 == 0u) && ((count * 100u) >= (total * 99u)))
+        {
+            Result->LatencyP99 = (Sim_Time_t)(bucket + 1u) * SIM_LATENCY_BUCKET_NS;
+        }
+    }
+}
+
+bool Sim_Traffic_Create(uint32_t Id, bool Ext, Sim_Time_t Period, uint8_t Dlc)
+{
+    SIM_Traffic_t *traffic = NULL;
+    bool created = false;
+
+    if ((Traffic_Num < SIM_TRAFFIC_MAX) && (Period != 0u))
+    {
+        traffic = &Traffic[Traffic_Num];
+        traffic->Agent = Sim_CAN_AttachAgent(CAN_SENSOR_BUS, SIM_IgnoreFrame, traffic);
+        traffic->Period = Period;
+        traffic->Frame.Id = Id;
+        traffic->Frame.Ext = Ext ? 1u : 0u;
+        traffic->Frame.Rtr = 0u;
+        traffic->Frame.Dlc = (Dlc > 8u) ? 8u : Dlc;
+
+        if (traffic->Agent != 0xFFu)
+        {
+            Traffic_Num++;
+            Sim_Schedule(Sim_Now() + (SIM_Random() % Period), SIM_TrafficTick, traffic, 0u);
+            created = true;
+        }
+    }
+
+    return created;
+}
+
+void Sim_Pc_Init(Sim_Time_t ConfirmDelay)
+{
+    Pc.ConfirmDelay = ConfirmDelay;
+    Sim_LPUART_Attach(SIM_PC_LPUART, SIM_PcReceive, &Pc);
+}
+
+void Sim_Pc_SendLine(uint32_t Id, uint32_t Data)
+{
+    char text[24];
+    uint32_t length = 0u;
+    uint32_t value = 0u;
+    uint8_t part = 0u;
+
+    /* "<id>-<data>\n", digits written backwards then pushed in order */
+    for (part = 0u; part < 2u; part++)
+    {
+        value = (part == 0u) ? Data : Id;
+
+        if (part == 1u)
+        {
+            text[length++] = '-';
+        }
+
+        do
+        {
+            text[length++] = (char)('0' + (value % 10u));
+            value /= 10u;
+        } while (value != 0u);
+    }
+
+    while (length != 0u)
+    {
+        length--;
+        SIM_PcPush((uint8_t)text[length]);
+    }
+
+    SIM_PcPush((uint8_t)'\n');
+    Pc.Result.LinesSent++;
+}
+
+void Sim_Pc_SendGarbage(uint32_t Length)
+{
+    uint32_t index = 0u;
+
+    for (index = 0u; index < Length; index++)
+    {
+        SIM_PcPush((uint8_t)SIM_Random());
+    }
+
+    SIM_PcPush((uint8_t)'\n');
+}
+
+void Sim_Pc_GetResult(Sim_PcResult_t *Result)
+{
+    *Result = Pc.Result;
+}
+
+void Sim_Pc_SetCaptureFile(const char *Path)
+{
+    (void)snprintf(Pc.CapturePath, sizeof(Pc.CapturePath), "%s", Path);
+}
+
+bool Sim_Pc_GetLastValue(uint32_t Id, uint32_t *Value)
+{
+    bool valid = (Id < 256u) && (Pc.LastValid[Id] == true);
+
+    if (valid == true)
+    {
+        *Value = Pc.LastValue[Id];
+    }
+
+    return valid;
+}
+
+/**
+  * @brief      Pseudo random number, xorshift32
+  * @param[in]  None
+  * @param[out] None
+  * @retval     Random value
+  */
+static uint32_t SIM_Random(void)
+{
+    Random_State ^= Random_State << 13u;
+    Random_State ^= Random_State >> 17u;
+    Random_State ^= Random_State << 5u;
+
+    return Random_State;
+}
+
+/**
+  * @brief      Send a frame whose first data word holds a value, as MID_CAN_SendCANMessage() does
+  * @param[in]  Agent: Agent index on the sensor bus
+  * @param[in]  Id: Identifier
+  * @param[in]  Dlc: Data length
+  * @param[in]  Word: Bytes 0..3, byte 0 most significant
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_SendWord(uint8_t Agent, uint32_t Id, uint8_t Dlc, uint32_t Word)
+{
+    Sim_CanFrame_t frame = {0};
+
+    frame.Id = Id;
+    frame.Ext = SIM_NODE_EXT;
+    frame.Dlc = Dlc;
+    frame.Data[0] = (uint8_t)(Word >> 24u);
+    frame.Data[1] = (uint8_t)(Word >> 16u);
+    frame.Data[2] = (uint8_t)(Word >> 8u);
+    frame.Data[3] = (uint8_t)Word;
+
+    (void)Sim_CAN_AgentSend(CAN_SENSOR_BUS, Agent, &frame);
+}
+
+/**
+  * @brief      First data word of a frame
+  * @param[in]  Frame: Frame
+  * @param[out] None
+  * @retval     Bytes 0..3, byte 0 most significant
+  */
+static uint32_t SIM_FrameWord(const Sim_CanFrame_t *Frame)
+{
+    return ((uint32_t)Frame->Data[0] << 24u) | ((uint32_t)Frame->Data[1] << 16u) |
+           ((uint32_t)Frame->Data[2] << 8u) | (uint32_t)Frame->Data[3];
+}
+
+/**
+  * @brief      Frame seen by a sensor node: answer the commands of the forwarder
+  * @param[in]  Context: Node
+  * @param[in]  Frame: Frame
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_NodeReceive(void *Context, const Sim_CanFrame_t *Frame)
+{
+    SIM_Node_t *node = (SIM_Node_t *)Context;
+    const SIM_NodeDesc_t *desc = &Node_Desc[node - Node];
+    uint8_t command = (uint8_t)SIM_FrameWord(Frame);
+
+    if ((Sim_Now() < node->MuteUntil) || (Frame->Ext != SIM_NODE_EXT))
+    {
+        /* Do nothing */
+    }
+    else if ((Frame->Id == desc->ConnectId) && (command == TX_MSG_REQUEST_DATA))
+    {
+        SIM_SendWord(node->Agent, desc->ConfirmId, CAN_LEGACY_DATA_LENGTH, CONFIRM_CONNECTION_DATA);
+        node->Connected = true;
+
+        if (node->Running == false)
+        {
+            node->Running = true;
+            Sim_Schedule(Sim_Now() + node->Period, SIM_NodeTick, node, 0u);
+        }
+    }
+    else if (Frame->Id == desc->StopId)
+    {
+        if (command == TX_STOPOPR_DATA)
+        {
+            SIM_SendWord(node->Agent, desc->StopConfirmId, CAN_LEGACY_DATA_LENGTH, TX_STOPOPR_DATA);
+            node->Stopped = true;
+            node->Result.Stops++;
+        }
+        else if (command == TX_WAKEUP_DATA)
+        {
+            node->Stopped = false;
+        }
+        else
+        {
+            /* Do nothing */
+        }
+    }
+    else if (((Frame->Id == desc->PingId) && (Frame->Rtr == 0u)) ||
+             ((Frame->Id == desc->PingConfirmId) && (Frame->Rtr != 0u)))
+    {
+        /* Software ping or remote request, both answered by the latest sample */
+        SIM_NodeSendSample(node, desc->PingConfirmId);
+        node->Result.Pings++;
+    }
+    else if (Frame->Id == desc->DataConfirmId)
+    {
+        node->Result.Confirms++;
+    }
+    else
+    {
+        /* Do nothing */
+    }
+}
+
+/**
+  * @brief      Data period of a sensor node: send the next sample while connected and running
+  * @param[in]  Context: Node
+  * @param[in]  Arg: Not used
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_NodeTick(void *Context, uint32_t Arg)
+{
+    SIM_Node_t *node = (SIM_Node_t *)Context;
+    Sim_Time_t jitter = (node->Jitter != 0u) ? (SIM_Random() % node->Jitter) : 0u;
+
+    (void)Arg;
+
+    if ((node->Connected == true) && (node->Stopped == false) && (Sim_Now() >= node->MuteUntil))
+    {
+        node->LastValue = node->Value;
+        node->SendTime[node->Value] = Sim_Now() + 1u;
+        node->Value = (uint16_t)((node->Value + 1u) % SIM_NODE_VALUE_NUM);
+        node->Result.Sent++;
+        SIM_NodeSendSample(node, Node_Desc[node - Node].DataId);
+    }
+
+    Sim_Schedule(Sim_Now() + node->Period + jitter, SIM_NodeTick, node, 0u);
+}
+
+/**
+  * @brief      Send the latest sample of a node in the legacy layout
+  * @param[in]  Node: Node
+  * @param[in]  Id: Data or ping answer identifier
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_NodeSendSample(SIM_Node_t *Node, uint32_t Id)
+{
+    SIM_SendWord(Node->Agent, Id, CAN_LEGACY_DATA_LENGTH, Node->LastValue);
+}
+
+/**
+  * @brief      Sample of a node received by the PC: measure its latency
+  * @param[in]  Index: Node
+  * @param[in]  Value: Sample
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_NodeForwarded(uint8_t Index, uint32_t Value)
+{
+    SIM_Node_t *node = &Node[Index];
+    Sim_Time_t latency = 0u;
+    uint32_t bucket = 0u;
+
+    if (Value == SENSOR_DISCONNECT_DATA)
+    {
+        node->Result.Disconnects++;
+    }
+    else if ((Value < SIM_NODE_VALUE_NUM) && (node->SendTime[Value] != 0u))
+    {
+        latency = Sim_Now() - (node->SendTime[Value] - 1u);
+        node->SendTime[Value] = 0u;
+        bucket = (uint32_t)(latency / SIM_LATENCY_BUCKET_NS);
+        bucket = (bucket > SIM_LATENCY_BUCKET_NUM) ? SIM_LATENCY_BUCKET_NUM : bucket;
+        node->Histogram[bucket]++;
+        node->Result.LatencyMax = (latency > node->Result.LatencyMax) ? latency : node->Result.LatencyMax;
+        node->Result.Forwarded++;
+    }
+    else
+    {
+        /* Ping answers repeat the latest sample */
+        node->Result.Unknown++;
+    }
+}
+
+/**
+  * @brief      Receive callback of the agents not listening to the bus
+  * @param[in]  Context: Not used
+  * @param[in]  Frame: Not used
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_IgnoreFrame(void *Context, const Sim_CanFrame_t *Frame)
+{
+    (void)Context;
+    (void)Frame;
+}
+
+/**
+  * @brief      Period of a traffic generator: send a frame holding a counter
+  * @param[in]  Context: Generator
+  * @param[in]  Arg: Not used
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_TrafficTick(void *Context, uint32_t Arg)
+{
+    SIM_Traffic_t *traffic = (SIM_Traffic_t *)Context;
+    uint8_t index = 0u;
+
+    (void)Arg;
+
+    for (index = 0u; index < 8u; index++)
+    {
+        traffic->Frame.Data[index]++;
+
+        if (traffic->Frame.Data[index] != 0u)
+        {
+            break;
+        }
+    }
+
+    (void)Sim_CAN_AgentSend(CAN_SENSOR_BUS, traffic->Agent, &traffic->Frame);
+    Sim_Schedule(Sim_Now() + traffic->Period, SIM_TrafficTick, traffic, 0u);
+}
+
+/**
+  * @brief      Byte sent by the forwarder, lines end on '\n'
+  * @param[in]  Context: PC agent
+  * @param[in]  Byte: Byte received
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_PcReceive(void *Context, uint8_t Byte)
+{
+    (void)Context;
+
+    if (Byte == (uint8_t)'\n')
+    {
+        SIM_PcLine();
+        Pc.LineLength = 0u;
+        Pc.LineOverflow = false;
+    }
+    else if (Pc.LineLength < SIM_PC_LINE_MAX)
+    {
+        Pc.Line[Pc.LineLength] = (char)Byte;
+        Pc.LineLength++;
+    }
+    else
+    {
+        Pc.LineOverflow = true;
+    }
+}
+
+/**
+  * @brief      Line "<id>-<data>" sent by the forwarder
+  * @param[in]  None
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_PcLine(void)
+{
+    uint32_t value[2] = {0u, 0u};
+    uint32_t digits[2] = {0u, 0u};
+    uint8_t part = 0u;
+    uint32_t index = 0u;
+    uint8_t node = 0u;
+    bool valid = (Pc.LineOverflow == false);
+    char c = '\0';
+
+    for (index = 0u; (index < Pc.LineLength) && (valid == true); index++)
+    {
+        c = Pc.Line[index];
+
+        if ((c >= '0') && (c <= '9'))
+        {
+            value[part] = (value[part] * 10u) + (uint32_t)(c - '0');
+            digits[part]++;
+        }
+        else if ((c == '-') && (part == 0u))
+        {
+            part = 1u;
+        }
+        else
+        {
+            valid = false;
+        }
+    }
+
+    Pc.Result.Lines++;
+
+    if ((valid == false) || (part != 1u) || (digits[0] == 0u) || (digits[1] == 0u) || (value[0] > 255u))
+    {
+        Pc.Result.BadLines++;
+    }
+    else
+    {
+        Pc.LastValue[value[0]] = value[1];
+        Pc.LastValid[value[0]] = true;
+        SIM_PcCapture(value[0], value[1]);
+
+        for (node = 0u; node < Node_Num; node++)
+        {
+            if (value[0] == Node_Desc[node].UartDataId)
+            {
+                SIM_NodeForwarded(node, value[1]);
+
+                /* The PC Tool confirms the data, one confirmation in flight per node */
+                if ((Pc.ConfirmDelay != 0u) && (Pc.ConfirmPending[node] == false) && (value[1] != SENSOR_DISCONNECT_DATA))
+                {
+                    Pc.ConfirmPending[node] = true;
+                    Sim_Schedule(Sim_Now() + Pc.ConfirmDelay, SIM_PcConfirm, &Pc, node);
+                }
+            }
+            else if ((value[0] == Node_Desc[node].UartConnectId) && (value[1] == CONFIRM_CONNECTION_DATA) &&
+                     (Node_Desc[node].Index == 0u))
+            {
+                /* Shared by the nodes of the class, counted once */
+                Pc.Result.ConnectConfirms++;
+            }
+            else
+            {
+                /* Do nothing */
+            }
+        }
+
+        if ((value[0] == PC_CONNECT_FORWARDER_ID) && (value[1] == CONFIRM_CONNECTION_DATA))
+        {
+            Pc.Result.ConnectConfirms++;
+        }
+        else if (value[0] == STATS_NODE_INDEX_ID)
+        {
+            Pc.Result.ReportNodes++;
+        }
+        else if (value[0] == TASK_INDEX_ID)
+        {
+            Pc.Result.ReportTasks++;
+        }
+        else
+        {
+            /* Do nothing */
+        }
+    }
+}
+
+/**
+  * @brief      Queue a byte for the UART line of the PC agent
+  * @param[in]  Byte: Byte to send
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_PcPush(uint8_t Byte)
+{
+    if (Pc.TxCount < SIM_PC_TX_SIZE)
+    {
+        Pc.Tx[(Pc.TxHead + Pc.TxCount) % SIM_PC_TX_SIZE] = Byte;
+        Pc.TxCount++;
+    }
+
+    if (Pc.TxRunning == false)
+    {
+        Pc.TxRunning = true;
+        Sim_Schedule(Sim_Now(), SIM_PcTxTick, &Pc, 0u);
+    }
+}
+
+/**
+  * @brief      Character period of the PC agent: the byte on the line reaches the receiver of the forwarder
+  * @param[in]  Context: PC agent
+  * @param[in]  Arg: 1 if a byte completes, 0 to start the line
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_PcTxTick(void *Context, uint32_t Arg)
+{
+    Sim_Time_t charTime = Sim_LPUART_GetCharTime(SIM_PC_LPUART);
+
+    (void)Context;
+    (void)Arg;
+
+    if (charTime == 0u)
+    {
+        Sim_Schedule(Sim_Now() + SIM_PC_RETRY_NS, SIM_PcTxTick, &Pc, 0u);
+    }
+    else
+    {
+        if (Arg == 1u)
+        {
+            Sim_LPUART_Inject(SIM_PC_LPUART, Pc.Tx[Pc.TxHead]);
+            Pc.TxHead = (Pc.TxHead + 1u) % SIM_PC_TX_SIZE;
+            Pc.TxCount--;
+        }
+
+        /* The next byte is complete one character time after its start bit */
+        if (Pc.TxCount != 0u)
+        {
+            Sim_Schedule(Sim_Now() + charTime, SIM_PcTxTick, &Pc, 1u);
+        }
+        else
+        {
+            Pc.TxRunning = false;
+        }
+    }
+}
+
+/**
+  * @brief      Data confirmation of the PC Tool
+  * @param[in]  Context: PC agent
+  * @param[in]  Arg: Node
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_PcConfirm(void *Context, uint32_t Arg)
+{
+    (void)Context;
+
+    Pc.ConfirmPending[Arg] = false;
+    Sim_Pc_SendLine(Node_Desc[Arg].UartDataId, CONFIRM_SENSOR_DATA);
+}
+
+/**
+  * @brief      Collect a capture dump of the forwarder and write it to the capture file once complete
+  * @param[in]  Id: UART frame ID
+  * @param[in]  Value: Value of the frame
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_PcCapture(uint32_t Id, uint32_t Value)
+{
+    FILE *file = NULL;
+    uint8_t index = 0u;
+    bool collected = false;
+
+    if (Id == CAPTURE_SIZE_ID)
+    {
+        Pc.CaptureSize = (Value <= SIM_PC_CAPTURE_MAX) ? Value : SIM_PC_CAPTURE_MAX;
+        Pc.CaptureLength = 0u;
+        collected = true;
+    }
+    else if ((Id == CAPTURE_DATA_ID) && (Pc.CaptureLength < Pc.CaptureSize))
+    {
+        /* Big-endian words, the padding of the last one is dropped */
+        for (index = 0u; (index < 4u) && (Pc.CaptureLength < Pc.CaptureSize); index++)
+        {
+            Pc.Capture[Pc.CaptureLength] = (uint8_t)(Value >> (24u - (8u * index)));
+            Pc.CaptureLength++;
+        }
+        collected = true;
+    }
+    else
+    {
+        /* Do nothing */
+    }
+
+    if ((collected == true) && (Pc.CaptureLength == Pc.CaptureSize) && (Pc.CapturePath[0] != '\0'))
+    {
+        file = fopen(Pc.CapturePath, "wb");
+
+        if (file != NULL)
+        {
+            (void)fwrite(Pc.Capture, 1u, Pc.CaptureLength, file);
+            fclose(file);
+            Pc.Result.Captures++;
+        }
+        else
+        {
+            fprintf(stderr, "%s: cannot write\n", Pc.CapturePath);
+        }
+    }
+}
+
+/*******************************************************************************
+ * End Of File
+ ******************************************************************************/
@@ -0,0 +1,196 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "DRV_S32K144_MCU.h"
+#include "DRV_S32K144_PORT.h"
+#include "DRV_S32K144_GPIO.h"
+#include "DRV_S32K144_NVIC.h"
+#include "Sim_Kernel.h"
+#include "Sim_Board.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/* Clock tree set up by MID_Clock_Init(): SOSC 8 MHz, SPLL 160 MHz, SYS_CLK 80 MHz */
+#define SIM_SOSCDIV2_HZ     8000000u
+#define SIM_SPLLDIV2_HZ     40000000u
+#define SIM_SYS_CLK_HZ      80000000u
+
+#define SIM_PORT_NUM        5u
+#define SIM_PIN_NUM         32u
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+static void SIM_SetPin(uint8_t Port, uint8_t Pin, bool Level);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/* Output level and toggle count of every GPIO pin */
+static uint32_t Pin_Level[SIM_PORT_NUM];
+static uint32_t Pin_Changes[SIM_PORT_NUM][SIM_PIN_NUM];
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+uint32_t Sim_Board_GetPinChanges(uint8_t Port, uint8_t Pin)
+{
+    return ((Port < SIM_PORT_NUM) && (Pin < SIM_PIN_NUM)) ? Pin_Changes[Port][Pin] : 0u;
+}
+
+bool Sim_Board_GetPinLevel(uint8_t Port, uint8_t Pin)
+{
+    return ((Port < SIM_PORT_NUM) && (Pin < SIM_PIN_NUM)) ? (((Pin_Level[Port] >> Pin) & 1u) != 0u) : false;
+}
+
+/**
+  * @brief      Drive a GPIO pin, counting the level changes
+  * @param[in]  Port: Port index
+  * @param[in]  Pin: Pin number
+  * @param[in]  Level: New level
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_SetPin(uint8_t Port, uint8_t Pin, bool Level)
+{
+    if ((Port < SIM_PORT_NUM) && (Pin < SIM_PIN_NUM) && (Sim_Board_GetPinLevel(Port, Pin) != Level))
+    {
+        Pin_Level[Port] ^= (1u << Pin);
+        Pin_Changes[Port][Pin]++;
+    }
+}
+
+clock_status_t DRV_Clock_Init(const clock_manager_config_t * clkConfig)
+{
+    (void)clkConfig;
+    Sim_Access();
+
+    return CLOCK_STATUS_SUCCESS;
+}
+
+clock_status_t DRV_Clock_GetFrequency(clock_names_t clockName, uint32_t * frequency)
+{
+    Sim_Access();
+
+    switch (clockName)
+    {
+    case SOSCDIV2_CLK:
+        *frequency = SIM_SOSCDIV2_HZ;
+        break;
+
+    case LPIT0_CLK:
+    case LPUART0_CLK:
+    case LPUART1_CLK:
+    case LPUART2_CLK:
+        *frequency = SIM_SPLLDIV2_HZ;
+        break;
+
+    default:
+        *frequency = SIM_SYS_CLK_HZ;
+        break;
+    }
+
+    return CLOCK_STATUS_SUCCESS;
+}
+
+void DRV_PORT_Init(const uint8_t Port_Ins, const uint8_t Pin, const PortConfig_t * pConfig)
+{
+    (void)Port_Ins;
+    (void)Pin;
+    (void)pConfig;
+    Sim_Access();
+}
+
+void DRV_GPIO_SetPinDirection(const uint8_t Port_Ins, const uint8_t Pin, const GPIO_Data_Direction_t mode)
+{
+    (void)Port_Ins;
+    (void)Pin;
+    (void)mode;
+    Sim_Access();
+}
+
+uint32_t DRV_GPIO_ReadPins(const uint8_t Port_Ins, const uint8_t Pin)
+{
+    Sim_Access();
+
+    return (Sim_Board_GetPinLevel(Port_Ins, Pin) == true) ? 1u : 0u;
+}
+
+void DRV_GPIO_WritePins(const uint8_t Port_Ins, const uint8_t Pin, const GPIO_Data_Output_t mode)
+{
+    SIM_SetPin(Port_Ins, Pin, (mode == GPIO_PIN_1_LOGIC));
+    Sim_Access();
+}
+
+void DRV_GPIO_SetPins(const uint8_t Port_Ins, const uint8_t Pin)
+{
+    SIM_SetPin(Port_Ins, Pin, true);
+    Sim_Access();
+}
+
+void DRV_GPIO_ClearPins(const uint8_t Port_Ins, const uint8_t Pin)
+{
+    SIM_SetPin(Port_Ins, Pin, false);
+    Sim_Access();
+}
+
+void DRV_GPIO_TogglePins(const uint8_t Port_Ins, const uint8_t Pin)
+{
+    SIM_SetPin(Port_Ins, Pin, !Sim_Board_GetPinLevel(Port_Ins, Pin));
+    Sim_Access();
+}
+
+void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    Sim_Irq_SetEnabled(IRQn, true);
+    Sim_Access();
+}
+
+void NVIC_DisbleIRQ(IRQn_Type IRQn)
+{
+    Sim_Irq_SetEnabled(IRQn, false);
+    Sim_Access();
+}
+
+void NVIC_SetPendingIRQ(IRQn_Type IRQn)
+{
+    /* Lines are level driven by the peripheral models, software pending is not modelled */
+    (void)IRQn;
+    Sim_Access();
+}
+
+void NVIC_ClearPendingIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+    Sim_Access();
+}
+
+uint32_t NVIC_GetPendingIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+    Sim_Access();
+
+    return 0u;
+}
+
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority)
+{
+    (void)IRQn;
+    (void)priority;
+    Sim_Access();
+}
+
+uint32_t NVIC_GetPriority(IRQn_Type IRQn)
+{
+    (void)IRQn;
+    Sim_Access();
+
+    return 0u;
+}
+
+/*******************************************************************************
+ * End Of File
+ ******************************************************************************/
@@ -0,0 +1,1316 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "DRV_S32K144_FLEXCAN.h"
+#include "Sim_Kernel.h"
+#include "Sim_FlexCAN.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+#define SIM_CAN_NUM             FLEXCAN_INSTANCE_COUNT
+
+/* Bitrate of a bus nobody configured yet */
+#define SIM_CAN_BITRATE_DEFAULT 500000u
+
+/* Frame length in bits without stuff bits: SOF, arbitration, control, CRC, ACK, EOF and intermission */
+#define SIM_CAN_STD_FRAME_BITS  47u
+#define SIM_CAN_EXT_FRAME_BITS  67u
+
+/* Fault confinement thresholds */
+#define SIM_CAN_WARNING_LIMIT   96u
+#define SIM_CAN_PASSIVE_LIMIT   128u
+#define SIM_CAN_BUSOFF_LIMIT    256u
+#define SIM_CAN_ERROR_STEP      8u
+#define SIM_CAN_RECOVERY_BITS   (128u * 11u)
+
+/* Sender of the frame on the bus, agents use their own index */
+#define SIM_CAN_SOURCE_CTRL     0xFEu
+
+/* No candidate for the bus */
+#define SIM_CAN_KEY_NONE        UINT64_MAX
+
+/* One message buffer, words as in the FlexCAN RAM */
+typedef struct
+{
+    uint32_t Cs;
+    uint32_t Id;                /* PRIO and ID fields */
+    uint32_t Data[2];
+    uint32_t Mask;              /* RXIMR, in ID space */
+    bool     Serviced;          /* Read by the CPU since the last move-in */
+    bool     AnswerPending;     /* RANSWER buffer hit by a remote request */
+} SIM_CanMb_t;
+
+/* One agent and its frames waiting for the bus */
+typedef struct
+{
+    Sim_CanReceive_t Receive;
+    void            *Context;
+    Sim_CanFrame_t   Queue[SIM_CAN_AGENT_TX_MAX];
+    uint8_t          Head;
+    uint8_t          Count;
+} SIM_CanAgent_t;
+
+/* One FlexCAN instance and the bus it drives */
+typedef struct
+{
+    bool                      Registered;
+    bool                      Initialized;
+    bool                      Frozen;
+    flexcan_operation_modes_t Mode;
+    flexcan_rx_mask_type_t    RxMaskType;
+    uint8_t                   LocalPriority;
+    uint8_t                   SelfReception;
+    uint32_t                  Bitrate;          /* Controller */
+    uint32_t                  BusBitrate;       /* Other nodes, 0: same as the controller */
+    Sim_Time_t                NoAckEnd;         /* Frames of the controller are not acknowledged before */
+    uint32_t                  GlobalMask;
+    Sim_Time_t                TimerStart;
+    uint8_t                   MbNum;
+    SIM_CanMb_t               Mb[FLEXCAN_MAX_MB_NUM];
+    uint32_t                  IFlag;
+    uint32_t                  IMask;
+    uint32_t                  Tec;
+    uint32_t                  Rec;
+    flexcan_fault_state_t     Fault;
+    bool                      RecoveryScheduled;
+    bool                      BusOffInt;        /* ESR1[BOFFINT] */
+    bool                      ErrStateInt;      /* ESR1[TWRNINT/RWRNINT/BOFFDONEINT] */
+    bool                      ErrInt;           /* ESR1[ERRINT], set by every bus error */
+    bool                      ErrMask;          /* CTRL1[ERRMSK] */
+    uint32_t                  RxErrFlags;       /* ESR1 error bits, cleared on read */
+    flexcan_handle_t         *Handle;
+    SIM_CanAgent_t            Agent[SIM_CAN_AGENT_MAX];
+    uint8_t                   AgentNum;
+    bool                      Busy;
+    bool                      ArbitrationScheduled;
+    uint8_t                   TxSource;
+    uint8_t                   TxMb;
+    Sim_CanFrame_t            TxFrame;
+    Sim_Time_t                TxStart;
+    Sim_Time_t                TxEnd;
+    Sim_CanStats_t            Stats;
+} SIM_Can_t;
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+static uint32_t SIM_CanEncodeId(bool Ext, uint32_t Id);
+static uint32_t SIM_CanDecodeId(bool Ext, uint32_t IdWord);
+static uint64_t SIM_CanArbitrationKey(const Sim_CanFrame_t *Frame);
+static uint32_t SIM_CanBusBitrate(const SIM_Can_t *Can);
+static Sim_Time_t SIM_CanBitTime(const SIM_Can_t *Can, uint32_t Bits);
+static uint16_t SIM_CanTimer(const SIM_Can_t *Can);
+static void SIM_CanMbToFrame(const SIM_CanMb_t *Mb, bool Answer, Sim_CanFrame_t *Frame);
+static bool SIM_CanControllerActive(const SIM_Can_t *Can);
+static void SIM_CanKick(SIM_Can_t *Can);
+static void SIM_CanArbitrate(void *Context, uint32_t Arg);
+static void SIM_CanFrameEnd(void *Context, uint32_t Arg);
+static void SIM_CanControllerReceive(SIM_Can_t *Can, const Sim_CanFrame_t *Frame);
+static void SIM_CanStore(SIM_Can_t *Can, uint8_t MbIdx, uint32_t Code, const Sim_CanFrame_t *Frame);
+static void SIM_CanUpdateFault(SIM_Can_t *Can, uint32_t OldTec, uint32_t OldRec);
+static void SIM_CanRecover(void *Context, uint32_t Arg);
+static bool SIM_CanMbPending(uint8_t Instance, uint32_t Lines);
+static bool SIM_CanErrPending(uint8_t Instance);
+static bool SIM_CanBusErrPending(uint8_t Instance);
+static void SIM_CanMbIrq(uint8_t Instance);
+static void SIM_CanErrIrq(uint8_t Instance);
+static void SIM_CanBusErrIrq(uint8_t Instance);
+static bool SIM_Can0MbLowPending(void);
+static bool SIM_Can0MbHighPending(void);
+static bool SIM_Can0ErrPending(void);
+static bool SIM_Can1MbPending(void);
+static bool SIM_Can1ErrPending(void);
+static bool SIM_Can2MbPending(void);
+static bool SIM_Can2ErrPending(void);
+static void SIM_Can0MbIrq(void);
+static void SIM_Can0ErrIrq(void);
+static void SIM_Can1MbIrq(void);
+static void SIM_Can1ErrIrq(void);
+static void SIM_Can2MbIrq(void);
+static void SIM_Can2ErrIrq(void);
+static bool SIM_Can0BusErrPending(void);
+static bool SIM_Can1BusErrPending(void);
+static bool SIM_Can2BusErrPending(void);
+static void SIM_Can0BusErrIrq(void);
+static void SIM_Can1BusErrIrq(void);
+static void SIM_Can2BusErrIrq(void);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static SIM_Can_t Can[SIM_CAN_NUM];
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+void DRV_FLEXCAN_Init(uint8_t instance, flexcan_module_config_t *config, flexcan_handle_t *handle)
+{
+    SIM_Can_t *can = &Can[instance];
+    uint8_t i = 0u;
+
+    if (can->Registered == false)
+    {
+        if (instance == 0u)
+        {
+            Sim_Irq_Register(CAN0_ORed_IRQn, "CAN0_ORed", SIM_Can0ErrPending, SIM_Can0ErrIrq);
+            Sim_Irq_Register(CAN0_Error_IRQn, "CAN0_Error", SIM_Can0BusErrPending, SIM_Can0BusErrIrq);
+            Sim_Irq_Register(CAN0_ORed_0_15_MB_IRQn, "CAN0_MB0_15", SIM_Can0MbLowPending, SIM_Can0MbIrq);
+            Sim_Irq_Register(CAN0_ORed_16_31_MB_IRQn, "CAN0_MB16_31", SIM_Can0MbHighPending, SIM_Can0MbIrq);
+        }
+        else if (instance == 1u)
+        {
+            Sim_Irq_Register(CAN1_ORed_IRQn, "CAN1_ORed", SIM_Can1ErrPending, SIM_Can1ErrIrq);
+            Sim_Irq_Register(CAN1_Error_IRQn, "CAN1_Error", SIM_Can1BusErrPending, SIM_Can1BusErrIrq);
+            Sim_Irq_Register(CAN1_ORed_0_15_MB_IRQn, "CAN1_MB0_15", SIM_Can1MbPending, SIM_Can1MbIrq);
+        }
+        else
+        {
+            Sim_Irq_Register(CAN2_ORed_IRQn, "CAN2_ORed", SIM_Can2ErrPending, SIM_Can2ErrIrq);
+            Sim_Irq_Register(CAN2_Error_IRQn, "CAN2_Error", SIM_Can2BusErrPending, SIM_Can2BusErrIrq);
+            Sim_Irq_Register(CAN2_ORed_0_15_MB_IRQn, "CAN2_MB0_15", SIM_Can2MbPending, SIM_Can2MbIrq);
+        }
+        can->Registered = true;
+    }
+
+    can->MbNum = (instance == 0u) ? 32u : 16u;
+    can->Mode = config->flexcanMode;
+    can->RxMaskType = config->rxMaskType;
+    can->LocalPriority = config->localPriority;
+    can->SelfReception = config->selfReception;
+    can->Bitrate = config->bitrate;
+    can->GlobalMask = 0u;
+    can->TimerStart = Sim_Now();
+    can->IFlag = 0u;
+    can->IMask = 0u;
+    can->Tec = 0u;
+    can->Rec = 0u;
+    can->Fault = FLEXCAN_ERROR_ACTIVE;
+    can->BusOffInt = false;
+    can->ErrStateInt = false;
+    can->ErrInt = false;
+    can->ErrMask = false;
+    can->RxErrFlags = 0u;
+    can->Frozen = false;
+
+    for (i = 0u; i < FLEXCAN_MAX_MB_NUM; i++)
+    {
+        can->Mb[i].Cs = 0u;
+        can->Mb[i].Id = 0u;
+        can->Mb[i].Data[0] = 0u;
+        can->Mb[i].Data[1] = 0u;
+        can->Mb[i].Mask = 0u;
+        can->Mb[i].Serviced = false;
+        can->Mb[i].AnswerPending = false;
+        handle->frames[i].cs = 0u;
+        handle->mbOverrunCnt[i] = 0u;
+        handle->mbBusyCnt[i] = 0u;
+    }
+
+    handle->mb_callback = NULL;
+    handle->bus_off_callback = NULL;
+    handle->error_state_callback = NULL;
+    handle->busOffRecovery = FLEXCAN_BUSOFF_RECOVERY_AUTO;
+    handle->selfReception = config->selfReception;
+    can->Handle = handle;
+    can->Initialized = true;
+
+    SIM_CanKick(can);
+    Sim_Access();
+}
+
+void DRV_FLEXCAN_ChangeBitrate(uint8_t instance, const flexcan_module_config_t *config)
+{
+    Can[instance].Bitrate = config->bitrate;
+    Sim_Access();
+}
+
+void DRV_FLEXCAN_SetOperationMode(uint8_t instance, flexcan_operation_modes_t flexcanMode)
+{
+    Can[instance].Mode = flexcanMode;
+    SIM_CanKick(&Can[instance]);
+    Sim_Access();
+}
+
+void DRV_FLEXCAN_EnterFreeze(uint8_t instance)
+{
+    Can[instance].Frozen = true;
+    Sim_Access();
+}
+
+void DRV_FLEXCAN_ExitFreeze(uint8_t instance)
+{
+    Can[instance].Frozen = false;
+    SIM_CanKick(&Can[instance]);
+    Sim_Access();
+}
+
+uint8_t DRV_FLEXCAN_GetMbCount(uint8_t instance)
+{
+    return (instance == 0u) ? 32u : 16u;
+}
+
+uint16_t DRV_FLEXCAN_GetTimer(uint8_t instance)
+{
+    Sim_Access();
+
+    return SIM_CanTimer(&Can[instance]);
+}
+
+void DRV_FLEXCAN_SetRxMbGlobalMask(uint8_t instance, flexcan_mb_id_type_t idType, uint32_t mask)
+{
+    (void)idType;
+
+    Can[instance].GlobalMask = mask;
+    Sim_Access();
+}
+
+void DRV_FLEXCAN_SetRxMbIndividualMask(uint8_t instance, flexcan_mb_id_type_t idType, uint8_t mbIdx, uint32_t mask)
+{
+    (void)idType;
+
+    Can[instance].Mb[mbIdx].Mask = mask;
+    Sim_Access();
+}
+
+void DRV_FLEXCAN_ConfigRxMb(uint8_t instance, uint8_t mbIdx, flexcan_mb_config_t *rx_mb, uint32_t mb_id)
+{
+    SIM_CanMb_t *mb = &Can[instance].Mb[mbIdx];
+    bool ext = (rx_mb->idType == FLEXCAN_MB_ID_EXT);
+
+    Can[instance].IFlag &= ~(1u << mbIdx);
+    mb->Id = SIM_CanEncodeId(ext, mb_id);
+    mb->Cs = (ext ? FLEXCAN_MB_IDE_MASK : 0u) | FLEXCAN_MB_DLC(rx_mb->dataLength) | FLEXCAN_MB_CODE(FLEXCAN_RX_EMPTY);
+    mb->Serviced = false;
+    mb->AnswerPending = false;
+    Sim_Access();
+}
+
+void DRV_FLEXCAN_ConfigTxMb(uint8_t instance, uint8_t mbIdx, flexcan_mb_config_t *tx_mb, uint32_t mb_id)
+{
+    SIM_CanMb_t *mb = &Can[instance].Mb[mbIdx];
+    bool ext = (tx_mb->idType == FLEXCAN_MB_ID_EXT);
+
+    Can[instance].IFlag &= ~(1u << mbIdx);
+    mb->Id = SIM_CanEncodeId(ext, mb_id);
+    mb->Cs = (ext ? FLEXCAN_MB_IDE_MASK : 0u) | FLEXCAN_MB_DLC(tx_mb->dataLength) | FLEXCAN_MB_CODE(FLEXCAN_TX_INACTIVE);
+    mb->AnswerPending = false;
+    Sim_Access();
+}
+
+void DRV_FLEXCAN_ConfigRemoteAnswerMb(uint8_t instance, uint8_t mbIdx, flexcan_mb_config_t *tx_mb, uint32_t mb_id, const flexcan_mb_t *data)
+{
+    SIM_CanMb_t *mb = &Can[instance].Mb[mbIdx];
+    bool ext = (tx_mb->idType == FLEXCAN_MB_ID_EXT);
+
+    Can[instance].IFlag &= ~(1u << mbIdx);
+    mb->Id = SIM_CanEncodeId(ext, mb_id);
+    mb->Data[0] = data->data[0];
+    mb->Data[1] = data->data[1];
+    mb->Cs = (ext ? FLEXCAN_MB_IDE_MASK : 0u) | FLEXCAN_MB_DLC(data->dataLength) | FLEXCAN_MB_CODE(FLEXCAN_RX_RANSWER);
+    mb->AnswerPending = false;
+    Sim_Access();
+}
+
+void DRV_FLEXCAN_DeactivateMb(uint8_t instance, uint8_t mbIdx)
+{
+    Can[instance].IMask &= ~(1u << mbIdx);
+    Can[instance].IFlag &= ~(1u << mbIdx);
+    Can[instance].Mb[mbIdx].Cs = FLEXCAN_MB_CODE(FLEXCAN_RX_INACTIVE);
+    Can[instance].Mb[mbIdx].AnswerPending = false;
+    Sim_Access();
+}
+
+void DRV_FLEXCAN_SetTxMbPriority(uint8_t instance, uint8_t mbIdx, uint8_t priority)
+{
+    SIM_CanMb_t *mb = &Can[instance].Mb[mbIdx];
+
+    mb->Id = (mb->Id & ~FLEXCAN_MB_PRIO_MASK) | FLEXCAN_MB_PRIO(priority);
+    Sim_Access();
+}
+
+void DRV_FLEXCAN_Transmit(uint8_t instance, uint8_t mbIdx, flexcan_mb_t *data)
+{
+    SIM_CanMb_t *mb = &Can[instance].Mb[mbIdx];
+
+    Can[instance].IFlag &= ~(1u << mbIdx);
+    mb->Data[0] = data->data[0];
+    mb->Data[1] = data->data[1];
+    mb->Cs = (mb->Cs & ~(FLEXCAN_MB_CODE_MASK | FLEXCAN_MB_DLC_MASK)) | FLEXCAN_MB_DLC(data->dataLength) | FLEXCAN_MB_CODE(FLEXCAN_TX_DATA);
+    SIM_CanKick(&Can[instance]);
+    Sim_Access();
+}
+
+void DRV_FLEXCAN_TransmitId(uint8_t instance, uint8_t mbIdx, flexcan_mb_t *data)
+{
+    SIM_CanMb_t *mb = &Can[instance].Mb[mbIdx];
+    bool ext = (data->idType == FLEXCAN_MB_ID_EXT);
+
+    Can[instance].IFlag &= ~(1u << mbIdx);
+    mb->Id = (mb->Id & FLEXCAN_MB_PRIO_MASK) | SIM_CanEncodeId(ext, data->msgId);
+    mb->Data[0] = data->data[0];
+    mb->Data[1] = data->data[1];
+    mb->Cs = (mb->Cs & ~(FLEXCAN_MB_CODE_MASK | FLEXCAN_MB_DLC_MASK | FLEXCAN_MB_IDE_MASK)) |
+             (ext ? FLEXCAN_MB_IDE_MASK : 0u) | FLEXCAN_MB_DLC(data->dataLength) | FLEXCAN_MB_CODE(FLEXCAN_TX_DATA);
+    SIM_CanKick(&Can[instance]);
+    Sim_Access();
+}
+
+void DRV_FLEXCAN_TransmitRemote(uint8_t instance, uint8_t mbIdx, uint32_t dataLength)
+{
+    SIM_CanMb_t *mb = &Can[instance].Mb[mbIdx];
+
+    Can[instance].IFlag &= ~(1u << mbIdx);
+    mb->Cs = (mb->Cs & ~(FLEXCAN_MB_CODE_MASK | FLEXCAN_MB_DLC_MASK | FLEXCAN_MB_TIME_STAMP_MASK)) |
+             FLEXCAN_MB_RTR_MASK | FLEXCAN_MB_DLC(dataLength) | FLEXCAN_MB_CODE(FLEXCAN_TX_DATA);
+    SIM_CanKick(&Can[instance]);
+    Sim_Access();
+}
+
+flexcan_abort_status_t DRV_FLEXCAN_AbortTxMb(uint8_t instance, uint8_t mbIdx)
+{
+    SIM_Can_t *can = &Can[instance];
+    SIM_CanMb_t *mb = &can->Mb[mbIdx];
+    uint32_t flag = 1u << mbIdx;
+    uint32_t code = (mb->Cs & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT;
+    flexcan_abort_status_t status = FLEXCAN_ABORT_IDLE;
+
+    Sim_Access();
+
+    if (code == (uint32_t)FLEXCAN_TX_DATA)
+    {
+        can->IFlag &= ~flag;
+        mb->Cs = (mb->Cs & ~FLEXCAN_MB_CODE_MASK) | FLEXCAN_MB_CODE(FLEXCAN_TX_ABORT);
+        code = (uint32_t)FLEXCAN_TX_ABORT;
+
+        /* A frame on the bus completes at its end of frame, a stopped controller holds the buffer */
+        if (((can->Busy == false) || (can->TxSource != SIM_CAN_SOURCE_CTRL) || (can->TxMb != mbIdx)) &&
+            (SIM_CanControllerActive(can) == true))
+        {
+            can->IFlag |= flag;
+            can->Stats.Aborted++;
+        }
+    }
+
+    if ((can->IFlag & flag) == 0u)
+    {
+        status = (code == (uint32_t)FLEXCAN_TX_ABORT) ? FLEXCAN_ABORT_PENDING : FLEXCAN_ABORT_IDLE;
+    }
+    else
+    {
+        code = (mb->Cs & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT;
+
+        if (code == (uint32_t)FLEXCAN_TX_ABORT)
+        {
+            mb->Cs = (mb->Cs & ~FLEXCAN_MB_CODE_MASK) | FLEXCAN_MB_CODE(FLEXCAN_TX_INACTIVE);
+            status = FLEXCAN_ABORT_DONE;
+        }
+        else
+        {
+            status = FLEXCAN_ABORT_SENT;
+        }
+
+        can->IFlag &= ~flag;
+    }
+
+    return status;
+}
+
+uint8_t DRV_FLEXCAN_IsTxMbPending(uint8_t instance, uint8_t mbIdx)
+{
+    uint32_t code = (Can[instance].Mb[mbIdx].Cs & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT;
+
+    Sim_Access();
+
+    return ((code == (uint32_t)FLEXCAN_TX_DATA) ||
+            ((code == (uint32_t)FLEXCAN_TX_ABORT) && ((Can[instance].IFlag & (1u << mbIdx)) == 0u))) ? 1u : 0u;
+}
+
+uint16_t DRV_FLEXCAN_GetMbTimeStamp(uint8_t instance, uint8_t mbIdx)
+{
+    Sim_Access();
+
+    return (uint16_t)(Can[instance].Mb[mbIdx].Cs & FLEXCAN_MB_TIME_STAMP_MASK);
+}
+
+const flexcan_frame_t *DRV_FLEXCAN_ReceiveInt(uint8_t instance, uint8_t mbIdx)
+{
+    SIM_Can_t *can = &Can[instance];
+    SIM_CanMb_t *mb = &can->Mb[mbIdx];
+    flexcan_frame_t *frame = &can->Handle->frames[mbIdx];
+
+    frame->cs = mb->Cs;
+    frame->id = mb->Id;
+    frame->data[0] = mb->Data[0];
+    frame->data[1] = mb->Data[1];
+
+    if (FLEXCAN_FRAME_CODE(frame) == (uint32_t)FLEXCAN_RX_OVERRUN)
+    {
+        can->Handle->mbOverrunCnt[mbIdx]++;
+    }
+
+    /* Reading the free running timer unlocks the MB, the next frame may take it */
+    mb->Serviced = true;
+    Sim_Access();
+
+    return frame;
+}
+
+void DRV_FLEXCAN_Receive(uint8_t instance, uint8_t mbIdx, flexcan_mb_t *data)
+{
+    const flexcan_frame_t *frame = DRV_FLEXCAN_ReceiveInt(instance, mbIdx);
+
+    data->cs = frame->cs;
+    data->code = FLEXCAN_FRAME_CODE(frame);
+    data->msgId = FLEXCAN_FRAME_ID(frame);
+    data->idType = FLEXCAN_FRAME_IS_EXT(frame) ? FLEXCAN_MB_ID_EXT : FLEXCAN_MB_ID_STD;
+    data->dataLength = FLEXCAN_FRAME_DLC(frame);
+    data->timeStamp = FLEXCAN_FRAME_TIME_STAMP(frame);
+    data->data[0] = frame->data[0];
+    data->data[1] = frame->data[1];
+    Can[instance].IFlag &= ~(1u << mbIdx);
+}
+
+void DRV_FLEXCAN_GetMbLossCounters(uint8_t instance, uint8_t mbIdx, uint32_t *overrunCnt, uint32_t *busyCnt)
+{
+    *overrunCnt = Can[instance].Handle->mbOverrunCnt[mbIdx];
+    *busyCnt = Can[instance].Handle->mbBusyCnt[mbIdx];
+}
+
+uint8_t DRV_FLEXCAN_GetMbIntFlag(uint8_t instance, uint8_t mbIdx)
+{
+    Sim_Access();
+
+    return (uint8_t)((Can[instance].IFlag >> mbIdx) & 1u);
+}
+
+void DRV_FLEXCAN_ClearMbIntFlag(uint8_t instance, uint8_t mbIdx)
+{
+    Can[instance].IFlag &= ~(1u << mbIdx);
+    Sim_Access();
+}
+
+void DRV_FLEXCAN_EnableMbInt(uint8_t instance, uint8_t mbIdx)
+{
+    Can[instance].IMask |= (1u << mbIdx);
+    Sim_Access();
+}
+
+void DRV_FLEXCAN_DisableMbInt(uint8_t instance, uint8_t mbIdx)
+{
+    Can[instance].IMask &= ~(1u << mbIdx);
+    Sim_Access();
+}
+
+void DRV_FLEXCAN_RegisterMbCallback(uint8_t instance, void (*cb_ptr)(void))
+{
+    Can[instance].Handle->mb_callback = cb_ptr;
+    Sim_Access();
+}
+
+void DRV_FLEXCAN_RegisterBusOffCallback(uint8_t instance, void (*cb_ptr)(void))
+{
+    Can[instance].Handle->bus_off_callback = cb_ptr;
+    Sim_Access();
+}
+
+void DRV_FLEXCAN_RegisterErrorStateCallback(uint8_t instance, void (*cb_ptr)(void))
+{
+    Can[instance].Handle->error_state_callback = cb_ptr;
+    Sim_Access();
+}
+
+void DRV_FLEXCAN_EnableErrorInt(uint8_t instance)
+{
+    Can[instance].ErrInt = false;
+    Can[instance].ErrMask = true;
+    Sim_Access();
+}
+
+flexcan_fault_state_t DRV_FLEXCAN_GetFaultState(uint8_t instance)
+{
+    Sim_Access();
+
+    return Can[instance].Fault;
+}
+
+void DRV_FLEXCAN_GetErrorCounters(uint8_t instance, uint8_t *txErrCnt, uint8_t *rxErrCnt)
+{
+    const SIM_Can_t *can = &Can[instance];
+
+    *txErrCnt = (uint8_t)((can->Tec > 255u) ? 255u : can->Tec);
+    *rxErrCnt = (uint8_t)((can->Rec > 255u) ? 255u : can->Rec);
+    Sim_Access();
+}
+
+uint32_t DRV_FLEXCAN_GetRxErrorFlags(uint8_t instance)
+{
+    uint32_t flags = Can[instance].RxErrFlags;
+
+    /* The error bits of ESR1 clear when the register is read */
+    Can[instance].RxErrFlags = 0u;
+    Sim_Access();
+
+    return flags;
+}
+
+void DRV_FLEXCAN_SetBusOffRecovery(uint8_t instance, flexcan_busoff_recovery_t mode)
+{
+    Can[instance].Handle->busOffRecovery = mode;
+
+    if ((mode == FLEXCAN_BUSOFF_RECOVERY_AUTO) && (Can[instance].Fault == FLEXCAN_BUS_OFF))
+    {
+        DRV_FLEXCAN_RecoverBusOff(instance);
+    }
+
+    Sim_Access();
+}
+
+void DRV_FLEXCAN_RecoverBusOff(uint8_t instance)
+{
+    SIM_Can_t *can = &Can[instance];
+
+    if ((can->Fault == FLEXCAN_BUS_OFF) && (can->RecoveryScheduled == false))
+    {
+        can->RecoveryScheduled = true;
+        Sim_Schedule(Sim_Now() + SIM_CanBitTime(can, SIM_CAN_RECOVERY_BITS), SIM_CanRecover, can, 0u);
+    }
+
+    Sim_Access();
+}
+
+uint8_t Sim_CAN_AttachAgent(uint8_t Bus, Sim_CanReceive_t Receive, void *Context)
+{
+    SIM_Can_t *can = &Can[Bus];
+    uint8_t index = 0xFFu;
+
+    if (can->AgentNum < SIM_CAN_AGENT_MAX)
+    {
+        index = can->AgentNum;
+        can->Agent[index].Receive = Receive;
+        can->Agent[index].Context = Context;
+        can->AgentNum++;
+    }
+
+    return index;
+}
+
+bool Sim_CAN_AgentSend(uint8_t Bus, uint8_t Agent, const Sim_CanFrame_t *Frame)
+{
+    SIM_Can_t *can = &Can[Bus];
+    SIM_CanAgent_t *agent = &can->Agent[Agent];
+    bool queued = false;
+
+    if (agent->Count < SIM_CAN_AGENT_TX_MAX)
+    {
+        agent->Queue[(agent->Head + agent->Count) % SIM_CAN_AGENT_TX_MAX] = *Frame;
+        agent->Count++;
+        queued = true;
+        SIM_CanKick(can);
+    }
+    else
+    {
+        can->Stats.AgentDropped++;
+    }
+
+    return queued;
+}
+
+void Sim_CAN_SetBitrate(uint8_t Bus, uint32_t Bitrate)
+{
+    Can[Bus].BusBitrate = Bitrate;
+}
+
+void Sim_CAN_InjectErrors(uint8_t Bus, uint32_t Count)
+{
+    SIM_Can_t *can = &Can[Bus];
+    uint32_t oldTec = can->Tec;
+    uint32_t oldRec = can->Rec;
+
+    if ((can->Initialized == true) && (can->Fault != FLEXCAN_BUS_OFF))
+    {
+        can->Tec += Count * SIM_CAN_ERROR_STEP;
+        can->RxErrFlags |= FLEXCAN_ESR1_FRMERR_MASK;
+        can->ErrInt = true;
+        SIM_CanUpdateFault(can, oldTec, oldRec);
+    }
+}
+
+void Sim_CAN_SetNoAck(uint8_t Bus, Sim_Time_t Duration)
+{
+    Can[Bus].NoAckEnd = Sim_Now() + Duration;
+}
+
+void Sim_CAN_GetStats(uint8_t Bus, Sim_CanStats_t *Stats)
+{
+    *Stats = Can[Bus].Stats;
+}
+
+/**
+  * @brief      Place an identifier in the ID word of a message buffer
+  * @param[in]  Ext: Extended identifier
+  * @param[in]  Id: Identifier
+  * @param[out] None
+  * @retval     ID word without PRIO
+  */
+static uint32_t SIM_CanEncodeId(bool Ext, uint32_t Id)
+{
+    return Ext ? (Id & FLEXCAN_MB_ID_EXT_FULL_MASK) : ((Id << FLEXCAN_MB_ID_STD_SHIFT) & FLEXCAN_MB_ID_STD_MASK);
+}
+
+/**
+  * @brief      Get the identifier out of the ID word of a message buffer
+  * @param[in]  Ext: Extended identifier
+  * @param[in]  IdWord: ID word
+  * @param[out] None
+  * @retval     Identifier
+  */
+static uint32_t SIM_CanDecodeId(bool Ext, uint32_t IdWord)
+{
+    return Ext ? (IdWord & FLEXCAN_MB_ID_EXT_FULL_MASK) : ((IdWord & FLEXCAN_MB_ID_STD_MASK) >> FLEXCAN_MB_ID_STD_SHIFT);
+}
+
+/**
+  * @brief      Order of a frame on the bus: the bits of the arbitration field as sent, dominant first
+  * @param[in]  Frame: Frame
+  * @param[out] None
+  * @retval     Key, the lowest one wins the arbitration
+  */
+static uint64_t SIM_CanArbitrationKey(const Sim_CanFrame_t *Frame)
+{
+    uint64_t key = 0u;
+
+    if (Frame->Ext != 0u)
+    {
+        /* Base ID, SRR (recessive), IDE (recessive), ID extension, RTR */
+        key = ((uint64_t)(Frame->Id >> 18u) << 21u) | (1u << 20u) | (1u << 19u) |
+              ((uint64_t)(Frame->Id & 0x3FFFFu) << 1u) | (uint64_t)Frame->Rtr;
+    }
+    else
+    {
+        /* Base ID, RTR, IDE (dominant) */
+        key = ((uint64_t)Frame->Id << 21u) | ((uint64_t)Frame->Rtr << 20u);
+    }
+
+    return key;
+}
+
+/**
+  * @brief      Bitrate the frames of a bus are sent at
+  * @param[in]  Can: Instance
+  * @param[out] None
+  * @retval     bit/s
+  */
+static uint32_t SIM_CanBusBitrate(const SIM_Can_t *Can)
+{
+    uint32_t bitrate = SIM_CAN_BITRATE_DEFAULT;
+
+    if (Can->BusBitrate != 0u)
+    {
+        bitrate = Can->BusBitrate;
+    }
+    else if (Can->Bitrate != 0u)
+    {
+        bitrate = Can->Bitrate;
+    }
+    else
+    {
+        /* Do nothing */
+    }
+
+    return bitrate;
+}
+
+/**
+  * @brief      Duration of a number of bits on a bus
+  * @param[in]  Can: Instance
+  * @param[in]  Bits: Number of bits
+  * @param[out] None
+  * @retval     Virtual time
+  */
+static Sim_Time_t SIM_CanBitTime(const SIM_Can_t *Can, uint32_t Bits)
+{
+    return ((Sim_Time_t)Bits * SIM_NS_PER_S) / SIM_CanBusBitrate(Can);
+}
+
+/**
+  * @brief      Free running timer of the controller, one tick per bit time
+  * @param[in]  Can: Instance
+  * @param[out] None
+  * @retval     TIMER register
+  */
+static uint16_t SIM_CanTimer(const SIM_Can_t *Can)
+{
+    Sim_Time_t elapsed = Sim_Now() - Can->TimerStart;
+    uint64_t bitrate = (Can->Bitrate != 0u) ? Can->Bitrate : SIM_CAN_BITRATE_DEFAULT;
+
+    return (uint16_t)(((elapsed / SIM_NS_PER_S) * bitrate) + (((elapsed % SIM_NS_PER_S) * bitrate) / SIM_NS_PER_S));
+}
+
+/**
+  * @brief      Build the frame a message buffer sends
+  * @param[in]  Mb: Message buffer
+  * @param[in]  Answer: Data frame answering a remote request (RANSWER)
+  * @param[out] Frame: Frame
+  * @retval     None
+  */
+static void SIM_CanMbToFrame(const SIM_CanMb_t *Mb, bool Answer, Sim_CanFrame_t *Frame)
+{
+    uint8_t i = 0u;
+
+    Frame->Ext = ((Mb->Cs & FLEXCAN_MB_IDE_MASK) != 0u) ? 1u : 0u;
+    Frame->Id = SIM_CanDecodeId((Frame->Ext != 0u), Mb->Id);
+    Frame->Rtr = ((Answer == false) && ((Mb->Cs & FLEXCAN_MB_RTR_MASK) != 0u)) ? 1u : 0u;
+    Frame->Dlc = (uint8_t)((Mb->Cs & FLEXCAN_MB_DLC_MASK) >> FLEXCAN_MB_DLC_SHIFT);
+    Frame->Dlc = (Frame->Dlc > 8u) ? 8u : Frame->Dlc;
+
+    for (i = 0u; i < 8u; i++)
+    {
+        Frame->Data[i] = (uint8_t)(Mb->Data[i / 4u] >> (24u - (8u * (i % 4u))));
+    }
+}
+
+/**
+  * @brief      Whether the controller takes part in the bus traffic
+  * @param[in]  Can: Instance
+  * @param[out] None
+  * @retval     true if initialized, out of freeze, enabled and not bus-off
+  */
+static bool SIM_CanControllerActive(const SIM_Can_t *Can)
+{
+    return (Can->Initialized == true) && (Can->Frozen == false) && (Can->Mode != FLEXCAN_FREEZE_MODE) &&
+           (Can->Mode != FLEXCAN_DISABLE_MODE) && (Can->Fault != FLEXCAN_BUS_OFF);
+}
+
+/**
+  * @brief      Start an arbitration once the bus is idle
+  * @param[in]  Can: Instance
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_CanKick(SIM_Can_t *Can)
+{
+    if ((Can->Busy == false) && (Can->ArbitrationScheduled == false))
+    {
+        Can->ArbitrationScheduled = true;
+        Sim_Schedule(Sim_Now(), SIM_CanArbitrate, Can, 0u);
+    }
+}
+
+/**
+  * @brief      Arbitration: the lowest key among the controller and the agents takes the bus
+  * @note       With local priority, the controller first selects its candidate on PRIO then ID
+  * @param[in]  Context: Instance
+  * @param[in]  Arg: Not used
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_CanArbitrate(void *Context, uint32_t Arg)
+{
+    SIM_Can_t *can = (SIM_Can_t *)Context;
+    Sim_CanFrame_t frame;
+    Sim_CanFrame_t best;
+    uint64_t bestKey = SIM_CAN_KEY_NONE;
+    uint64_t mbKey = SIM_CAN_KEY_NONE;
+    uint64_t key = 0u;
+    uint8_t source = 0u;
+    uint8_t mbIdx = 0u;
+    uint8_t i = 0u;
+    uint32_t code = 0u;
+    uint32_t bits = 0u;
+
+    (void)Arg;
+
+    can->ArbitrationScheduled = false;
+
+    for (i = 0u; (SIM_CanControllerActive(can) == true) && (i < can->MbNum); i++)
+    {
+        /* Aborts requested in bus-off or freeze complete once the controller runs again */
+        code = (can->Mb[i].Cs & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT;
+
+        if ((code == (uint32_t)FLEXCAN_TX_ABORT) && ((can->IFlag & (1u << i)) == 0u) &&
+            ((can->Busy == false) || (can->TxSource != SIM_CAN_SOURCE_CTRL) || (can->TxMb != i)))
+        {
+            can->IFlag |= (1u << i);
+            can->Stats.Aborted++;
+        }
+    }
+
+    if (can->Busy == false)
+    {
+        /* Controller candidate, listen-only controllers never send */
+        if ((SIM_CanControllerActive(can) == true) && (can->Mode != FLEXCAN_LISTEN_ONLY_MODE))
+        {
+            for (i = 0u; i < can->MbNum; i++)
+            {
+                code = (can->Mb[i].Cs & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT;
+
+                if ((code == (uint32_t)FLEXCAN_TX_DATA) || ((code == (uint32_t)FLEXCAN_RX_RANSWER) && (can->Mb[i].AnswerPending == true)))
+                {
+                    SIM_CanMbToFrame(&can->Mb[i], (code == (uint32_t)FLEXCAN_RX_RANSWER), &frame);
+                    key = SIM_CanArbitrationKey(&frame);
+
+                    if (can->LocalPriority != 0u)
+                    {
+                        key |= (uint64_t)((can->Mb[i].Id & FLEXCAN_MB_PRIO_MASK) >> FLEXCAN_MB_PRIO_SHIFT) << 40u;
+                    }
+
+                    if (key < mbKey)
+                    {
+                        mbKey = key;
+                        mbIdx = i;
+                        best = frame;
+                        bestKey = SIM_CanArbitrationKey(&frame);
+                        source = SIM_CAN_SOURCE_CTRL;
+                    }
+                }
+            }
+        }
+
+        for (i = 0u; i < can->AgentNum; i++)
+        {
+            if (can->Agent[i].Count != 0u)
+            {
+                key = SIM_CanArbitrationKey(&can->Agent[i].Queue[can->Agent[i].Head]);
+
+                if (key < bestKey)
+                {
+                    bestKey = key;
+                    best = can->Agent[i].Queue[can->Agent[i].Head];
+                    source = i;
+                }
+            }
+        }
+
+        if (bestKey != SIM_CAN_KEY_NONE)
+        {
+            bits = (best.Ext != 0u) ? SIM_CAN_EXT_FRAME_BITS : SIM_CAN_STD_FRAME_BITS;
+            bits += (best.Rtr != 0u) ? 0u : (8u * (uint32_t)best.Dlc);
+
+            can->Busy = true;
+            can->TxSource = source;
+            can->TxMb = mbIdx;
+            can->TxFrame = best;
+            can->TxStart = Sim_Now();
+            can->TxEnd = Sim_Now() + SIM_CanBitTime(can, bits);
+            Sim_Schedule(can->TxEnd, SIM_CanFrameEnd, can, 0u);
+        }
+    }
+}
+
+/**
+  * @brief      End of frame: complete the sender, deliver the frame to every other node
+  * @note       In loopback the frames of the controller do not reach the agents, and the other way round.
+  *             A controller at another bitrate than the bus sees its frames unacknowledged.
+  * @param[in]  Context: Instance
+  * @param[in]  Arg: Not used
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_CanFrameEnd(void *Context, uint32_t Arg)
+{
+    SIM_Can_t *can = (SIM_Can_t *)Context;
+    SIM_CanMb_t *mb = NULL;
+    uint32_t code = 0u;
+    uint8_t i = 0u;
+    bool loopback = (can->Mode == FLEXCAN_LOOPBACK_MODE);
+
+    (void)Arg;
+
+    can->Busy = false;
+    can->Stats.Frames++;
+    can->Stats.BusyTime += Sim_Now() - can->TxStart;
+
+    if ((can->TxSource == SIM_CAN_SOURCE_CTRL) && (loopback == false) &&
+        ((SIM_CanBusBitrate(can) != can->Bitrate) || (Sim_Now() < can->NoAckEnd)))
+    {
+        /* Sent at the wrong bitrate or alone on the bus: no node acknowledges, the frame is repeated unless aborted meanwhile.
+         * Acknowledge errors stop counting once error passive. */
+        can->ErrInt = true;
+
+        if (can->Fault == FLEXCAN_ERROR_ACTIVE)
+        {
+            can->Tec += SIM_CAN_ERROR_STEP;
+            SIM_CanUpdateFault(can, can->Tec - SIM_CAN_ERROR_STEP, can->Rec);
+        }
+
+        if (((can->Mb[can->TxMb].Cs & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT) == (uint32_t)FLEXCAN_TX_ABORT)
+        {
+            can->IFlag |= (1u << can->TxMb);
+            can->Stats.Aborted++;
+        }
+    }
+    else if (can->TxSource == SIM_CAN_SOURCE_CTRL)
+    {
+        mb = &can->Mb[can->TxMb];
+        code = (mb->Cs & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT;
+
+        if ((code == (uint32_t)FLEXCAN_TX_DATA) || (code == (uint32_t)FLEXCAN_TX_ABORT))
+        {
+            /* A remote request turns its buffer into a receive buffer for the answer.
+             * An abort requested during the frame is too late, the frame completes as sent. */
+            if ((mb->Cs & FLEXCAN_MB_RTR_MASK) != 0u)
+            {
+                mb->Cs = (mb->Cs & ~(FLEXCAN_MB_CODE_MASK | FLEXCAN_MB_RTR_MASK)) | FLEXCAN_MB_CODE(FLEXCAN_RX_EMPTY);
+                mb->Serviced = false;
+            }
+            else
+            {
+                mb->Cs = (mb->Cs & ~(FLEXCAN_MB_CODE_MASK | FLEXCAN_MB_TIME_STAMP_MASK)) |
+                         FLEXCAN_MB_CODE(FLEXCAN_TX_INACTIVE) | SIM_CanTimer(can);
+                can->IFlag |= (1u << can->TxMb);
+            }
+        }
+        else
+        {
+            mb->AnswerPending = false;
+        }
+
+        can->Tec = (can->Tec != 0u) ? (can->Tec - 1u) : 0u;
+        can->Stats.ControllerTx++;
+
+        if ((loopback == true) || (can->SelfReception != 0u))
+        {
+            SIM_CanControllerReceive(can, &can->TxFrame);
+        }
+
+        for (i = 0u; (loopback == false) && (i < can->AgentNum); i++)
+        {
+            can->Agent[i].Receive(can->Agent[i].Context, &can->TxFrame);
+        }
+    }
+    else
+    {
+        can->Agent[can->TxSource].Head = (uint8_t)((can->Agent[can->TxSource].Head + 1u) % SIM_CAN_AGENT_TX_MAX);
+        can->Agent[can->TxSource].Count--;
+
+        if (loopback == false)
+        {
+            SIM_CanControllerReceive(can, &can->TxFrame);
+        }
+
+        for (i = 0u; i < can->AgentNum; i++)
+        {
+            if (i != can->TxSource)
+            {
+                can->Agent[i].Receive(can->Agent[i].Context, &can->TxFrame);
+            }
+        }
+    }
+
+    SIM_CanKick(can);
+}
+
+/**
+  * @brief      Frame seen by the controller: arm a remote answer or move it into a receive buffer
+  * @param[in]  Can: Instance
+  * @param[in]  Frame: Frame
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_CanControllerReceive(SIM_Can_t *Can, const Sim_CanFrame_t *Frame)
+{
+    const SIM_CanMb_t *mb = NULL;
+    uint32_t code = 0u;
+    uint32_t mask = 0u;
+    uint8_t match = 0xFFu;
+    uint8_t i = 0u;
+    bool ext = false;
+    bool stored = false;
+
+    if ((SIM_CanControllerActive(Can) == true) && (SIM_CanBusBitrate(Can) != Can->Bitrate))
+    {
+        /* Sampled at the wrong bitrate, the controller only sees form errors */
+        Can->RxErrFlags |= FLEXCAN_ESR1_FRMERR_MASK;
+        Can->ErrInt = true;
+
+        if (Can->Rec < SIM_CAN_PASSIVE_LIMIT)
+        {
+            Can->Rec++;
+            SIM_CanUpdateFault(Can, Can->Tec, Can->Rec - 1u);
+        }
+    }
+    else if (SIM_CanControllerActive(Can) == true)
+    {
+        for (i = 0u; (i < Can->MbNum) && (stored == false); i++)
+        {
+            mb = &Can->Mb[i];
+            code = (mb->Cs & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT;
+            ext = ((mb->Cs & FLEXCAN_MB_IDE_MASK) != 0u);
+            mask = (Can->RxMaskType == FLEXCAN_RX_MASK_INDIVIDUAL) ? mb->Mask : Can->GlobalMask;
+
+            if ((ext != (Frame->Ext != 0u)) || (((SIM_CanDecodeId(ext, mb->Id) ^ Frame->Id) & mask) != 0u))
+            {
+                /* Do nothing */
+            }
+            else if (Frame->Rtr != 0u)
+            {
+                if (code == (uint32_t)FLEXCAN_RX_RANSWER)
+                {
+                    Can->Mb[i].AnswerPending = true;
+                    SIM_CanKick(Can);
+                    stored = true;
+                }
+            }
+            else if ((code == (uint32_t)FLEXCAN_RX_EMPTY) ||
+                     (((code == (uint32_t)FLEXCAN_RX_FULL) || (code == (uint32_t)FLEXCAN_RX_OVERRUN)) && (mb->Serviced == true)))
+            {
+                SIM_CanStore(Can, i, FLEXCAN_RX_FULL, Frame);
+                stored = true;
+            }
+            else if ((code == (uint32_t)FLEXCAN_RX_FULL) || (code == (uint32_t)FLEXCAN_RX_OVERRUN))
+            {
+                match = i;
+            }
+            else
+            {
+                /* Do nothing */
+            }
+        }
+
+        if (stored == true)
+        {
+            Can->Rec = (Can->Rec != 0u) ? (Can->Rec - 1u) : 0u;
+        }
+        else if (Frame->Rtr != 0u)
+        {
+            /* Do nothing */
+        }
+        else if (match != 0xFFu)
+        {
+            /* Every matching buffer still holds an unread frame, the last one is overwritten */
+            SIM_CanStore(Can, match, FLEXCAN_RX_OVERRUN, Frame);
+            Can->Stats.Overrun++;
+        }
+        else
+        {
+            Can->Stats.Unmatched++;
+        }
+    }
+    else
+    {
+        /* Do nothing */
+    }
+}
+
+/**
+  * @brief      Move a frame into a receive buffer
+  * @param[in]  Can: Instance
+  * @param[in]  MbIdx: Message buffer
+  * @param[in]  Code: FLEXCAN_RX_FULL or FLEXCAN_RX_OVERRUN
+  * @param[in]  Frame: Frame
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_CanStore(SIM_Can_t *Can, uint8_t MbIdx, uint32_t Code, const Sim_CanFrame_t *Frame)
+{
+    SIM_CanMb_t *mb = &Can->Mb[MbIdx];
+    uint8_t i = 0u;
+
+    mb->Id = (mb->Id & FLEXCAN_MB_PRIO_MASK) | SIM_CanEncodeId((Frame->Ext != 0u), Frame->Id);
+    mb->Data[0] = 0u;
+    mb->Data[1] = 0u;
+
+    for (i = 0u; i < Frame->Dlc; i++)
+    {
+        mb->Data[i / 4u] |= (uint32_t)Frame->Data[i] << (24u - (8u * (i % 4u)));
+    }
+
+    mb->Cs = FLEXCAN_MB_CODE(Code) | ((Frame->Ext != 0u) ? FLEXCAN_MB_IDE_MASK : 0u) |
+             FLEXCAN_MB_DLC(Frame->Dlc) | SIM_CanTimer(Can);
+    mb->Serviced = false;
+    Can->IFlag |= (1u << MbIdx);
+    Can->Stats.ControllerRx++;
+}
+
+/**
+  * @brief      Fault confinement after an error counter changed
+  * @param[in]  Can: Instance
+  * @param[in]  OldTec: Transmit error counter before the change
+  * @param[in]  OldRec: Receive error counter before the change
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_CanUpdateFault(SIM_Can_t *Can, uint32_t OldTec, uint32_t OldRec)
+{
+    bool warning = ((OldTec < SIM_CAN_WARNING_LIMIT) && (Can->Tec >= SIM_CAN_WARNING_LIMIT)) ||
+                   ((OldRec < SIM_CAN_WARNING_LIMIT) && (Can->Rec >= SIM_CAN_WARNING_LIMIT));
+
+    if (Can->Tec >= SIM_CAN_BUSOFF_LIMIT)
+    {
+        Can->Fault = FLEXCAN_BUS_OFF;
+        Can->Stats.BusOffCnt++;
+
+        if (Can->Handle->bus_off_callback != NULL)
+        {
+            Can->BusOffInt = true;
+        }
+
+        if (Can->Handle->busOffRecovery == FLEXCAN_BUSOFF_RECOVERY_AUTO)
+        {
+            Can->RecoveryScheduled = true;
+            Sim_Schedule(Sim_Now() + SIM_CanBitTime(Can, SIM_CAN_RECOVERY_BITS), SIM_CanRecover, Can, 0u);
+        }
+    }
+    else
+    {
+        Can->Fault = ((Can->Tec >= SIM_CAN_PASSIVE_LIMIT) || (Can->Rec >= SIM_CAN_PASSIVE_LIMIT)) ?
+                     FLEXCAN_ERROR_PASSIVE : FLEXCAN_ERROR_ACTIVE;
+    }
+
+    if ((warning == true) && (Can->Handle->error_state_callback != NULL))
+    {
+        Can->ErrStateInt = true;
+    }
+}
+
+/**
+  * @brief      Bus-off recovery done: the controller rejoins the bus error active
+  * @param[in]  Context: Instance
+  * @param[in]  Arg: Not used
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_CanRecover(void *Context, uint32_t Arg)
+{
+    SIM_Can_t *can = (SIM_Can_t *)Context;
+
+    (void)Arg;
+
+    can->RecoveryScheduled = false;
+
+    if (can->Fault == FLEXCAN_BUS_OFF)
+    {
+        can->Fault = FLEXCAN_ERROR_ACTIVE;
+        can->Tec = 0u;
+        can->Rec = 0u;
+
+        if (can->Handle->error_state_callback != NULL)
+        {
+            can->ErrStateInt = true;
+        }
+
+        SIM_CanKick(can);
+    }
+}
+
+/**
+  * @brief      Level of a message buffer interrupt line
+  * @param[in]  Instance: FlexCAN instance
+  * @param[in]  Lines: Message buffers routed to the line
+  * @param[out] None
+  * @retval     true if a flagged buffer has its interrupt enabled
+  */
+static bool SIM_CanMbPending(uint8_t Instance, uint32_t Lines)
+{
+    const SIM_Can_t *can = &Can[Instance];
+
+    return (can->Handle != NULL) && (can->Handle->mb_callback != NULL) && ((can->IFlag & can->IMask & Lines) != 0u);
+}
+
+/**
+  * @brief      Level of the bus-off and error interrupt line
+  * @param[in]  Instance: FlexCAN instance
+  * @param[out] None
+  * @retval     true if BOFFINT or a warning/BOFFDONE flag is set
+  */
+static bool SIM_CanErrPending(uint8_t Instance)
+{
+    return (Can[Instance].BusOffInt == true) || (Can[Instance].ErrStateInt == true);
+}
+
+/**
+  * @brief      Model of CANx_ORed_0_15_MB_IRQHandler(): run the message buffer callback
+  * @param[in]  Instance: FlexCAN instance
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_CanMbIrq(uint8_t Instance)
+{
+    Can[Instance].Handle->mb_callback();
+}
+
+/**
+  * @brief      Model of CANx_ORed_IRQHandler(): bus-off callback on BOFFINT, then the error state callback
+  * @param[in]  Instance: FlexCAN instance
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_CanErrIrq(uint8_t Instance)
+{
+    SIM_Can_t *can = &Can[Instance];
+
+    if (can->BusOffInt == true)
+    {
+        can->BusOffInt = false;
+
+        if (can->Handle->bus_off_callback != NULL)
+        {
+            can->Handle->bus_off_callback();
+        }
+    }
+
+    if (can->ErrStateInt == true)
+    {
+        can->ErrStateInt = false;
+
+        if (can->Handle->error_state_callback != NULL)
+        {
+            can->Handle->error_state_callback();
+        }
+    }
+}
+
+/**
+  * @brief      Level of the bus error interrupt line
+  * @param[in]  Instance: FlexCAN instance
+  * @param[out] None
+  * @retval     true if ERRINT is set and enabled
+  */
+static bool SIM_CanBusErrPending(uint8_t Instance)
+{
+    const SIM_Can_t *can = &Can[Instance];
+
+    return (can->ErrInt == true) && (can->ErrMask == true) && (can->Handle != NULL) && (can->Handle->error_state_callback != NULL);
+}
+
+/**
+  * @brief      Model of CANx_Error_IRQHandler(): mask ERRINT again, then the error state callback
+  * @param[in]  Instance: FlexCAN instance
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_CanBusErrIrq(uint8_t Instance)
+{
+    SIM_Can_t *can = &Can[Instance];
+
+    can->ErrMask = false;
+    can->ErrInt = false;
+    can->Handle->error_state_callback();
+}
+
+static bool SIM_Can0MbLowPending(void) { return SIM_CanMbPending(0u, 0x0000FFFFu); }
+static bool SIM_Can0MbHighPending(void) { return SIM_CanMbPending(0u, 0xFFFF0000u); }
+static bool SIM_Can0ErrPending(void) { return SIM_CanErrPending(0u); }
+static bool SIM_Can1MbPending(void) { return SIM_CanMbPending(1u, 0x0000FFFFu); }
+static bool SIM_Can1ErrPending(void) { return SIM_CanErrPending(1u); }
+static bool SIM_Can2MbPending(void) { return SIM_CanMbPending(2u, 0x0000FFFFu); }
+static bool SIM_Can2ErrPending(void) { return SIM_CanErrPending(2u); }
+static void SIM_Can0MbIrq(void) { SIM_CanMbIrq(0u); }
+static void SIM_Can0ErrIrq(void) { SIM_CanErrIrq(0u); }
+static void SIM_Can1MbIrq(void) { SIM_CanMbIrq(1u); }
+static void SIM_Can1ErrIrq(void) { SIM_CanErrIrq(1u); }
+static void SIM_Can2MbIrq(void) { SIM_CanMbIrq(2u); }
+static void SIM_Can2ErrIrq(void) { SIM_CanErrIrq(2u); }
+static bool SIM_Can0BusErrPending(void) { return SIM_CanBusErrPending(0u); }
+static bool SIM_Can1BusErrPending(void) { return SIM_CanBusErrPending(1u); }
+static bool SIM_Can2BusErrPending(void) { return SIM_CanBusErrPending(2u); }
+static void SIM_Can0BusErrIrq(void) { SIM_CanBusErrIrq(0u); }
+static void SIM_Can1BusErrIrq(void) { SIM_CanBusErrIrq(1u); }
+static void SIM_Can2BusErrIrq(void) { SIM_CanBusErrIrq(2u); }
+
+/*******************************************************************************
+ * End Of File
+ ******************************************************************************/
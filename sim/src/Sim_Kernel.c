@@ -0,0 +1,409 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "Sim_Kernel.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/* Initial size of the event queue, it doubles when full */
+#define SIM_EVENT_QUEUE_INIT    256u
+
+/* One scheduled event, Seq keeps events of the same time in scheduling order */
+typedef struct
+{
+    Sim_Time_t         At;
+    uint64_t           Seq;
+    Sim_EventHandler_t Handler;
+    void              *Context;
+    uint32_t           Arg;
+} SIM_Event_t;
+
+/* One interrupt line */
+typedef struct
+{
+    IRQn_Type        Irq;
+    bool             Enabled;
+    Sim_IrqPending_t IsPending;
+    Sim_IrqHandler_t Handler;
+    Sim_IrqStats_t   Stats;
+} SIM_IrqLine_t;
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+static bool SIM_EventBefore(const SIM_Event_t *A, const SIM_Event_t *B);
+static void SIM_EventPush(const SIM_Event_t *Event);
+static void SIM_EventPop(SIM_Event_t *Event);
+static void SIM_RunUntil(Sim_Time_t Target);
+static SIM_IrqLine_t *SIM_NextPendingIrq(void);
+static void SIM_Dispatch(void);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static Sim_Time_t Now = 0u;
+static Sim_Time_t Access_Cost = 0u;
+static Sim_Time_t End_Time = UINT64_MAX;
+static Sim_EndHook_t End_Hook = NULL;
+
+/* Binary min-heap on (At, Seq) */
+static SIM_Event_t *Event_Queue = NULL;
+static uint32_t Event_Cnt = 0u;
+static uint32_t Event_Size = 0u;
+static uint64_t Event_Seq = 0u;
+
+/* Interrupt lines sorted by interrupt number */
+static SIM_IrqLine_t Irq_Line[SIM_IRQ_LINE_MAX];
+static uint8_t Irq_Num = 0u;
+static uint32_t Primask = 0u;
+static bool In_Isr = false;
+
+static Sim_KernelStats_t Stats;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+void Sim_Kernel_Init(Sim_Time_t AccessCost)
+{
+    Now = 0u;
+    Access_Cost = AccessCost;
+    End_Time = UINT64_MAX;
+    End_Hook = NULL;
+    Event_Cnt = 0u;
+    Event_Seq = 0u;
+    Irq_Num = 0u;
+    Primask = 0u;
+    In_Isr = false;
+
+    Stats = (Sim_KernelStats_t){0};
+}
+
+void Sim_Kernel_SetAccessCost(Sim_Time_t AccessCost)
+{
+    Access_Cost = AccessCost;
+}
+
+void Sim_Kernel_SetEnd(Sim_Time_t EndTime, Sim_EndHook_t Hook)
+{
+    End_Time = EndTime;
+    End_Hook = Hook;
+}
+
+void Sim_Kernel_Stop(int ExitCode)
+{
+    Sim_EndHook_t hook = End_Hook;
+
+    /* The hook may read counters through driver calls, they must not end here again */
+    End_Hook = NULL;
+    End_Time = UINT64_MAX;
+
+    if (hook != NULL)
+    {
+        hook();
+    }
+
+    exit(ExitCode);
+}
+
+Sim_Time_t Sim_Now(void)
+{
+    return Now;
+}
+
+void Sim_Schedule(Sim_Time_t At, Sim_EventHandler_t Handler, void *Context, uint32_t Arg)
+{
+    SIM_Event_t event =
+    {
+        .At      = (At < Now) ? Now : At,
+        .Seq     = Event_Seq++,
+        .Handler = Handler,
+        .Context = Context,
+        .Arg     = Arg
+    };
+
+    SIM_EventPush(&event);
+}
+
+void Sim_Advance(Sim_Time_t Duration)
+{
+    SIM_RunUntil(Now + Duration);
+}
+
+void Sim_Access(void)
+{
+    Stats.AccessCnt++;
+    SIM_RunUntil(Now + Access_Cost);
+    SIM_Dispatch();
+}
+
+void Sim_Irq_Register(IRQn_Type Irq, const char *Name, Sim_IrqPending_t IsPending, Sim_IrqHandler_t Handler)
+{
+    uint8_t index = Irq_Num;
+
+    if (Irq_Num < SIM_IRQ_LINE_MAX)
+    {
+        /* Keep the lines sorted, equal NVIC priorities are served by interrupt number */
+        while ((index > 0u) && (Irq_Line[index - 1u].Irq > Irq))
+        {
+            Irq_Line[index] = Irq_Line[index - 1u];
+            index--;
+        }
+
+        Irq_Line[index] = (SIM_IrqLine_t){ .Irq = Irq, .Enabled = false, .IsPending = IsPending, .Handler = Handler };
+        Irq_Line[index].Stats.Name = Name;
+        Irq_Num++;
+    }
+    else
+    {
+        fprintf(stderr, "sim: too many interrupt lines, %s ignored\n", Name);
+    }
+}
+
+void Sim_Irq_SetEnabled(IRQn_Type Irq, bool Enabled)
+{
+    uint8_t index = 0u;
+
+    for (index = 0u; index < Irq_Num; index++)
+    {
+        if (Irq_Line[index].Irq == Irq)
+        {
+            Irq_Line[index].Enabled = Enabled;
+        }
+    }
+}
+
+void Sim_Irq_Disable(void)
+{
+    Primask = 1u;
+}
+
+void Sim_Irq_Enable(void)
+{
+    Primask = 0u;
+    SIM_Dispatch();
+}
+
+uint32_t Sim_Irq_GetPrimask(void)
+{
+    return Primask;
+}
+
+void Sim_Cpu_Standby(void)
+{
+    SIM_Event_t event;
+    Sim_Time_t start = Now;
+    bool slept = false;
+
+    while (SIM_NextPendingIrq() == NULL)
+    {
+        if (Event_Cnt == 0u)
+        {
+            fprintf(stderr, "sim: the CPU sleeps with no event left\n");
+            Sim_Kernel_Stop(0);
+        }
+
+        /* Nothing can happen before the next event, jump there */
+        SIM_EventPop(&event);
+        if (event.At >= End_Time)
+        {
+            Now = End_Time;
+            Stats.SleepTime += Now - start;
+            Sim_Kernel_Stop(0);
+        }
+        Now = event.At;
+        Stats.EventCnt++;
+        event.Handler(event.Context, event.Arg);
+        slept = true;
+    }
+
+    if (slept == true)
+    {
+        Stats.SleepTime += Now - start;
+        Stats.WakeupCnt++;
+    }
+}
+
+void Sim_Kernel_GetStats(Sim_KernelStats_t *Out)
+{
+    uint8_t index = 0u;
+
+    Stats.Now = Now;
+    Stats.IrqNum = Irq_Num;
+    for (index = 0u; index < Irq_Num; index++)
+    {
+        Stats.Irq[index] = Irq_Line[index].Stats;
+    }
+
+    *Out = Stats;
+}
+
+/**
+  * @brief      Order of two events in the queue
+  * @param[in]  A, B: Events
+  * @param[out] None
+  * @retval     true if A runs before B
+  */
+static bool SIM_EventBefore(const SIM_Event_t *A, const SIM_Event_t *B)
+{
+    return (A->At < B->At) || ((A->At == B->At) && (A->Seq < B->Seq));
+}
+
+/**
+  * @brief      Insert an event in the queue
+  * @param[in]  Event: Event to copy in
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_EventPush(const SIM_Event_t *Event)
+{
+    uint32_t index = Event_Cnt;
+    uint32_t parent = 0u;
+
+    if (Event_Cnt == Event_Size)
+    {
+        Event_Size = (Event_Size == 0u) ? SIM_EVENT_QUEUE_INIT : (Event_Size * 2u);
+        Event_Queue = realloc(Event_Queue, Event_Size * sizeof(SIM_Event_t));
+        if (Event_Queue == NULL)
+        {
+            fprintf(stderr, "sim: out of memory\n");
+            exit(2);
+        }
+    }
+
+    while (index > 0u)
+    {
+        parent = (index - 1u) / 2u;
+        if (SIM_EventBefore(Event, &Event_Queue[parent]) == false)
+        {
+            break;
+        }
+        Event_Queue[index] = Event_Queue[parent];
+        index = parent;
+    }
+
+    Event_Queue[index] = *Event;
+    Event_Cnt++;
+}
+
+/**
+  * @brief      Remove the earliest event from the queue
+  * @param[in]  None
+  * @param[out] Event: Earliest event, the queue must not be empty
+  * @retval     None
+  */
+static void SIM_EventPop(SIM_Event_t *Event)
+{
+    SIM_Event_t last;
+    uint32_t index = 0u;
+    uint32_t child = 0u;
+
+    *Event = Event_Queue[0];
+    Event_Cnt--;
+    last = Event_Queue[Event_Cnt];
+
+    while ((child = (2u * index) + 1u) < Event_Cnt)
+    {
+        if (((child + 1u) < Event_Cnt) && SIM_EventBefore(&Event_Queue[child + 1u], &Event_Queue[child]))
+        {
+            child++;
+        }
+        if (SIM_EventBefore(&Event_Queue[child], &last) == false)
+        {
+            break;
+        }
+        Event_Queue[index] = Event_Queue[child];
+        index = child;
+    }
+
+    Event_Queue[index] = last;
+}
+
+/**
+  * @brief      Run the events due up to a time, then move the clock there
+  * @param[in]  Target: Virtual time
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_RunUntil(Sim_Time_t Target)
+{
+    SIM_Event_t event;
+
+    if (Target > End_Time)
+    {
+        Target = End_Time;
+    }
+
+    while ((Event_Cnt != 0u) && (Event_Queue[0].At <= Target))
+    {
+        SIM_EventPop(&event);
+        Now = event.At;
+        Stats.EventCnt++;
+        event.Handler(event.Context, event.Arg);
+    }
+
+    Now = Target;
+
+    if (Now >= End_Time)
+    {
+        Sim_Kernel_Stop(0);
+    }
+}
+
+/**
+  * @brief      Find the enabled pending interrupt served first
+  * @param[in]  None
+  * @param[out] None
+  * @retval     Interrupt line, NULL if none
+  */
+static SIM_IrqLine_t *SIM_NextPendingIrq(void)
+{
+    SIM_IrqLine_t *line = NULL;
+    uint8_t index = 0u;
+
+    for (index = 0u; (index < Irq_Num) && (line == NULL); index++)
+    {
+        if ((Irq_Line[index].Enabled == true) && (Irq_Line[index].IsPending() == true))
+        {
+            line = &Irq_Line[index];
+        }
+    }
+
+    return line;
+}
+
+/**
+  * @brief      Run the pending interrupts, unless masked or already in an interrupt
+  * @note       Interrupts do not nest, all lines have the same NVIC priority
+  * @param[in]  None
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_Dispatch(void)
+{
+    SIM_IrqLine_t *line = NULL;
+    uint32_t count = 0u;
+
+    if ((Primask == 0u) && (In_Isr == false))
+    {
+        while ((line = SIM_NextPendingIrq()) != NULL)
+        {
+            if (++count > SIM_IRQ_STORM_LIMIT)
+            {
+                fprintf(stderr, "sim: interrupt storm on %s\n", line->Stats.Name);
+                Sim_Kernel_Stop(3);
+            }
+
+            In_Isr = true;
+            line->Stats.DispatchCnt++;
+            line->Handler();
+            In_Isr = false;
+        }
+    }
+}
+
+/*******************************************************************************
+ * End Of File
+ ******************************************************************************/
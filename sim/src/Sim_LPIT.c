@@ -0,0 +1,249 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "DRV_S32K144_LPIT.h"
+#include "DRV_S32K144_MCU.h"
+#include "Sim_Kernel.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+#define SIM_LPIT_CHANNEL_NUM    4u
+
+/* One timer channel: a 32-bit down counter reloaded from Reload, TVAL 0 counts 2^32 ticks */
+typedef struct
+{
+    bool            Running;
+    bool            IntEnable;
+    bool            Flag;           /* TIF */
+    uint32_t        Reload;
+    Sim_Time_t      Start;          /* Virtual time of the last start */
+    uint32_t        Generation;     /* Bumped on every start/stop, stale expiry events are dropped */
+    IRQ_FuncCallback Callback;
+} SIM_LpitChannel_t;
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+static uint64_t SIM_LpitPeriodTicks(const SIM_LpitChannel_t *Channel);
+static uint64_t SIM_LpitElapsedTicks(const SIM_LpitChannel_t *Channel);
+static void SIM_LpitScheduleExpiry(uint8_t Index);
+static void SIM_LpitExpiry(void *Context, uint32_t Arg);
+static void SIM_LpitIrq(uint8_t Index);
+static bool SIM_LpitCh0Pending(void);
+static bool SIM_LpitCh1Pending(void);
+static bool SIM_LpitCh2Pending(void);
+static bool SIM_LpitCh3Pending(void);
+static void SIM_LpitCh0Irq(void);
+static void SIM_LpitCh1Irq(void);
+static void SIM_LpitCh2Irq(void);
+static void SIM_LpitCh3Irq(void);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static SIM_LpitChannel_t Lpit_Channel[SIM_LPIT_CHANNEL_NUM];
+static uint32_t Lpit_Freq = 0u;
+static bool Lpit_Registered = false;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+void DRV_LPIT_EnableModule(uint8_t instance)
+{
+    (void)instance;
+
+    if (Lpit_Registered == false)
+    {
+        Sim_Irq_Register(LPIT0_Ch0_IRQn, "LPIT0_Ch0", SIM_LpitCh0Pending, SIM_LpitCh0Irq);
+        Sim_Irq_Register(LPIT0_Ch1_IRQn, "LPIT0_Ch1", SIM_LpitCh1Pending, SIM_LpitCh1Irq);
+        Sim_Irq_Register(LPIT0_Ch2_IRQn, "LPIT0_Ch2", SIM_LpitCh2Pending, SIM_LpitCh2Irq);
+        Sim_Irq_Register(LPIT0_Ch3_IRQn, "LPIT0_Ch3", SIM_LpitCh3Pending, SIM_LpitCh3Irq);
+        Lpit_Registered = true;
+    }
+
+    (void)DRV_Clock_GetFrequency(LPIT0_CLK, &Lpit_Freq);
+}
+
+void DRV_LPIT_DisableModule(uint8_t instance)
+{
+    uint8_t index = 0u;
+
+    (void)instance;
+
+    for (index = 0u; index < SIM_LPIT_CHANNEL_NUM; index++)
+    {
+        DRV_LPIT_StopTimerChannel(instance, (LPIT_ChannelTypedef)index);
+    }
+}
+
+void DRV_LPIT_Init(uint8_t instance, LPIT_ChannelTypedef CHx, LPIT_InitTypedef *LPIT_InitStructure)
+{
+    (void)instance;
+
+    /* Chained and trigger modes are not used by the firmware, every channel counts periodically */
+    Lpit_Channel[CHx].IntEnable = (LPIT_InitStructure->LPIT_Interupt == ENABLE);
+    Sim_Access();
+}
+
+void DRV_LPIT_ClearInterruptFlagTimerChannels(uint8_t instance, LPIT_ChannelTypedef CHx)
+{
+    (void)instance;
+
+    Lpit_Channel[CHx].Flag = false;
+    Sim_Access();
+}
+
+uint32_t DRV_LPIT_GetCurrentTimerCount(uint8_t instance, LPIT_ChannelTypedef CHx)
+{
+    const SIM_LpitChannel_t *channel = &Lpit_Channel[CHx];
+    uint32_t count = channel->Reload;
+
+    (void)instance;
+
+    Sim_Access();
+
+    if (channel->Running == true)
+    {
+        count = (uint32_t)(SIM_LpitPeriodTicks(channel) - 1u - (SIM_LpitElapsedTicks(channel) % SIM_LpitPeriodTicks(channel)));
+    }
+
+    return count;
+}
+
+void DRV_LPIT_SetReloadValue(uint8_t instance, LPIT_ChannelTypedef CHx, uint32_t Val)
+{
+    (void)instance;
+
+    /* Takes effect on the next start, the firmware only reloads stopped channels */
+    Lpit_Channel[CHx].Reload = Val;
+    Sim_Access();
+}
+
+void DRV_LPIT_StartTimerChannel(uint8_t instance, LPIT_ChannelTypedef CHx)
+{
+    SIM_LpitChannel_t *channel = &Lpit_Channel[CHx];
+
+    (void)instance;
+
+    channel->Running = true;
+    channel->Start = Sim_Now();
+    channel->Generation++;
+    SIM_LpitScheduleExpiry((uint8_t)CHx);
+    Sim_Access();
+}
+
+void DRV_LPIT_StopTimerChannel(uint8_t instance, LPIT_ChannelTypedef CHx)
+{
+    (void)instance;
+
+    Lpit_Channel[CHx].Running = false;
+    Lpit_Channel[CHx].Generation++;
+    Sim_Access();
+}
+
+void DRV_LPIT0_RegisterIntCallback(LPIT_ChannelTypedef CHx, IRQ_FuncCallback fp)
+{
+    if ((uint8_t)CHx < SIM_LPIT_CHANNEL_NUM)
+    {
+        Lpit_Channel[CHx].Callback = fp;
+    }
+    else
+    {
+        /* Do nothing */
+    }
+}
+
+/**
+  * @brief      Number of ticks of one period of a channel
+  * @param[in]  Channel: Timer channel
+  * @param[out] None
+  * @retval     Ticks
+  */
+static uint64_t SIM_LpitPeriodTicks(const SIM_LpitChannel_t *Channel)
+{
+    return (Channel->Reload == 0u) ? ((uint64_t)UINT32_MAX + 1u) : ((uint64_t)Channel->Reload + 1u);
+}
+
+/**
+  * @brief      Number of ticks counted since the channel started
+  * @param[in]  Channel: Timer channel
+  * @param[out] None
+  * @retval     Ticks
+  */
+static uint64_t SIM_LpitElapsedTicks(const SIM_LpitChannel_t *Channel)
+{
+    Sim_Time_t elapsed = Sim_Now() - Channel->Start;
+
+    return ((elapsed / SIM_NS_PER_S) * Lpit_Freq) + (((elapsed % SIM_NS_PER_S) * Lpit_Freq) / SIM_NS_PER_S);
+}
+
+/**
+  * @brief      Schedule the next time-out of a channel
+  * @param[in]  Index: Channel
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_LpitScheduleExpiry(uint8_t Index)
+{
+    SIM_LpitChannel_t *channel = &Lpit_Channel[Index];
+    uint64_t periods = (SIM_LpitElapsedTicks(channel) / SIM_LpitPeriodTicks(channel)) + 1u;
+    uint64_t ticks = periods * SIM_LpitPeriodTicks(channel);
+    Sim_Time_t at = channel->Start + ((ticks / Lpit_Freq) * SIM_NS_PER_S) + (((ticks % Lpit_Freq) * SIM_NS_PER_S) / Lpit_Freq);
+
+    Sim_Schedule(at, SIM_LpitExpiry, channel, channel->Generation);
+}
+
+/**
+  * @brief      Time-out of a channel: set TIF and schedule the next one
+  * @param[in]  Context: Timer channel
+  * @param[in]  Arg: Generation the event was scheduled for
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_LpitExpiry(void *Context, uint32_t Arg)
+{
+    SIM_LpitChannel_t *channel = (SIM_LpitChannel_t *)Context;
+
+    if ((channel->Running == true) && (channel->Generation == Arg))
+    {
+        channel->Flag = true;
+
+        /* A free running time base without interrupt needs no event */
+        if (channel->IntEnable == true)
+        {
+            SIM_LpitScheduleExpiry((uint8_t)(channel - Lpit_Channel));
+        }
+    }
+}
+
+/**
+  * @brief      Model of LPIT0_ChN_IRQHandler(): clear TIF, run the callback
+  * @param[in]  Index: Channel
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_LpitIrq(uint8_t Index)
+{
+    Lpit_Channel[Index].Flag = false;
+
+    if (Lpit_Channel[Index].Callback != NULL)
+    {
+        Lpit_Channel[Index].Callback();
+    }
+}
+
+static bool SIM_LpitCh0Pending(void) { return Lpit_Channel[0].Flag && Lpit_Channel[0].IntEnable; }
+static bool SIM_LpitCh1Pending(void) { return Lpit_Channel[1].Flag && Lpit_Channel[1].IntEnable; }
+static bool SIM_LpitCh2Pending(void) { return Lpit_Channel[2].Flag && Lpit_Channel[2].IntEnable; }
+static bool SIM_LpitCh3Pending(void) { return Lpit_Channel[3].Flag && Lpit_Channel[3].IntEnable; }
+static void SIM_LpitCh0Irq(void) { SIM_LpitIrq(0u); }
+static void SIM_LpitCh1Irq(void) { SIM_LpitIrq(1u); }
+static void SIM_LpitCh2Irq(void) { SIM_LpitIrq(2u); }
+static void SIM_LpitCh3Irq(void) { SIM_LpitIrq(3u); }
+
+/*******************************************************************************
+ * End Of File
+ ******************************************************************************/
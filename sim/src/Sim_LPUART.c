@@ -0,0 +1,291 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "DRV_S32K144_LPUART.h"
+#include "DRV_S32K144_MCU.h"
+#include "Sim_Kernel.h"
+#include "Sim_LPUART.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+#define SIM_LPUART_NUM      LPUART_INSTANCE_COUNT
+
+/* One instance: a transmit data register feeding a shifter, a receive data register */
+typedef struct
+{
+    bool        Initialized;
+    bool        TxEnabled;          /* CTRL[TE] */
+    bool        RxEnabled;          /* CTRL[RE] */
+    bool        TxIntEnable;        /* CTRL[TIE] */
+    bool        RxIntEnable;        /* CTRL[RIE] */
+    bool        TdrFull;            /* !STAT[TDRE] */
+    uint8_t     Tdr;
+    bool        Shifting;
+    uint8_t     ShiftByte;
+    Sim_Time_t  ShiftStart;
+    bool        RdrFull;            /* STAT[RDRF] */
+    uint8_t     Rdr;
+    Sim_Time_t  CharTime;
+    IRQ_FuncCallback TxCallback;
+    IRQ_FuncCallback RxCallback;
+    Sim_LpuartReceive_t Receive;
+    void       *ReceiveContext;
+    Sim_LpuartStats_t Stats;
+} SIM_Lpuart_t;
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+static void SIM_LpuartStartShift(SIM_Lpuart_t *Uart);
+static void SIM_LpuartShiftDone(void *Context, uint32_t Arg);
+static bool SIM_LpuartPending(uint8_t Instance);
+static void SIM_LpuartIrq(uint8_t Instance);
+static bool SIM_Lpuart0Pending(void);
+static bool SIM_Lpuart1Pending(void);
+static bool SIM_Lpuart2Pending(void);
+static void SIM_Lpuart0Irq(void);
+static void SIM_Lpuart1Irq(void);
+static void SIM_Lpuart2Irq(void);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static SIM_Lpuart_t Lpuart[SIM_LPUART_NUM];
+static const clock_names_t Lpuart_Clock[SIM_LPUART_NUM] = LPUART_CLOCK_NAMES;
+static bool Lpuart_Registered = false;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+void DRV_LPUART_Init(const uint8_t instance, const lpuart_config_t * pConfig)
+{
+    SIM_Lpuart_t *uart = &Lpuart[instance];
+    uint32_t clkFreq = 0u;
+    uint32_t bits = 0u;
+
+    if (Lpuart_Registered == false)
+    {
+        Sim_Irq_Register(LPUART0_RxTx_IRQn, "LPUART0_RxTx", SIM_Lpuart0Pending, SIM_Lpuart0Irq);
+        Sim_Irq_Register(LPUART1_RxTx_IRQn, "LPUART1_RxTx", SIM_Lpuart1Pending, SIM_Lpuart1Irq);
+        Sim_Irq_Register(LPUART2_RxTx_IRQn, "LPUART2_RxTx", SIM_Lpuart2Pending, SIM_Lpuart2Irq);
+        Lpuart_Registered = true;
+    }
+
+    (void)DRV_Clock_GetFrequency(Lpuart_Clock[instance], &clkFreq);
+
+    if ((clkFreq != 0u) && (pConfig->baudRate != 0u))
+    {
+        /* Start bit, data bits, parity, stop bits */
+        bits = 1u + 7u + (uint32_t)pConfig->numberDataBits;
+        bits += (pConfig->parityMode != LPUART_PARITY_DISABLED) ? 1u : 0u;
+        bits += (pConfig->stopBit == LPUART_TWO_STOP_BIT) ? 2u : 1u;
+
+        uart->CharTime    = ((Sim_Time_t)bits * SIM_NS_PER_S) / pConfig->baudRate;
+        uart->TxIntEnable = pConfig->enableTransmitInterrupt;
+        uart->RxIntEnable = pConfig->enableReceiveInterrupt;
+        uart->TxEnabled   = true;
+        uart->RxEnabled   = true;
+        uart->Initialized = true;
+    }
+
+    Sim_Access();
+}
+
+void DRV_LPUART_DeInit(const uint8_t instance)
+{
+    Lpuart[instance].Initialized = false;
+    Lpuart[instance].TxEnabled = false;
+    Lpuart[instance].RxEnabled = false;
+    Sim_Access();
+}
+
+void DRV_LPUART_DisableCommunication(const uint8_t instance)
+{
+    Lpuart[instance].TxEnabled = false;
+    Lpuart[instance].RxEnabled = false;
+    Sim_Access();
+}
+
+void DRV_LPUART_EnableCommunication(const uint8_t instance)
+{
+    Lpuart[instance].TxEnabled = Lpuart[instance].Initialized;
+    Lpuart[instance].RxEnabled = Lpuart[instance].Initialized;
+    SIM_LpuartStartShift(&Lpuart[instance]);
+    Sim_Access();
+}
+
+void DRV_LPUART_SendChar(const uint8_t instance, uint8_t Data)
+{
+    SIM_Lpuart_t *uart = &Lpuart[instance];
+
+    if (uart->TdrFull == true)
+    {
+        uart->Stats.TxOverwrite++;
+    }
+
+    uart->Tdr = Data;
+    uart->TdrFull = true;
+    SIM_LpuartStartShift(uart);
+    Sim_Access();
+}
+
+uint8_t DRV_LPUART_ReceiveChar(const uint8_t instance)
+{
+    SIM_Lpuart_t *uart = &Lpuart[instance];
+    uint8_t data = 0u;
+
+    if (uart->RdrFull == true)
+    {
+        data = uart->Rdr;
+        uart->RdrFull = false;
+        uart->Stats.RxBytes++;
+    }
+
+    Sim_Access();
+
+    return data;
+}
+
+void DRV_LPUART_SetTransmitITStatus(const uint8_t instance, bool enable)
+{
+    Lpuart[instance].TxIntEnable = enable;
+    Sim_Access();
+}
+
+void DRV_LPUART_RegisterIntCallback(uint8_t instance, IRQ_FuncCallback Txcallback, IRQ_FuncCallback Rxcallback)
+{
+    Lpuart[instance].TxCallback = Txcallback;
+    Lpuart[instance].RxCallback = Rxcallback;
+    Sim_Access();
+}
+
+void Sim_LPUART_Attach(uint8_t Instance, Sim_LpuartReceive_t Receive, void *Context)
+{
+    Lpuart[Instance].Receive = Receive;
+    Lpuart[Instance].ReceiveContext = Context;
+}
+
+void Sim_LPUART_Inject(uint8_t Instance, uint8_t Byte)
+{
+    SIM_Lpuart_t *uart = &Lpuart[Instance];
+
+    if (uart->RxEnabled == true)
+    {
+        if (uart->RdrFull == true)
+        {
+            uart->Stats.RxOverrun++;
+        }
+        else
+        {
+            uart->Rdr = Byte;
+            uart->RdrFull = true;
+        }
+    }
+    else
+    {
+        /* Do nothing */
+    }
+}
+
+Sim_Time_t Sim_LPUART_GetCharTime(uint8_t Instance)
+{
+    return Lpuart[Instance].CharTime;
+}
+
+void Sim_LPUART_GetStats(uint8_t Instance, Sim_LpuartStats_t *Stats)
+{
+    *Stats = Lpuart[Instance].Stats;
+}
+
+/**
+  * @brief      Move the transmit data register to the idle shifter
+  * @param[in]  Uart: Instance
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_LpuartStartShift(SIM_Lpuart_t *Uart)
+{
+    if ((Uart->TxEnabled == true) && (Uart->Shifting == false) && (Uart->TdrFull == true))
+    {
+        Uart->ShiftByte = Uart->Tdr;
+        Uart->TdrFull = false;
+        Uart->Shifting = true;
+        Uart->ShiftStart = Sim_Now();
+        Sim_Schedule(Sim_Now() + Uart->CharTime, SIM_LpuartShiftDone, Uart, 0u);
+    }
+}
+
+/**
+  * @brief      Stop bit of the shifted byte sent: hand it to the agent, shift the next one
+  * @param[in]  Context: Instance
+  * @param[in]  Arg: Not used
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_LpuartShiftDone(void *Context, uint32_t Arg)
+{
+    SIM_Lpuart_t *uart = (SIM_Lpuart_t *)Context;
+
+    (void)Arg;
+
+    uart->Shifting = false;
+    uart->Stats.TxBytes++;
+    uart->Stats.TxBusyTime += Sim_Now() - uart->ShiftStart;
+
+    if (uart->Receive != NULL)
+    {
+        uart->Receive(uart->ReceiveContext, uart->ShiftByte);
+    }
+
+    SIM_LpuartStartShift(uart);
+}
+
+/**
+  * @brief      Level of the RxTx interrupt of an instance
+  * @param[in]  Instance: LPUART instance
+  * @param[out] None
+  * @retval     true if RDRF with RIE or TDRE with TIE
+  */
+static bool SIM_LpuartPending(uint8_t Instance)
+{
+    const SIM_Lpuart_t *uart = &Lpuart[Instance];
+
+    return ((uart->RdrFull == true) && (uart->RxIntEnable == true)) ||
+           ((uart->TdrFull == false) && (uart->TxIntEnable == true) && (uart->TxEnabled == true));
+}
+
+/**
+  * @brief      Model of DRV_LPUART_IRQHandler(): the RX callback on RDRF, the TX callback on TDRE
+  * @note       As in the driver, the TX callback runs on TDRE whether TIE is set or not
+  * @param[in]  Instance: LPUART instance
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_LpuartIrq(uint8_t Instance)
+{
+    const SIM_Lpuart_t *uart = &Lpuart[Instance];
+
+    if ((uart->RdrFull == true) && (uart->RxCallback != NULL))
+    {
+        uart->RxCallback();
+    }
+
+    if ((uart->TdrFull == false) && (uart->TxCallback != NULL))
+    {
+        uart->TxCallback();
+    }
+}
+
+static bool SIM_Lpuart0Pending(void) { return SIM_LpuartPending(0u); }
+static bool SIM_Lpuart1Pending(void) { return SIM_LpuartPending(1u); }
+static bool SIM_Lpuart2Pending(void) { return SIM_LpuartPending(2u); }
+static void SIM_Lpuart0Irq(void) { SIM_LpuartIrq(0u); }
+static void SIM_Lpuart1Irq(void) { SIM_LpuartIrq(1u); }
+static void SIM_Lpuart2Irq(void) { SIM_LpuartIrq(2u); }
+
+/*******************************************************************************
+ * End Of File
+ ******************************************************************************/
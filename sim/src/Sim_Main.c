@@ -0,0 +1,435 @@
+/* clock_gettime() for the wall time of the run */
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Sim_Kernel.h"
+#include "Sim_FlexCAN.h"
+#include "Sim_LPUART.h"
+#include "Sim_Agents.h"
+#include "Sim_Replay.h"
+
+/* The firmware is built with -Dmain=Firmware_Main, this file provides the host entry point */
+#undef main
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/* Defaults of a scenario */
+#define SIM_END_MS_DEFAULT      10000u
+#define SIM_ACCESS_NS_DEFAULT   25u         /* Two bus cycles at 80 MHz per driver call */
+#define SIM_SEED_DEFAULT        1u
+
+#define SIM_SENSOR_BUS          0u
+#define SIM_PC_LPUART           1u
+#define SIM_COMMAND_MAX         256u
+#define SIM_LINE_MAX            128u
+
+/* Timed commands of a scenario */
+typedef enum
+{
+    SIM_COMMAND_UART,           /* PC sends a line: Arg[0] ID, Arg[1] data */
+    SIM_COMMAND_GARBAGE,        /* PC sends Arg[0] random bytes */
+    SIM_COMMAND_MUTE,           /* Node Arg[0] ignores the bus for Arg[1] ms */
+    SIM_COMMAND_ERRORS,         /* Arg[0] error frames hit the forwarder */
+    SIM_COMMAND_NOACK           /* Frames of the forwarder are not acknowledged for Arg[0] ms */
+} SIM_CommandType_t;
+
+typedef struct
+{
+    SIM_CommandType_t Type;
+    uint32_t          Arg[2];
+} SIM_Command_t;
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+int Firmware_Main(void);
+
+static bool SIM_LoadScenario(const char *Path);
+static bool SIM_ParseLine(char *Line);
+static bool SIM_ParseClass(const char *Name, uint8_t *Class);
+static void SIM_RunCommand(void *Context, uint32_t Arg);
+static double SIM_WallTime(void);
+static void SIM_Report(void);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static SIM_Command_t Command[SIM_COMMAND_MAX];
+static uint32_t Command_Num = 0u;
+static const char *Scenario_Path = NULL;
+static uint32_t Scenario_EndMs = SIM_END_MS_DEFAULT;
+static double Wall_Start = 0.0;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+int main(int argc, char *argv[])
+{
+    int status = 0;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s <scenario>\n", argv[0]);
+        status = 2;
+    }
+    else
+    {
+        Scenario_Path = argv[1];
+        Sim_Kernel_Init(SIM_ACCESS_NS_DEFAULT);
+        Sim_Agents_Seed(SIM_SEED_DEFAULT);
+
+        if (SIM_LoadScenario(Scenario_Path) == false)
+        {
+            status = 2;
+        }
+        else
+        {
+            Sim_Kernel_SetEnd((Sim_Time_t)Scenario_EndMs * SIM_NS_PER_MS, SIM_Report);
+            Wall_Start = SIM_WallTime();
+
+            /* Returns only if the scheduler ever does, the end hook reports and exits */
+            (void)Firmware_Main();
+            SIM_Report();
+        }
+    }
+
+    return status;
+}
+
+/**
+  * @brief      Read a scenario file, one command per line, '#' starts a comment
+  * @param[in]  Path: Scenario file
+  * @param[out] None
+  * @retval     false if the file cannot be read or holds an invalid line
+  */
+static bool SIM_LoadScenario(const char *Path)
+{
+    FILE *file = fopen(Path, "r");
+    char line[SIM_LINE_MAX];
+    uint32_t number = 0u;
+    bool valid = (file != NULL);
+    char *comment = NULL;
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "%s: cannot open\n", Path);
+    }
+
+    while ((valid == true) && (fgets(line, sizeof(line), file) != NULL))
+    {
+        number++;
+        comment = strchr(line, '#');
+
+        if (comment != NULL)
+        {
+            *comment = '\0';
+        }
+
+        if (SIM_ParseLine(line) == false)
+        {
+            fprintf(stderr, "%s:%u: invalid command\n", Path, (unsigned)number);
+            valid = false;
+        }
+    }
+
+    if (file != NULL)
+    {
+        fclose(file);
+    }
+
+    return valid;
+}
+
+/**
+  * @brief      Apply one line of a scenario
+  * @note       end <ms> | cost <ns> | seed <n> | bitrate <bit/s> | pc confirm <us> | pc noconfirm
+  *             | node <distance|rotation> <period_us> [jitter_us] | traffic <id> <period_us> <dlc> [ext]
+  *             | at <ms> uart <id> <data> | at <ms> garbage <length> | at <ms> mute <node> <ms>
+  *             | at <ms> errors <count> | capture <file> | replay <file> <start_ms> [speed]
+  * @param[in]  Line: Line without comment, modified
+  * @param[out] None
+  * @retval     false if the line is not a valid command
+  */
+static bool SIM_ParseLine(char *Line)
+{
+    char *word[6] = {NULL};
+    uint32_t count = 0u;
+    bool valid = true;
+    uint8_t node = 0u;
+    uint8_t nodeClass = 0u;
+    SIM_Command_t *command = &Command[Command_Num];
+
+    for (word[0] = strtok(Line, " \t\r\n"); (word[count] != NULL) && (count < 5u); )
+    {
+        count++;
+        word[count] = strtok(NULL, " \t\r\n");
+    }
+
+    if (count == 0u)
+    {
+        /* Empty line */
+    }
+    else if ((strcmp(word[0], "end") == 0) && (count == 2u))
+    {
+        Scenario_EndMs = (uint32_t)strtoul(word[1], NULL, 0);
+    }
+    else if ((strcmp(word[0], "cost") == 0) && (count == 2u))
+    {
+        Sim_Kernel_SetAccessCost(strtoull(word[1], NULL, 0));
+    }
+    else if ((strcmp(word[0], "seed") == 0) && (count == 2u))
+    {
+        Sim_Agents_Seed((uint32_t)strtoul(word[1], NULL, 0));
+    }
+    else if ((strcmp(word[0], "bitrate") == 0) && (count == 2u))
+    {
+        Sim_CAN_SetBitrate(SIM_SENSOR_BUS, (uint32_t)strtoul(word[1], NULL, 0));
+    }
+    else if ((strcmp(word[0], "pc") == 0) && (count == 3u) && (strcmp(word[1], "confirm") == 0))
+    {
+        Sim_Pc_Init(strtoull(word[2], NULL, 0) * SIM_NS_PER_US);
+    }
+    else if ((strcmp(word[0], "pc") == 0) && (count == 2u) && (strcmp(word[1], "noconfirm") == 0))
+    {
+        Sim_Pc_Init(0u);
+    }
+    else if ((strcmp(word[0], "node") == 0) && ((count == 3u) || (count == 4u)) && (SIM_ParseClass(word[1], &nodeClass) == true))
+    {
+        valid = Sim_Node_Create(nodeClass, strtoull(word[2], NULL, 0) * SIM_NS_PER_US,
+                                (count == 4u) ? (strtoull(word[3], NULL, 0) * SIM_NS_PER_US) : 0u);
+    }
+    else if ((strcmp(word[0], "traffic") == 0) && ((count == 4u) || (count == 5u)))
+    {
+        valid = Sim_Traffic_Create((uint32_t)strtoul(word[1], NULL, 0), (count == 5u) && (strcmp(word[4], "ext") == 0),
+                                   strtoull(word[2], NULL, 0) * SIM_NS_PER_US, (uint8_t)strtoul(word[3], NULL, 0));
+    }
+    else if ((strcmp(word[0], "capture") == 0) && (count == 2u))
+    {
+        Sim_Pc_SetCaptureFile(word[1]);
+    }
+    else if ((strcmp(word[0], "replay") == 0) && ((count == 3u) || (count == 4u)))
+    {
+        valid = Sim_Replay_Load(word[1], strtoull(word[2], NULL, 0) * SIM_NS_PER_MS,
+                                (count == 4u) ? (uint32_t)strtoul(word[3], NULL, 0) : 1u);
+    }
+    else if ((strcmp(word[0], "at") == 0) && (count >= 3u) && (Command_Num < SIM_COMMAND_MAX))
+    {
+        if ((strcmp(word[2], "uart") == 0) && (count == 5u))
+        {
+            command->Type = SIM_COMMAND_UART;
+            command->Arg[0] = (uint32_t)strtoul(word[3], NULL, 0);
+            command->Arg[1] = (uint32_t)strtoul(word[4], NULL, 0);
+        }
+        else if ((strcmp(word[2], "garbage") == 0) && (count == 4u))
+        {
+            command->Type = SIM_COMMAND_GARBAGE;
+            command->Arg[0] = (uint32_t)strtoul(word[3], NULL, 0);
+        }
+        else if ((strcmp(word[2], "mute") == 0) && (count == 5u) && (Sim_Node_Find(word[3], &node) == true))
+        {
+            command->Type = SIM_COMMAND_MUTE;
+            command->Arg[0] = node;
+            command->Arg[1] = (uint32_t)strtoul(word[4], NULL, 0);
+        }
+        else if ((strcmp(word[2], "errors") == 0) && (count == 4u))
+        {
+            command->Type = SIM_COMMAND_ERRORS;
+            command->Arg[0] = (uint32_t)strtoul(word[3], NULL, 0);
+        }
+        else if ((strcmp(word[2], "noack") == 0) && (count == 4u))
+        {
+            command->Type = SIM_COMMAND_NOACK;
+            command->Arg[0] = (uint32_t)strtoul(word[3], NULL, 0);
+        }
+        else
+        {
+            valid = false;
+        }
+
+        if (valid == true)
+        {
+            Sim_Schedule(strtoull(word[1], NULL, 0) * SIM_NS_PER_MS, SIM_RunCommand, command, 0u);
+            Command_Num++;
+        }
+    }
+    else
+    {
+        valid = false;
+    }
+
+    return valid;
+}
+
+/**
+  * @brief      Get a simulated node class from its name
+  * @param[in]  Name: "distance" or "rotation"
+  * @param[out] Class: it can be a value of @defgroup Simulated node class
+  * @retval     false if the name is unknown
+  */
+static bool SIM_ParseClass(const char *Name, uint8_t *Class)
+{
+    bool valid = true;
+
+    if (strcmp(Name, "distance") == 0)
+    {
+        *Class = SIM_NODE_CLASS_DISTANCE;
+    }
+    else if (strcmp(Name, "rotation") == 0)
+    {
+        *Class = SIM_NODE_CLASS_ROTATION;
+    }
+    else
+    {
+        valid = false;
+    }
+
+    return valid;
+}
+
+/**
+  * @brief      Run a timed command of the scenario
+  * @param[in]  Context: Command
+  * @param[in]  Arg: Not used
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_RunCommand(void *Context, uint32_t Arg)
+{
+    const SIM_Command_t *command = (const SIM_Command_t *)Context;
+
+    (void)Arg;
+
+    switch (command->Type)
+    {
+    case SIM_COMMAND_UART:
+        Sim_Pc_SendLine(command->Arg[0], command->Arg[1]);
+        break;
+
+    case SIM_COMMAND_GARBAGE:
+        Sim_Pc_SendGarbage(command->Arg[0]);
+        break;
+
+    case SIM_COMMAND_MUTE:
+        Sim_Node_Mute((uint8_t)command->Arg[0], (Sim_Time_t)command->Arg[1] * SIM_NS_PER_MS);
+        break;
+
+    case SIM_COMMAND_ERRORS:
+        Sim_CAN_InjectErrors(SIM_SENSOR_BUS, command->Arg[0]);
+        break;
+
+    case SIM_COMMAND_NOACK:
+        Sim_CAN_SetNoAck(SIM_SENSOR_BUS, (Sim_Time_t)command->Arg[0] * SIM_NS_PER_MS);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+  * @brief      Host monotonic time
+  * @param[in]  None
+  * @param[out] None
+  * @retval     Seconds
+  */
+static double SIM_WallTime(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec + ((double)now.tv_nsec * 1e-9);
+}
+
+/**
+  * @brief      Print the result of the run, called once at the end of the scenario
+  * @param[in]  None
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_Report(void)
+{
+    Sim_KernelStats_t kernel;
+    Sim_CanStats_t can;
+    Sim_LpuartStats_t uart;
+    Sim_NodeResult_t node;
+    Sim_PcResult_t pc;
+    Sim_ReplayResult_t replay;
+    double wall = SIM_WallTime() - Wall_Start;
+    double now = 0.0;
+    uint8_t index = 0u;
+
+    Sim_Kernel_GetStats(&kernel);
+    Sim_CAN_GetStats(SIM_SENSOR_BUS, &can);
+    Sim_LPUART_GetStats(SIM_PC_LPUART, &uart);
+    Sim_Pc_GetResult(&pc);
+    Sim_Replay_GetResult(&replay);
+    now = (kernel.Now != 0u) ? ((double)kernel.Now * 1e-9) : 1e-9;
+
+    printf("scenario %s\n", Scenario_Path);
+    printf("time     virtual %.3f s, wall %.3f s, x%.1f\n", now, wall, (wall > 0.0) ? (now / wall) : 0.0);
+    printf("cpu      sleep %.1f %%, wake-ups %u, driver calls %llu, events %llu\n",
+           (100.0 * (double)kernel.SleepTime * 1e-9) / now, (unsigned)kernel.WakeupCnt,
+           (unsigned long long)kernel.AccessCnt, (unsigned long long)kernel.EventCnt);
+
+    for (index = 0u; index < kernel.IrqNum; index++)
+    {
+        if (kernel.Irq[index].DispatchCnt != 0u)
+        {
+            printf("irq      %-14s %u\n", kernel.Irq[index].Name, (unsigned)kernel.Irq[index].DispatchCnt);
+        }
+    }
+
+    for (index = 0u; index < SIM_NODE_NUM; index++)
+    {
+        Sim_Node_GetResult(index, &node);
+
+        if (node.Created == true)
+        {
+            printf("node     %-8s sent %u, forwarded %u, missing %u, unknown %u, confirms %u, pings %u, stops %u, disconnects %u\n",
+                   node.Name, (unsigned)node.Sent, (unsigned)node.Forwarded, (unsigned)(node.Sent - node.Forwarded),
+                   (unsigned)node.Unknown, (unsigned)node.Confirms, (unsigned)node.Pings, (unsigned)node.Stops,
+                   (unsigned)node.Disconnects);
+            printf("latency  %-8s p50 %llu us, p99 %llu us, max %llu us\n", node.Name,
+                   (unsigned long long)(node.LatencyP50 / SIM_NS_PER_US), (unsigned long long)(node.LatencyP99 / SIM_NS_PER_US),
+                   (unsigned long long)(node.LatencyMax / SIM_NS_PER_US));
+        }
+    }
+
+    printf("can0     frames %u, load %.1f %%, fw tx %u, fw rx %u, overrun %u, unmatched %u, agent drops %u, aborted %u, bus-off %u\n",
+           (unsigned)can.Frames, (100.0 * (double)can.BusyTime * 1e-9) / now, (unsigned)can.ControllerTx,
+           (unsigned)can.ControllerRx, (unsigned)can.Overrun, (unsigned)can.Unmatched, (unsigned)can.AgentDropped,
+           (unsigned)can.Aborted, (unsigned)can.BusOffCnt);
+    printf("uart1    tx %u bytes, load %.1f %%, rx %u bytes, rx overrun %u, tx overwrite %u\n",
+           (unsigned)uart.TxBytes, (100.0 * (double)uart.TxBusyTime * 1e-9) / now, (unsigned)uart.RxBytes,
+           (unsigned)uart.RxOverrun, (unsigned)uart.TxOverwrite);
+    printf("pc       lines %u, bad %u, sent %u, connection confirms %u, captures %u\n",
+           (unsigned)pc.Lines, (unsigned)pc.BadLines, (unsigned)pc.LinesSent, (unsigned)pc.ConnectConfirms,
+           (unsigned)pc.Captures);
+
+    if ((pc.ReportNodes + pc.ReportTasks) != 0u)
+    {
+        printf("report   nodes %u, tasks %u\n", (unsigned)pc.ReportNodes, (unsigned)pc.ReportTasks);
+    }
+
+    if (replay.Loaded == true)
+    {
+        printf("replay   records %u over %.3f s, can %u, uart %u, late %u, worst %llu us\n",
+               (unsigned)replay.Records, (double)replay.Span * 1e-9, (unsigned)replay.CanFrames,
+               (unsigned)replay.UartBytes, (unsigned)replay.Late, (unsigned long long)(replay.LateMax / SIM_NS_PER_US));
+    }
+    fflush(stdout);
+}
+
+/*******************************************************************************
+ * End Of File
+ ******************************************************************************/
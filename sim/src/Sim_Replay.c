@@ -0,0 +1,364 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "MID_CAN_Interface.h"
+#include "App_Capture.h"
+#include "Sim_Kernel.h"
+#include "Sim_FlexCAN.h"
+#include "Sim_LPUART.h"
+#include "Sim_Replay.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/* USR_LPUART_INS of MID_UART_Interface.c, the PC Tool port */
+#define SIM_PC_LPUART           1u
+
+/* Largest capture file, far beyond CAPTURE_BUFFER_SIZE for captures of a larger ring */
+#define SIM_REPLAY_FILE_MAX     (1u << 20u)
+
+/* Retry period of a record waiting for the bus or for the UART initialization */
+#define SIM_REPLAY_RETRY_NS     (10u * SIM_NS_PER_US)
+#define SIM_REPLAY_INIT_NS      SIM_NS_PER_MS
+
+/* Resolution of the capture, a record sent within it is on time */
+#define SIM_REPLAY_LATE_NS      SIM_NS_PER_US
+
+/* One record of the capture, in replay order */
+typedef struct
+{
+    int64_t        TimeUs;      /* From the earliest record once sorted */
+    uint32_t       Order;       /* Position in the file, keeps the order of records of the same time */
+    uint8_t        Type;        /* CAPTURE_REC_UART or CAPTURE_REC_CAN_* */
+    uint8_t        Byte;        /* UART byte */
+    bool           Follows;     /* UART byte appended to the previous one, sent one character time after it */
+    Sim_CanFrame_t Frame;       /* CAN frame */
+} SIM_ReplayRecord_t;
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+static bool SIM_ReplayParse(const uint8_t *Data, uint32_t Size);
+static int SIM_ReplayCompare(const void *Left, const void *Right);
+static void SIM_ReplayTick(void *Context, uint32_t Arg);
+static void SIM_ReplayIgnore(void *Context, const Sim_CanFrame_t *Frame);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static SIM_ReplayRecord_t Record[SIM_REPLAY_RECORD_MAX];
+static uint32_t   Record_Num = 0u;
+static uint32_t   Cursor = 0u;
+static uint8_t    Agent = 0u;
+static Sim_Time_t Start_Time = 0u;
+static uint32_t   Speed_Factor = 1u;
+static Sim_Time_t Uart_Free = 0u;     /* End of the character on the UART line */
+static Sim_ReplayResult_t Replay_Result;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+bool Sim_Replay_Load(const char *Path, Sim_Time_t Start, uint32_t Speed)
+{
+    static uint8_t data[SIM_REPLAY_FILE_MAX];
+    FILE *file = fopen(Path, "rb");
+    uint32_t size = 0u;
+    bool valid = (file != NULL) && (Replay_Result.Loaded == false);
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "%s: cannot open\n", Path);
+    }
+    else
+    {
+        size = (uint32_t)fread(data, 1u, sizeof(data), file);
+        fclose(file);
+    }
+
+    if ((valid == true) && (SIM_ReplayParse(data, size) == false))
+    {
+        fprintf(stderr, "%s: invalid record or more than %u records\n", Path, (unsigned)SIM_REPLAY_RECORD_MAX);
+        valid = false;
+    }
+
+    if ((valid == true) && (Record_Num != 0u))
+    {
+        Agent = Sim_CAN_AttachAgent(CAN_SENSOR_BUS, SIM_ReplayIgnore, NULL);
+        Start_Time = Start;
+        Speed_Factor = (Speed == 0u) ? 1u : Speed;
+        Replay_Result.Loaded = true;
+        Replay_Result.Records = Record_Num;
+        Replay_Result.Span = (Sim_Time_t)(Record[Record_Num - 1u].TimeUs - Record[0].TimeUs) * SIM_NS_PER_US;
+
+        Sim_Schedule(Start_Time, SIM_ReplayTick, NULL, 0u);
+    }
+
+    return valid;
+}
+
+void Sim_Replay_GetResult(Sim_ReplayResult_t *Result)
+{
+    *Result = Replay_Result;
+}
+
+/**
+  * @brief      Decode the records of a capture and sort them by time
+  * @note       A zero tag ends the capture, it is the padding of the last CAPTURE_DATA_ID word
+  * @param[in]  Data: Capture
+  * @param[in]  Size: Bytes of the capture
+  * @param[out] None
+  * @retval     false if a record is truncated or unknown, or the capture holds too many records
+  */
+static bool SIM_ReplayParse(const uint8_t *Data, uint32_t Size)
+{
+    SIM_ReplayRecord_t *record = NULL;
+    int64_t  timeUs = 0;
+    int64_t  first = 0;
+    uint32_t index = 0u;
+    uint32_t code = 0u;
+    uint8_t  shift = 0u;
+    uint8_t  tag = 0u;
+    uint8_t  idLength = 0u;
+    uint8_t  bodyLength = 0u;
+    uint8_t  byte = 0u;
+    bool     valid = true;
+
+    while ((valid == true) && (index < Size) && (Data[index] != 0u))
+    {
+        tag = Data[index++];
+        code = 0u;
+        shift = 0u;
+
+        do
+        {
+            byte = (index < Size) ? Data[index] : 0u;
+            code |= (uint32_t)(byte & (uint8_t)~CAPTURE_TIME_MORE) << shift;
+            shift += 7u;
+            index++;
+        } while (((byte & CAPTURE_TIME_MORE) != 0u) && (shift < (7u * CAPTURE_TIME_BYTES_MAX)));
+
+        valid = ((byte & CAPTURE_TIME_MORE) == 0u);
+
+        timeUs += ((code & CAPTURE_TIME_SIGN) != 0u) ? -(int64_t)(code >> 1u) : (int64_t)(code >> 1u);
+
+        switch (tag & CAPTURE_REC_TYPE_MASK)
+        {
+        case CAPTURE_REC_UART:
+            idLength = 0u;
+            break;
+
+        case CAPTURE_REC_CAN_STD:
+            idLength = 2u;
+            break;
+
+        case CAPTURE_REC_CAN_EXT:
+            idLength = 4u;
+            break;
+
+        case CAPTURE_REC_TIME:
+            idLength = 0u;
+            break;
+
+        default:
+            idLength = 0u;
+            valid = false;
+            break;
+        }
+
+        if ((tag & CAPTURE_REC_TYPE_MASK) == CAPTURE_REC_TIME)
+        {
+            /* Moves the time on, nothing to replay */
+            valid = valid && ((tag & CAPTURE_REC_DLC_MASK) == 0u);
+        }
+        else if ((tag & CAPTURE_REC_TYPE_MASK) == CAPTURE_REC_UART)
+        {
+            bodyLength = (tag & CAPTURE_REC_DLC_MASK) + 1u;
+            valid = valid && ((index + bodyLength) <= Size) && ((Record_Num + bodyLength) <= SIM_REPLAY_RECORD_MAX);
+        }
+        else
+        {
+            valid = valid && ((tag & CAPTURE_REC_DLC_MASK) <= 8u) && ((index + idLength + (tag & CAPTURE_REC_DLC_MASK)) <= Size);
+        }
+
+        if ((valid == true) && ((tag & CAPTURE_REC_TYPE_MASK) == CAPTURE_REC_TIME))
+        {
+            /* Do nothing */
+        }
+        else if ((valid == true) && (Record_Num < SIM_REPLAY_RECORD_MAX))
+        {
+            record = &Record[Record_Num];
+            record->TimeUs = timeUs;
+            record->Order = Record_Num;
+            record->Type = tag & CAPTURE_REC_TYPE_MASK;
+            record->Follows = false;
+
+            if (record->Type == CAPTURE_REC_UART)
+            {
+                /* One replay record per byte, the same time keeps them together once sorted */
+                for (byte = 0u; byte < bodyLength; byte++)
+                {
+                    record = &Record[Record_Num + byte];
+                    record->TimeUs = timeUs;
+                    record->Order = Record_Num + byte;
+                    record->Type = CAPTURE_REC_UART;
+                    record->Follows = (byte != 0u);
+                    record->Byte = Data[index++];
+                }
+
+                Record_Num += bodyLength - 1u;
+            }
+            else
+            {
+                record->Frame.Ext = (record->Type == CAPTURE_REC_CAN_EXT) ? 1u : 0u;
+                record->Frame.Rtr = 0u;
+                record->Frame.Dlc = tag & CAPTURE_REC_DLC_MASK;
+                record->Frame.Id = 0u;
+
+                for (byte = 0u; byte < idLength; byte++)
+                {
+                    record->Frame.Id = (record->Frame.Id << 8u) | Data[index++];
+                }
+
+                for (byte = 0u; byte < record->Frame.Dlc; byte++)
+                {
+                    record->Frame.Data[byte] = Data[index++];
+                }
+            }
+
+            Record_Num++;
+        }
+        else
+        {
+            valid = false;
+        }
+    }
+
+    if ((valid == true) && (Record_Num != 0u))
+    {
+        /* CAN frames carry their capture time on the bus, they may be older than the previous record */
+        qsort(Record, Record_Num, sizeof(Record[0]), SIM_ReplayCompare);
+        first = Record[0].TimeUs;
+
+        for (index = 0u; index < Record_Num; index++)
+        {
+            Record[index].TimeUs -= first;
+        }
+    }
+
+    return valid;
+}
+
+/**
+  * @brief      Order of two records: time, then position in the file
+  * @param[in]  Left, Right: Records
+  * @param[out] None
+  * @retval     Negative, 0 or positive as for qsort()
+  */
+static int SIM_ReplayCompare(const void *Left, const void *Right)
+{
+    const SIM_ReplayRecord_t *left = (const SIM_ReplayRecord_t *)Left;
+    const SIM_ReplayRecord_t *right = (const SIM_ReplayRecord_t *)Right;
+    int result = 0;
+
+    if (left->TimeUs != right->TimeUs)
+    {
+        result = (left->TimeUs < right->TimeUs) ? -1 : 1;
+    }
+    else
+    {
+        result = (left->Order < right->Order) ? -1 : ((left->Order > right->Order) ? 1 : 0);
+    }
+
+    return result;
+}
+
+/**
+  * @brief      Send the record at the cursor once the bus or the line takes it, then schedule the next one
+  * @param[in]  Context: Not used
+  * @param[in]  Arg: Not used
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_ReplayTick(void *Context, uint32_t Arg)
+{
+    const SIM_ReplayRecord_t *record = &Record[Cursor];
+    Sim_Time_t charTime = Sim_LPUART_GetCharTime(SIM_PC_LPUART);
+    Sim_Time_t now = Sim_Now();
+    Sim_Time_t due = Start_Time + (((Sim_Time_t)record->TimeUs * SIM_NS_PER_US) / Speed_Factor);
+    Sim_Time_t retry = 0u;
+
+    (void)Context;
+    (void)Arg;
+
+    if (record->Type == CAPTURE_REC_UART)
+    {
+        if (charTime == 0u)
+        {
+            retry = now + SIM_REPLAY_INIT_NS;
+        }
+        else if (now < Uart_Free)
+        {
+            retry = Uart_Free;
+        }
+        else
+        {
+            /* The byte completes now, the next one cannot complete before a character time */
+            Sim_LPUART_Inject(SIM_PC_LPUART, record->Byte);
+            Uart_Free = now + charTime;
+            Replay_Result.UartBytes++;
+        }
+    }
+    else
+    {
+        if (Sim_CAN_AgentSend(CAN_SENSOR_BUS, Agent, &record->Frame) == true)
+        {
+            Replay_Result.CanFrames++;
+        }
+        else
+        {
+            retry = now + SIM_REPLAY_RETRY_NS;
+        }
+    }
+
+    if (retry != 0u)
+    {
+        Sim_Schedule(retry, SIM_ReplayTick, NULL, 0u);
+    }
+    else
+    {
+        if ((record->Follows == false) && (now > (due + SIM_REPLAY_LATE_NS)))
+        {
+            Replay_Result.Late++;
+            Replay_Result.LateMax = ((now - due) > Replay_Result.LateMax) ? (now - due) : Replay_Result.LateMax;
+        }
+
+        Cursor++;
+
+        if (Cursor < Record_Num)
+        {
+            due = Start_Time + (((Sim_Time_t)Record[Cursor].TimeUs * SIM_NS_PER_US) / Speed_Factor);
+            Sim_Schedule((due > now) ? due : now, SIM_ReplayTick, NULL, 0u);
+        }
+    }
+}
+
+/**
+  * @brief      Frames of the bus are not answered, the replay is open loop
+  * @param[in]  Context: Not used
+  * @param[in]  Frame: Not used
+  * @param[out] None
+  * @retval     None
+  */
+static void SIM_ReplayIgnore(void *Context, const Sim_CanFrame_t *Frame)
+{
+    (void)Context;
+    (void)Frame;
+}
+
+/*******************************************************************************
+ * End Of File
+ ******************************************************************************/
@@ -0,0 +1,125 @@
+/*
+ * Host test of the FlexCAN bit timing table.
+ *
+ * The driver is compiled into the test, its static table and search become visible. Every
+ * entry of g_flexcanBitTimingTable must be what FLEXCAN_BitrateToTimeSeg() gives for its
+ * clock, bitrate and sample point, reach the bitrate exactly and a sample point within half
+ * a time quantum of the requested one, with an SJW no longer than either phase segment.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include "DRV_S32K144_FLEXCAN.c"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/* Sample point error allowed, in hundredths of a time quantum */
+#define TEST_SAMPLE_POINT_TOLERANCE     50u
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+static uint32_t TEST_CheckEntry(const flexcan_bit_timing_t *entry);
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+int main(void)
+{
+    uint32_t failed = 0u;
+    uint32_t i = 0u;
+
+    for (i = 0u; i < FLEXCAN_BIT_TIMING_TABLE_SIZE; i++)
+    {
+        failed += TEST_CheckEntry(&g_flexcanBitTimingTable[i]);
+    }
+
+    printf("%u entries, %u failed\n", (unsigned)FLEXCAN_BIT_TIMING_TABLE_SIZE, (unsigned)failed);
+
+    return (failed == 0u) ? 0 : 1;
+}
+
+/**
+  * @brief      Compare one table entry with the search and with the requested timing
+  * @note       Sample point and bitrate are computed back from the register values, not
+  *             taken from the search
+  * @param[in]  entry: Table entry
+  * @param[out] None
+  * @retval     1 if the entry fails, 0 otherwise
+  */
+static uint32_t TEST_CheckEntry(const flexcan_bit_timing_t *entry)
+{
+    const flexcan_time_segment_t *table = &entry->timeSeg;
+    flexcan_time_segment_t search;
+    /* Sync segment, then the register values + 1 */
+    uint32_t beforeSample = 1u + (table->propSeg + 1u) + (table->phaseSeg1 + 1u);
+    uint32_t numTq = beforeSample + (table->phaseSeg2 + 1u);
+    uint32_t bitrate = entry->clkFreq / ((table->presDiv + 1u) * numTq);
+    uint32_t error = 0u;
+    uint32_t failed = 0u;
+
+    FLEXCAN_BitrateToTimeSeg(entry->bitrate, entry->clkFreq, entry->samplePoint, &search);
+
+    printf("%8u Hz %7u bit/s SP %2u%%: %2u tq, %5.1f%%",
+           (unsigned)entry->clkFreq, (unsigned)entry->bitrate, (unsigned)entry->samplePoint,
+           (unsigned)numTq, (100.0 * beforeSample) / numTq);
+
+    if ((search.presDiv != table->presDiv) || (search.rJumpWidth != table->rJumpWidth) ||
+        (search.propSeg != table->propSeg) || (search.phaseSeg1 != table->phaseSeg1) ||
+        (search.phaseSeg2 != table->phaseSeg2))
+    {
+        printf(", search gives {%u, %u, %u, %u, %u}",
+               (unsigned)search.presDiv, (unsigned)search.rJumpWidth, (unsigned)search.propSeg,
+               (unsigned)search.phaseSeg1, (unsigned)search.phaseSeg2);
+        failed = 1u;
+    }
+    else
+    {
+        /* Do nothing */
+    }
+
+    if ((bitrate != entry->bitrate) || ((entry->clkFreq % ((table->presDiv + 1u) * numTq)) != 0u))
+    {
+        printf(", bitrate %u", (unsigned)bitrate);
+        failed = 1u;
+    }
+    else
+    {
+        /* Do nothing */
+    }
+
+    /* SJW may not exceed either phase segment */
+    if ((table->rJumpWidth > table->phaseSeg1) || (table->rJumpWidth > table->phaseSeg2))
+    {
+        printf(", SJW %u tq", (unsigned)(table->rJumpWidth + 1u));
+        failed = 1u;
+    }
+    else
+    {
+        /* Do nothing */
+    }
+
+    /* |beforeSample - numTq * SP / 100| in hundredths of a time quantum */
+    error = (100u * beforeSample > entry->samplePoint * numTq) ? ((100u * beforeSample) - (entry->samplePoint * numTq))
+                                                                : ((entry->samplePoint * numTq) - (100u * beforeSample));
+    if (error > TEST_SAMPLE_POINT_TOLERANCE)
+    {
+        printf(", sample point %u.%02u tq off", (unsigned)(error / 100u), (unsigned)(error % 100u));
+        failed = 1u;
+    }
+    else
+    {
+        /* Do nothing */
+    }
+
+    printf("%s\n", (failed != 0u) ? "  FAIL" : "");
+
+    return failed;
+}
+
+/*******************************************************************************
+ * End Of File
+ ******************************************************************************/
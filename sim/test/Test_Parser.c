@@ -0,0 +1,523 @@
+/*
+ * Host test, fuzz harness and benchmark of the UART frame parser.
+ *
+ * App_DataProcessing.c is compiled into the test with UART_PARSER_BENCHMARK set, its static
+ * NonDigitMask() and the former Parser_UARTFrame_Legacy() become visible.
+ * - NonDigitMask() must flag exactly the bytes that are not decimal digits, for every word made
+ *   of the bytes of Test_Byte[] and for TEST_RANDOM_NUM pseudo random words. "all" as first
+ *   argument checks every uint32_t word instead.
+ * - App_Parser_UARTFrame() must agree with TEST_Reference(), a character by character reading
+ *   of "<id>-<data>" with the range checks, on every corpus file given as argument and on
+ *   TEST_FUZZ_NUM inputs mutated from the corpus. Output must stay untouched on failure.
+ * - The benchmark parses the frames of APP_Benchmark_ParserUARTFrame() with both versions and
+ *   prints the host time per frame, it never fails the test.
+ *
+ * Built with -DPARSER_USE_SIMD32=1u, the test provides __usub8() and __sel() and checks the
+ * SIMD32 path of NonDigitMask() on the host, the same checks hold for both paths.
+ * Built with -DTEST_LIBFUZZER, only LLVMFuzzerTestOneInput() is kept for libFuzzer.
+ */
+
+/* clock_gettime() of POSIX.1b */
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(PARSER_USE_SIMD32) && (PARSER_USE_SIMD32 == 1u) && !defined(__ARM_FEATURE_SIMD32)
+/* APSR.GE of the DSP extension, bit n set when byte n of the last __usub8() did not borrow */
+static uint32_t Test_Ge = 0u;
+
+/* Per byte a - b, setting GE */
+static uint32_t __usub8(uint32_t a, uint32_t b)
+{
+    uint32_t result = 0u;
+    uint32_t shift = 0u;
+    uint32_t byteA = 0u;
+    uint32_t byteB = 0u;
+
+    Test_Ge = 0u;
+    for (shift = 0u; shift < 32u; shift += 8u)
+    {
+        byteA = (a >> shift) & 0xFFu;
+        byteB = (b >> shift) & 0xFFu;
+        result |= ((byteA - byteB) & 0xFFu) << shift;
+        Test_Ge |= (byteA >= byteB) ? (1u << (shift / 8u)) : 0u;
+    }
+
+    return result;
+}
+
+/* Per byte a where GE is set, b elsewhere */
+static uint32_t __sel(uint32_t a, uint32_t b)
+{
+    uint32_t result = 0u;
+    uint32_t shift = 0u;
+
+    for (shift = 0u; shift < 32u; shift += 8u)
+    {
+        result |= ((((Test_Ge >> (shift / 8u)) & 1u) != 0u) ? a : b) & (0xFFu << shift);
+    }
+
+    return result;
+}
+#endif
+
+#include "App_DataProcessing.c"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+#define TEST_RANDOM_NUM         10000000u   /* Pseudo random words checked by NonDigitMask() */
+#define TEST_FUZZ_NUM           2000000u    /* Mutated parser inputs */
+#define TEST_INPUT_MAX          300u        /* Longest input, above the UINT8_MAX the parser accepts */
+#define TEST_CORPUS_MAX         64u
+#define TEST_BENCHMARK_ROUNDS   200000u     /* Rounds of BENCHMARK_VALUE_NUM frames */
+#define TEST_NS_PER_S           1000000000u
+
+#define TEST_SENTINEL_ID        0xA5A5A5A5u
+#define TEST_SENTINEL_DATA      0x5A5Au
+
+/* Input kept for mutation */
+typedef struct
+{
+    uint8_t Data[TEST_INPUT_MAX];
+    size_t  Size;
+} TEST_Input_t;
+
+/* Parser under benchmark */
+typedef bool (*TEST_Parser_t)(const uint8_t *str, int length, ReceiveFrame_t *Output);
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+static bool TEST_Reference(const uint8_t *str, size_t size, uint32_t *id, uint32_t *data);
+#ifndef TEST_LIBFUZZER
+static uint32_t TEST_CheckMask(uint32_t word);
+static uint32_t TEST_CheckMasks(bool all);
+static uint32_t TEST_Fuzz(const TEST_Input_t *corpus, uint32_t corpusNum);
+static bool TEST_LoadInput(const char *path, TEST_Input_t *input);
+static uint32_t TEST_Random(void);
+static double TEST_Benchmark(TEST_Parser_t parser);
+static uint64_t TEST_Now(void);
+#endif
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/* Mismatches found by LLVMFuzzerTestOneInput() */
+static uint32_t Test_Failed = 0u;
+
+#ifndef TEST_LIBFUZZER
+/* Bytes around the digit range, '-', and the bytes that differ from a digit by bit 7 only */
+static const uint8_t Test_Byte[] =
+{
+    0x00u, 0x01u, '-', '/', '0', '1', '4', '5', '8', '9', ':', 'A', 0x7Fu,
+    0x80u, 0xAFu, 0xB0u, 0xB9u, 0xBAu, 0xC9u, 0xF9u, 0xFFu
+};
+
+/* Frames of APP_Benchmark_ParserUARTFrame() */
+static const char * const Test_BenchmarkFrame[] = { "160-0", "208-65535", "176-1", "161-12345", "163-20000", "144-0" };
+
+/* State of TEST_Random() */
+static uint32_t Test_Seed = 1u;
+
+/* Sum of the parsed IDs, keeps the benchmark loops from being optimized out */
+static volatile uint32_t Test_Sink = 0u;
+#endif
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+/* The UART transmit queue is not part of the test */
+QueueCheckOperation_t MID_Transmit_EnqueueBlock(const uint8_t *pData, uint16_t length)
+{
+    (void)pData;
+    (void)length;
+
+    return QUEUE_DONE_SUCCESS;
+}
+
+/**
+  * @brief      Parse one input and compare it with the reference, entry point of libFuzzer
+  * @note       The input is copied to a buffer of its exact size, a sanitizer catches any read past it
+  * @param[in]  data: Input bytes
+  * @param[in]  size: Number of input bytes
+  * @param[out] None
+  * @retval     0
+  */
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    uint8_t *copy = malloc((size != 0u) ? size : 1u);
+    ReceiveFrame_t frame = { .ID = TEST_SENTINEL_ID, .Data = TEST_SENTINEL_DATA };
+    uint32_t id = 0u;
+    uint32_t value = 0u;
+    bool expected = TEST_Reference(data, size, &id, &value);
+    bool parsed = false;
+
+    if ((copy != NULL) && (size <= (size_t)INT32_MAX))
+    {
+        memcpy(copy, data, size);
+        parsed = App_Parser_UARTFrame(copy, (int)size, &frame);
+
+        if ((parsed != expected) ||
+            ((parsed == true) && ((frame.ID != id) || (frame.Data != value))) ||
+            ((parsed == false) && ((frame.ID != TEST_SENTINEL_ID) || (frame.Data != TEST_SENTINEL_DATA))))
+        {
+            printf("\"%.*s\" (%u bytes): parser %d %u-%u, reference %d %u-%u\n", (int)size, (const char *)data,
+                   (unsigned)size, (int)parsed, (unsigned)frame.ID, (unsigned)frame.Data,
+                   (int)expected, (unsigned)id, (unsigned)value);
+            Test_Failed++;
+#ifdef TEST_LIBFUZZER
+            abort();
+#endif
+        }
+    }
+
+    free(copy);
+
+    return 0;
+}
+
+/**
+  * @brief      Read "<id>-<data>" one character at a time
+  * @param[in]  str:  Input bytes
+  * @param[in]  size: Number of input bytes, the parser takes at most UINT8_MAX
+  * @param[out] id:   ID of the frame, up to UART_FRAME_ID_MAX
+  * @param[out] data: Data of the frame, up to UART_FRAME_DATA_MAX
+  * @retval     true if the input is a frame
+  */
+static bool TEST_Reference(const uint8_t *str, size_t size, uint32_t *id, uint32_t *data)
+{
+    uint32_t value[2] = { 0u, 0u };
+    const uint32_t limit[2] = { UART_FRAME_ID_MAX, UART_FRAME_DATA_MAX };
+    uint32_t digits[2] = { 0u, 0u };
+    uint32_t number = 0u;
+    size_t idx = 0u;
+    bool valid = (size > 0u) && (size <= UINT8_MAX);
+
+    for (idx = 0u; (idx < size) && (valid == true); idx++)
+    {
+        if ((str[idx] >= '0') && (str[idx] <= '9'))
+        {
+            value[number] = (value[number] * 10u) + (uint32_t)(str[idx] - '0');
+            valid = (value[number] <= limit[number]);
+            digits[number]++;
+        }
+        else if ((str[idx] == '-') && (number == 0u) && (digits[0] != 0u))
+        {
+            number = 1u;
+        }
+        else
+        {
+            valid = false;
+        }
+    }
+
+    *id = value[0];
+    *data = value[1];
+
+    return (valid == true) && (number == 1u) && (digits[1] != 0u);
+}
+
+#ifndef TEST_LIBFUZZER
+int main(int argc, char *argv[])
+{
+    static TEST_Input_t corpus[TEST_CORPUS_MAX];
+    uint32_t corpusNum = 0u;
+    uint32_t failed = 0u;
+    bool all = false;
+    int arg = 1;
+    double legacyNs = 0.0;
+    double fastNs = 0.0;
+
+    if ((argc > 1) && (strcmp(argv[1], "all") == 0))
+    {
+        all = true;
+        arg++;
+    }
+
+    failed += TEST_CheckMasks(all);
+
+    /* Corpus first, then its mutations */
+    for (; (arg < argc) && (corpusNum < TEST_CORPUS_MAX); arg++)
+    {
+        if (TEST_LoadInput(argv[arg], &corpus[corpusNum]) == true)
+        {
+            (void)LLVMFuzzerTestOneInput(corpus[corpusNum].Data, corpus[corpusNum].Size);
+            corpusNum++;
+        }
+        else
+        {
+            printf("%s: cannot read\n", argv[arg]);
+            failed++;
+        }
+    }
+    printf("%u corpus inputs, %u failed\n", (unsigned)corpusNum, (unsigned)Test_Failed);
+
+    failed += Test_Failed;
+    failed += TEST_Fuzz(corpus, corpusNum);
+
+    legacyNs = TEST_Benchmark(Parser_UARTFrame_Legacy);
+    fastNs = TEST_Benchmark(App_Parser_UARTFrame);
+
+    printf("%s: legacy %.2f ns/frame, word at a time %.2f ns/frame, x%.2f\n",
+           (PARSER_USE_SIMD32 == 1u) ? "SIMD32" : "portable", legacyNs, fastNs, legacyNs / fastNs);
+
+    return (failed == 0u) ? 0 : 1;
+}
+
+/**
+  * @brief      Check that NonDigitMask() flags exactly the bytes of a word that are not digits
+  * @param[in]  word: Four characters
+  * @param[out] None
+  * @retval     1 if it fails, 0 otherwise
+  */
+static uint32_t TEST_CheckMask(uint32_t word)
+{
+    uint32_t mask = NonDigitMask(word);
+    uint32_t shift = 0u;
+    uint32_t failed = 0u;
+    uint8_t character = 0u;
+
+    for (shift = 0u; shift < 32u; shift += 8u)
+    {
+        character = (uint8_t)(word >> shift);
+        if ((((mask >> shift) & 0xFFu) == 0u) != ((character >= '0') && (character <= '9')))
+        {
+            failed = 1u;
+        }
+    }
+
+    if (failed == 1u)
+    {
+        printf("NonDigitMask(0x%08X) = 0x%08X\n", (unsigned)word, (unsigned)mask);
+    }
+
+    return failed;
+}
+
+/**
+  * @brief      Check NonDigitMask() on the words of Test_Byte[] and on pseudo random words
+  * @param[in]  all: true to check every uint32_t word instead
+  * @param[out] None
+  * @retval     Number of failed words
+  */
+static uint32_t TEST_CheckMasks(bool all)
+{
+    const uint32_t byteNum = (uint32_t)sizeof(Test_Byte);
+    uint64_t checked = 0u;
+    uint64_t word = 0u;
+    uint32_t failed = 0u;
+    uint32_t i = 0u;
+
+    if (all == true)
+    {
+        for (word = 0u; word <= UINT32_MAX; word++)
+        {
+            failed += TEST_CheckMask((uint32_t)word);
+        }
+        checked = word;
+    }
+    else
+    {
+        for (i = 0u; i < (byteNum * byteNum * byteNum * byteNum); i++)
+        {
+            failed += TEST_CheckMask((uint32_t)Test_Byte[i % byteNum] |
+                                     ((uint32_t)Test_Byte[(i / byteNum) % byteNum] << 8u) |
+                                     ((uint32_t)Test_Byte[(i / (byteNum * byteNum)) % byteNum] << 16u) |
+                                     ((uint32_t)Test_Byte[i / (byteNum * byteNum * byteNum)] << 24u));
+        }
+
+        for (i = 0u; i < TEST_RANDOM_NUM; i++)
+        {
+            failed += TEST_CheckMask(TEST_Random());
+        }
+        checked = (uint64_t)(byteNum * byteNum * byteNum * byteNum) + TEST_RANDOM_NUM;
+    }
+
+    printf("%s NonDigitMask: %llu words checked, %u failed\n", (PARSER_USE_SIMD32 == 1u) ? "SIMD32" : "portable",
+           (unsigned long long)checked, (unsigned)failed);
+
+    return failed;
+}
+
+/**
+  * @brief      Feed the parser with inputs mutated from the corpus
+  * @note       Each input takes a corpus entry, or the previous input, and applies a few byte
+  *             changes, insertions of digits and '-', deletions or a repetition of its start
+  * @param[in]  corpus:    Corpus inputs
+  * @param[in]  corpusNum: Number of corpus inputs
+  * @param[out] None
+  * @retval     Number of failed inputs
+  */
+static uint32_t TEST_Fuzz(const TEST_Input_t *corpus, uint32_t corpusNum)
+{
+    static const uint8_t alphabet[] = "0123456789-0123456789-/:+ \n\r";
+    TEST_Input_t input = { .Size = 0u };
+    uint32_t before = Test_Failed;
+    uint32_t iteration = 0u;
+    uint32_t change = 0u;
+    uint32_t at = 0u;
+    uint32_t len = 0u;
+
+    for (iteration = 0u; iteration < TEST_FUZZ_NUM; iteration++)
+    {
+        if ((corpusNum != 0u) && ((TEST_Random() % 4u) != 0u))
+        {
+            input = corpus[TEST_Random() % corpusNum];
+        }
+
+        for (change = 1u + (TEST_Random() % 4u); change > 0u; change--)
+        {
+            at = (input.Size != 0u) ? (TEST_Random() % (uint32_t)input.Size) : 0u;
+
+            switch (TEST_Random() % 5u)
+            {
+            case 0u:
+                /* Any byte */
+                if (input.Size != 0u)
+                {
+                    input.Data[at] = (uint8_t)TEST_Random();
+                }
+                break;
+
+            case 1u:
+                /* Digit, '-' or separator inserted */
+                if (input.Size < TEST_INPUT_MAX)
+                {
+                    memmove(&input.Data[at + 1u], &input.Data[at], input.Size - at);
+                    input.Data[at] = alphabet[TEST_Random() % (sizeof(alphabet) - 1u)];
+                    input.Size++;
+                }
+                break;
+
+            case 2u:
+                /* Byte removed */
+                if (input.Size != 0u)
+                {
+                    memmove(&input.Data[at], &input.Data[at + 1u], input.Size - at - 1u);
+                    input.Size--;
+                }
+                break;
+
+            case 3u:
+                /* Start repeated at the end, long digit runs and inputs above UINT8_MAX */
+                len = (uint32_t)((input.Size < (TEST_INPUT_MAX - input.Size)) ? input.Size : (TEST_INPUT_MAX - input.Size));
+                memcpy(&input.Data[input.Size], input.Data, len);
+                input.Size += len;
+                break;
+
+            default:
+                /* Truncated */
+                input.Size = at;
+                break;
+            }
+        }
+
+        (void)LLVMFuzzerTestOneInput(input.Data, input.Size);
+    }
+
+    printf("%u mutated inputs, %u failed\n", (unsigned)TEST_FUZZ_NUM, (unsigned)(Test_Failed - before));
+
+    return Test_Failed - before;
+}
+
+/**
+  * @brief      Read a corpus file
+  * @param[in]  path:  File name
+  * @param[out] input: File content, the first TEST_INPUT_MAX bytes
+  * @retval     true if the file is read
+  */
+static bool TEST_LoadInput(const char *path, TEST_Input_t *input)
+{
+    FILE *file = fopen(path, "rb");
+    bool loaded = false;
+
+    if (file != NULL)
+    {
+        input->Size = fread(input->Data, 1u, sizeof(input->Data), file);
+        loaded = (ferror(file) == 0);
+        (void)fclose(file);
+    }
+
+    return loaded;
+}
+
+/**
+  * @brief      Pseudo random number, the same sequence on every run
+  * @param[in]  None
+  * @param[out] None
+  * @retval     Next number
+  */
+static uint32_t TEST_Random(void)
+{
+    /* xorshift32 */
+    Test_Seed ^= Test_Seed << 13u;
+    Test_Seed ^= Test_Seed >> 17u;
+    Test_Seed ^= Test_Seed << 5u;
+
+    return Test_Seed;
+}
+
+/**
+  * @brief      Time a parser over the frames of APP_Benchmark_ParserUARTFrame()
+  * @note       With the emulated SIMD32 intrinsics the time says nothing about the target
+  * @param[in]  parser: Parser to time
+  * @param[out] None
+  * @retval     Host time per frame, in ns
+  */
+static double TEST_Benchmark(TEST_Parser_t parser)
+{
+    const uint32_t frameNum = (uint32_t)(sizeof(Test_BenchmarkFrame) / sizeof(Test_BenchmarkFrame[0]));
+    ReceiveFrame_t frame = {0u};
+    uint32_t length[sizeof(Test_BenchmarkFrame) / sizeof(Test_BenchmarkFrame[0])];
+    uint32_t round = 0u;
+    uint32_t sum = 0u;
+    uint32_t sel = 0u;
+    uint16_t idx = 0u;
+    uint64_t start = 0u;
+
+    for (sel = 0u; sel < frameNum; sel++)
+    {
+        length[sel] = (uint32_t)strlen(Test_BenchmarkFrame[sel]);
+    }
+
+    start = TEST_Now();
+    for (round = 0u; round < TEST_BENCHMARK_ROUNDS; round++)
+    {
+        for (idx = 0u; idx < BENCHMARK_VALUE_NUM; idx++)
+        {
+            sel = (idx + round) % frameNum;
+            (void)parser((const uint8_t *)Test_BenchmarkFrame[sel], (int)length[sel], &frame);
+            sum += frame.ID;
+        }
+    }
+    Test_Sink = sum;
+
+    return (double)(TEST_Now() - start) / ((double)TEST_BENCHMARK_ROUNDS * BENCHMARK_VALUE_NUM);
+}
+
+/**
+  * @brief      Monotonic host time
+  * @param[in]  None
+  * @param[out] None
+  * @retval     Time in ns
+  */
+static uint64_t TEST_Now(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((uint64_t)now.tv_sec * TEST_NS_PER_S) + (uint64_t)now.tv_nsec;
+}
+#endif
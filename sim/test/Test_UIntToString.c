@@ -0,0 +1,207 @@
+/*
+ * Host test and benchmark of the integer to text conversion of the UART frames.
+ *
+ * App_DataProcessing.c is compiled into the test with UART_ITOA_BENCHMARK set, its static
+ * UIntToString() and the former UIntToString_Legacy() become visible. Both must give the
+ * same text and length for every value below TEST_EXHAUSTIVE_LIMIT, around every power of
+ * 2 and of 10 and for TEST_RANDOM_NUM pseudo random values. "all" as argument compares the
+ * whole uint32_t range instead, it takes a few minutes.
+ * The benchmark converts the values of APP_Benchmark_UIntToString() with both versions and
+ * prints the host time per value, it never fails the test.
+ */
+
+/* clock_gettime() of POSIX.1b */
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "App_DataProcessing.c"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+#define TEST_EXHAUSTIVE_LIMIT   10000000u   /* Every value below is compared */
+#define TEST_RANDOM_NUM         10000000u   /* Pseudo random values compared above it */
+#define TEST_BENCHMARK_ROUNDS   200000u     /* Rounds of BENCHMARK_VALUE_NUM values */
+#define TEST_NS_PER_S           1000000000u
+
+/* Conversion under benchmark */
+typedef uint8_t (*TEST_Convert_t)(uint32_t value, uint8_t *buffer);
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+static uint32_t TEST_Compare(uint32_t value);
+static uint32_t TEST_CompareEdges(void);
+static double TEST_Benchmark(TEST_Convert_t convert);
+static uint64_t TEST_Now(void);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/* Sum of the converted lengths, keeps the benchmark loops from being optimized out */
+static volatile uint32_t Test_Sink = 0u;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+/* The UART transmit queue is not part of the test */
+QueueCheckOperation_t MID_Transmit_EnqueueBlock(const uint8_t *pData, uint16_t length)
+{
+    (void)pData;
+    (void)length;
+
+    return QUEUE_DONE_SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t failed = 0u;
+    uint64_t compared = 0u;
+    uint64_t value = 0u;
+    uint32_t random = 1u;
+    uint32_t i = 0u;
+    double legacyNs = 0.0;
+    double fastNs = 0.0;
+
+    if ((argc > 1) && (strcmp(argv[1], "all") == 0))
+    {
+        for (value = 0u; value <= UINT32_MAX; value++)
+        {
+            failed += TEST_Compare((uint32_t)value);
+        }
+        compared = value;
+    }
+    else
+    {
+        for (i = 0u; i < TEST_EXHAUSTIVE_LIMIT; i++)
+        {
+            failed += TEST_Compare(i);
+        }
+
+        for (i = 0u; i < TEST_RANDOM_NUM; i++)
+        {
+            random = (random * 1664525u) + 1013904223u;
+            failed += TEST_Compare(random);
+        }
+
+        failed += TEST_CompareEdges();
+        compared = (uint64_t)TEST_EXHAUSTIVE_LIMIT + TEST_RANDOM_NUM;
+    }
+
+    printf("%llu values compared, %u failed\n", (unsigned long long)compared, (unsigned)failed);
+
+    legacyNs = TEST_Benchmark(UIntToString_Legacy);
+    fastNs = TEST_Benchmark(UIntToString);
+
+    printf("legacy %.2f ns/value, digit pairs %.2f ns/value, x%.2f\n", legacyNs, fastNs, legacyNs / fastNs);
+
+    return (failed == 0u) ? 0 : 1;
+}
+
+/**
+  * @brief      Convert one value with both versions and compare the text and the length
+  * @param[in]  value: Value to convert
+  * @param[out] None
+  * @retval     1 if they differ, 0 otherwise
+  */
+static uint32_t TEST_Compare(uint32_t value)
+{
+    uint8_t legacy[MAX_VALUE_STR + 1u];
+    uint8_t fast[MAX_VALUE_STR + 1u];
+    uint8_t legacyLength = UIntToString_Legacy(value, legacy);
+    uint8_t fastLength = UIntToString(value, fast);
+    uint32_t failed = 0u;
+
+    if ((legacyLength != fastLength) || (memcmp(legacy, fast, (size_t)legacyLength + 1u) != 0))
+    {
+        printf("%u: legacy \"%s\" (%u), digit pairs \"%s\" (%u)\n", (unsigned)value,
+               (const char *)legacy, (unsigned)legacyLength, (const char *)fast, (unsigned)fastLength);
+        failed = 1u;
+    }
+
+    return failed;
+}
+
+/**
+  * @brief      Compare the values around every power of 2 and of 10, where the digit count
+  *             and the reciprocal division are most likely to go wrong
+  * @param[in]  None
+  * @param[out] None
+  * @retval     Number of failed values
+  */
+static uint32_t TEST_CompareEdges(void)
+{
+    uint32_t failed = 0u;
+    uint64_t power = 1u;
+    uint32_t shift = 0u;
+    uint32_t delta = 0u;
+
+    for (power = 10u; power <= UINT32_MAX; power *= 10u)
+    {
+        for (delta = 0u; delta <= 2u; delta++)
+        {
+            failed += TEST_Compare((uint32_t)(power - 1u + delta));
+            failed += TEST_Compare((uint32_t)(power - 1u - delta));
+        }
+    }
+
+    for (shift = 0u; shift < 32u; shift++)
+    {
+        failed += TEST_Compare((1u << shift) - 1u);
+        failed += TEST_Compare(1u << shift);
+        failed += TEST_Compare((1u << shift) + 1u);
+    }
+
+    failed += TEST_Compare(UINT32_MAX);
+
+    return failed;
+}
+
+/**
+  * @brief      Time a conversion over the values of APP_Benchmark_UIntToString()
+  * @param[in]  convert: Conversion to time
+  * @param[out] None
+  * @retval     Host time per value, in ns
+  */
+static double TEST_Benchmark(TEST_Convert_t convert)
+{
+    uint8_t buffer[MAX_VALUE_STR + 1u];
+    uint32_t value = 0u;
+    uint32_t round = 0u;
+    uint32_t sum = 0u;
+    uint16_t idx = 0u;
+    uint64_t start = TEST_Now();
+
+    for (round = 0u; round < TEST_BENCHMARK_ROUNDS; round++)
+    {
+        for (idx = 0u, value = 1u + round; idx < BENCHMARK_VALUE_NUM; idx++)
+        {
+            value = (value * 1664525u) + 1013904223u;
+            sum += convert(value >> (idx & 31u), buffer);
+        }
+    }
+    Test_Sink = sum;
+
+    return (double)(TEST_Now() - start) / ((double)TEST_BENCHMARK_ROUNDS * BENCHMARK_VALUE_NUM);
+}
+
+/**
+  * @brief      Monotonic host time
+  * @param[in]  None
+  * @param[out] None
+  * @retval     Time in ns
+  */
+static uint64_t TEST_Now(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((uint64_t)now.tv_sec * TEST_NS_PER_S) + (uint64_t)now.tv_nsec;
+}
@@ -9,19 +9,115 @@
 #include "MID_ReceiveQueue_Interface.h"
 #include "MID_TransmitQueue_Interface.h"
 #include "App_DataProcessing.h"
+#include "App_Statistics.h"
+#include "App_CanHealth.h"
+#include "App_SelfTest.h"
+#include "App_Node.h"
+#include "App_Scheduler.h"
+#include "App_Capture.h"
 
 /*******************************************************************************
  * Definition
  ******************************************************************************/
-#define MSG_LENGTH_MAX    12u
+#define MSG_LENGTH_MAX    24u
 
 #define IDLE              0u
 #define STOP              1u
 #define RUNNING           2u
 
-#define D_LOCK            0u
-#define R_LOCK            1u
-#define UNLOCK            2u
+/* PC Tool respond lock: node whose data started the PC Tool respond timeout */
+#define UNLOCK            APP_NODE_NONE
+
+/* Byte offset of the first signal in sensor data frames, refer to @defgroup Data payload layout.
+ * Current sensor nodes send one value in data word 0; nodes packing several samples per frame
+ * use CAN_PACKED_SIGNAL_START_BYTE. */
+#define SENSOR_SIGNAL_START_BYTE    CAN_LEGACY_SIGNAL_START_BYTE
+
+/* Report-on-change of the sensor samples, refer to @defgroup Report-on-change Message ID.
+ * The defaults forward every sample. The silent interval is kept below half the time base period. */
+#define DEADBAND_DEFAULT            0u
+#define MAX_SILENT_MS_DEFAULT       1000u
+#define MAX_SILENT_MS_MAX           30000u
+#define US_PER_MS                   1000u
+
+/* Dispatch table field without action */
+#define DISPATCH_NONE           0xFFu
+
+/* Timeout slot of the message node, resolved through its descriptor */
+#define DISPATCH_SLOT_DATA      0u  /* Incoming data */
+#define DISPATCH_SLOT_RESPOND   1u  /* Ping answer */
+
+/* PC Tool respond lock transition of a message */
+#define DISPATCH_LOCK_NONE      0u  /* Lock state left as is */
+#define DISPATCH_LOCK_ACQUIRE   1u  /* If unlocked: start the PC Tool respond timeout, lock to the message node */
+#define DISPATCH_LOCK_RELEASE   2u  /* If locked to the message node: stop the PC Tool respond timeout, unlock */
+
+/* Messages taken from the receive queue, one row per message ID or per message type of a node class:
+ * name, ID of the first node, ID step between two nodes, node count, handler, first sensor node,
+ * timeout slot reset and timeout slot disabled on reception, lock transition.
+ * A row of count n serves the IDs ID + k * step (k < n) of the nodes first + k, its handler gets
+ * the node of the message. Dispatch_Index[] is indexed by the low byte of the ID (the message type
+ * in extended format), it is built by App_Dispatch_Init(): the low bytes of the rows must differ,
+ * a clash leaves the IDs of the later row unhandled. */
+#define APP_DISPATCH_TABLE(X)                                                                                                                                                                                                                                                 \
+    X(DISTANCE_DATA,          CAN_MSG_ID(CAN_NODE_CLASS_DISTANCE, RX_DISTANCE_DATA_TYPE),              CAN_NODE_INST_STEP, APP_NODE_DISTANCE_NUM, App_Handle_DataFromNode,               APP_NODE_DISTANCE, DISPATCH_SLOT_DATA, DISPATCH_NONE,         DISPATCH_LOCK_ACQUIRE) \
+    X(ROTATION_DATA,          CAN_MSG_ID(CAN_NODE_CLASS_ROTATION, RX_ROTATION_DATA_TYPE),              CAN_NODE_INST_STEP, APP_NODE_ROTATION_NUM, App_Handle_DataFromNode,               APP_NODE_ROTATION, DISPATCH_SLOT_DATA, DISPATCH_NONE,         DISPATCH_LOCK_ACQUIRE) \
+    X(CONFIRM_FROM_DISTANCE,  CAN_MSG_ID(CAN_NODE_CLASS_DISTANCE, RX_CONFIRM_FROM_DISTANCE_NODE_TYPE), CAN_NODE_INST_STEP, APP_NODE_DISTANCE_NUM, App_Handle_ConfirmConnectionFromNode,  APP_NODE_DISTANCE, DISPATCH_NONE,      DISPATCH_NONE,         DISPATCH_LOCK_NONE)    \
+    X(CONFIRM_FROM_ROTATION,  CAN_MSG_ID(CAN_NODE_CLASS_ROTATION, RX_CONFIRM_FROM_ROTATION_NODE_TYPE), CAN_NODE_INST_STEP, APP_NODE_ROTATION_NUM, App_Handle_ConfirmConnectionFromNode,  APP_NODE_ROTATION, DISPATCH_NONE,      DISPATCH_NONE,         DISPATCH_LOCK_NONE)    \
+    X(CONFIRM_PING_DISTANCE,  CAN_MSG_ID(CAN_NODE_CLASS_DISTANCE, RX_CONFIRM_PING_DISTANCE_NODE_TYPE), CAN_NODE_INST_STEP, APP_NODE_DISTANCE_NUM, App_Handle_ReceivePingFromNode,        APP_NODE_DISTANCE, DISPATCH_NONE,      DISPATCH_SLOT_RESPOND, DISPATCH_LOCK_NONE)    \
+    X(CONFIRM_PING_ROTATION,  CAN_MSG_ID(CAN_NODE_CLASS_ROTATION, RX_CONFIRM_PING_ROTATION_NODE_TYPE), CAN_NODE_INST_STEP, APP_NODE_ROTATION_NUM, App_Handle_ReceivePingFromNode,        APP_NODE_ROTATION, DISPATCH_NONE,      DISPATCH_SLOT_RESPOND, DISPATCH_LOCK_NONE)    \
+    X(PC_CONNECT_FORWARDER,   PC_CONNECT_FORWARDER_ID,                                                 1u,                 1u,                    App_Handle_RequestConnectFromPcToFw,   APP_NODE_ROTATION, DISPATCH_SLOT_DATA, DISPATCH_NONE,         DISPATCH_LOCK_NONE)    \
+    X(PC_CONNECT_DISTANCE,    PC_CONNECT_DISTANCE_SENSOR_ID,                                           1u,                 1u,                    App_Handle_RequestConnectFromPcToNode, APP_NODE_DISTANCE, DISPATCH_NONE,      DISPATCH_NONE,         DISPATCH_LOCK_NONE)    \
+    X(PC_CONNECT_ROTATION,    PC_CONNECT_ROTATION_SENSOR_ID,                                           1u,                 1u,                    App_Handle_RequestConnectFromPcToNode, APP_NODE_ROTATION, DISPATCH_NONE,      DISPATCH_NONE,         DISPATCH_LOCK_NONE)    \
+    X(PC_CONFIRM_DISTANCE,    DISTANCE_DATA_ID,                                                        1u,                 APP_NODE_DISTANCE_NUM, App_Handle_ConfirmDataFromPCTool,      APP_NODE_DISTANCE, DISPATCH_NONE,      DISPATCH_NONE,         DISPATCH_LOCK_RELEASE) \
+    X(PC_CONFIRM_ROTATION,    ROTATION_DATA_ID,                                                        1u,                 APP_NODE_ROTATION_NUM, App_Handle_ConfirmDataFromPCTool,      APP_NODE_ROTATION, DISPATCH_NONE,      DISPATCH_NONE,         DISPATCH_LOCK_RELEASE) \
+    X(PC_REQUEST_STATISTICS,  PC_REQUEST_STATISTICS_ID,                                                1u,                 1u,                    App_Handle_RequestStatisticsFromPc,    APP_NODE_NONE,     DISPATCH_NONE,      DISPATCH_NONE,         DISPATCH_LOCK_NONE)    \
+    X(PC_START_SELFTEST,      PC_START_SELFTEST_ID,                                                    1u,                 1u,                    App_Handle_StartSelfTestFromPc,        APP_NODE_NONE,     DISPATCH_NONE,      DISPATCH_NONE,         DISPATCH_LOCK_NONE)    \
+    X(PC_REQUEST_DISPATCH,    PC_REQUEST_DISPATCH_TABLE_ID,                                            1u,                 1u,                    App_Handle_RequestDispatchTableFromPc, APP_NODE_NONE,     DISPATCH_NONE,      DISPATCH_NONE,         DISPATCH_LOCK_NONE)    \
+    X(PC_REQUEST_CAPTURE,     PC_REQUEST_CAPTURE_ID,                                                   1u,                 1u,                    App_Handle_RequestCaptureFromPc,       APP_NODE_NONE,     DISPATCH_NONE,      DISPATCH_NONE,         DISPATCH_LOCK_NONE)    \
+    X(PC_START_CAPTURE,       PC_START_CAPTURE_ID,                                                     1u,                 1u,                    App_Handle_StartCaptureFromPc,         APP_NODE_NONE,     DISPATCH_NONE,      DISPATCH_NONE,         DISPATCH_LOCK_NONE)    \
+    X(PC_SELECT_NODE,         PC_SELECT_NODE_ID,                                                       1u,                 1u,                    App_Handle_SelectNodeFromPc,           APP_NODE_NONE,     DISPATCH_NONE,      DISPATCH_NONE,         DISPATCH_LOCK_NONE)    \
+    X(PC_DISTANCE_DEADBAND,   PC_SET_DISTANCE_DEADBAND_ID,                                             1u,                 1u,                    App_Handle_SetDeadbandFromPc,          APP_NODE_DISTANCE, DISPATCH_NONE,      DISPATCH_NONE,         DISPATCH_LOCK_NONE)    \
+    X(PC_ROTATION_DEADBAND,   PC_SET_ROTATION_DEADBAND_ID,                                             1u,                 1u,                    App_Handle_SetDeadbandFromPc,          APP_NODE_ROTATION, DISPATCH_NONE,      DISPATCH_NONE,         DISPATCH_LOCK_NONE)    \
+    X(PC_DISTANCE_MAX_SILENT, PC_SET_DISTANCE_MAX_SILENT_ID,                                           1u,                 1u,                    App_Handle_SetMaxSilentFromPc,         APP_NODE_DISTANCE, DISPATCH_NONE,      DISPATCH_NONE,         DISPATCH_LOCK_NONE)    \
+    X(PC_ROTATION_MAX_SILENT, PC_SET_ROTATION_MAX_SILENT_ID,                                           1u,                 1u,                    App_Handle_SetMaxSilentFromPc,         APP_NODE_ROTATION, DISPATCH_NONE,      DISPATCH_NONE,         DISPATCH_LOCK_NONE)
+
+#define DISPATCH_ROW_ENUM(name, id, step, count, handler, node, resetSlot, disableSlot, lockAction)   DISPATCH_ROW_##name,
+#define DISPATCH_ROW_ENTRY(name, id, step, count, handler, node, resetSlot, disableSlot, lockAction)  { (id), (step), (count), handler, (node), (resetSlot), (disableSlot), (lockAction) },
+
+/* Row of every message in Dispatch_Table[] */
+enum
+{
+    APP_DISPATCH_TABLE(DISPATCH_ROW_ENUM)
+    DISPATCH_ROW_NUM
+};
+
+/* One row of the dispatch table */
+typedef struct
+{
+    uint32_t Id;                    /* CAN identifier or UART frame ID of the first node */
+    uint32_t Step;                  /* ID of the next node minus ID of the node, 0 in standard format */
+    uint8_t  Count;                 /* Nodes served by the row */
+    void   (*Handler)(uint8_t Node);/* Runs on Processing_Msg */
+    uint8_t  Node;                  /* First sensor node of the row, APP_NODE_NONE if none */
+    uint8_t  ResetCounter;          /* Timeout slot reset on reception, DISPATCH_SLOT_* or DISPATCH_NONE */
+    uint8_t  DisableGate;           /* Timeout slot disabled on reception, DISPATCH_SLOT_* or DISPATCH_NONE */
+    uint8_t  LockAction;            /* DISPATCH_LOCK_NONE, DISPATCH_LOCK_ACQUIRE or DISPATCH_LOCK_RELEASE */
+} App_DispatchEntry_t;
+
+/* Runtime state of one sensor node */
+typedef struct
+{
+    uint16_t    Value;              /* Latest sample */
+    uint16_t    ReportedValue;      /* Latest sample sent to the PC Tool ... */
+    uint32_t    ReportedTime;       /* ... and its arrival time, in time base ticks */
+    bool        Reported;           /* ReportedValue is valid */
+    uint16_t    Deadband;           /* Change forwarded at least, 0: every sample */
+    uint16_t    MaxSilentMs;        /* Longest time without a forwarded sample while samples arrive */
+    uint8_t     TimeoutNotified;    /* 1 once the disconnection was sent to the PC Tool */
+    UARTFrame_t ConfirmFrame;       /* Constant connection confirmation, composed once */
+    UARTFrame_t DisconnectFrame;    /* Constant disconnection notice, composed once */
+} App_NodeState_t;
 
 /*******************************************************************************
  * Prototypes
@@ -30,17 +126,34 @@ static void App_CANReceiveNotification(void);
 static void App_UART_TxNotification(void);
 static void App_UART_RxNotification(void);
 
-static void App_Handle_DataFromDistanceSensor(void);
-static void App_Handle_DataFromRotationSensor(void);
-static void App_Handle_ConfirmConnectionFromDistanceSensor(void);
-static void App_Handle_ConfirmConnectionFromRotationSensor(void);
-static void App_Handle_RequestConnectFromPcToFw(void);
-static void App_Handle_RequestConnectFromPcToDistanceNode(void);
-static void App_Handle_RequestConnectFromPcToRotationNode(void);
-static void App_Handle_ReceivePingFromDistanceNode(void);
-static void App_Handle_ReceivePingFromRotationNode(void);
-static void App_Handle_ConfirmDataFromPCTool(void);
+static void App_Handle_DataFromNode(uint8_t Node);
+static void App_Handle_ConfirmConnectionFromNode(uint8_t Node);
+static void App_Handle_RequestConnectFromPcToFw(uint8_t Node);
+static void App_Handle_RequestConnectFromPcToNode(uint8_t Node);
+static void App_Handle_ReceivePingFromNode(uint8_t Node);
+static void App_Handle_ConfirmDataFromPCTool(uint8_t Node);
+static void App_Handle_RequestStatisticsFromPc(uint8_t Node);
+static void App_Handle_StartSelfTestFromPc(uint8_t Node);
+static void App_Handle_RequestDispatchTableFromPc(uint8_t Node);
+static void App_Handle_RequestCaptureFromPc(uint8_t Node);
+static void App_Handle_StartCaptureFromPc(uint8_t Node);
+static void App_Handle_SetDeadbandFromPc(uint8_t Node);
+static void App_Handle_SetMaxSilentFromPc(uint8_t Node);
+static void App_Handle_SelectNodeFromPc(uint8_t Node);
+static uint8_t App_SelectedNode(uint8_t Node);
+static void App_SendNodeSelect(uint8_t Node);
+static bool App_Deadband_Pass(uint8_t Node, uint16_t Value, uint32_t Time);
+static uint8_t App_DispatchSlot(uint8_t Node, uint8_t Slot);
+static void App_Dispatch_Init(void);
+static void App_Dispatch(void);
+static void App_PrepareFrames(void);
+#if (UART_ITOA_BENCHMARK == 1u) || (UART_PARSER_BENCHMARK == 1u)
+static void App_ReportBenchmark(void);
+#endif
 static void App_Handle_TimeoutEvent(void);
+static void App_Task_Forward(void);
+static void App_Task_StatsReport(void);
+static void App_Task_DispatchReport(void);
 
 /*******************************************************************************
  * Variables
@@ -49,14 +162,13 @@ static void App_Handle_TimeoutEvent(void);
 /* Array stores UART frame from PC Tool */
 static uint8_t Receive_Data_Str[MSG_LENGTH_MAX] = {0};
 static uint8_t Receive_Data_Idx                 = 0u;
+static bool    Receive_Data_Overflow            = false;  /* Frame longer than MSG_LENGTH_MAX, dropped at its end */
 
-/* Array stores UART frame to transmit PC Tool */
-static uint8_t Transmit_Data_Str[MSG_LENGTH_MAX] = {0};
-static uint8_t Transmit_Data_Idx                 = 0u;
+/* Constant reply to the connection request of the PC Tool, composed once */
+static UARTFrame_t Confirm_Forwarder_Frame;
 
-/* Lastest sensor value */
-static uint16_t Current_D_Value = 0u;
-static uint16_t Current_R_Value = 0u;
+/* Latest sample and timeout notification of every sensor node */
+static App_NodeState_t Node_Runtime[APP_NODE_NUM] = {0};
 
 /* Sensor node operation status */
 static uint8_t Node_State = IDLE;
@@ -66,9 +178,38 @@ static uint8_t PcTool_Timer_Lock_State = UNLOCK;
 
 static ReceiveFrame_t Processing_Msg = {0};
 
-/*   Variables to track if timeout notification has been sent to user layer for Distance and Rotation sensor node */
-static bool g_Dnode_isTimeoutNotified = false; /* Distance sensor node timeout notification flag */
-static bool g_Rnode_isTimeoutNotified = false; /* Rotation sensor node timeout notification flag */
+/* Every sample of Processing_Msg was held back by the deadband, the PC Tool has nothing to confirm */
+static bool Processing_Suppressed = false;
+
+/* Instance offset of the node the next PC Tool command of a node class applies to, refer to PC_SELECT_NODE_ID */
+static uint8_t Pc_Node_Select = 0u;
+
+#if (CAN_PING_MODE == CAN_PING_REMOTE)
+/* Node waiting for the answer to a remote request, by first node of the class, APP_NODE_NONE if none */
+static uint8_t Remote_Ping_Node[APP_NODE_NUM];
+#endif
+
+/* Message handlers and their timeout bookkeeping, refer to APP_DISPATCH_TABLE */
+static const App_DispatchEntry_t Dispatch_Table[DISPATCH_ROW_NUM] =
+{
+    APP_DISPATCH_TABLE(DISPATCH_ROW_ENTRY)
+};
+
+/* Row + 1 of Dispatch_Table[] by low byte of the message ID, 0 if not handled, refer to App_Dispatch_Init() */
+static uint8_t Dispatch_Index[256] = {0u};
+
+/* Tasks of the main loop by priority, refer to @defgroup Task slot */
+static const App_TaskDesc_t Task_Table[APP_TASK_NUM] =
+{
+    [APP_TASK_FORWARD]         = { .Run = App_Task_Forward,           .IsBusy = NULL,                   .Events = NOTIFY_EVENT_RECEIVE,                     .PeriodMs = 0u },
+    [APP_TASK_TX_DEADLINE]     = { .Run = MID_CAN_ProcessTxDeadlines, .IsBusy = NULL,                   .Events = NOTIFY_EVENT_CAN_TX | NOTIFY_EVENT_ALARM, .PeriodMs = TIMER_TICK_MS },
+    [APP_TASK_CAN_HEALTH]      = { .Run = App_CanHealth_Process,      .IsBusy = App_CanHealth_IsBusy,   .Events = NOTIFY_EVENT_CAN_STATUS,                  .PeriodMs = TIMER_TICK_MS },
+    [APP_TASK_TIMEOUT]         = { .Run = App_Handle_TimeoutEvent,    .IsBusy = NULL,                   .Events = NOTIFY_EVENT_TIMEOUT,                     .PeriodMs = 0u },
+    [APP_TASK_SELFTEST]        = { .Run = App_SelfTest_Process,       .IsBusy = App_SelfTest_IsRunning, .Events = 0u,                                       .PeriodMs = 0u },
+    [APP_TASK_STATS_REPORT]    = { .Run = App_Task_StatsReport,       .IsBusy = NULL,                   .Events = NOTIFY_EVENT_UART_ROOM,                   .PeriodMs = STATS_REPORT_PERIOD_MS },
+    [APP_TASK_DISPATCH_REPORT] = { .Run = App_Task_DispatchReport,    .IsBusy = NULL,                   .Events = 0u,                                       .PeriodMs = 0u },
+    [APP_TASK_CAPTURE_DUMP]    = { .Run = App_Capture_Process,        .IsBusy = NULL,                   .Events = NOTIFY_EVENT_UART_ROOM,                   .PeriodMs = TIMER_TICK_MS },
+};
 
 /*******************************************************************************
  * Code
@@ -76,9 +217,11 @@ static bool g_Rnode_isTimeoutNotified = false; /* Rotation sensor node timeout n
 
 int main(void)
 {
-    QueueCheckOperation_t status = QUEUE_DONE_FAILED;
+    uint8_t node = 0u;
 
     /* System initialization */
+    App_Node_Init();
+    App_Dispatch_Init();
     MID_Clock_Init();
     MID_CAN_Init();
     MID_Timer_Init();
@@ -86,10 +229,15 @@ int main(void)
     MID_UART_Init();
     MID_Transmit_Queue_Init();
     MID_Receive_Queue_Init();
+    App_Stats_Init();
+    App_Scheduler_Init(Task_Table);
+    App_PrepareFrames();
+    App_Capture_Start();
 
     /* Register Notification */
     MID_CAN_RegisterRxNotificationCallback(App_CANReceiveNotification);
     MID_UART_RegisterNotificationCallback(App_UART_TxNotification, App_UART_RxNotification);
+    App_CanHealth_Init();
 
     /* Allow notification */
     MID_EnableNotification();
@@ -98,142 +246,19 @@ int main(void)
     MID_Timer_StartTimer();
 
     /* Enable timeout gate for data message */
-    MID_TimeoutService_CounterCmd(D_NODE_COMMINGDATA_GATE, ENABLE);
-    MID_TimeoutService_CounterCmd(R_NODE_COMMINGDATA_GATE, ENABLE);
-    MID_TimeoutService_CounterCmd(PC_RESPOND_DATA_CNT, ENABLE);
-
-    while(1)
+    for (node = 0u; node < APP_NODE_NUM; node++)
     {
+        MID_TimeoutService_CounterCmd(App_Node_GetDesc(node)->DataTimeout, ENABLE);
+    }
+    MID_TimeoutService_CounterCmd(PC_RESPOND_DATA_GATE, ENABLE);
 
-        status = MID_Receive_DeQueue(&Processing_Msg);
-
-        if(status == QUEUE_DONE_SUCCESS)
-        {
-            switch (Processing_Msg.ID)
-            {
-            /* If received data message from Distance sensor node */
-            case RX_DISTANCE_DATA_ID:
-                /* Reset timeout counter */
-                MID_TimeoutService_ResetCounter(D_NODE_COMMINGDATA_CNT);
-
-                /* Send confirm message to Distance sensor node */
-                App_Handle_DataFromDistanceSensor();
-
-                if(PcTool_Timer_Lock_State == UNLOCK)
-                {
-                    /* Start counter to calculate timeout for respond data message from Pc Tool */
-                    MID_TimeoutService_CounterCmd(PC_RESPOND_DATA_GATE, ENABLE);
-                    PcTool_Timer_Lock_State = D_LOCK;
-                }
-
-                break;
-
-            /* If received data message from Rotation sensor node */
-            case RX_ROTATION_DATA_ID:
-
-                /* Send confirm message to Rotation sensor node */
-                App_Handle_DataFromRotationSensor();
-
-                /* Reset timeout counter */
-                MID_TimeoutService_ResetCounter(R_NODE_COMMINGDATA_CNT);
-
-                if(PcTool_Timer_Lock_State == UNLOCK)
-                {
-                    /* Start counter to calculate timeout for respond data message from Pc Tool */
-                    MID_TimeoutService_CounterCmd(PC_RESPOND_DATA_GATE, ENABLE);
-                    PcTool_Timer_Lock_State = R_LOCK;
-                }
-
-                break;
-
-            /* If receive confirm request connection message to intialize PC Tool */
-            case RX_CONFIRM_FROM_DISTANCE_NODE_ID:
-
-                /* Send confirm connection to PC tool */
-                App_Handle_ConfirmConnectionFromDistanceSensor();
-                break;
-
-            /* If receive confirm request connection message to intialize PC Tool */
-            case RX_CONFIRM_FROM_ROTATION_NODE_ID:
-
-                /* Send confirm connection to PC tool */
-                App_Handle_ConfirmConnectionFromRotationSensor();
-                break;
-
-            /* If receive confirm ping message from distance node */
-            case RX_CONFIRM_PING_DISTANCE_NODE_ID:
-
-                App_Handle_ReceivePingFromDistanceNode();
-
-                /* Disable timeout counter */
-                MID_TimeoutService_CounterCmd(D_NODE_RESPONDCONNECTION_GATE, DISABLE);
-
-                g_Dnode_isTimeoutNotified = false;
-                break;
-
-            /* If receive confirm ping message from rotation node */
-            case RX_CONFIRM_PING_ROTATION_NODE_ID:
-                App_Handle_ReceivePingFromRotationNode();
-
-                /* Disable timeout counter */
-                MID_TimeoutService_CounterCmd(R_NODE_RESPONDCONNECTION_GATE, DISABLE);
-
-                g_Rnode_isTimeoutNotified = false;
-                break;
-
-            /* If received request connection message from PC Tool to itself */
-            case PC_CONNECT_FORWARDER_ID:
-                /* Reset timeout counter */
-                MID_TimeoutService_ResetCounter(R_NODE_COMMINGDATA_CNT);
-
-                App_Handle_RequestConnectFromPcToFw();
-                break;
-
-            /* If received request connection message from PC Tool to distance sensor node */
-            case PC_CONNECT_DISTANCE_SENSOR_ID:
-                App_Handle_RequestConnectFromPcToDistanceNode();
-                break;
-
-            /* If received request connection message from PC Tool to rotation sensor node */
-            case PC_CONNECT_ROTATION_SENSOR_ID:
-
-                App_Handle_RequestConnectFromPcToRotationNode();
-                break;
-
-            /* If received confirm data from PC Tools */
-            case DISTANCE_DATA_ID:
-                App_Handle_ConfirmDataFromPCTool();
-
-                if (PcTool_Timer_Lock_State == D_LOCK)
-                {
-                    /* Disable timeout counter */
-                    MID_TimeoutService_CounterCmd(PC_RESPOND_DATA_GATE, DISABLE);
-                    PcTool_Timer_Lock_State = UNLOCK;
-                }
-
-                break;
-
-            /* If received confirm data from PC Tools */
-            case ROTATION_DATA_ID:
-                App_Handle_ConfirmDataFromPCTool();
-
-                if (PcTool_Timer_Lock_State == R_LOCK)
-                {
-                    /* Disable timeout counter */
-                    MID_TimeoutService_CounterCmd(PC_RESPOND_DATA_GATE, DISABLE);
-                    PcTool_Timer_Lock_State = UNLOCK;
-                }
-
-                break;
+#if (UART_ITOA_BENCHMARK == 1u) || (UART_PARSER_BENCHMARK == 1u)
+    App_ReportBenchmark();
+#endif
 
-            default:
-                break;
-            }
-        }
+    /* Run the tasks, sleep while none is ready */
+    App_Scheduler_Run();
 
-        /* Handle timeout function */
-        App_Handle_TimeoutEvent();
-    }
     return 0;
 }
 
@@ -260,30 +285,53 @@ static void App_CANReceiveNotification(void)
     /* Struture contain Data was converted from CAN Message to be used as param input of MID_Receive_EnQueue()*/
     ReceiveFrame_t l_Data_Receive = {0U};
 
+    const App_NodeDesc_t *desc = NULL;
+    uint8_t mailboxes[3] = {0u};
+    uint8_t node = 0u;
     uint8_t index = 0u;
 
-    /* Array of mailbox IDs and their associated data */
-    static const uint8_t messageBoxes[] =
-    {
-        RX_DISTANCE_DATA_MB,
-        RX_ROTATION_DATA_MB,
-        RX_CONFIRM_FROM_DISTANCE_NODE_MB,
-        RX_CONFIRM_FROM_ROTATION_NODE_MB,
-        RX_CONFIRM_PING_DISTANCE_NODE_MB,
-        RX_CONFIRM_PING_ROTATION_NODE_MB,
-    };
-
-    for (index = 0u; index < (sizeof(messageBoxes) / sizeof(messageBoxes[0])); index++)
+    /* The receive mailboxes are shared by the nodes of a class, the first node reads them */
+    for (node = 0u; node < APP_NODE_NUM; node++)
     {
-        if (MID_CheckCommingMessageEvent(messageBoxes[index]) == CAN_MSG_RECEIVED)
+        desc = App_Node_GetDesc(node);
+        if (desc->First == node)
         {
-            MID_CAN_ReceiveMessage(messageBoxes[index], &CAN_Data_Receive);
-
-            l_Data_Receive.ID = CAN_Data_Receive.ID;
-            l_Data_Receive.Data = CAN_Data_Receive.Data;
+            mailboxes[0] = desc->DataMb;
+            mailboxes[1] = desc->ConnectConfirmMb;
+            mailboxes[2] = desc->PingAnswerMb;
 
-            MID_ClearMessageCommingEvent(messageBoxes[index]);
-            (void)MID_Receive_EnQueue(&l_Data_Receive);
+            for (index = 0u; index < (sizeof(mailboxes) / sizeof(mailboxes[0])); index++)
+            {
+                if (MID_CheckCommingMessageEvent(mailboxes[index]) == CAN_MSG_RECEIVED)
+                {
+                    MID_CAN_ReceiveMessage(mailboxes[index], &CAN_Data_Receive);
+
+                    if (CAN_Data_Receive.Overrun == 1u)
+                    {
+                        App_Stats_RecordLoss(CAN_Data_Receive.ID);
+                    }
+                    else
+                    {
+                        /* Do nothing */
+                    }
+
+                    l_Data_Receive.ID = CAN_Data_Receive.ID;
+                    l_Data_Receive.Data = CAN_Data_Receive.Data;
+                    l_Data_Receive.Length = CAN_Data_Receive.Length;
+                    memcpy(l_Data_Receive.Payload, CAN_Data_Receive.Payload, CAN_MAX_DATA_LENGTH);
+
+                    /* Move the hardware capture onto the 32-bit time base */
+                    l_Data_Receive.TimeStamp = MID_Timer_GetTimestamp() - MID_Timer_UsToTicks(CAN_Data_Receive.AgeUs);
+                    App_Capture_RecordCan(&CAN_Data_Receive, l_Data_Receive.TimeStamp);
+
+                    MID_ClearMessageCommingEvent(mailboxes[index]);
+                    (void)MID_Receive_EnQueue(&l_Data_Receive);
+                }
+                else
+                {
+                    /* Do nothing */
+                }
+            }
         }
         else
         {
@@ -310,6 +358,16 @@ static void App_UART_TxNotification(void)
 
     if (status == QUEUE_DONE_SUCCESS)
     {
+        /* The queue passes every level on its way down, the bulk senders resume once per drain */
+        if (MID_Transmit_GetCount() == UART_BULK_RESUME_LEVEL)
+        {
+            MID_Notification_Raise(NOTIFY_EVENT_UART_ROOM);
+        }
+        else
+        {
+            /* Do nothing */
+        }
+
         if (data != '\0')
         {
             MID_UART_SendData(data);
@@ -331,7 +389,8 @@ static void App_UART_TxNotification(void)
  * This function is triggered when a UART receive interrupt occurs. It retrieves
  * incoming UART data byte by byte, stores it in a buffer, and processes the data
  * when the end of a frame (newline character) is detected. The processed data is
- * enqueued for further handling.
+ * enqueued for further handling. Frames too long for the buffer or rejected by
+ * the parser are dropped.
  *
  * @param None
  * @retval None
@@ -343,352 +402,788 @@ static void App_UART_RxNotification(void)
 
     /* Get 1 byte message from UART*/
     l_UART_Received_Data = MID_UART_ReceiveData();
+    App_Capture_RecordUart(l_UART_Received_Data);
 
     /* Check if end of frame (\n character) */
     if(l_UART_Received_Data != '\n')
     {
-        Receive_Data_Str[Receive_Data_Idx] = l_UART_Received_Data;
-        Receive_Data_Idx++;
+        if (Receive_Data_Idx < MSG_LENGTH_MAX)
+        {
+            Receive_Data_Str[Receive_Data_Idx] = l_UART_Received_Data;
+            Receive_Data_Idx++;
+        }
+        else
+        {
+            Receive_Data_Overflow = true;
+        }
     }
     else
     {
-        /* Convert string to number */
-        App_Parser_UARTFrame(Receive_Data_Str, Receive_Data_Idx, &l_Data_Receive);
-
-        /* Push to receive Queue */
-        (void)MID_Receive_EnQueue(&l_Data_Receive);
+        /* Convert string to number, push to receive Queue only when valid */
+        if ((Receive_Data_Overflow == false) && (App_Parser_UARTFrame(Receive_Data_Str, Receive_Data_Idx, &l_Data_Receive) == true))
+        {
+            l_Data_Receive.TimeStamp = MID_Timer_GetTimestamp();
+            (void)MID_Receive_EnQueue(&l_Data_Receive);
+        }
+        else
+        {
+            /* Do nothing */
+        }
 
         /* Clear data index */
         Receive_Data_Idx = 0u;
+        Receive_Data_Overflow = false;
     }
 }
 
 /**
-  * @brief Handles data processing and communication for the distance sensor.
+  * @brief Handles data processing and communication for a sensor node.
   *
-  * This function manages data received from the distance sensor by sending a
-  * confirmation message to the sensor node and forwarding the processed data
-  * to the UART for transmission.
+  * This function manages data received from a sensor node by sending a
+  * confirmation message to the node and forwarding the samples of the
+  * frame the deadband lets through to the UART for transmission. The
+  * self-test measures the whole forwarding path, its samples bypass the
+  * deadband.
   *
-  * @param None
+  * @param Node Sensor node the data comes from
   * @return None
   */
-static void App_Handle_DataFromDistanceSensor(void)
+static void App_Handle_DataFromNode(uint8_t Node)
 {
-    /* Send confirm message to distance sensor node */
-    MID_CAN_SendCANMessage(TX_CONFIRM_DISTANCE_DATA_MB, TX_MSG_CONFIRM_DATA);
+    const App_NodeDesc_t *desc = App_Node_GetDesc(Node);
+    uint16_t l_Signals[CAN_MAX_SIGNALS] = {0u};
+    uint8_t  l_SignalCnt = 0u;
+    uint8_t  l_ForwardCnt = 0u;
+    uint8_t  index = 0u;
 
-    Current_D_Value = Processing_Msg.Data;
-    /**/
-    APP_Compose_UARTFrame(DISTANCE_DATA_ID, Processing_Msg.Data, Transmit_Data_Str);
+    /* Send confirm message to the sensor node */
+    MID_CAN_SendCANMessageToId(desc->ConfirmDataMb, desc->ConfirmDataId, TX_MSG_CONFIRM_DATA, CAN_TX_CONFIRM_DEADLINE_US);
 
-    while (Transmit_Data_Str[Transmit_Data_Idx] != '\0')
+    /* A frame may carry several samples, forward each of them in order */
+    l_SignalCnt = MID_CAN_UnpackSignals(Processing_Msg.Payload, Processing_Msg.Length, SENSOR_SIGNAL_START_BYTE, l_Signals);
+
+    for (index = 0u; index < l_SignalCnt; index++)
     {
-        MID_Transmit_Enqueue(Transmit_Data_Str[Transmit_Data_Idx]);
-        Transmit_Data_Idx++;
+        Node_Runtime[Node].Value = l_Signals[index];
+
+        if ((App_SelfTest_IsRunning() == true) ||
+            (App_Deadband_Pass(Node, l_Signals[index], Processing_Msg.TimeStamp) == true))
+        {
+            APP_Send_UARTFrame(desc->UartDataId, l_Signals[index]);
+            l_ForwardCnt++;
+
+            App_Stats_RecordForward(Node, Processing_Msg.TimeStamp, MID_Timer_GetTimestamp());
+        }
+        else
+        {
+            App_Stats_RecordSuppressed(Node);
+        }
+    }
+
+    if (l_ForwardCnt != 0u)
+    {
+        /* Enable Tx interrupt to send */
+        MID_UART_SetTxInterrupt(true);
+    }
+    else
+    {
+        Processing_Suppressed = true;
     }
-    MID_UART_SetTxInterrupt(true);
-    Transmit_Data_Idx = 0u;
 }
 
 /**
-  * @brief Handles data processing and communication for the rotation sensor.
+  * @brief Checks whether a sample of a sensor node goes to the PC Tool.
   *
-  * This function manages data received from the rotation sensor by sending a
-  * confirmation message to the sensor node and forwarding the processed data
-  * to the UART for transmission.
+  * A sample is forwarded when it is the first one, when it differs from
+  * the last forwarded sample by the deadband or more, or when the last
+  * forwarded sample is older than the maximum silent interval.
   *
-  * @param None
-  * @retval None
+  * @param Node  Sensor node of the sample
+  * @param Value Sample
+  * @param Time  Arrival time of the sample, in time base ticks
+  * @return true if the sample is forwarded, it becomes the reference
   */
-static void App_Handle_DataFromRotationSensor(void)
+static bool App_Deadband_Pass(uint8_t Node, uint16_t Value, uint32_t Time)
 {
-    /* Send confirm message to rotation sensor */
-    MID_CAN_SendCANMessage(TX_CONFIRM_ROTATION_DATA_MB, TX_MSG_CONFIRM_DATA);
+    App_NodeState_t *state = &Node_Runtime[Node];
+    uint16_t change = (Value > state->ReportedValue) ? (uint16_t)(Value - state->ReportedValue) : (uint16_t)(state->ReportedValue - Value);
+    bool pass = (state->Reported == false) || (change >= state->Deadband) ||
+                ((Time - state->ReportedTime) >= MID_Timer_UsToTicks((uint32_t)state->MaxSilentMs * US_PER_MS));
 
-    Current_R_Value = Processing_Msg.Data;
-    /* Convert message for uart transfer */
-    APP_Compose_UARTFrame(ROTATION_DATA_ID, Processing_Msg.Data, Transmit_Data_Str);
-    /* Push message to transmit queue and enable Tx interrupt to send */
-    while(Transmit_Data_Str[Transmit_Data_Idx] != '\0')
+    if (pass == true)
     {
-        MID_Transmit_Enqueue(Transmit_Data_Str[Transmit_Data_Idx]);
-        Transmit_Data_Idx++;
+        state->ReportedValue = Value;
+        state->ReportedTime  = Time;
+        state->Reported      = true;
     }
-    MID_UART_SetTxInterrupt(true);
-    Transmit_Data_Idx = 0u;
+
+    return pass;
 }
 
 /**
-  * @brief Handles confirmation of connection from the distance sensor node.
+  * @brief Handles confirmation of connection from a sensor node.
   *
-  * This function processes a confirmation connection message received from the
-  * distance sensor node and forwards a corresponding confirmation message to the PC.
+  * This function processes a confirmation connection message received from a
+  * sensor node and forwards a corresponding confirmation message to the PC.
   *
-  * @param None
+  * @param Node Sensor node confirming the connection
   * @return None
   */
-static void App_Handle_ConfirmConnectionFromDistanceSensor(void)
+static void App_Handle_ConfirmConnectionFromNode(uint8_t Node)
 {
-    /* FW receive Confirm Connection msg from Distance node */
     /* FW send Confirm Connection to PC */
-    APP_Compose_UARTFrame(PC_CONNECT_DISTANCE_SENSOR_ID, CONFIRM_CONNECTION_DATA, Transmit_Data_Str);
-    /* Push message to transmit queue and enable Tx interrupt to send */
-    while(Transmit_Data_Str[Transmit_Data_Idx] != '\0')
-    {
-        MID_Transmit_Enqueue(Transmit_Data_Str[Transmit_Data_Idx]);
-        Transmit_Data_Idx++;
-    }
+    App_SendNodeSelect(Node);
+    APP_Emit_UARTFrame(&Node_Runtime[Node].ConfirmFrame);
+    MID_UART_SetTxInterrupt(true);
+}
+
+/**
+  * @brief  Handles the connection request from PC to Forwarder (FW).
+  *         This function composes a confirmation frame, enqueues it for transmission,
+  * and enables the UART transmission interrupt to send the data.
+  * @param  Node Not used
+  * @retval None
+  */
+static void App_Handle_RequestConnectFromPcToFw(uint8_t Node)
+{
+    (void)Node;
+
+    /* FW send Confirm Connection between itself and PC */
+    APP_Emit_UARTFrame(&Confirm_Forwarder_Frame);
     MID_UART_SetTxInterrupt(true);
-    Transmit_Data_Idx = 0u;
 }
 
 /**
-  * @brief Handles confirmation of connection from the rotation sensor node.
+  * @brief Handles a connection request from the PC to a sensor node.
   *
-  * This function processes a confirmation connection message received from the
-  * rotation sensor node and forwards a corresponding confirmation message to the PC.
+  * This function sends a CAN message to request a connection with the
+  * sensor node selected in the class, initiated by the PC.
   *
-  * @param None
+  * @param Node First sensor node of the class
   * @return None
   */
-static void App_Handle_ConfirmConnectionFromRotationSensor(void)
+static void App_Handle_RequestConnectFromPcToNode(uint8_t Node)
 {
-    /* FW receive Confirm Connection msg from Rotation node */
-    /* FW send Confirm Connection to PC */
-    APP_Compose_UARTFrame(PC_CONNECT_ROTATION_SENSOR_ID, CONFIRM_CONNECTION_DATA, Transmit_Data_Str);
-    /* Push message to transmit queue and enable Tx interrupt to send */
-    while(Transmit_Data_Str[Transmit_Data_Idx] != '\0')
+    const App_NodeDesc_t *desc = NULL;
+    uint8_t node = App_SelectedNode(Node);
+
+    if (node != APP_NODE_NONE)
     {
-        MID_Transmit_Enqueue(Transmit_Data_Str[Transmit_Data_Idx]);
-        Transmit_Data_Idx++;
+        /* Send connection request to the sensor node */
+        desc = App_Node_GetDesc(node);
+        MID_CAN_SendCANMessageToId(desc->ConnectMb, desc->ConnectId, TX_MSG_REQUEST_DATA, CAN_TX_DEADLINE_NONE);
+    }
+    else
+    {
+        /* Do nothing */
     }
-    MID_UART_SetTxInterrupt(true);
-    Transmit_Data_Idx = 0u;
 }
 
 /**
-  * @brief  Handles the connection request from PC to Forwarder (FW).
-  *         This function composes a confirmation frame, enqueues it for transmission,
-  * and enables the UART transmission interrupt to send the data.
-  * @param  None
-  * @retval None
+  * @brief Handles receiving a ping answer from a sensor node.
+  *
+  * This function sends the latest value of the node to the UART and
+  * re-arms the disconnection notification of the node.
+  *
+  * @param Node Sensor node answering the ping
+  * @return None
   */
-static void App_Handle_RequestConnectFromPcToFw(void)
+static void App_Handle_ReceivePingFromNode(uint8_t Node)
 {
-    /* FW send Confirm Connection between itself and PC */
-    APP_Compose_UARTFrame(PC_CONNECT_FORWARDER_ID, CONFIRM_CONNECTION_DATA, Transmit_Data_Str);
-    /* Push message to transmit queue and enable Tx interrupt to send */
-    while(Transmit_Data_Str[Transmit_Data_Idx] != '\0')
+#if (CAN_PING_MODE == CAN_PING_REMOTE)
+    const App_NodeDesc_t *desc = App_Node_GetDesc(Node);
+
+    /* The class may send its next remote request */
+    if (Remote_Ping_Node[desc->First] == Node)
     {
-        MID_Transmit_Enqueue(Transmit_Data_Str[Transmit_Data_Idx]);
-        Transmit_Data_Idx++;
+        Remote_Ping_Node[desc->First] = APP_NODE_NONE;
     }
+#endif
+
+    APP_Send_UARTFrame(App_Node_GetDesc(Node)->UartDataId, Node_Runtime[Node].Value);
     MID_UART_SetTxInterrupt(true);
-    Transmit_Data_Idx = 0u;
+
+    /* The PC Tool holds the latest sample now */
+    Node_Runtime[Node].ReportedValue = Node_Runtime[Node].Value;
+    Node_Runtime[Node].ReportedTime = Processing_Msg.TimeStamp;
+    Node_Runtime[Node].TimeoutNotified = 0u;
+}
+
+/**
+ * @brief Handles confirm message of sensor data from the Pc Tool.
+ *
+ * This function checks the operational state of the sensor nodes and,
+ * if they are stopped, sends a wake-up CAN message to every node.
+ *
+ * @param Node Node of the confirmed data, all nodes are woken up
+ * @return None
+ */
+static void App_Handle_ConfirmDataFromPCTool(uint8_t Node)
+{
+    const App_NodeDesc_t *desc = NULL;
+    uint8_t node = 0u;
+
+    (void)Node;
+
+    if(Node_State == STOP)
+    {
+        for (node = 0u; node < APP_NODE_NUM; node++)
+        {
+            /* Send wake up message */
+            desc = App_Node_GetDesc(node);
+            MID_CAN_SendCANMessageToId(desc->StopMb, desc->StopId, TX_WAKEUP_DATA, CAN_TX_DEADLINE_NONE);
+        }
+
+        Node_State = RUNNING;
+
+        MID_TurnOffLed(LED_RED);
+        MID_TurnOffLed(LED_GREEN);
+    }
 }
 
 /**
-  * @brief Handles a connection request from the PC to the distance sensor node.
+  * @brief Handles a statistics request from the PC Tool.
   *
-  * This function sends a CAN message to request a connection with the distance
-  * sensor node, initiated by the PC.
+  * This function sends the bus-to-UART latency, inter-arrival jitter and
+  * forwarded sample count of every sensor node, followed by the CAN
+  * error state and bus-off telemetry, to the PC Tool.
   *
-  * @param None
+  * @param Node Not used
   * @return None
   */
-static void App_Handle_RequestConnectFromPcToDistanceNode(void)
+static void App_Handle_RequestStatisticsFromPc(uint8_t Node)
 {
-    /* Send connection request to distance sensor node */
-    MID_CAN_SendCANMessage(TX_RQ_CONNECT_DISTANCE_NODE_MB, TX_MSG_REQUEST_DATA);
+    (void)Node;
+
+    /* The report is long, it is sent after the forwarding work as the transmit queue drains */
+    App_Stats_RequestReport();
+    App_Scheduler_Activate(APP_TASK_STATS_REPORT);
 }
 
 /**
-  * @brief Handles a connection request from the PC to the rotation sensor node.
+  * @brief Handles a self-test request from the PC Tool.
   *
-  * This function sends a CAN message to request a connection with the rotation
-  * sensor node, initiated by the PC.
+  * This function switches the sensor bus to loopback and pumps synthetic
+  * sensor frames through the forwarding path at the rate carried by the
+  * request. Frames per second, drops and latency are sent back when the
+  * test is over.
   *
-  * @param None
+  * @param Node Not used
   * @return None
   */
-static void App_Handle_RequestConnectFromPcToRotationNode(void)
+static void App_Handle_StartSelfTestFromPc(uint8_t Node)
 {
-    /* Send connection request to rotation sensor node */
-    MID_CAN_SendCANMessage(TX_RQ_CONNECT_ROTATION_NODE_MB, TX_MSG_REQUEST_DATA);
+    (void)Node;
+
+    App_SelfTest_Start(Processing_Msg.Data);
 }
 
 /**
-  * @brief Handles receiving a ping message from the distance sensor node.
+  * @brief Handles a dispatch table request from the PC Tool.
   *
-  * This function processes a "ping" message received from the distance sensor node
-  * and sends back the current distance value to the UART, while managing the timeout
-  * for the response counter.
+  * This function starts the task sending the number of message IDs the
+  * forwarder handles, followed by one frame per ID in dispatch table order.
   *
-  * @param None
+  * @param Node Not used
+  * @return None
+  */
+static void App_Handle_RequestDispatchTableFromPc(uint8_t Node)
+{
+    (void)Node;
+
+    App_Scheduler_Activate(APP_TASK_DISPATCH_REPORT);
+}
+
+/**
+  * @brief Handles a capture request from the PC Tool.
+  *
+  * This function stops the capture of the ingress traffic and starts the
+  * task sending it, the task runs again each time the transmit queue
+  * drained until the last word is queued.
+  *
+  * @param Node Not used
+  * @return None
+  */
+static void App_Handle_RequestCaptureFromPc(uint8_t Node)
+{
+    (void)Node;
+
+    App_Capture_RequestDump();
+    App_Scheduler_Activate(APP_TASK_CAPTURE_DUMP);
+}
+
+/**
+  * @brief Handles a capture restart from the PC Tool.
+  *
+  * @param Node Not used
   * @return None
   */
-static void App_Handle_ReceivePingFromDistanceNode(void)
+static void App_Handle_StartCaptureFromPc(uint8_t Node)
 {
-    /**/
-    APP_Compose_UARTFrame(DISTANCE_DATA_ID, Current_D_Value, Transmit_Data_Str);
+    (void)Node;
+
+    App_Capture_Start();
+}
 
-    while (Transmit_Data_Str[Transmit_Data_Idx] != '\0')
+/**
+  * @brief Handles a deadband setting from the PC Tool.
+  *
+  * This function sets the change a sample of the selected node must show
+  * to be forwarded and sends the value applied back with the same ID.
+  *
+  * @param Node First sensor node of the class
+  * @return None
+  */
+static void App_Handle_SetDeadbandFromPc(uint8_t Node)
+{
+    uint8_t node = App_SelectedNode(Node);
+
+    if (node != APP_NODE_NONE)
     {
-        MID_Transmit_Enqueue(Transmit_Data_Str[Transmit_Data_Idx]);
-        Transmit_Data_Idx++;
+        Node_Runtime[node].Deadband = Processing_Msg.Data;
+
+        App_SendNodeSelect(node);
+        APP_Send_UARTFrame(Processing_Msg.ID, Node_Runtime[node].Deadband);
+        MID_UART_SetTxInterrupt(true);
     }
-    MID_UART_SetTxInterrupt(true);
-    Transmit_Data_Idx = 0u;
+    else
+    {
+        /* Do nothing */
+    }
+}
+
+/**
+  * @brief Handles a maximum silent interval setting from the PC Tool.
+  *
+  * This function sets the longest time the deadband may hold the samples
+  * of the selected node back, limited to MAX_SILENT_MS_MAX, and sends the
+  * value applied back with the same ID.
+  *
+  * @param Node First sensor node of the class
+  * @return None
+  */
+static void App_Handle_SetMaxSilentFromPc(uint8_t Node)
+{
+    uint8_t node = App_SelectedNode(Node);
+
+    if (node != APP_NODE_NONE)
+    {
+        Node_Runtime[node].MaxSilentMs = (Processing_Msg.Data > MAX_SILENT_MS_MAX) ? MAX_SILENT_MS_MAX : Processing_Msg.Data;
+
+        App_SendNodeSelect(node);
+        APP_Send_UARTFrame(Processing_Msg.ID, Node_Runtime[node].MaxSilentMs);
+        MID_UART_SetTxInterrupt(true);
+    }
+    else
+    {
+        /* Do nothing */
+    }
+}
+
+/**
+  * @brief Handles a node selection from the PC Tool.
+  *
+  * This function keeps the instance offset carried by the message, the
+  * next connection request or report-on-change setting of a node class
+  * applies to that node of the class.
+  *
+  * @param Node Not used
+  * @return None
+  */
+static void App_Handle_SelectNodeFromPc(uint8_t Node)
+{
+    (void)Node;
+
+    Pc_Node_Select = (Processing_Msg.Data > CAN_NODE_INST_MAX) ? (uint8_t)CAN_NODE_INST_MAX : (uint8_t)Processing_Msg.Data;
+}
+
+/**
+  * @brief Gets the node a PC Tool command of a node class applies to.
+  *
+  * The selection is used once, the next command applies to the first node
+  * of the class unless the PC Tool selects another one.
+  *
+  * @param Node First sensor node of the class
+  * @return Selected node, APP_NODE_NONE if the class has no such node
+  */
+static uint8_t App_SelectedNode(uint8_t Node)
+{
+    const App_NodeDesc_t *desc = App_Node_GetDesc(Node);
+    uint8_t node = App_Node_Find(desc->Class, (uint8_t)(desc->Instance + Pc_Node_Select));
+
+    Pc_Node_Select = 0u;
+
+    return node;
 }
 
 /**
-  * @brief Handles receiving a ping message from the rotation sensor node.
+  * @brief Sends the selection of a node other than the first of its class
+  *        ahead of a reply sent with the class ID.
   *
-  * This function processes a "ping" message received from the rotation sensor node
-  * and sends back the current rotation value to the UART, while managing the timeout
-  * for the response counter.
+  * @param Node Sensor node of the reply
+  * @return None
+  */
+static void App_SendNodeSelect(uint8_t Node)
+{
+    const App_NodeDesc_t *desc = App_Node_GetDesc(Node);
+
+    if (Node != desc->First)
+    {
+        APP_Send_UARTFrame(PC_SELECT_NODE_ID, (uint32_t)Node - desc->First);
+    }
+    else
+    {
+        /* Do nothing */
+    }
+}
+
+/**
+  * @brief Sends the message IDs handled by the dispatch table to the PC Tool.
   *
   * @param None
   * @return None
   */
-static void App_Handle_ReceivePingFromRotationNode(void)
+static void App_Task_DispatchReport(void)
 {
-    /* Convert message for uart transfer */
-    APP_Compose_UARTFrame(ROTATION_DATA_ID, Current_R_Value, Transmit_Data_Str);
-    /* Push message to transmit queue and enable Tx interrupt to send */
-    while(Transmit_Data_Str[Transmit_Data_Idx] != '\0')
+    const App_DispatchEntry_t *entry = NULL;
+    uint32_t count = 0u;
+    uint8_t index = 0u;
+    uint8_t node = 0u;
+
+    for (index = 0u; index < DISPATCH_ROW_NUM; index++)
+    {
+        count += Dispatch_Table[index].Count;
+    }
+
+    APP_Send_UARTFrame(DISPATCH_COUNT_ID, count);
+
+    for (index = 0u; index < DISPATCH_ROW_NUM; index++)
     {
-        MID_Transmit_Enqueue(Transmit_Data_Str[Transmit_Data_Idx]);
-        Transmit_Data_Idx++;
+        entry = &Dispatch_Table[index];
+
+        for (node = 0u; node < entry->Count; node++)
+        {
+            APP_Send_UARTFrame(DISPATCH_MSG_ID, entry->Id + (node * entry->Step));
+        }
     }
     MID_UART_SetTxInterrupt(true);
-    Transmit_Data_Idx = 0u;
 }
 
 /**
- * @brief Handles confirm message of rotation data from the Pc Tool.
- *
- * This function checks the operational state of the rotation sensor node and,
- * if it is stopped, sends a wake-up CAN message to resume its operation.
- *
- * @param None
- * @return None
- */
-static void App_Handle_ConfirmDataFromPCTool(void)
+  * @brief Gets the timeout slot of a sensor node named by a dispatch table row.
+  *
+  * @param Node Sensor node of the message
+  * @param Slot DISPATCH_SLOT_DATA or DISPATCH_SLOT_RESPOND
+  * @return Timeout slot, refer to @defgroup Timeout slot
+  */
+static uint8_t App_DispatchSlot(uint8_t Node, uint8_t Slot)
 {
-    if(Node_State == STOP)
+    const App_NodeDesc_t *desc = App_Node_GetDesc(Node);
+
+    return (Slot == DISPATCH_SLOT_DATA) ? desc->DataTimeout : desc->RespondTimeout;
+}
+
+/**
+  * @brief Builds the lookup of the dispatch table by low byte of the message ID.
+  *
+  * Every ID of every row is entered, the first row entering a low byte
+  * keeps it.
+  *
+  * @param None
+  * @return None
+  */
+static void App_Dispatch_Init(void)
+{
+    const App_DispatchEntry_t *entry = NULL;
+    uint8_t row = 0u;
+    uint8_t node = 0u;
+    uint8_t key = 0u;
+
+    for (row = 0u; row < DISPATCH_ROW_NUM; row++)
     {
-        /* Send wake up message */
-        MID_CAN_SendCANMessage(TX_STOPOPR_DISTANCE_NODE_MB, TX_WAKEUP_DATA);
-        /* Send wake up message */
-        MID_CAN_SendCANMessage(TX_STOPOPR_ROTATION_NODE_MB, TX_WAKEUP_DATA);
+        entry = &Dispatch_Table[row];
 
-        Node_State = RUNNING;
+        for (node = 0u; node < entry->Count; node++)
+        {
+            key = (uint8_t)(entry->Id + (node * entry->Step));
 
-        MID_TurnOffLed(LED_RED);
-        MID_TurnOffLed(LED_GREEN);
+            if (Dispatch_Index[key] == 0u)
+            {
+                Dispatch_Index[key] = (uint8_t)(row + 1u);
+            }
+            else
+            {
+                /* Do nothing */
+            }
+        }
     }
 }
 
 /**
-  * @brief Handles timeout events related to the distance sensor node.
+  * @brief Dispatches the message taken from the receive queue.
   *
-  * This function processes timeout events, sending appropriate messages
-  * or resetting counters and states as needed. It ensures that the system
-  * responds to timeout scenarios for communication with the distance sensor node.
+  * This function looks the message ID up in the dispatch table in constant
+  * time, runs its handler, then applies the timeout counter reset, gate
+  * disable and PC Tool respond lock transition of its row. The lock is not
+  * acquired for sensor data the deadband held back whole. Unknown IDs
+  * are ignored.
   *
   * @param None
   * @return None
   */
-static void App_Handle_TimeoutEvent(void)
+static void App_Dispatch(void)
 {
-    if(MID_TimeoutService_GetEvent(D_NODE_TIMEOUT_EVENT) == EVENT_SET)
+    const App_DispatchEntry_t *entry = NULL;
+    uint8_t  row = Dispatch_Index[(uint8_t)Processing_Msg.ID];
+    uint8_t  node = APP_NODE_NONE;
+    uint32_t offset = 0u;
+    uint32_t index = 0u;
+
+    if (row != 0u)
     {
-        /* Send ping message to Distance sensor node */
-        MID_CAN_SendCANMessage(TX_PING_DISTANCE_NODE_MB, TX_MSG_REQUEST_DATA);
-        /* Start counter to calculate timeout for respond message from distance sensor node */
-        MID_TimeoutService_CounterCmd(D_NODE_RESPONDCONNECTION_GATE, ENABLE);
-        /* Reset state */
-        MID_TimeoutService_WriteEvent(D_NODE_TIMEOUT_EVENT, EVENT_NONE);
-        /* Reset timeout counter */
-        MID_TimeoutService_ResetCounter(D_NODE_COMMINGDATA_CNT);
+        /* Node of the message within the row, the ID must be one of the row */
+        entry = &Dispatch_Table[row - 1u];
+        offset = Processing_Msg.ID - entry->Id;
+        index = (entry->Step != 0u) ? (offset / entry->Step) : 0u;
+
+        if (((index * entry->Step) != offset) || (index >= entry->Count))
+        {
+            entry = NULL;
+        }
+        else if (entry->Node != APP_NODE_NONE)
+        {
+            node = (uint8_t)(entry->Node + index);
+        }
+        else
+        {
+            /* Do nothing */
+        }
     }
 
-    if(MID_TimeoutService_GetEvent(D_NODE_RESPOND_TIMEOUT_EVENT) == EVENT_SET)
+    if (entry != NULL)
     {
-        if (g_Dnode_isTimeoutNotified == false)
-        {
-            /* Compress to UART String */
-            APP_Compose_UARTFrame(DISTANCE_DATA_ID, SENSOR_DISCONNECT_DATA, Transmit_Data_Str);
+        Processing_Suppressed = false;
+        entry->Handler(node);
 
-            while (Transmit_Data_Str[Transmit_Data_Idx] != '\0')
-            {
-                MID_Transmit_Enqueue(Transmit_Data_Str[Transmit_Data_Idx]);
-                Transmit_Data_Idx++;
-            }
-            MID_UART_SetTxInterrupt(true);
-            Transmit_Data_Idx = 0u;
+        if (entry->ResetCounter != DISPATCH_NONE)
+        {
+            /* Reset timeout counter */
+            MID_TimeoutService_ResetCounter(App_DispatchSlot(node, entry->ResetCounter));
+        }
 
-            g_Dnode_isTimeoutNotified = true;
+        if (entry->DisableGate != DISPATCH_NONE)
+        {
+            /* Disable timeout counter */
+            MID_TimeoutService_CounterCmd(App_DispatchSlot(node, entry->DisableGate), DISABLE);
         }
 
-        MID_TimeoutService_CounterCmd(D_NODE_RESPONDCONNECTION_GATE, DISABLE);
-        /* Reset state */
-        MID_TimeoutService_WriteEvent(D_NODE_RESPOND_TIMEOUT_EVENT, EVENT_NONE);
+        if ((entry->LockAction == DISPATCH_LOCK_ACQUIRE) && (PcTool_Timer_Lock_State == UNLOCK) && (Processing_Suppressed == false))
+        {
+            /* Start counter to calculate timeout for respond data message from Pc Tool */
+            MID_TimeoutService_CounterCmd(PC_RESPOND_DATA_GATE, ENABLE);
+            PcTool_Timer_Lock_State = node;
+        }
+        else if ((entry->LockAction == DISPATCH_LOCK_RELEASE) && (PcTool_Timer_Lock_State == node))
+        {
+            /* Disable timeout counter */
+            MID_TimeoutService_CounterCmd(PC_RESPOND_DATA_GATE, DISABLE);
+            PcTool_Timer_Lock_State = UNLOCK;
+        }
+        else
+        {
+            /* Do nothing */
+        }
     }
-
-    if(MID_TimeoutService_GetEvent(R_NODE_TIMEOUT_EVENT) == EVENT_SET)
+    else
     {
-        /* Send ping message to Rotation sensor node */
-        MID_CAN_SendCANMessage(TX_PING_ROTATION_NODE_MB, TX_MSG_REQUEST_DATA);
-        /* Start counter to calculate timeout for respond message from distance sensor node */
-        MID_TimeoutService_CounterCmd(R_NODE_RESPONDCONNECTION_GATE, ENABLE);
-        /* Reset state */
-        MID_TimeoutService_WriteEvent(R_NODE_TIMEOUT_EVENT, EVENT_NONE);
-        /* Reset timeout counter */
-        MID_TimeoutService_ResetCounter(R_NODE_COMMINGDATA_CNT);
+        /* Do nothing */
     }
+}
+
+/**
+  * @brief Handles timeout events of the sensor nodes and of the PC Tool.
+  *
+  * This function pings a sensor node whose data stopped, reports it as
+  * disconnected once when the ping stays unanswered, and stops every node
+  * when the PC Tool does not confirm the forwarded data.
+  *
+  * @param None
+  * @return None
+  */
+static void App_Handle_TimeoutEvent(void)
+{
+    const App_NodeDesc_t *desc = NULL;
+    uint8_t node = 0u;
+    bool sent = false;
 
-    if(MID_TimeoutService_GetEvent(R_NODE_RESPOND_TIMEOUT_EVENT) == EVENT_SET)
+    for (node = 0u; node < APP_NODE_NUM; node++)
     {
-        if (g_Rnode_isTimeoutNotified == false)
+        desc = App_Node_GetDesc(node);
+
+        if(MID_TimeoutService_GetEvent(desc->DataTimeout) == EVENT_SET)
         {
-            /* Compress to UART String */
-            APP_Compose_UARTFrame(ROTATION_DATA_ID, SENSOR_DISCONNECT_DATA, Transmit_Data_Str);
+            /* Send ping message to the sensor node */
+#if (CAN_PING_MODE == CAN_PING_REMOTE)
+            /* One remote request of the class at a time, the answer mailbox is shared */
+            sent = (Remote_Ping_Node[desc->First] == APP_NODE_NONE) &&
+                   (MID_CAN_SendRemoteRequest(desc->PingAnswerMb, desc->PingAnswerId, CAN_PING_ANSWER_LENGTH) == 1u);
+            if (sent == true)
+            {
+                Remote_Ping_Node[desc->First] = node;
+            }
+#else
+            MID_CAN_SendCANMessageToId(desc->PingMb, desc->PingId, TX_MSG_REQUEST_DATA, CAN_TX_DEADLINE_NONE);
+            sent = true;
+#endif
+            if (sent == true)
+            {
+                /* Start counter to calculate timeout for respond message from the sensor node */
+                MID_TimeoutService_CounterCmd(desc->RespondTimeout, ENABLE);
+                /* Reset state */
+                MID_TimeoutService_WriteEvent(desc->DataTimeout, EVENT_NONE);
+                /* Reset timeout counter */
+                MID_TimeoutService_ResetCounter(desc->DataTimeout);
+            }
+            else
+            {
+                /* The event stays set, the request is sent on a later tick */
+            }
+        }
 
-            while (Transmit_Data_Str[Transmit_Data_Idx] != '\0')
+        if(MID_TimeoutService_GetEvent(desc->RespondTimeout) == EVENT_SET)
+        {
+            if (Node_Runtime[node].TimeoutNotified == 0u)
             {
-                MID_Transmit_Enqueue(Transmit_Data_Str[Transmit_Data_Idx]);
-                Transmit_Data_Idx++;
+                APP_Emit_UARTFrame(&Node_Runtime[node].DisconnectFrame);
+                MID_UART_SetTxInterrupt(true);
+
+                /* The PC Tool shows the node as disconnected, its next sample is forwarded whatever the deadband */
+                Node_Runtime[node].Reported = false;
+                Node_Runtime[node].TimeoutNotified = 1u;
             }
-            MID_UART_SetTxInterrupt(true);
-            Transmit_Data_Idx = 0u;
 
-            g_Rnode_isTimeoutNotified = true;
+            MID_TimeoutService_CounterCmd(desc->RespondTimeout, DISABLE);
+            /* Reset state */
+            MID_TimeoutService_WriteEvent(desc->RespondTimeout, EVENT_NONE);
+#if (CAN_PING_MODE == CAN_PING_REMOTE)
+            if (Remote_Ping_Node[desc->First] == node)
+            {
+                Remote_Ping_Node[desc->First] = APP_NODE_NONE;
+            }
+#endif
         }
-
-        MID_TimeoutService_CounterCmd(R_NODE_RESPONDCONNECTION_GATE, DISABLE);
-        /* Reset state */
-        MID_TimeoutService_WriteEvent(R_NODE_RESPOND_TIMEOUT_EVENT, EVENT_NONE);
     }
 
     if(MID_TimeoutService_GetEvent(PC_RESPOND_DATA_TIMEOUT_EVENT) == EVENT_SET)
     {
         if(Node_State != STOP)
         {
-            /* Send stop operation */
-            MID_CAN_SendCANMessage(TX_STOPOPR_DISTANCE_NODE_MB, TX_STOPOPR_DATA);
-            /* Send stop operation */
-            MID_CAN_SendCANMessage(TX_STOPOPR_ROTATION_NODE_MB, TX_STOPOPR_DATA);
+            for (node = 0u; node < APP_NODE_NUM; node++)
+            {
+                /* Send stop operation */
+                desc = App_Node_GetDesc(node);
+                MID_CAN_SendCANMessageToId(desc->StopMb, desc->StopId, TX_STOPOPR_DATA, CAN_TX_DEADLINE_NONE);
+            }
 
             MID_TimeoutService_CounterCmd(PC_RESPOND_DATA_GATE, DISABLE);
             /* Reset state */
             MID_TimeoutService_WriteEvent(PC_RESPOND_DATA_TIMEOUT_EVENT, EVENT_NONE);
-            /* Set status of Distance node as Stop opreation */
+            /* Set status of the sensor nodes as Stop opreation */
             MID_TurnOnLed(LED_RED);
             MID_TurnOnLed(LED_GREEN);
             Node_State = STOP;
         }
     }
 }
+
+/**
+  * @brief Composes the constant replies once, they are emitted without formatting,
+  *        and sets the report-on-change defaults of the sensor nodes.
+  *
+  * @param None
+  * @return None
+  */
+static void App_PrepareFrames(void)
+{
+    const App_NodeDesc_t *desc = NULL;
+    uint8_t node = 0u;
+
+    APP_Prepare_UARTFrame(&Confirm_Forwarder_Frame, PC_CONNECT_FORWARDER_ID, CONFIRM_CONNECTION_DATA);
+
+    for (node = 0u; node < APP_NODE_NUM; node++)
+    {
+        desc = App_Node_GetDesc(node);
+        APP_Prepare_UARTFrame(&Node_Runtime[node].ConfirmFrame, desc->UartConnectId, CONFIRM_CONNECTION_DATA);
+        APP_Prepare_UARTFrame(&Node_Runtime[node].DisconnectFrame, desc->UartDataId, SENSOR_DISCONNECT_DATA);
+
+        Node_Runtime[node].Deadband = DEADBAND_DEFAULT;
+        Node_Runtime[node].MaxSilentMs = MAX_SILENT_MS_DEFAULT;
+#if (CAN_PING_MODE == CAN_PING_REMOTE)
+        Remote_Ping_Node[node] = APP_NODE_NONE;
+#endif
+    }
+}
+
+/**
+  * @brief Dispatches every message waiting in the receive queue.
+  *
+  * @param None
+  * @return None
+  */
+static void App_Task_Forward(void)
+{
+    while (MID_Receive_DeQueue(&Processing_Msg) == QUEUE_DONE_SUCCESS)
+    {
+        App_Dispatch();
+    }
+}
+
+/**
+  * @brief Sends the statistics and the CAN health telemetry to the PC Tool.
+  *
+  * The statistics go one block at a time as the transmit queue drains,
+  * the CAN health telemetry follows the last block.
+  *
+  * @param None
+  * @return None
+  */
+static void App_Task_StatsReport(void)
+{
+    if (App_Stats_Process() == true)
+    {
+        App_CanHealth_Report();
+    }
+    else
+    {
+        /* Do nothing */
+    }
+}
+
+#if (UART_ITOA_BENCHMARK == 1u) || (UART_PARSER_BENCHMARK == 1u)
+/**
+  * @brief Sends the cycle counts of the UART frame conversions to the PC Tool.
+  *
+  * @param None
+  * @return None
+  */
+static void App_ReportBenchmark(void)
+{
+    uint32_t legacyCycles = 0u;
+    uint32_t fastCycles = 0u;
+
+#if (UART_ITOA_BENCHMARK == 1u)
+    APP_Benchmark_UIntToString(&legacyCycles, &fastCycles);
+
+    APP_Send_UARTFrame(BENCH_ITOA_LEGACY_CYCLES_ID, legacyCycles);
+    APP_Send_UARTFrame(BENCH_ITOA_FAST_CYCLES_ID, fastCycles);
+#endif
+
+#if (UART_PARSER_BENCHMARK == 1u)
+    APP_Benchmark_ParserUARTFrame(&legacyCycles, &fastCycles);
+
+    APP_Send_UARTFrame(BENCH_PARSER_LEGACY_CYCLES_ID, legacyCycles);
+    APP_Send_UARTFrame(BENCH_PARSER_FAST_CYCLES_ID, fastCycles);
+#endif
+    MID_UART_SetTxInterrupt(true);
+}
+#endif
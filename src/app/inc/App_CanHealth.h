@@ -0,0 +1,62 @@
+#ifndef APP_CANHEALTH_H_
+#define APP_CANHEALTH_H_
+
+/*******************************************************************************
+ * Include
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/** @defgroup Bus-off recovery policy
+  * @{
+  */
+#define CAN_HEALTH_RECOVERY_AUTO            0u  /* Controller rejoins the bus as soon as the bus allows it */
+#define CAN_HEALTH_RECOVERY_RATE_LIMITED    1u  /* Recovery is started by the application after a hold-off */
+
+/* Policy used, it can be a value of @defgroup Bus-off recovery policy */
+#define CAN_HEALTH_RECOVERY_POLICY          CAN_HEALTH_RECOVERY_RATE_LIMITED
+
+/* Hold-off before recovery: starts at MIN, doubles on every bus-off that follows a recovery
+ * within CAN_HEALTH_STABLE_US, up to MAX. A faulty node cannot flood the bus that way. */
+#define CAN_HEALTH_HOLDOFF_MIN_US           1000u
+#define CAN_HEALTH_HOLDOFF_MAX_US           200000u
+#define CAN_HEALTH_STABLE_US                1000000u
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/**
+  * @brief      Select the recovery policy and register the CAN error notifications
+  * @param[in]  None
+  * @retval     None
+  */
+void App_CanHealth_Init(void);
+
+/**
+  * @brief      Track error state transitions and run the bus-off recovery, called from the main loop
+  * @note       Runs on NOTIFY_EVENT_CAN_STATUS and every TIMER_TICK_MS
+  * @param[in]  None
+  * @retval     None
+  */
+void App_CanHealth_Process(void);
+
+/**
+  * @brief      Check whether the health tracking polls the time base for the recovery hold-off
+  * @param[in]  None
+  * @retval     true while a recovery is due
+  */
+bool App_CanHealth_IsBusy(void);
+
+/**
+  * @brief      Send the CAN health telemetry to the PC Tool
+  * @param[in]  None
+  * @retval     None
+  */
+void App_CanHealth_Report(void);
+
+#endif /* APP_CANHEALTH_H_ */
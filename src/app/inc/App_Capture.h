@@ -0,0 +1,94 @@
+#ifndef APP_CAPTURE_H_
+#define APP_CAPTURE_H_
+
+/*******************************************************************************
+ * Include
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "MID_CAN_Interface.h"
+#include "Queue_Common.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/* RAM kept for the capture, a power of two. When full the oldest records are overwritten. */
+#define CAPTURE_BUFFER_SIZE         4096u
+
+/** @defgroup Capture record
+  * @brief  | tag (1) | time (1..5) | CAN ID (2 or 4) | data (0..8) |
+  *         Time is the delay from the previous record in us, bit 0 is set when the record
+  *         is older than the previous one (CAN frames are stamped at their capture on the bus,
+  *         up to CAPTURE_CAN_AGE_MAX_US earlier), bits 31..1 hold the magnitude. It is coded
+  *         7 bits per byte, lowest first, bit 7 set when another byte follows. A time record
+  *         is written after CAPTURE_IDLE_US without record, the delays stay far below the
+  *         wrap of the time base. CAN IDs are big-endian. A UART record holds 1 to 16 bytes,
+  *         a byte following the previous one within CAPTURE_UART_RUN_GAP_US is appended to it
+  *         and replayed one character time after it.
+  * @{
+  */
+#define CAPTURE_REC_UART            0x10u   /* Bytes received from the PC Tool, count - 1 in the low nibble */
+#define CAPTURE_REC_CAN_STD         0x20u   /* CAN frame with an 11-bit ID, DLC in the low nibble */
+#define CAPTURE_REC_CAN_EXT         0x30u   /* CAN frame with a 29-bit ID, DLC in the low nibble */
+#define CAPTURE_REC_TIME            0x40u   /* No body, moves the time on */
+#define CAPTURE_REC_TYPE_MASK       0xF0u
+#define CAPTURE_REC_DLC_MASK        0x0Fu   /* Also the UART byte count - 1 */
+
+#define CAPTURE_UART_RUN_GAP_US     200u        /* Two characters at 115200 bit/s */
+#define CAPTURE_CAN_AGE_MAX_US      7000000u    /* FlexCAN timer wraps after 65536 bit times, 6.6 s at 10 kbit/s */
+#define CAPTURE_IDLE_US             10000000u   /* Time record after this long without record */
+
+#define CAPTURE_TIME_SIGN           0x01u   /* Bit 0 of the time: record older than the previous one */
+#define CAPTURE_TIME_MORE           0x80u   /* Bit 7 of a time byte: another byte follows */
+#define CAPTURE_TIME_BYTES_MAX      5u
+/**
+  * @}
+  */
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/**
+  * @brief      Clear the capture and start recording
+  * @note       Ignored while a dump is running
+  * @param[in]  None
+  * @retval     None
+  */
+void App_Capture_Start(void);
+
+/**
+  * @brief      Append a CAN frame to the capture, called from the receive interrupt
+  * @param[in]  frame:       Received frame
+  * @param[in]  captureTime: Time base value when the frame was captured on the bus
+  * @retval     None
+  */
+void App_Capture_RecordCan(const Data_Typedef *frame, uint32_t captureTime);
+
+/**
+  * @brief      Append a byte received from the PC Tool to the capture, called from the receive interrupt
+  * @param[in]  data: Received byte
+  * @retval     None
+  */
+void App_Capture_RecordUart(uint8_t data);
+
+/**
+  * @brief      Stop recording and start sending the capture to the PC Tool
+  * @note       CAPTURE_LOST_ID and CAPTURE_SIZE_ID come first, then the records as
+  *             CAPTURE_DATA_ID words. Recording resumes on App_Capture_Start() only.
+  * @param[in]  None
+  * @retval     None
+  */
+void App_Capture_RequestDump(void);
+
+/**
+  * @brief      Queue the next words of the capture, up to UART_BULK_QUEUE_MAX bytes in the transmit queue,
+  *             or write a time record after CAPTURE_IDLE_US without record
+  * @note       Runs on the dump request, on NOTIFY_EVENT_UART_ROOM and every TIMER_TICK_MS, never by polling
+  * @param[in]  None
+  * @retval     None
+  */
+void App_Capture_Process(void);
+
+#endif /* APP_CAPTURE_H_ */
@@ -12,12 +12,47 @@
  * Definition
  ******************************************************************************/
 
+/* 1: compile the cycle count benchmark of the integer to text conversion, run once at startup */
+#ifndef UART_ITOA_BENCHMARK
+#define UART_ITOA_BENCHMARK     0u
+#endif
+
+/* 1: compile the cycle count benchmark of the UART frame parser, run once at startup */
+#ifndef UART_PARSER_BENCHMARK
+#define UART_PARSER_BENCHMARK   0u
+#endif
+
+/* Range of a received UART frame, "<id>-<data>" outside of it is rejected */
+#define UART_FRAME_ID_MAX       0xFFu
+#define UART_FRAME_DATA_MAX     0xFFFFu
+
+/* "<id>-<data>\n" with two 10 digit numbers, plus the terminator */
+#define UART_FRAME_LENGTH_MAX   24u
+
+/* Transmit queue bytes the bulk senders (capture dump, statistics report) may fill, the rest is left to the sensor data */
+#define UART_BULK_QUEUE_MAX     (TRANSMIT_QUEUE_SIZE / 2u)
+
+/* Most frames a bulk sender queues as one block */
+#define UART_BULK_BLOCK_FRAMES  6u
+
+/* Transmit queue bytes the bulk senders resume at, on NOTIFY_EVENT_UART_ROOM. A block still fits below UART_BULK_QUEUE_MAX. */
+#define UART_BULK_RESUME_LEVEL  (UART_BULK_QUEUE_MAX - (UART_BULK_BLOCK_FRAMES * UART_FRAME_LENGTH_MAX))
+
+/* UART frame composed once, emitted as many times as needed */
+typedef struct
+{
+    uint8_t Length;                         /* Characters to send, terminator excluded */
+    uint8_t Text[UART_FRAME_LENGTH_MAX];
+} UARTFrame_t;
+
 /*******************************************************************************
  * API
  ******************************************************************************/
 
 /**
   * @brief  Function to parse the string and extract 2 unsigned integers
+  * @note   The string must be "<id>-<data>" in decimal, with id up to UART_FRAME_ID_MAX
+  *         and data up to UART_FRAME_DATA_MAX. Output is left untouched on failure.
   * @param[in]  str   Pointer to the input string to be parsed.
   * @param[in]  length Length of the input string (excluding any null terminator).
   * @param[out] Output  Pointer to store Message frame struct (contain ID and Data).
@@ -29,8 +64,53 @@ bool App_Parser_UARTFrame(const uint8_t* str, int length, ReceiveFrame_t *Output
   * @brief  Function to convert ID and Data to a UART string that can be printed out
   * @param[in]  id       ID of the frame
   * @param[in]  data     Data of the frame
-  * @param[out] outputBuffer  Pointer to store the output string
+  * @param[out] outputBuffer  Pointer to store the output string, UART_FRAME_LENGTH_MAX bytes
+  * @return Length of the string, terminator excluded
+  */
+uint8_t APP_Compose_UARTFrame(uint32_t id, uint32_t data, uint8_t *outputBuffer);
+
+/**
+  * @brief  Compose a UART frame to be emitted later, constant replies are prepared once at init
+  * @param[out] frame    Frame to fill
+  * @param[in]  id       ID of the frame
+  * @param[in]  data     Data of the frame
+  */
+void APP_Prepare_UARTFrame(UARTFrame_t *frame, uint32_t id, uint32_t data);
+
+/**
+  * @brief  Push a composed UART frame to the transmit queue in one block
+  * @note   The frame is dropped whole when the queue has no room for it. The caller
+  *         enables the Tx interrupt once all its frames are queued.
+  * @param[in]  frame    Frame to send
+  */
+void APP_Emit_UARTFrame(const UARTFrame_t *frame);
+
+/**
+  * @brief  Compose a UART frame and push it to the transmit queue
+  * @note   The caller enables the Tx interrupt once all its frames are queued.
+  * @param[in]  id       ID of the frame
+  * @param[in]  data     Data of the frame
+  */
+void APP_Send_UARTFrame(uint32_t id, uint32_t data);
+
+#if (UART_ITOA_BENCHMARK == 1u)
+/**
+  * @brief  Measure the integer to text conversion against the former divide by 10 version
+  * @note   Cycles are counted by the DWT cycle counter over the same set of values.
+  * @param[out] legacyCycles  Cycles of the divide by 10 and reverse version
+  * @param[out] fastCycles    Cycles of the digit pair version
+  */
+void APP_Benchmark_UIntToString(uint32_t *legacyCycles, uint32_t *fastCycles);
+#endif
+
+#if (UART_PARSER_BENCHMARK == 1u)
+/**
+  * @brief  Measure the UART frame parser against the former character by character version
+  * @note   Cycles are counted by the DWT cycle counter over the same set of frames.
+  * @param[out] legacyCycles  Cycles of the character by character version
+  * @param[out] fastCycles    Cycles of the word at a time version
   */
-void APP_Compose_UARTFrame(uint32_t id, uint32_t data, uint8_t *outputBuffer);
+void APP_Benchmark_ParserUARTFrame(uint32_t *legacyCycles, uint32_t *fastCycles);
+#endif
 
 #endif /* APP_DATAPROCESSING_H_ */
@@ -0,0 +1,101 @@
+#ifndef APP_NODE_H_
+#define APP_NODE_H_
+
+/*******************************************************************************
+ * Include
+ ******************************************************************************/
+#include <stdint.h>
+#include "MID_CAN_Interface.h"
+#include "MID_Timer_Interface.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/** @defgroup Sensor node index
+  * @brief  Position of a sensor node in the node registry: the distance nodes come first, then
+  *         the rotation nodes, each class in instance order from CAN_NODE_INST_DEFAULT. The
+  *         descriptors are derived from the index by App_Node_Init(), adding a node of an
+  *         existing class only takes a larger count. More than one node per class needs the
+  *         extended identifier format, refer to @defgroup Node addressing.
+  * @{
+  */
+#ifndef APP_NODE_DISTANCE_NUM
+#define APP_NODE_DISTANCE_NUM   1u
+#endif
+#ifndef APP_NODE_ROTATION_NUM
+#define APP_NODE_ROTATION_NUM   1u
+#endif
+
+#define APP_NODE_DISTANCE       0u                          /* First distance node */
+#define APP_NODE_ROTATION       (APP_NODE_DISTANCE_NUM)     /* First rotation node */
+#define APP_NODE_NUM            (APP_NODE_DISTANCE_NUM + APP_NODE_ROTATION_NUM)
+#define APP_NODE_NONE           0xFFu   /* Message not bound to a sensor node */
+
+#if (CAN_ID_FORMAT != CAN_ID_EXTENDED) && ((APP_NODE_DISTANCE_NUM > 1u) || (APP_NODE_ROTATION_NUM > 1u))
+#error "Several nodes of a class need CAN_ID_FORMAT == CAN_ID_EXTENDED"
+#endif
+
+#if (APP_NODE_DISTANCE_NUM > (CAN_NODE_INST_MAX - CAN_NODE_INST_DEFAULT + 1u)) || \
+    (APP_NODE_ROTATION_NUM > (CAN_NODE_INST_MAX - CAN_NODE_INST_DEFAULT + 1u))
+#error "A node class exceeds the instances of the extended identifier layout"
+#endif
+
+#if (APP_NODE_NUM > TIMEOUT_NODE_MAX)
+#error "APP_NODE_NUM exceeds the timeout slots of MID_Timer_Interface"
+#endif
+
+/* Description of one sensor node, derived from its class and instance */
+typedef struct
+{
+    uint8_t  Class;             /* Node class, it can be a value of @defgroup Node addressing */
+    uint8_t  Instance;          /* Node instance, CAN_NODE_INST_DEFAULT for the first node of the class */
+    uint8_t  First;             /* Index of the first node of the class, it reads the shared receive mailboxes */
+    uint8_t  DataMb;            /* Mailboxes of the class, values of @defgroup Mailboxes of the sensor bus: sensor data ... */
+    uint8_t  ConnectConfirmMb;  /* ... connection confirmation */
+    uint8_t  PingAnswerMb;      /* ... ping answer, remote request in CAN_PING_REMOTE mode */
+    uint8_t  ConfirmDataMb;     /* ... data confirmation sent back */
+    uint8_t  ConnectMb;         /* ... connection request */
+    uint8_t  StopMb;            /* ... stop and wake up commands */
+    uint8_t  PingMb;            /* ... ping in CAN_PING_SOFTWARE mode */
+    uint8_t  SelfTestMb;        /* ... synthetic data of the loopback self-test */
+    uint8_t  DataTimeout;       /* Timeout slot of the incoming data, refer to @defgroup Timeout slot */
+    uint8_t  RespondTimeout;    /* Timeout slot of the ping answer */
+    uint32_t DataId;            /* CAN IDs of the node: sensor data ... */
+    uint32_t ConfirmDataId;     /* ... data confirmation */
+    uint32_t ConnectId;         /* ... connection request */
+    uint32_t StopId;            /* ... stop and wake up commands */
+    uint32_t PingId;            /* ... ping in CAN_PING_SOFTWARE mode */
+    uint32_t PingAnswerId;      /* ... ping answer */
+    uint32_t UartDataId;        /* UART frame ID of the samples and of the disconnection */
+    uint32_t UartConnectId;     /* UART frame ID of the connection request and confirmation, shared by the class */
+} App_NodeDesc_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/**
+  * @brief      Derive the descriptor of every sensor node from its index, called before the node
+  *             descriptors are used
+  * @param[in]  None
+  * @retval     None
+  */
+void App_Node_Init(void);
+
+/**
+  * @brief      Get the descriptor of a sensor node
+  * @param[in]  Node: it can be a value of @defgroup Sensor node index
+  * @retval     Descriptor of the node
+  */
+const App_NodeDesc_t *App_Node_GetDesc(uint8_t Node);
+
+/**
+  * @brief      Find a sensor node by class and instance
+  * @param[in]  Class:    Node class, it can be a value of @defgroup Node addressing
+  * @param[in]  Instance: Node instance
+  * @retval     Index of the node, APP_NODE_NONE if the forwarder does not serve it
+  */
+uint8_t App_Node_Find(uint8_t Class, uint8_t Instance);
+
+#endif /* APP_NODE_H_ */
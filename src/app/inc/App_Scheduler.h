@@ -0,0 +1,74 @@
+#ifndef APP_SCHEDULER_H_
+#define APP_SCHEDULER_H_
+
+/*******************************************************************************
+ * Include
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/** @defgroup Task slot
+  * @brief  Position of a task in the task table, also its priority: slot 0 runs first.
+  *         Between two tasks the pending work is taken again, a higher slot never
+  *         waits for more than one lower task.
+  * @{
+  */
+#define APP_TASK_FORWARD            0u  /* Dispatch of the received frames */
+#define APP_TASK_TX_DEADLINE        1u  /* Transmit completion and deadlines */
+#define APP_TASK_CAN_HEALTH         2u  /* CAN error state and bus-off recovery */
+#define APP_TASK_TIMEOUT            3u  /* Sensor node and PC Tool timeouts */
+#define APP_TASK_SELFTEST           4u  /* Synthetic frame generation */
+#define APP_TASK_STATS_REPORT       5u  /* Statistics and CAN health report */
+#define APP_TASK_DISPATCH_REPORT    6u  /* List of the handled message IDs */
+#define APP_TASK_CAPTURE_DUMP       7u  /* Capture of the ingress traffic sent to the PC Tool, time records while idle */
+#define APP_TASK_NUM                8u
+
+/* Static description of one task */
+typedef struct
+{
+    void   (*Run)(void);        /* Runs to completion */
+    bool   (*IsBusy)(void);     /* Task polls the time base while true: it runs once per pass and the CPU does not sleep, NULL if never */
+    uint32_t Events;            /* Values of @defgroup Pending work event starting the task, 0 if none */
+    uint32_t PeriodMs;          /* Period, rounded down to TIMER_TICK_MS, 0 if not periodic */
+} App_TaskDesc_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/**
+  * @brief      Register the task table and clear the task statistics
+  * @param[in]  Tasks: Table of APP_TASK_NUM tasks, indexed by @defgroup Task slot
+  * @retval     None
+  */
+void App_Scheduler_Init(const App_TaskDesc_t *Tasks);
+
+/**
+  * @brief      Start a task on the next scheduler pass, called from the main loop context
+  * @param[in]  Task: it can be a value of @defgroup Task slot
+  * @retval     None
+  */
+void App_Scheduler_Activate(uint8_t Task);
+
+/**
+  * @brief      Run the ready tasks by priority and sleep while none is ready, never returns
+  * @param[in]  None
+  * @retval     None
+  */
+void App_Scheduler_Run(void);
+
+/**
+  * @brief      Read the execution statistics of one task and start a new interval
+  * @param[in]  Task:      it can be a value of @defgroup Task slot
+  * @param[out] runCnt:    Number of runs
+  * @param[out] execAvgUs: Average execution time (us)
+  * @param[out] execMaxUs: Worst execution time (us)
+  * @retval     None
+  */
+void App_Scheduler_GetTaskStats(uint8_t Task, uint32_t *runCnt, uint32_t *execAvgUs, uint32_t *execMaxUs);
+
+#endif /* APP_SCHEDULER_H_ */
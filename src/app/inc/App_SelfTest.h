@@ -0,0 +1,50 @@
+#ifndef APP_SELFTEST_H_
+#define APP_SELFTEST_H_
+
+/*******************************************************************************
+ * Include
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/* Length of the generation phase and time left afterwards for the last frames to reach UART */
+#define SELFTEST_DURATION_MS        1000u
+#define SELFTEST_DRAIN_MS           100u
+
+/* Offered load in frames per second, distance and rotation frames alternate */
+#define SELFTEST_RATE_DEFAULT       1000u
+#define SELFTEST_RATE_MAX           20000u
+
+/* Frames generated in one call at most, when the main loop falls behind the schedule */
+#define SELFTEST_BURST_MAX          4u
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/**
+  * @brief      Switch the sensor bus to loopback and start pumping synthetic sensor frames
+  * @param[in]  rate: Frames per second, 0 selects SELFTEST_RATE_DEFAULT
+  * @retval     None
+  */
+void App_SelfTest_Start(uint32_t rate);
+
+/**
+  * @brief      Check whether the self-test is running
+  * @param[in]  None
+  * @retval     true while frames are generated or drained
+  */
+bool App_SelfTest_IsRunning(void);
+
+/**
+  * @brief      Generate the frames due, finish and report the test when its time is over
+  * @param[in]  None
+  * @retval     None
+  */
+void App_SelfTest_Process(void);
+
+#endif /* APP_SELFTEST_H_ */
@@ -0,0 +1,86 @@
+#ifndef APP_STATISTICS_H_
+#define APP_STATISTICS_H_
+
+/*******************************************************************************
+ * Include
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "App_Node.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/* Statistics are kept per sensor node, refer to @defgroup Sensor node index */
+#define STATS_NODE_NUM          APP_NODE_NUM
+
+/** @defgroup Receive loss per CAN ID
+  * @{
+  */
+#define STATS_LOSS_ID_NUM       8u              /* CAN IDs tracked, further IDs are counted together */
+#define STATS_LOSS_ID_OTHER     0xFFFFFFFFu     /* Reported ID of the losses beyond the table */
+
+/* Period of the unsolicited statistics report (ms), 0: sent on request of the PC Tool only */
+#define STATS_REPORT_PERIOD_MS  0u
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/**
+  * @brief      Clear all statistics
+  * @param[in]  None
+  * @retval     None
+  */
+void App_Stats_Init(void);
+
+/**
+  * @brief      Record a sample forwarded from a sensor node to the PC Tool
+  * @param[in]  node:        Sensor node index, it can be a value of @defgroup Sensor node index
+  * @param[in]  captureTime: Time base value when the frame was captured on the bus
+  * @param[in]  forwardTime: Time base value when the frame was handed over to UART
+  * @retval     None
+  */
+void App_Stats_RecordForward(uint8_t node, uint32_t captureTime, uint32_t forwardTime);
+
+/**
+  * @brief      Record a sample of a sensor node held back by the report-on-change deadband
+  * @param[in]  node: Sensor node index, it can be a value of @defgroup Sensor node index
+  * @retval     None
+  */
+void App_Stats_RecordSuppressed(uint8_t node);
+
+/**
+  * @brief      Read the forwarding statistics of one node for the current interval
+  * @param[in]  node:         Sensor node index, it can be a value of @defgroup Sensor node index
+  * @param[out] forwardCnt:   Number of samples forwarded
+  * @param[out] latencyAvgUs: Average bus-to-UART latency (us)
+  * @param[out] latencyMaxUs: Worst bus-to-UART latency (us)
+  * @retval     None
+  */
+void App_Stats_GetForward(uint8_t node, uint32_t *forwardCnt, uint32_t *latencyAvgUs, uint32_t *latencyMaxUs);
+
+/**
+  * @brief      Record a receive mailbox overrun
+  * @param[in]  canId: ID of the frame read from the overrun mailbox
+  * @retval     None
+  */
+void App_Stats_RecordLoss(uint32_t canId);
+
+/**
+  * @brief      Start a statistics report, ignored while one is being sent
+  * @param[in]  None
+  * @retval     None
+  */
+void App_Stats_RequestReport(void);
+
+/**
+  * @brief      Queue the next blocks of the statistics report, up to UART_BULK_QUEUE_MAX bytes in the transmit queue
+  * @note       Runs on the report request, on NOTIFY_EVENT_UART_ROOM and every STATS_REPORT_PERIOD_MS
+  * @param[in]  None
+  * @retval     true if the last block of the report was queued by this call
+  */
+bool App_Stats_Process(void);
+
+#endif /* APP_STATISTICS_H_ */
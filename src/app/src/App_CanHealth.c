@@ -0,0 +1,209 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "MID_CAN_Interface.h"
+#include "MID_Timer_Interface.h"
+#include "MID_UART_Interface.h"
+#include "MID_Notification_Manager.h"
+#include "App_DataProcessing.h"
+#include "App_CanHealth.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+
+static void CanHealth_BusOffNotification(void);
+static void CanHealth_ErrorStateNotification(void);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/* Set from the FlexCAN interrupt, consumed by App_CanHealth_Process() */
+static volatile bool     BusOff_Pending      = false;
+static volatile bool     ErrorState_Changed  = false;
+static volatile uint32_t BusOff_Time         = 0u;
+
+/* Last published error state */
+static uint8_t  Error_State         = CAN_ERROR_ACTIVE;
+
+/* Transition counters */
+static uint32_t Warning_Cnt         = 0u;
+static uint32_t Passive_Cnt         = 0u;
+static uint32_t BusOff_Cnt          = 0u;
+
+/* Bus-off timing, in time base ticks */
+static uint32_t BusOff_Start        = 0u;
+static uint32_t Last_Recovery       = 0u;
+static uint32_t Last_Recovery_Us    = 0u;
+static bool     Has_Recovered       = false;
+
+/* Rate limited recovery */
+static bool     Recovery_Due        = false;
+static uint32_t Holdoff_Us          = CAN_HEALTH_HOLDOFF_MIN_US;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+/**
+  * @brief      Select the recovery policy and register the CAN error notifications
+  * @param[in]  None
+  * @retval     None
+  */
+void App_CanHealth_Init(void)
+{
+#if (CAN_HEALTH_RECOVERY_POLICY == CAN_HEALTH_RECOVERY_RATE_LIMITED)
+    MID_CAN_SetBusOffRecovery(CAN_BUSOFF_RECOVERY_MANUAL);
+#else
+    MID_CAN_SetBusOffRecovery(CAN_BUSOFF_RECOVERY_AUTO);
+#endif
+
+    MID_CAN_RegisterBusOffNotificationCallback(CanHealth_BusOffNotification);
+    MID_CAN_RegisterErrorStateNotificationCallback(CanHealth_ErrorStateNotification);
+
+    Error_State = MID_CAN_GetErrorState();
+}
+
+/**
+  * @brief      Track error state transitions and run the bus-off recovery, called from the main loop
+  * @note       Runs on NOTIFY_EVENT_CAN_STATUS and every TIMER_TICK_MS. Warning and passive are
+  *             left without interrupt, the state is read again on every tick while it is not error
+  *             active. In warning the error interrupt is armed for one error, so the way to passive
+  *             is seen without waiting for the tick.
+  * @param[in]  None
+  * @retval     None
+  */
+void App_CanHealth_Process(void)
+{
+    uint32_t now = MID_Timer_GetTimestamp();
+    uint8_t state = CAN_ERROR_ACTIVE;
+
+    if (BusOff_Pending == true)
+    {
+        BusOff_Pending = false;
+        BusOff_Start = BusOff_Time;
+        BusOff_Cnt++;
+
+#if (CAN_HEALTH_RECOVERY_POLICY == CAN_HEALTH_RECOVERY_RATE_LIMITED)
+        /* Back off further when the node falls off the bus again shortly after rejoining */
+        if ((Has_Recovered == true) && ((BusOff_Start - Last_Recovery) < MID_Timer_UsToTicks(CAN_HEALTH_STABLE_US)))
+        {
+            Holdoff_Us = ((Holdoff_Us << 1u) > CAN_HEALTH_HOLDOFF_MAX_US) ? CAN_HEALTH_HOLDOFF_MAX_US : (Holdoff_Us << 1u);
+        }
+        else
+        {
+            Holdoff_Us = CAN_HEALTH_HOLDOFF_MIN_US;
+        }
+        Recovery_Due = true;
+#endif
+    }
+
+    if ((Recovery_Due == true) && ((now - BusOff_Start) >= MID_Timer_UsToTicks(Holdoff_Us)))
+    {
+        Recovery_Due = false;
+        MID_CAN_RecoverBusOff();
+    }
+
+    if ((ErrorState_Changed == true) || (Error_State != CAN_ERROR_ACTIVE))
+    {
+        ErrorState_Changed = false;
+        state = MID_CAN_GetErrorState();
+
+        if (state != Error_State)
+        {
+            if (state == CAN_ERROR_WARNING)
+            {
+                Warning_Cnt++;
+            }
+            else if (state == CAN_ERROR_PASSIVE)
+            {
+                Passive_Cnt++;
+            }
+            else
+            {
+                /* Do nothing */
+            }
+
+            /* Node is back on the bus */
+            if ((Error_State == CAN_BUS_OFF) && (state != CAN_BUS_OFF))
+            {
+                Last_Recovery    = now;
+                Last_Recovery_Us = MID_Timer_TicksToUs(now - BusOff_Start);
+                Has_Recovered    = true;
+            }
+
+            Error_State = state;
+            App_CanHealth_Report();
+        }
+
+        if (Error_State == CAN_ERROR_WARNING)
+        {
+            MID_CAN_EnableErrorNotification();
+        }
+        else
+        {
+            /* Do nothing */
+        }
+    }
+}
+
+/**
+  * @brief      Check whether the health tracking polls the time base for the recovery hold-off
+  * @param[in]  None
+  * @retval     true while a recovery is due
+  */
+bool App_CanHealth_IsBusy(void)
+{
+    return (Recovery_Due == true);
+}
+
+/**
+  * @brief      Send the CAN health telemetry to the PC Tool
+  * @param[in]  None
+  * @retval     None
+  */
+void App_CanHealth_Report(void)
+{
+    uint8_t txErrCnt = 0u;
+    uint8_t rxErrCnt = 0u;
+
+    MID_CAN_GetErrorCounters(&txErrCnt, &rxErrCnt);
+
+    APP_Send_UARTFrame(CAN_HEALTH_STATE_ID, Error_State);
+    APP_Send_UARTFrame(CAN_HEALTH_TX_ERR_CNT_ID, txErrCnt);
+    APP_Send_UARTFrame(CAN_HEALTH_RX_ERR_CNT_ID, rxErrCnt);
+    APP_Send_UARTFrame(CAN_HEALTH_WARNING_CNT_ID, Warning_Cnt);
+    APP_Send_UARTFrame(CAN_HEALTH_PASSIVE_CNT_ID, Passive_Cnt);
+    APP_Send_UARTFrame(CAN_HEALTH_BUS_OFF_CNT_ID, BusOff_Cnt);
+    APP_Send_UARTFrame(CAN_HEALTH_RECOVERY_TIME_ID, Last_Recovery_Us);
+
+    MID_UART_SetTxInterrupt(true);
+}
+
+/**
+  * @brief      Bus-off notification, called from the FlexCAN interrupt
+  * @param[in]  None
+  * @retval     None
+  */
+static void CanHealth_BusOffNotification(void)
+{
+    BusOff_Time = MID_Timer_GetTimestamp();
+    BusOff_Pending = true;
+    ErrorState_Changed = true;
+    MID_Notification_Raise(NOTIFY_EVENT_CAN_STATUS);
+}
+
+/**
+  * @brief      Error warning, bus error and bus-off recovery done notification, called from the FlexCAN interrupt
+  * @param[in]  None
+  * @retval     None
+  */
+static void CanHealth_ErrorStateNotification(void)
+{
+    ErrorState_Changed = true;
+    MID_Notification_Raise(NOTIFY_EVENT_CAN_STATUS);
+}
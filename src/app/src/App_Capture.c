@@ -0,0 +1,404 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "MID_CAN_Interface.h"
+#include "MID_Timer_Interface.h"
+#include "MID_UART_Interface.h"
+#include "MID_TransmitQueue_Interface.h"
+#include "MID_Notification_Manager.h"
+#include "App_DataProcessing.h"
+#include "App_Capture.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/** @defgroup Capture state
+  * @{
+  */
+#define CAPTURE_STOPPED             0u
+#define CAPTURE_RUNNING             1u
+#define CAPTURE_DUMPING             2u
+
+#define CAPTURE_INDEX_MASK          (CAPTURE_BUFFER_SIZE - 1u)
+
+/* Capture_UartTag when the last record is not a UART one */
+#define CAPTURE_NO_RUN              0xFFFFu
+
+/* Largest 11-bit identifier */
+#define CAPTURE_STD_ID_MAX          0x7FFu
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+
+static void Capture_Dump(void);
+static uint16_t Capture_Append(uint8_t tag, uint32_t time, const uint8_t *body, uint8_t length);
+static void Capture_MakeRoom(uint16_t length);
+static uint8_t Capture_CodeTime(uint32_t time, uint8_t *output);
+static uint16_t Capture_RecordLength(uint16_t index);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/* Records are written by the receive interrupts and read by the dump task once they stopped */
+static volatile uint8_t Capture_State = CAPTURE_STOPPED;
+
+static uint8_t  Capture_Buffer[CAPTURE_BUFFER_SIZE];
+static uint16_t Capture_Head     = 0u;     /* Next byte written */
+static uint16_t Capture_Used     = 0u;     /* Bytes held, the oldest record starts at Head - Used */
+static uint32_t Capture_Lost     = 0u;     /* Records overwritten */
+
+/* Time the delay of the next record is counted from, in time base ticks */
+static uint32_t Capture_LastTime = 0u;
+
+/* UART record the next byte may be appended to */
+static uint16_t Capture_UartTag  = CAPTURE_NO_RUN;  /* Position of its tag */
+static uint32_t Capture_UartTime = 0u;              /* Time of its last byte */
+
+/* Dump progress */
+static uint16_t Dump_Offset      = 0u;
+static bool     Dump_HeaderSent  = false;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+/**
+  * @brief      Clear the capture and start recording
+  * @note       Ignored while a dump is running
+  * @param[in]  None
+  * @retval     None
+  */
+void App_Capture_Start(void)
+{
+    if (Capture_State != CAPTURE_DUMPING)
+    {
+        Capture_State    = CAPTURE_STOPPED;
+        Capture_Head     = 0u;
+        Capture_Used     = 0u;
+        Capture_Lost     = 0u;
+        Capture_UartTag  = CAPTURE_NO_RUN;
+        Capture_LastTime = MID_Timer_GetTimestamp();
+        Capture_State    = CAPTURE_RUNNING;
+    }
+}
+
+/**
+  * @brief      Append a CAN frame to the capture, called from the receive interrupt
+  * @param[in]  frame:       Received frame
+  * @param[in]  captureTime: Time base value when the frame was captured on the bus
+  * @retval     None
+  */
+void App_Capture_RecordCan(const Data_Typedef *frame, uint32_t captureTime)
+{
+    uint8_t body[4u + CAN_MAX_DATA_LENGTH];
+    uint8_t length = 0u;
+    uint8_t dlc = (frame->Length > CAN_MAX_DATA_LENGTH) ? CAN_MAX_DATA_LENGTH : frame->Length;
+    uint8_t tag = CAPTURE_REC_CAN_STD;
+    uint8_t index = 0u;
+
+    if (Capture_State == CAPTURE_RUNNING)
+    {
+        if ((frame->IdType == CAN_ID_EXTENDED) || (frame->ID > CAPTURE_STD_ID_MAX))
+        {
+            tag = CAPTURE_REC_CAN_EXT;
+            body[length++] = (uint8_t)(frame->ID >> 24u);
+            body[length++] = (uint8_t)(frame->ID >> 16u);
+        }
+
+        body[length++] = (uint8_t)(frame->ID >> 8u);
+        body[length++] = (uint8_t)(frame->ID);
+
+        for (index = 0u; index < dlc; index++)
+        {
+            body[length++] = frame->Payload[index];
+        }
+
+        (void)Capture_Append((uint8_t)(tag | dlc), captureTime, body, length);
+        Capture_UartTag = CAPTURE_NO_RUN;
+    }
+}
+
+/**
+  * @brief      Append a byte received from the PC Tool to the capture, called from the receive interrupt
+  * @param[in]  data: Received byte
+  * @retval     None
+  */
+void App_Capture_RecordUart(uint8_t data)
+{
+    uint32_t now = MID_Timer_GetTimestamp();
+
+    if (Capture_State == CAPTURE_RUNNING)
+    {
+        if ((Capture_UartTag != CAPTURE_NO_RUN) &&
+            ((Capture_Buffer[Capture_UartTag] & CAPTURE_REC_DLC_MASK) < CAPTURE_REC_DLC_MASK) &&
+            ((now - Capture_UartTime) <= MID_Timer_UsToTicks(CAPTURE_UART_RUN_GAP_US)))
+        {
+            /* Byte of the same line, one byte instead of a record. The record is the newest, the room is taken from older ones. */
+            Capture_MakeRoom(1u);
+            Capture_Buffer[Capture_Head] = data;
+            Capture_Head = (Capture_Head + 1u) & CAPTURE_INDEX_MASK;
+            Capture_Used++;
+            Capture_Buffer[Capture_UartTag]++;
+        }
+        else
+        {
+            Capture_UartTag = Capture_Append(CAPTURE_REC_UART, now, &data, 1u);
+        }
+
+        Capture_UartTime = now;
+    }
+}
+
+/**
+  * @brief      Stop recording and start sending the capture to the PC Tool
+  * @note       CAPTURE_LOST_ID and CAPTURE_SIZE_ID come first, then the records as
+  *             CAPTURE_DATA_ID words. Recording resumes on App_Capture_Start() only.
+  * @param[in]  None
+  * @retval     None
+  */
+void App_Capture_RequestDump(void)
+{
+    if (Capture_State != CAPTURE_DUMPING)
+    {
+        /* Both receive interrupts have the same priority as the writer, none is half way through a record here */
+        Capture_State   = CAPTURE_DUMPING;
+        Dump_Offset     = 0u;
+        Dump_HeaderSent = false;
+    }
+}
+
+/**
+  * @brief      Queue the next words of the capture, up to UART_BULK_QUEUE_MAX bytes in the transmit queue,
+  *             or write a time record after CAPTURE_IDLE_US without record
+  * @note       Runs on the dump request, on NOTIFY_EVENT_UART_ROOM and every TIMER_TICK_MS, never by polling
+  * @param[in]  None
+  * @retval     None
+  */
+void App_Capture_Process(void)
+{
+    uint32_t now = 0u;
+    uint32_t primask = 0u;
+
+    if (Capture_State == CAPTURE_RUNNING)
+    {
+        /* The receive interrupts write records too */
+        primask = MID_Notification_EnterCritical();
+        now = MID_Timer_GetTimestamp();
+
+        if ((Capture_State == CAPTURE_RUNNING) && ((now - Capture_LastTime) >= MID_Timer_UsToTicks(CAPTURE_IDLE_US)))
+        {
+            (void)Capture_Append(CAPTURE_REC_TIME, now, NULL, 0u);
+            Capture_UartTag = CAPTURE_NO_RUN;
+        }
+        else
+        {
+            /* Do nothing */
+        }
+
+        MID_Notification_ExitCritical(primask);
+    }
+    else
+    {
+        Capture_Dump();
+    }
+}
+
+/**
+  * @brief      Queue the next words of the capture, as many as the transmit queue takes
+  * @note       The dump fills the transmit queue up to UART_BULK_QUEUE_MAX. A frame
+  *             without room is composed again when the queue drained to UART_BULK_RESUME_LEVEL
+  *             (NOTIFY_EVENT_UART_ROOM), the dump never drops a word.
+  * @param[in]  None
+  * @retval     None
+  */
+static void Capture_Dump(void)
+{
+    UARTFrame_t frame;
+    uint8_t  header[2u * UART_FRAME_LENGTH_MAX];
+    uint16_t headerLength = 0u;
+    uint16_t start = (uint16_t)((Capture_Head - Capture_Used) & CAPTURE_INDEX_MASK);
+    uint32_t word = 0u;
+    uint8_t index = 0u;
+    bool queued = true;
+
+    if (Capture_State == CAPTURE_DUMPING)
+    {
+        if (Dump_HeaderSent == false)
+        {
+            /* Both header frames are queued as one block, the PC Tool never gets the size alone */
+            APP_Prepare_UARTFrame(&frame, CAPTURE_LOST_ID, Capture_Lost);
+            memcpy(header, frame.Text, frame.Length);
+            headerLength = frame.Length;
+            APP_Prepare_UARTFrame(&frame, CAPTURE_SIZE_ID, Capture_Used);
+            memcpy(&header[headerLength], frame.Text, frame.Length);
+            headerLength += frame.Length;
+
+            queued = ((MID_Transmit_GetCount() + headerLength) <= UART_BULK_QUEUE_MAX) &&
+                     (MID_Transmit_EnqueueBlock(header, headerLength) == QUEUE_DONE_SUCCESS);
+            Dump_HeaderSent = queued;
+        }
+
+        while ((queued == true) && (Dump_Offset < Capture_Used))
+        {
+            word = 0u;
+
+            for (index = 0u; index < 4u; index++)
+            {
+                word <<= 8u;
+
+                if ((Dump_Offset + index) < Capture_Used)
+                {
+                    word |= Capture_Buffer[(start + Dump_Offset + index) & CAPTURE_INDEX_MASK];
+                }
+            }
+
+            APP_Prepare_UARTFrame(&frame, CAPTURE_DATA_ID, word);
+            queued = ((MID_Transmit_GetCount() + frame.Length) <= UART_BULK_QUEUE_MAX) &&
+                     (MID_Transmit_EnqueueBlock(frame.Text, frame.Length) == QUEUE_DONE_SUCCESS);
+
+            if (queued == true)
+            {
+                Dump_Offset += 4u;
+            }
+        }
+
+        if ((Dump_HeaderSent == true) && (Dump_Offset >= Capture_Used))
+        {
+            Capture_State = CAPTURE_STOPPED;
+        }
+
+        MID_UART_SetTxInterrupt(true);
+    }
+}
+
+/**
+  * @brief      Write one record at the head, the oldest records make room for it
+  * @param[in]  tag:    First byte of the record, refer to @defgroup Capture record
+  * @param[in]  time:   Time base value of the record
+  * @param[in]  body:   CAN ID and data, the UART byte, or NULL for a time record
+  * @param[in]  length: Number of bytes in body
+  * @retval     Position of the tag of the record
+  */
+static uint16_t Capture_Append(uint8_t tag, uint32_t time, const uint8_t *body, uint8_t length)
+{
+    uint16_t position = 0u;
+    uint8_t  timeCode[CAPTURE_TIME_BYTES_MAX];
+    uint8_t  timeLength = 0u;
+    uint16_t total = 0u;
+    uint8_t  index = 0u;
+    uint32_t behind = Capture_LastTime - time;
+    bool     older = (behind != 0u) && (behind <= MID_Timer_UsToTicks(CAPTURE_CAN_AGE_MAX_US));
+    uint32_t elapsedUs = MID_Timer_TicksToUs((older == true) ? behind : (time - Capture_LastTime));
+
+    /* Only a CAN frame is older than the reference, by its age on the bus at most. Time records keep the
+     * other delays below CAPTURE_IDLE_US. The reference moves by the recorded delay only, the rounding
+     * does not build up over records. */
+    if (older == true)
+    {
+        Capture_LastTime -= MID_Timer_UsToTicks(elapsedUs);
+        timeLength = Capture_CodeTime((elapsedUs << 1u) | CAPTURE_TIME_SIGN, timeCode);
+    }
+    else
+    {
+        Capture_LastTime += MID_Timer_UsToTicks(elapsedUs);
+        timeLength = Capture_CodeTime(elapsedUs << 1u, timeCode);
+    }
+
+    total = (uint16_t)(1u + timeLength + length);
+    Capture_MakeRoom(total);
+
+    position = Capture_Head;
+    Capture_Buffer[Capture_Head] = tag;
+    Capture_Head = (Capture_Head + 1u) & CAPTURE_INDEX_MASK;
+
+    for (index = 0u; index < timeLength; index++)
+    {
+        Capture_Buffer[Capture_Head] = timeCode[index];
+        Capture_Head = (Capture_Head + 1u) & CAPTURE_INDEX_MASK;
+    }
+
+    for (index = 0u; index < length; index++)
+    {
+        Capture_Buffer[Capture_Head] = body[index];
+        Capture_Head = (Capture_Head + 1u) & CAPTURE_INDEX_MASK;
+    }
+
+    Capture_Used += total;
+
+    return position;
+}
+
+/**
+  * @brief      Drop the oldest records until a number of bytes is free
+  * @param[in]  length: Bytes needed
+  * @retval     None
+  */
+static void Capture_MakeRoom(uint16_t length)
+{
+    while ((CAPTURE_BUFFER_SIZE - Capture_Used) < length)
+    {
+        Capture_Used -= Capture_RecordLength((uint16_t)((Capture_Head - Capture_Used) & CAPTURE_INDEX_MASK));
+        Capture_Lost++;
+    }
+}
+
+/**
+  * @brief      Code a record time 7 bits per byte, lowest first
+  * @param[in]  time:   Delay and sign, refer to @defgroup Capture record
+  * @param[out] output: CAPTURE_TIME_BYTES_MAX bytes at most
+  * @retval     Number of bytes written
+  */
+static uint8_t Capture_CodeTime(uint32_t time, uint8_t *output)
+{
+    uint8_t length = 0u;
+
+    while (time >= CAPTURE_TIME_MORE)
+    {
+        output[length++] = (uint8_t)(time | CAPTURE_TIME_MORE);
+        time >>= 7u;
+    }
+    output[length++] = (uint8_t)time;
+
+    return length;
+}
+
+/**
+  * @brief      Get the length of the record starting at an index of the buffer
+  * @param[in]  index: Position of the tag
+  * @retval     Bytes of the record
+  */
+static uint16_t Capture_RecordLength(uint16_t index)
+{
+    uint8_t  tag = Capture_Buffer[index];
+    uint16_t length = 1u;
+
+    /* Time bytes, the last one has bit 7 clear */
+    while ((Capture_Buffer[(index + length) & CAPTURE_INDEX_MASK] & CAPTURE_TIME_MORE) != 0u)
+    {
+        length++;
+    }
+    length++;
+
+    switch (tag & CAPTURE_REC_TYPE_MASK)
+    {
+    case CAPTURE_REC_CAN_STD:
+        length += 2u + (tag & CAPTURE_REC_DLC_MASK);
+        break;
+
+    case CAPTURE_REC_CAN_EXT:
+        length += 4u + (tag & CAPTURE_REC_DLC_MASK);
+        break;
+
+    case CAPTURE_REC_TIME:
+        break;
+
+    default:
+        length += 1u + (tag & CAPTURE_REC_DLC_MASK);
+        break;
+    }
+
+    return length;
+}
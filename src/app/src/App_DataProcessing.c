@@ -1,3 +1,5 @@
+#include <string.h>
+#include "MID_TransmitQueue_Interface.h"
 #include "App_DataProcessing.h"
 
 /*******************************************************************************
@@ -5,24 +7,87 @@
  ******************************************************************************/
 
 #define DECIMAL_BASE  (10u)
-#define MAX_VALUE_STR  (5u)
+#define MAX_VALUE_STR  (10u) /* uint32_t has at most 10 decimal digits */
+
+/* Byte SIMD of the DSP extension classifies four characters at once, plain C elsewhere.
+ * A host test may force it and provide __usub8() and __sel() itself, refer to sim/test/Test_Parser.c */
+#ifndef PARSER_USE_SIMD32
+#if defined(__ARM_FEATURE_SIMD32) && (__ARM_FEATURE_SIMD32 == 1)
+#define PARSER_USE_SIMD32   1u
+#else
+#define PARSER_USE_SIMD32   0u
+#endif
+#endif
+
+#if (PARSER_USE_SIMD32 == 1u) && defined(__ARM_FEATURE_SIMD32)
+#include <arm_acle.h>
+#endif
+
+#define ASCII_ZERO_X4       0x30303030u     /* '0' in every byte */
+#define DIGIT_MAX_X4        0x09090909u     /* 9 in every byte */
+#define BYTE_LOW7_X4        0x7F7F7F7Fu
+#define DIGIT_LIMIT_X4      0x76767676u     /* 0x7F - 9 in every byte */
+#define BYTE_HIGH_X4        0x80808080u
+
+#if (UART_ITOA_BENCHMARK == 1u) || (UART_PARSER_BENCHMARK == 1u)
+/* DWT cycle counter of the Cortex-M4 */
+#define DWT_CTRL            (*(volatile uint32_t *)0xE0001000u)
+#define DWT_CYCCNT          (*(volatile uint32_t *)0xE0001004u)
+#define DEMCR               (*(volatile uint32_t *)0xE000EDFCu)
+#define DWT_CTRL_CYCCNTENA  (1u << 0u)
+#define DEMCR_TRCENA        (1u << 24u)
+
+#define BENCHMARK_VALUE_NUM 256u    /* Values converted per measurement */
+
+#define BENCHMARK_ENABLE_CYCLE_COUNTER()    do { DEMCR |= DEMCR_TRCENA; DWT_CYCCNT = 0u; DWT_CTRL |= DWT_CTRL_CYCCNTENA; } while (0)
+#endif
+
+/* value / 100 as (value * ceil(2^37 / 100)) >> 37, exact for every uint32_t */
+#define DIV_BY_100(value)   ((uint32_t)(((uint64_t)(value) * 0x51EB851Fu) >> 37u))
 
 /*******************************************************************************
  * Prototypes
  ******************************************************************************/
 
 static uint8_t UIntToString(uint32_t value, uint8_t *buffer);
+static uint8_t UIntDigitCount(uint32_t value);
+static bool ParseNumber(const uint8_t *str, uint8_t length, uint8_t *pos, uint32_t limit, uint32_t *value);
+static uint32_t NonDigitMask(uint32_t word);
+static uint32_t FourDigitsValue(uint32_t word);
+#if (UART_ITOA_BENCHMARK == 1u)
+static uint8_t UIntToString_Legacy(uint32_t value, uint8_t *buffer);
+#endif
+#if (UART_PARSER_BENCHMARK == 1u)
+static bool Parser_UARTFrame_Legacy(const uint8_t* str, int length, ReceiveFrame_t *Output);
+#endif
 
 /*******************************************************************************
  * Variables
  ******************************************************************************/
 
+/* ASCII digits of 00 to 99, two characters per number */
+static const uint8_t Digit_Pairs[200] =
+{
+    '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+    '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+    '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+    '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+    '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+    '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+    '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+    '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+    '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+    '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+};
+
 /*******************************************************************************
  * Code
  ******************************************************************************/
 
 /**
   * @brief  Function to parser the string and extract 2 unsigned integers
+  * @note   The string must be "<id>-<data>" in decimal, with id up to UART_FRAME_ID_MAX
+  *         and data up to UART_FRAME_DATA_MAX. Output is left untouched on failure.
   * @param[in]  str   Pointer to the input string to be parsed.
   * @param[in]  length Length of the input string (excluding any null terminator).
   * @param[out] Output  Pointer to store Message frame struct (contain ID and Data).
@@ -30,52 +95,126 @@ static uint8_t UIntToString(uint32_t value, uint8_t *buffer);
   */
 bool App_Parser_UARTFrame(const uint8_t* str, int length, ReceiveFrame_t *Output)
 {
-    uint32_t temp1           = 0u;
-    uint32_t temp2           = 0u;
-    uint8_t idx              = 0u;
-    uint8_t is_second_number = 0u;
+    uint32_t id   = 0u;
+    uint32_t data = 0u;
+    uint8_t  pos  = 0u;
+    bool     valid = false;
 
-    /* Pass through each character in the string */
-    while (idx < length)
+    if ((str != NULL) && (length > 0) && (length <= UINT8_MAX))
     {
-        if (str[idx] >= '0' && str[idx] <= '9')
+        /* "<id>", then exactly one '-', then "<data>" up to the end */
+        if (ParseNumber(str, (uint8_t)length, &pos, UART_FRAME_ID_MAX, &id) == true)
         {
-            if (is_second_number)
-            {
-                temp2 = temp2 * 10 + (str[idx] - '0');
-            } else
+            if ((pos < length) && (str[pos] == '-'))
             {
-                temp1 = temp1 * 10 + (str[idx] - '0');
+                pos++;
+                if (ParseNumber(str, (uint8_t)length, &pos, UART_FRAME_DATA_MAX, &data) == true)
+                {
+                    valid = (pos == length);
+                }
             }
         }
-        else if (str[idx] == '-')
-        {
-            if (is_second_number)
-            {
-                return false; /* Invalid string (more than one '-') */
-            }
-            is_second_number = 1; /* Switch to parsing the second number */
-        }
-        else
+    }
+
+    if (valid == true)
+    {
+        Output->ID   = id;
+        Output->Data = (uint16_t)data;
+    }
+
+    return valid;
+}
+
+/**
+  * @brief  Parse the decimal number starting at a position, four digits at a time while possible
+  * @param[in]     str     Pointer to the input string.
+  * @param[in]     length  Length of the input string.
+  * @param[in,out] pos     Position of the first digit, set after the last digit on return.
+  * @param[in]     limit   Largest value accepted.
+  * @param[out]    value   Value of the number.
+  * @return true if at least one digit was found and the value does not exceed limit.
+  */
+static bool ParseNumber(const uint8_t *str, uint8_t length, uint8_t *pos, uint32_t limit, uint32_t *value)
+{
+    uint32_t word = 0u;
+    uint32_t acc = 0u;
+    uint8_t  start = *pos;
+    uint8_t  idx = *pos;
+    bool     inRange = true;
+
+    /* Whole words of digits. acc stays below (limit + 1) * 10000, it cannot overflow for limits below 429496 */
+    while (((idx + 4u) <= length) && (inRange == true))
+    {
+        memcpy(&word, &str[idx], sizeof(word));
+        if (NonDigitMask(word) != 0u)
         {
-            return false; /* Invalid character */
+            break;
         }
+        acc = (acc * 10000u) + FourDigitsValue(word);
+        inRange = (acc <= limit);
+        idx += 4u;
+    }
+
+    /* Remaining digits */
+    while ((idx < length) && (inRange == true) && ((uint8_t)(str[idx] - '0') <= 9u))
+    {
+        acc = (acc * DECIMAL_BASE) + (uint32_t)(str[idx] - '0');
+        inRange = (acc <= limit);
         idx++;
     }
 
-    Output->ID   = temp1;
-    Output->Data = temp2;
+    *value = acc;
+    *pos = idx;
 
-    return true;
+    return ((idx > start) && (inRange == true));
+}
+
+/**
+  * @brief  Flag the characters of a word that are not decimal digits
+  * @param[in]  word  Four characters, the first one in the lowest byte.
+  * @return 0 if the four characters are digits, non zero otherwise.
+  */
+static uint32_t NonDigitMask(uint32_t word)
+{
+#if (PARSER_USE_SIMD32 == 1u)
+    /* Per byte c - '0', then GE set where 9 >= c - '0': only digits, the others wrap to large values */
+    uint32_t offset = __usub8(word, ASCII_ZERO_X4);
+
+    (void)__usub8(DIGIT_MAX_X4, offset);
+
+    return __sel(0u, 0xFFFFFFFFu);
+#else
+    /* Per byte c ^ '0' is 0..9 only for digits. Adding 0x7F - 9 to the low 7 bits sets bit 7 above 9
+     * without carry into the next byte, the OR catches the bytes having bit 7 set already. */
+    uint32_t offset = word ^ ASCII_ZERO_X4;
+
+    return (((offset & BYTE_LOW7_X4) + DIGIT_LIMIT_X4) | offset) & BYTE_HIGH_X4;
+#endif
+}
+
+/**
+  * @brief  Value of four decimal digits
+  * @param[in]  word  Four digit characters, the most significant one in the lowest byte.
+  * @return Value 0 to 9999.
+  */
+static uint32_t FourDigitsValue(uint32_t word)
+{
+    uint32_t digits = word - ASCII_ZERO_X4;   /* No borrow, every byte is '0' or above */
+
+    /* Pairs: d0 * 10 + d1 in byte 0, d2 * 10 + d3 in byte 2 */
+    digits = ((digits * 10u) + (digits >> 8u)) & 0x00FF00FFu;
+
+    return ((digits & 0xFFu) * 100u) + (digits >> 16u);
 }
 
 /**
  * @brief  Function to convert ID and Data to a UART string that can be printed out
  * @param[in]  id       ID of the frame
  * @param[in]  data     Data of the frame
- * @param[out] outputBuffer  Pointer to store the output string
+ * @param[out] outputBuffer  Pointer to store the output string, UART_FRAME_LENGTH_MAX bytes
+ * @return Length of the string, terminator excluded
  */
-void APP_Compose_UARTFrame(uint32_t id, uint32_t data, uint8_t *outputBuffer)
+uint8_t APP_Compose_UARTFrame(uint32_t id, uint32_t data, uint8_t *outputBuffer)
 {
     uint8_t *ptr = outputBuffer;
 
@@ -88,45 +227,283 @@ void APP_Compose_UARTFrame(uint32_t id, uint32_t data, uint8_t *outputBuffer)
     *ptr++ = '\n';
 
     *ptr = '\0';
+
+    return (uint8_t)(ptr - outputBuffer);
+}
+
+/**
+ * @brief  Compose a UART frame to be emitted later, constant replies are prepared once at init
+ * @param[out] frame    Frame to fill
+ * @param[in]  id       ID of the frame
+ * @param[in]  data     Data of the frame
+ */
+void APP_Prepare_UARTFrame(UARTFrame_t *frame, uint32_t id, uint32_t data)
+{
+    frame->Length = APP_Compose_UARTFrame(id, data, frame->Text);
+}
+
+/**
+ * @brief  Push a composed UART frame to the transmit queue in one block
+ * @note   The frame is dropped whole when the queue has no room for it. The caller
+ *         enables the Tx interrupt once all its frames are queued.
+ * @param[in]  frame    Frame to send
+ */
+void APP_Emit_UARTFrame(const UARTFrame_t *frame)
+{
+    (void)MID_Transmit_EnqueueBlock(frame->Text, frame->Length);
+}
+
+/**
+ * @brief  Compose a UART frame and push it to the transmit queue
+ * @note   The caller enables the Tx interrupt once all its frames are queued.
+ * @param[in]  id       ID of the frame
+ * @param[in]  data     Data of the frame
+ */
+void APP_Send_UARTFrame(uint32_t id, uint32_t data)
+{
+    UARTFrame_t frame;
+
+    APP_Prepare_UARTFrame(&frame, id, data);
+    APP_Emit_UARTFrame(&frame);
 }
 
 /**
  * @brief  Converts an unsigned integer to a null-terminated string in decimal (base 10) format.
  *
+ * The digit count is found first, then the digits are written from the end of the
+ * output two at a time from Digit_Pairs[]. Division by 100 is a multiplication by
+ * its reciprocal, exact for the whole uint32_t range.
+ *
  * @param[in]  value   The unsigned integer to be converted.
  * @param[out] buffer  The buffer where the resulting string will be stored.
  *
  * @return  The length of the resulting string.
  */
 static uint8_t UIntToString(uint32_t value, uint8_t *buffer)
+{
+    uint8_t length = UIntDigitCount(value);
+    uint8_t *ptr = &buffer[length];
+    uint32_t quotient = 0u;
+    uint32_t pair = 0u;
+
+    *ptr = '\0';
+
+    /* Two digits per step, lowest first */
+    while (value >= 100u)
+    {
+        quotient = DIV_BY_100(value);
+        pair = (value - (quotient * 100u)) * 2u;
+        value = quotient;
+
+        *--ptr = Digit_Pairs[pair + 1u];
+        *--ptr = Digit_Pairs[pair];
+    }
+
+    /* One or two leading digits */
+    if (value >= 10u)
+    {
+        pair = value * 2u;
+        *--ptr = Digit_Pairs[pair + 1u];
+        *--ptr = Digit_Pairs[pair];
+    }
+    else
+    {
+        *--ptr = (uint8_t)('0' + value);
+    }
+
+    return length;
+}
+
+/**
+ * @brief  Counts the decimal digits of an unsigned integer.
+ *
+ * @param[in]  value   The unsigned integer.
+ *
+ * @return  Number of digits, 1 for 0.
+ */
+static uint8_t UIntDigitCount(uint32_t value)
+{
+    uint8_t count = 1u;
+
+    if (value >= 100000u)
+    {
+        count = 6u;
+        if (value >= 10000000u)
+        {
+            count = (value >= 1000000000u) ? 10u : ((value >= 100000000u) ? 9u : 8u);
+        }
+        else
+        {
+            count = (value >= 1000000u) ? 7u : 6u;
+        }
+    }
+    else
+    {
+        if (value >= 100u)
+        {
+            count = (value >= 10000u) ? 5u : ((value >= 1000u) ? 4u : 3u);
+        }
+        else
+        {
+            count = (value >= 10u) ? 2u : 1u;
+        }
+    }
+
+    return count;
+}
+
+#if (UART_ITOA_BENCHMARK == 1u)
+/**
+ * @brief  Measure the integer to text conversion against the former divide by 10 version
+ * @note   Cycles are counted by the DWT cycle counter over the same set of values.
+ * @param[out] legacyCycles  Cycles of the divide by 10 and reverse version
+ * @param[out] fastCycles    Cycles of the digit pair version
+ */
+void APP_Benchmark_UIntToString(uint32_t *legacyCycles, uint32_t *fastCycles)
+{
+    uint8_t buffer[MAX_VALUE_STR + 1u];
+    uint32_t value = 0u;
+    uint32_t start = 0u;
+    uint16_t idx = 0u;
+
+    BENCHMARK_ENABLE_CYCLE_COUNTER();
+
+    /* Same pseudo random values with all digit counts for both versions */
+    start = DWT_CYCCNT;
+    for (idx = 0u, value = 1u; idx < BENCHMARK_VALUE_NUM; idx++)
+    {
+        value = (value * 1664525u) + 1013904223u;
+        (void)UIntToString_Legacy(value >> (idx & 31u), buffer);
+    }
+    *legacyCycles = DWT_CYCCNT - start;
+
+    start = DWT_CYCCNT;
+    for (idx = 0u, value = 1u; idx < BENCHMARK_VALUE_NUM; idx++)
+    {
+        value = (value * 1664525u) + 1013904223u;
+        (void)UIntToString(value >> (idx & 31u), buffer);
+    }
+    *fastCycles = DWT_CYCCNT - start;
+}
+
+/**
+ * @brief  Former conversion, a division by 10 per digit then a reversal pass. Kept as benchmark reference.
+ *
+ * @param[in]  value   The unsigned integer to be converted.
+ * @param[out] buffer  The buffer where the resulting string will be stored.
+ *
+ * @return  The length of the resulting string.
+ */
+static uint8_t UIntToString_Legacy(uint32_t value, uint8_t *buffer)
 {
     uint8_t temp[MAX_VALUE_STR];  /* Temporary buffer to store digits in reverse order.    */
     uint8_t digitIndex = 0u;      /* Index for storing digits in the temporary buffer.     */
     uint8_t reverseIndex = 0u;    /* Index for reversing the digits into the final buffer. */
 
-    /* Handle the special case where the value is 0. */
     if (value == 0u)
     {
-        buffer[digitIndex++] = '0'; /* Add '0' to the buffer. */
-        buffer[digitIndex] = '\0';  /* Null-terminate the string. */
+        buffer[digitIndex++] = '0';
+        buffer[digitIndex] = '\0';
         reverseIndex = digitIndex;
     }
     else
     {
-        /* Extract digits from the number and store them in reverse order in the temp buffer. */
         while (value > 0u)
         {
-            temp[digitIndex++] = (value % DECIMAL_BASE) + '0'; /* Get the last digit and convert to a character. */
-            value /= DECIMAL_BASE;                             /* Remove the last digit from the number. */
+            temp[digitIndex++] = (value % DECIMAL_BASE) + '0';
+            value /= DECIMAL_BASE;
         }
 
-        /* Reverse the digits from the temp buffer into the final buffer. */
         for (reverseIndex = 0u; reverseIndex < digitIndex; reverseIndex++)
         {
             buffer[reverseIndex] = temp[digitIndex - 1u - reverseIndex];
         }
-        buffer[reverseIndex] = '\0'; /* Null-terminate the string. */
+        buffer[reverseIndex] = '\0';
     }
 
-    return reverseIndex; /* Return the length of the resulting string. */
+    return reverseIndex;
+}
+#endif
+
+#if (UART_PARSER_BENCHMARK == 1u)
+/**
+  * @brief  Measure the UART frame parser against the former character by character version
+  * @note   Cycles are counted by the DWT cycle counter over the same set of frames.
+  * @param[out] legacyCycles  Cycles of the character by character version
+  * @param[out] fastCycles    Cycles of the word at a time version
+  */
+void APP_Benchmark_ParserUARTFrame(uint32_t *legacyCycles, uint32_t *fastCycles)
+{
+    static const char * const frames[] = { "160-0", "208-65535", "176-1", "161-12345", "163-20000", "144-0" };
+    ReceiveFrame_t frame = {0u};
+    uint32_t start = 0u;
+    uint16_t idx = 0u;
+    uint8_t  sel = 0u;
+
+    BENCHMARK_ENABLE_CYCLE_COUNTER();
+
+    start = DWT_CYCCNT;
+    for (idx = 0u; idx < BENCHMARK_VALUE_NUM; idx++)
+    {
+        sel = (uint8_t)(idx % (sizeof(frames) / sizeof(frames[0])));
+        (void)Parser_UARTFrame_Legacy((const uint8_t *)frames[sel], (int)strlen(frames[sel]), &frame);
+    }
+    *legacyCycles = DWT_CYCCNT - start;
+
+    start = DWT_CYCCNT;
+    for (idx = 0u; idx < BENCHMARK_VALUE_NUM; idx++)
+    {
+        sel = (uint8_t)(idx % (sizeof(frames) / sizeof(frames[0])));
+        (void)App_Parser_UARTFrame((const uint8_t *)frames[sel], (int)strlen(frames[sel]), &frame);
+    }
+    *fastCycles = DWT_CYCCNT - start;
+}
+
+/**
+  * @brief  Former parser, one branch per character and no range check. Kept as benchmark reference.
+  * @param[in]  str   Pointer to the input string to be parsed.
+  * @param[in]  length Length of the input string (excluding any null terminator).
+  * @param[out] Output  Pointer to store Message frame struct (contain ID and Data).
+  * @return true if the string holds digits and at most one '-'.
+  */
+static bool Parser_UARTFrame_Legacy(const uint8_t* str, int length, ReceiveFrame_t *Output)
+{
+    uint32_t temp1           = 0u;
+    uint32_t temp2           = 0u;
+    uint8_t idx              = 0u;
+    uint8_t is_second_number = 0u;
+
+    /* Pass through each character in the string */
+    while (idx < length)
+    {
+        if (str[idx] >= '0' && str[idx] <= '9')
+        {
+            if (is_second_number)
+            {
+                temp2 = temp2 * 10 + (str[idx] - '0');
+            } else
+            {
+                temp1 = temp1 * 10 + (str[idx] - '0');
+            }
+        }
+        else if (str[idx] == '-')
+        {
+            if (is_second_number)
+            {
+                return false; /* Invalid string (more than one '-') */
+            }
+            is_second_number = 1; /* Switch to parsing the second number */
+        }
+        else
+        {
+            return false; /* Invalid character */
+        }
+        idx++;
+    }
+
+    Output->ID   = temp1;
+    Output->Data = temp2;
+
+    return true;
 }
+#endif
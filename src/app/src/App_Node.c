@@ -0,0 +1,179 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "MID_CAN_Interface.h"
+#include "MID_Timer_Interface.h"
+#include "MID_UART_Interface.h"
+#include "App_Node.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/* Mailboxes, message types and UART IDs shared by the nodes of one class */
+typedef struct
+{
+    uint8_t  Class;             /* Node class, it can be a value of @defgroup Node addressing */
+    uint8_t  Count;             /* Nodes of the class served by the forwarder */
+    uint8_t  DataMb;
+    uint8_t  ConnectConfirmMb;
+    uint8_t  PingAnswerMb;
+    uint8_t  ConfirmDataMb;
+    uint8_t  ConnectMb;
+    uint8_t  StopMb;
+    uint8_t  PingMb;
+    uint8_t  SelfTestMb;
+    uint8_t  DataType;          /* Message types, refer to @defgroup Initialize Connection Message type */
+    uint8_t  ConfirmDataType;
+    uint8_t  ConnectType;
+    uint8_t  StopType;
+    uint8_t  PingType;
+    uint8_t  PingAnswerType;
+    uint32_t UartDataId;        /* UART data ID of the first node, the next nodes follow it */
+    uint32_t UartConnectId;
+} App_NodeClass_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/* Node classes in node index order, refer to @defgroup Sensor node index */
+static const App_NodeClass_t Node_Class[] =
+{
+    {
+        .Class            = CAN_NODE_CLASS_DISTANCE,
+        .Count            = APP_NODE_DISTANCE_NUM,
+        .DataMb           = RX_DISTANCE_DATA_MB,
+        .ConnectConfirmMb = RX_CONFIRM_FROM_DISTANCE_NODE_MB,
+        .PingAnswerMb     = RX_CONFIRM_PING_DISTANCE_NODE_MB,
+        .ConfirmDataMb    = TX_CONFIRM_DISTANCE_DATA_MB,
+        .ConnectMb        = TX_RQ_CONNECT_DISTANCE_NODE_MB,
+        .StopMb           = TX_STOPOPR_DISTANCE_NODE_MB,
+        .PingMb           = TX_PING_DISTANCE_NODE_MB,
+        .SelfTestMb       = SELFTEST_DISTANCE_TX_MB,
+        .DataType         = RX_DISTANCE_DATA_TYPE,
+        .ConfirmDataType  = TX_CONFIRM_DISTANCE_DATA_TYPE,
+        .ConnectType      = TX_RQ_CONNECT_DISTANCE_NODE_TYPE,
+        .StopType         = TX_STOPOPR_DISTANCE_NODE_TYPE,
+        .PingType         = TX_PING_DISTANCE_NODE_TYPE,
+        .PingAnswerType   = RX_CONFIRM_PING_DISTANCE_NODE_TYPE,
+        .UartDataId       = DISTANCE_DATA_ID,
+        .UartConnectId    = PC_CONNECT_DISTANCE_SENSOR_ID
+    },
+    {
+        .Class            = CAN_NODE_CLASS_ROTATION,
+        .Count            = APP_NODE_ROTATION_NUM,
+        .DataMb           = RX_ROTATION_DATA_MB,
+        .ConnectConfirmMb = RX_CONFIRM_FROM_ROTATION_NODE_MB,
+        .PingAnswerMb     = RX_CONFIRM_PING_ROTATION_NODE_MB,
+        .ConfirmDataMb    = TX_CONFIRM_ROTATION_DATA_MB,
+        .ConnectMb        = TX_RQ_CONNECT_ROTATION_NODE_MB,
+        .StopMb           = TX_STOPOPR_ROTATION_NODE_MB,
+        .PingMb           = TX_PING_ROTATION_NODE_MB,
+        .SelfTestMb       = SELFTEST_ROTATION_TX_MB,
+        .DataType         = RX_ROTATION_DATA_TYPE,
+        .ConfirmDataType  = TX_CONFIRM_ROTATION_DATA_TYPE,
+        .ConnectType      = TX_RQ_CONNECT_ROTATION_NODE_TYPE,
+        .StopType         = TX_STOPOPR_ROTATION_NODE_TYPE,
+        .PingType         = TX_PING_ROTATION_NODE_TYPE,
+        .PingAnswerType   = RX_CONFIRM_PING_ROTATION_NODE_TYPE,
+        .UartDataId       = ROTATION_DATA_ID,
+        .UartConnectId    = PC_CONNECT_ROTATION_SENSOR_ID
+    }
+};
+
+#define NODE_CLASS_NUM  (sizeof(Node_Class) / sizeof(Node_Class[0]))
+
+/* Registry of the sensor nodes served by the forwarder */
+static App_NodeDesc_t Node_Desc[APP_NODE_NUM];
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+/**
+  * @brief      Derive the descriptor of every sensor node from its index, called before the node
+  *             descriptors are used
+  * @param[in]  None
+  * @retval     None
+  */
+void App_Node_Init(void)
+{
+    const App_NodeClass_t *nodeClass = NULL;
+    App_NodeDesc_t *desc = NULL;
+    uint8_t classIdx = 0u;
+    uint8_t index = 0u;
+    uint8_t inst = 0u;
+    uint8_t node = 0u;
+
+    for (classIdx = 0u; classIdx < NODE_CLASS_NUM; classIdx++)
+    {
+        nodeClass = &Node_Class[classIdx];
+
+        for (index = 0u; index < nodeClass->Count; index++)
+        {
+            desc = &Node_Desc[node + index];
+            inst = (uint8_t)(CAN_NODE_INST_DEFAULT + index);
+
+            desc->Class            = nodeClass->Class;
+            desc->Instance         = inst;
+            desc->First            = node;
+            desc->DataMb           = nodeClass->DataMb;
+            desc->ConnectConfirmMb = nodeClass->ConnectConfirmMb;
+            desc->PingAnswerMb     = nodeClass->PingAnswerMb;
+            desc->ConfirmDataMb    = nodeClass->ConfirmDataMb;
+            desc->ConnectMb        = nodeClass->ConnectMb;
+            desc->StopMb           = nodeClass->StopMb;
+            desc->PingMb           = nodeClass->PingMb;
+            desc->SelfTestMb       = nodeClass->SelfTestMb;
+            desc->DataTimeout      = NODE_COMMINGDATA_SLOT(node + index);
+            desc->RespondTimeout   = NODE_RESPONDCONNECTION_SLOT(node + index);
+            desc->DataId           = CAN_NODE_ID(nodeClass->Class, inst, nodeClass->DataType);
+            desc->ConfirmDataId    = CAN_NODE_ID(nodeClass->Class, inst, nodeClass->ConfirmDataType);
+            desc->ConnectId        = CAN_NODE_ID(nodeClass->Class, inst, nodeClass->ConnectType);
+            desc->StopId           = CAN_NODE_ID(nodeClass->Class, inst, nodeClass->StopType);
+            desc->PingId           = CAN_NODE_ID(nodeClass->Class, inst, nodeClass->PingType);
+            desc->PingAnswerId     = CAN_NODE_ID(nodeClass->Class, inst, nodeClass->PingAnswerType);
+            desc->UartDataId       = nodeClass->UartDataId + index;
+            desc->UartConnectId    = nodeClass->UartConnectId;
+        }
+
+        node += nodeClass->Count;
+    }
+}
+
+/**
+  * @brief      Get the descriptor of a sensor node
+  * @param[in]  Node: it can be a value of @defgroup Sensor node index
+  * @retval     Descriptor of the node
+  */
+const App_NodeDesc_t *App_Node_GetDesc(uint8_t Node)
+{
+    return &Node_Desc[Node];
+}
+
+/**
+  * @brief      Find a sensor node by class and instance
+  * @param[in]  Class:    Node class, it can be a value of @defgroup Node addressing
+  * @param[in]  Instance: Node instance
+  * @retval     Index of the node, APP_NODE_NONE if the forwarder does not serve it
+  */
+uint8_t App_Node_Find(uint8_t Class, uint8_t Instance)
+{
+    uint8_t node = 0u;
+    uint8_t found = APP_NODE_NONE;
+
+    for (node = 0u; (node < APP_NODE_NUM) && (found == APP_NODE_NONE); node++)
+    {
+        if ((Node_Desc[node].Class == Class) && (Node_Desc[node].Instance == Instance))
+        {
+            found = node;
+        }
+        else
+        {
+            /* Do nothing */
+        }
+    }
+
+    return found;
+}
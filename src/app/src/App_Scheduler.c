@@ -0,0 +1,259 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "MID_Timer_Interface.h"
+#include "MID_Notification_Manager.h"
+#include "App_Scheduler.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+#define APP_TASK_NONE       0xFFu   /* No task is ready */
+
+/* Execution statistics of one task over the current interval */
+typedef struct
+{
+    uint32_t runCnt;
+    uint64_t execSum;               /* LPIT ticks */
+    uint32_t execMax;               /* LPIT ticks */
+} TaskStats_t;
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+static void Scheduler_TakeEvents(void);
+static void Scheduler_StartPass(void);
+static uint8_t Scheduler_NextReady(void);
+static void Scheduler_RunTask(uint8_t task);
+static bool Scheduler_IsAnyBusy(void);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/* Task table registered by App_Scheduler_Init() */
+static const App_TaskDesc_t *Task_Table = NULL;
+
+/* Task started by its events, its period or App_Scheduler_Activate() */
+static bool     Task_Ready[APP_TASK_NUM];
+
+/* Polling task not run yet in the current pass */
+static bool     Task_Poll[APP_TASK_NUM];
+
+/* Timer ticks left until the next run of a periodic task */
+static uint32_t Task_TicksLeft[APP_TASK_NUM];
+
+static TaskStats_t Task_Stats[APP_TASK_NUM];
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+/**
+  * @brief      Register the task table and clear the task statistics
+  * @param[in]  Tasks: Table of APP_TASK_NUM tasks, indexed by @defgroup Task slot
+  * @retval     None
+  */
+void App_Scheduler_Init(const App_TaskDesc_t *Tasks)
+{
+    uint8_t task = 0u;
+
+    Task_Table = Tasks;
+
+    memset(Task_Ready, 0, sizeof(Task_Ready));
+    memset(Task_Poll, 0, sizeof(Task_Poll));
+    memset(Task_Stats, 0, sizeof(Task_Stats));
+
+    for (task = 0u; task < APP_TASK_NUM; task++)
+    {
+        Task_TicksLeft[task] = Task_Table[task].PeriodMs / TIMER_TICK_MS;
+    }
+}
+
+/**
+  * @brief      Start a task on the next scheduler pass, called from the main loop context
+  * @param[in]  Task: it can be a value of @defgroup Task slot
+  * @retval     None
+  */
+void App_Scheduler_Activate(uint8_t Task)
+{
+    Task_Ready[Task] = true;
+}
+
+/**
+  * @brief      Run the ready tasks by priority and sleep while none is ready, never returns
+  * @note       One pass runs every polling task once and every started task, highest
+  *             priority first. The pending work is taken again after each task, so
+  *             the work an interrupt raised meanwhile goes before the lower tasks.
+  * @param[in]  None
+  * @retval     None
+  */
+void App_Scheduler_Run(void)
+{
+    uint8_t task = APP_TASK_NONE;
+
+    while (1)
+    {
+        Scheduler_StartPass();
+
+        task = Scheduler_NextReady();
+        while (task != APP_TASK_NONE)
+        {
+            Scheduler_RunTask(task);
+
+            Scheduler_TakeEvents();
+            task = Scheduler_NextReady();
+        }
+
+        /* Sleep until an interrupt raises work, unless a task still polls the time base */
+        if (Scheduler_IsAnyBusy() == false)
+        {
+            MID_Notification_WaitForEvent();
+        }
+        else
+        {
+            /* Do nothing */
+        }
+    }
+}
+
+/**
+  * @brief      Read the execution statistics of one task and start a new interval
+  * @param[in]  Task:      it can be a value of @defgroup Task slot
+  * @param[out] runCnt:    Number of runs
+  * @param[out] execAvgUs: Average execution time (us)
+  * @param[out] execMaxUs: Worst execution time (us)
+  * @retval     None
+  */
+void App_Scheduler_GetTaskStats(uint8_t Task, uint32_t *runCnt, uint32_t *execAvgUs, uint32_t *execMaxUs)
+{
+    uint32_t execAvg = 0u;
+
+    if (Task_Stats[Task].runCnt != 0u)
+    {
+        execAvg = (uint32_t)(Task_Stats[Task].execSum / Task_Stats[Task].runCnt);
+    }
+
+    *runCnt    = Task_Stats[Task].runCnt;
+    *execAvgUs = MID_Timer_TicksToUs(execAvg);
+    *execMaxUs = MID_Timer_TicksToUs(Task_Stats[Task].execMax);
+
+    /* Start a new interval */
+    Task_Stats[Task].runCnt  = 0u;
+    Task_Stats[Task].execSum = 0u;
+    Task_Stats[Task].execMax = 0u;
+}
+
+/**
+  * @brief      Take the pending work and start the tasks waiting for it
+  * @param[in]  None
+  * @retval     None
+  */
+static void Scheduler_TakeEvents(void)
+{
+    uint32_t events = MID_Notification_Take();
+    uint8_t task = 0u;
+
+    for (task = 0u; task < APP_TASK_NUM; task++)
+    {
+        if ((events & Task_Table[task].Events) != 0u)
+        {
+            Task_Ready[task] = true;
+        }
+
+        if (((events & NOTIFY_EVENT_TICK) != 0u) && (Task_Table[task].PeriodMs >= TIMER_TICK_MS))
+        {
+            if (Task_TicksLeft[task] > 1u)
+            {
+                Task_TicksLeft[task]--;
+            }
+            else
+            {
+                Task_TicksLeft[task] = Task_Table[task].PeriodMs / TIMER_TICK_MS;
+                Task_Ready[task] = true;
+            }
+        }
+    }
+}
+
+/**
+  * @brief      Take the pending work and mark the polling tasks for one run
+  * @param[in]  None
+  * @retval     None
+  */
+static void Scheduler_StartPass(void)
+{
+    uint8_t task = 0u;
+
+    Scheduler_TakeEvents();
+
+    for (task = 0u; task < APP_TASK_NUM; task++)
+    {
+        Task_Poll[task] = (Task_Table[task].IsBusy != NULL) && (Task_Table[task].IsBusy() == true);
+    }
+}
+
+/**
+  * @brief      Find the ready task of highest priority
+  * @param[in]  None
+  * @retval     Task slot, APP_TASK_NONE if no task is ready
+  */
+static uint8_t Scheduler_NextReady(void)
+{
+    uint8_t task = 0u;
+    uint8_t next = APP_TASK_NONE;
+
+    for (task = 0u; (task < APP_TASK_NUM) && (next == APP_TASK_NONE); task++)
+    {
+        if ((Task_Ready[task] == true) || (Task_Poll[task] == true))
+        {
+            next = task;
+        }
+    }
+
+    return next;
+}
+
+/**
+  * @brief      Run one task and record its execution time
+  * @param[in]  task: it can be a value of @defgroup Task slot
+  * @retval     None
+  */
+static void Scheduler_RunTask(uint8_t task)
+{
+    uint32_t start = 0u;
+    uint32_t exec = 0u;
+
+    Task_Ready[task] = false;
+    Task_Poll[task]  = false;
+
+    start = MID_Timer_GetTimestamp();
+    Task_Table[task].Run();
+    exec = MID_Timer_GetTimestamp() - start;
+
+    Task_Stats[task].runCnt++;
+    Task_Stats[task].execSum += exec;
+    if (exec > Task_Stats[task].execMax)
+    {
+        Task_Stats[task].execMax = exec;
+    }
+}
+
+/**
+  * @brief      Check whether a task polls the time base
+  * @param[in]  None
+  * @retval     true if the CPU must not sleep
+  */
+static bool Scheduler_IsAnyBusy(void)
+{
+    uint8_t task = 0u;
+    bool busy = false;
+
+    for (task = 0u; (task < APP_TASK_NUM) && (busy == false); task++)
+    {
+        busy = (Task_Table[task].IsBusy != NULL) && (Task_Table[task].IsBusy() == true);
+    }
+
+    return busy;
+}
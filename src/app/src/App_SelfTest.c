@@ -0,0 +1,209 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "MID_CAN_Interface.h"
+#include "MID_Timer_Interface.h"
+#include "MID_UART_Interface.h"
+#include "App_DataProcessing.h"
+#include "App_Node.h"
+#include "App_Statistics.h"
+#include "App_SelfTest.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/** @defgroup Self-test state
+  * @{
+  */
+#define SELFTEST_IDLE               0u
+#define SELFTEST_GENERATING         1u
+#define SELFTEST_DRAINING           2u
+
+#define US_PER_SECOND               1000000u
+#define US_PER_MS                   1000u
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+
+static void SelfTest_SendSensorFrame(void);
+static void SelfTest_Finish(void);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static uint8_t  SelfTest_State     = SELFTEST_IDLE;
+
+/* Schedule, in time base ticks */
+static uint32_t Start_Time         = 0u;
+static uint32_t Drain_Start_Time   = 0u;
+static uint32_t Next_Frame_Time    = 0u;
+static uint32_t Frame_Period       = 0u;
+
+/* Frames put on the loopback bus */
+static uint32_t Generated_Cnt      = 0u;
+
+/* Node of the next synthetic frame */
+static uint8_t  Next_Node          = 0u;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+/**
+  * @brief      Switch the sensor bus to loopback and start pumping synthetic sensor frames
+  * @note       Frames use the sensor data IDs, so they go through the whole forwarding path:
+  *             receive interrupt, receive queue, main loop, UART. The bus is not driven meanwhile.
+  * @param[in]  rate: Frames per second, 0 selects SELFTEST_RATE_DEFAULT
+  * @retval     None
+  */
+void App_SelfTest_Start(uint32_t rate)
+{
+    if (SelfTest_State == SELFTEST_IDLE)
+    {
+        if (rate == 0u)
+        {
+            rate = SELFTEST_RATE_DEFAULT;
+        }
+        else if (rate > SELFTEST_RATE_MAX)
+        {
+            rate = SELFTEST_RATE_MAX;
+        }
+        else
+        {
+            /* Do nothing */
+        }
+
+        /* SELFTEST_*_TX_MB send with the sensor data IDs of every node, looped back into the sensor data mailboxes */
+        MID_CAN_BusSetMode(CAN_SENSOR_BUS, CAN_MODE_LOOPBACK);
+
+        /* Measure the test frames only */
+        App_Stats_Init();
+
+        Generated_Cnt   = 0u;
+        Next_Node       = 0u;
+        Frame_Period    = MID_Timer_UsToTicks(US_PER_SECOND / rate);
+        Start_Time      = MID_Timer_GetTimestamp();
+        Next_Frame_Time = Start_Time;
+        SelfTest_State  = SELFTEST_GENERATING;
+    }
+}
+
+/**
+  * @brief      Check whether the self-test is running
+  * @param[in]  None
+  * @retval     true while frames are generated or drained
+  */
+bool App_SelfTest_IsRunning(void)
+{
+    return (SelfTest_State != SELFTEST_IDLE);
+}
+
+/**
+  * @brief      Generate the frames due, finish and report the test when its time is over
+  * @param[in]  None
+  * @retval     None
+  */
+void App_SelfTest_Process(void)
+{
+    uint32_t now = MID_Timer_GetTimestamp();
+    uint8_t burst = 0u;
+
+    if (SelfTest_State == SELFTEST_GENERATING)
+    {
+        /* Time base wraps modulo 2^32, a signed difference tells whether the frame is due */
+        while (((int32_t)(now - Next_Frame_Time) >= 0) && (burst < SELFTEST_BURST_MAX))
+        {
+            SelfTest_SendSensorFrame();
+            Next_Frame_Time += Frame_Period;
+            burst++;
+        }
+
+        if ((now - Start_Time) >= MID_Timer_UsToTicks(SELFTEST_DURATION_MS * US_PER_MS))
+        {
+            Drain_Start_Time = now;
+            SelfTest_State = SELFTEST_DRAINING;
+        }
+    }
+    else if (SelfTest_State == SELFTEST_DRAINING)
+    {
+        if ((now - Drain_Start_Time) >= MID_Timer_UsToTicks(SELFTEST_DRAIN_MS * US_PER_MS))
+        {
+            SelfTest_Finish();
+        }
+    }
+    else
+    {
+        /* Do nothing */
+    }
+}
+
+/**
+  * @brief      Send one synthetic sensor frame, legacy layout with a running counter as value
+  * @note       The nodes take turns. A frame is skipped when the mailbox of its class still holds
+  *             the previous one, the offered load is then limited by the bus itself.
+  * @param[in]  None
+  * @retval     None
+  */
+static void SelfTest_SendSensorFrame(void)
+{
+    uint8_t payload[CAN_LEGACY_DATA_LENGTH] = {0u};
+    const App_NodeDesc_t *desc = App_Node_GetDesc(Next_Node);
+
+    if (MID_CAN_IsTxMailboxBusy(desc->SelfTestMb) == 0u)
+    {
+        payload[CAN_LEGACY_SIGNAL_START_BYTE + 0u] = (uint8_t)(Generated_Cnt >> 8u);
+        payload[CAN_LEGACY_SIGNAL_START_BYTE + 1u] = (uint8_t)(Generated_Cnt);
+
+        MID_CAN_SendCANFrameToId(desc->SelfTestMb, desc->DataId, payload, CAN_LEGACY_DATA_LENGTH, CAN_TX_DEADLINE_NONE);
+        Generated_Cnt++;
+    }
+
+    Next_Node = ((Next_Node + 1u) < APP_NODE_NUM) ? (uint8_t)(Next_Node + 1u) : 0u;
+}
+
+/**
+  * @brief      Return to normal mode and send the results to the PC Tool
+  * @param[in]  None
+  * @retval     None
+  */
+static void SelfTest_Finish(void)
+{
+    uint32_t forwardCnt[STATS_NODE_NUM] = {0u};
+    uint32_t latencyAvg[STATS_NODE_NUM] = {0u};
+    uint32_t latencyMax[STATS_NODE_NUM] = {0u};
+    uint32_t totalCnt = 0u;
+    uint32_t totalAvg = 0u;
+    uint32_t totalMax = 0u;
+    uint8_t node = 0u;
+
+    MID_CAN_BusSetMode(CAN_SENSOR_BUS, CAN_MODE_NORMAL);
+
+    for (node = 0u; node < STATS_NODE_NUM; node++)
+    {
+        App_Stats_GetForward(node, &forwardCnt[node], &latencyAvg[node], &latencyMax[node]);
+        totalCnt += forwardCnt[node];
+        totalMax = (latencyMax[node] > totalMax) ? latencyMax[node] : totalMax;
+    }
+
+    if (totalCnt != 0u)
+    {
+        for (node = 0u; node < STATS_NODE_NUM; node++)
+        {
+            totalAvg += (uint32_t)(((uint64_t)latencyAvg[node] * forwardCnt[node]) / totalCnt);
+        }
+    }
+
+    /* One sample per legacy frame, forwarded samples are forwarded frames */
+    APP_Send_UARTFrame(SELFTEST_FPS_ID, (uint32_t)(((uint64_t)totalCnt * 1000u) / SELFTEST_DURATION_MS));
+    APP_Send_UARTFrame(SELFTEST_DROP_CNT_ID, (Generated_Cnt > totalCnt) ? (Generated_Cnt - totalCnt) : 0u);
+    APP_Send_UARTFrame(SELFTEST_LATENCY_AVG_ID, totalAvg);
+    APP_Send_UARTFrame(SELFTEST_LATENCY_MAX_ID, totalMax);
+    MID_UART_SetTxInterrupt(true);
+
+    /* Keep the test frames out of the regular statistics */
+    App_Stats_Init();
+
+    SelfTest_State = SELFTEST_IDLE;
+}
@@ -0,0 +1,534 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "MID_Timer_Interface.h"
+#include "MID_CAN_Interface.h"
+#include "MID_UART_Interface.h"
+#include "MID_Notification_Manager.h"
+#include "MID_TransmitQueue_Interface.h"
+#include "App_DataProcessing.h"
+#include "App_Statistics.h"
+#include "App_Scheduler.h"
+
+/*******************************************************************************
+ * Definition
+ ******************************************************************************/
+
+/* Gain of the jitter estimator, J += (|D| - J) / 16 as in RFC 3550 */
+#define STATS_JITTER_GAIN_SHIFT 4u
+
+#define US_PER_MS               1000u
+
+/** @defgroup Report step
+  * @{
+  */
+#define STATS_STEP_IDLE         0u      /* No report is being sent */
+#define STATS_STEP_NODE         1u      /* One block per sensor node */
+#define STATS_STEP_LOSS         2u      /* Receive loss totals */
+#define STATS_STEP_LOSS_MB      3u      /* One block per mailbox with overruns */
+#define STATS_STEP_LOSS_ID      4u      /* One block per CAN ID with overruns, then the other IDs */
+#define STATS_STEP_TX           5u      /* Transmit counters */
+#define STATS_STEP_CPU          6u      /* CPU load */
+#define STATS_STEP_TASK         7u      /* One block per scheduler task */
+#define STATS_STEP_DONE         8u      /* Last block composed */
+/**
+  * @}
+  */
+
+/* Per node latency and arrival statistics, all times in time base ticks */
+typedef struct
+{
+    uint32_t forwardCnt;        /* Number of samples forwarded in the interval */
+    uint32_t suppressedCnt;     /* Number of samples held back by the deadband in the interval */
+    uint64_t latencySum;        /* Sum of bus-to-UART latencies */
+    uint32_t latencyMax;        /* Worst bus-to-UART latency */
+    uint32_t lastArrival;       /* Capture time of the previous frame */
+    uint32_t lastInterval;      /* Previous inter-arrival time */
+    uint32_t jitter;            /* Smoothed inter-arrival jitter */
+    bool     hasArrival;        /* lastArrival is valid */
+    bool     hasInterval;       /* lastInterval is valid */
+} NodeStats_t;
+
+/* Overruns of one CAN ID */
+typedef struct
+{
+    uint32_t canId;
+    uint32_t lossCnt;
+} IdLoss_t;
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+
+static void Stats_ComposeBlock(void);
+static void Stats_AddFrame(uint32_t id, uint32_t data);
+static void Stats_ComposeNode(uint8_t node);
+static void Stats_ComposeLoss(void);
+static void Stats_ComposeLossMb(uint8_t mb);
+static void Stats_ComposeTx(void);
+static void Stats_ComposeCpu(void);
+static void Stats_ComposeTask(uint8_t task);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static NodeStats_t Node_Stats[STATS_NODE_NUM];
+
+/* Overruns per CAN ID, entries are taken in order of first loss */
+static IdLoss_t Id_Loss[STATS_LOSS_ID_NUM];
+static uint8_t  Id_Loss_Num = 0u;
+static uint32_t Id_Loss_Other_Cnt = 0u;
+
+/* Report progress, refer to @defgroup Report step */
+static uint8_t  Report_Step   = STATS_STEP_IDLE;
+static uint8_t  Report_Index  = 0u;     /* Node, mailbox, CAN ID or task of the step */
+static uint32_t Report_Time   = 0u;     /* Start of the last report, in time base ticks */
+
+/* Block composed and waiting for room in the transmit queue */
+static uint8_t  Report_Block[UART_BULK_BLOCK_FRAMES * UART_FRAME_LENGTH_MAX];
+static uint16_t Report_Length = 0u;     /* Bytes of the block, 0 if none */
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+/**
+  * @brief      Clear all statistics
+  * @param[in]  None
+  * @retval     None
+  */
+void App_Stats_Init(void)
+{
+    memset(Node_Stats, 0, sizeof(Node_Stats));
+    memset(Id_Loss, 0, sizeof(Id_Loss));
+    Id_Loss_Num = 0u;
+    Id_Loss_Other_Cnt = 0u;
+}
+
+/**
+  * @brief      Record a receive mailbox overrun
+  * @param[in]  canId: ID of the frame read from the overrun mailbox
+  * @retval     None
+  */
+void App_Stats_RecordLoss(uint32_t canId)
+{
+    uint8_t idx = 0u;
+
+    while ((idx < Id_Loss_Num) && (Id_Loss[idx].canId != canId))
+    {
+        idx++;
+    }
+
+    if (idx < Id_Loss_Num)
+    {
+        Id_Loss[idx].lossCnt++;
+    }
+    else if (Id_Loss_Num < STATS_LOSS_ID_NUM)
+    {
+        Id_Loss[Id_Loss_Num].canId = canId;
+        Id_Loss[Id_Loss_Num].lossCnt = 1u;
+        Id_Loss_Num++;
+    }
+    else
+    {
+        Id_Loss_Other_Cnt++;
+    }
+}
+
+/**
+  * @brief      Record a sample forwarded from a sensor node to the PC Tool
+  * @param[in]  node:        Sensor node index, it can be a value of @defgroup Sensor node index
+  * @param[in]  captureTime: Time base value when the frame was captured on the bus
+  * @param[in]  forwardTime: Time base value when the frame was handed over to UART
+  * @retval     None
+  */
+void App_Stats_RecordForward(uint8_t node, uint32_t captureTime, uint32_t forwardTime)
+{
+    NodeStats_t *stats = NULL;
+    uint32_t latency = 0u;
+    uint32_t interval = 0u;
+    uint32_t deviation = 0u;
+
+    if (node < STATS_NODE_NUM)
+    {
+        stats = &Node_Stats[node];
+
+        /* Time base wraps modulo 2^32, unsigned difference stays valid */
+        latency = forwardTime - captureTime;
+
+        stats->forwardCnt++;
+        stats->latencySum += latency;
+        if (latency > stats->latencyMax)
+        {
+            stats->latencyMax = latency;
+        }
+
+        /* Several samples of one frame share a capture time, only frames count as arrivals */
+        if ((stats->hasArrival == false) || (captureTime != stats->lastArrival))
+        {
+            if (stats->hasArrival == true)
+            {
+                interval = captureTime - stats->lastArrival;
+
+                if (stats->hasInterval == true)
+                {
+                    deviation = (interval > stats->lastInterval) ? (interval - stats->lastInterval) : (stats->lastInterval - interval);
+
+                    /* J += (|D| - J) / 16 */
+                    if (deviation > stats->jitter)
+                    {
+                        stats->jitter += (deviation - stats->jitter) >> STATS_JITTER_GAIN_SHIFT;
+                    }
+                    else
+                    {
+                        stats->jitter -= (stats->jitter - deviation) >> STATS_JITTER_GAIN_SHIFT;
+                    }
+                }
+
+                stats->lastInterval = interval;
+                stats->hasInterval  = true;
+            }
+
+            stats->lastArrival = captureTime;
+            stats->hasArrival  = true;
+        }
+    }
+}
+
+/**
+  * @brief      Record a sample of a sensor node held back by the report-on-change deadband
+  * @param[in]  node: Sensor node index, it can be a value of @defgroup Sensor node index
+  * @retval     None
+  */
+void App_Stats_RecordSuppressed(uint8_t node)
+{
+    if (node < STATS_NODE_NUM)
+    {
+        Node_Stats[node].suppressedCnt++;
+    }
+}
+
+/**
+  * @brief      Read the forwarding statistics of one node for the current interval
+  * @param[in]  node:         Sensor node index, it can be a value of @defgroup Sensor node index
+  * @param[out] forwardCnt:   Number of samples forwarded
+  * @param[out] latencyAvgUs: Average bus-to-UART latency (us)
+  * @param[out] latencyMaxUs: Worst bus-to-UART latency (us)
+  * @retval     None
+  */
+void App_Stats_GetForward(uint8_t node, uint32_t *forwardCnt, uint32_t *latencyAvgUs, uint32_t *latencyMaxUs)
+{
+    *forwardCnt   = 0u;
+    *latencyAvgUs = 0u;
+    *latencyMaxUs = 0u;
+
+    if (node < STATS_NODE_NUM)
+    {
+        *forwardCnt = Node_Stats[node].forwardCnt;
+        if (Node_Stats[node].forwardCnt != 0u)
+        {
+            *latencyAvgUs = MID_Timer_TicksToUs((uint32_t)(Node_Stats[node].latencySum / Node_Stats[node].forwardCnt));
+        }
+        *latencyMaxUs = MID_Timer_TicksToUs(Node_Stats[node].latencyMax);
+    }
+}
+
+/**
+  * @brief      Start a statistics report, ignored while one is being sent
+  * @param[in]  None
+  * @retval     None
+  */
+void App_Stats_RequestReport(void)
+{
+    if (Report_Step == STATS_STEP_IDLE)
+    {
+        Report_Step   = STATS_STEP_NODE;
+        Report_Index  = 0u;
+        Report_Length = 0u;
+        Report_Time   = MID_Timer_GetTimestamp();
+    }
+}
+
+/**
+  * @brief      Queue the next blocks of the statistics report, as many as the transmit queue takes
+  * @note       The report is sent one block at a time: one sensor node, one loss entry, the transmit
+  *             counters, the CPU load, one scheduler task. The blocks fill the transmit queue up to
+  *             UART_BULK_QUEUE_MAX, a block without room is kept and queued when the queue drained to
+  *             UART_BULK_RESUME_LEVEL (NOTIFY_EVENT_UART_ROOM). Latencies and jitter are reported in
+  *             microseconds, the values of a node start a new interval once its block is composed.
+  *             The jitter estimate and arrival history are kept across intervals.
+  * @param[in]  None
+  * @retval     true if the last block of the report was queued by this call
+  */
+bool App_Stats_Process(void)
+{
+    bool queued = true;
+    bool finished = false;
+
+#if (STATS_REPORT_PERIOD_MS != 0u)
+    /* The scheduler runs the task every STATS_REPORT_PERIOD_MS, half a tick absorbs the jitter of the runs */
+    if ((MID_Timer_GetTimestamp() - Report_Time) >= MID_Timer_UsToTicks((STATS_REPORT_PERIOD_MS - (TIMER_TICK_MS / 2u)) * US_PER_MS))
+    {
+        App_Stats_RequestReport();
+    }
+#endif
+
+    if (Report_Step != STATS_STEP_IDLE)
+    {
+        while ((queued == true) && (Report_Step != STATS_STEP_IDLE))
+        {
+            if (Report_Length != 0u)
+            {
+                queued = ((MID_Transmit_GetCount() + Report_Length) <= UART_BULK_QUEUE_MAX) &&
+                         (MID_Transmit_EnqueueBlock(Report_Block, Report_Length) == QUEUE_DONE_SUCCESS);
+
+                if (queued == true)
+                {
+                    Report_Length = 0u;
+                }
+            }
+            else if (Report_Step == STATS_STEP_DONE)
+            {
+                Report_Step = STATS_STEP_IDLE;
+                finished = true;
+            }
+            else
+            {
+                Stats_ComposeBlock();
+            }
+        }
+
+        MID_UART_SetTxInterrupt(true);
+    }
+
+    return finished;
+}
+
+/**
+  * @brief      Compose the block of the report at the cursor and move the cursor on
+  * @note       A mailbox or CAN ID without loss gives an empty block
+  * @param[in]  None
+  * @retval     None
+  */
+static void Stats_ComposeBlock(void)
+{
+    switch (Report_Step)
+    {
+    case STATS_STEP_NODE:
+        if (Report_Index < STATS_NODE_NUM)
+        {
+            Stats_ComposeNode(Report_Index);
+            Report_Index++;
+        }
+        else
+        {
+            Report_Step = STATS_STEP_LOSS;
+        }
+        break;
+
+    case STATS_STEP_LOSS:
+        Stats_ComposeLoss();
+        Report_Step  = STATS_STEP_LOSS_MB;
+        Report_Index = 0u;
+        break;
+
+    case STATS_STEP_LOSS_MB:
+        if (Report_Index < CAN_MAILBOX_COUNT)
+        {
+            Stats_ComposeLossMb(Report_Index);
+            Report_Index++;
+        }
+        else
+        {
+            Report_Step  = STATS_STEP_LOSS_ID;
+            Report_Index = 0u;
+        }
+        break;
+
+    case STATS_STEP_LOSS_ID:
+        if (Report_Index < Id_Loss_Num)
+        {
+            Stats_AddFrame(STATS_RX_LOSS_CAN_ID, Id_Loss[Report_Index].canId);
+            Stats_AddFrame(STATS_RX_LOSS_CAN_ID_CNT_ID, Id_Loss[Report_Index].lossCnt);
+            Report_Index++;
+        }
+        else
+        {
+            if (Id_Loss_Other_Cnt != 0u)
+            {
+                Stats_AddFrame(STATS_RX_LOSS_CAN_ID, STATS_LOSS_ID_OTHER);
+                Stats_AddFrame(STATS_RX_LOSS_CAN_ID_CNT_ID, Id_Loss_Other_Cnt);
+            }
+            else
+            {
+                /* Do nothing */
+            }
+            Report_Step = STATS_STEP_TX;
+        }
+        break;
+
+    case STATS_STEP_TX:
+        Stats_ComposeTx();
+        Report_Step = STATS_STEP_CPU;
+        break;
+
+    case STATS_STEP_CPU:
+        Stats_ComposeCpu();
+        Report_Step  = STATS_STEP_TASK;
+        Report_Index = 0u;
+        break;
+
+    case STATS_STEP_TASK:
+        if (Report_Index < APP_TASK_NUM)
+        {
+            Stats_ComposeTask(Report_Index);
+            Report_Index++;
+        }
+        else
+        {
+            Report_Step = STATS_STEP_DONE;
+        }
+        break;
+
+    default:
+        Report_Step = STATS_STEP_DONE;
+        break;
+    }
+}
+
+/**
+  * @brief      Append one UART frame to the block of the report
+  * @param[in]  id:   ID of the frame
+  * @param[in]  data: Data of the frame
+  * @retval     None
+  */
+static void Stats_AddFrame(uint32_t id, uint32_t data)
+{
+    Report_Length += APP_Compose_UARTFrame(id, data, &Report_Block[Report_Length]);
+}
+
+/**
+  * @brief      Compose the statistics of one node and start a new interval for it
+  * @param[in]  node: Sensor node index, it can be a value of @defgroup Sensor node index
+  * @retval     None
+  */
+static void Stats_ComposeNode(uint8_t node)
+{
+    uint32_t latencyAvg = 0u;
+
+    if (Node_Stats[node].forwardCnt != 0u)
+    {
+        latencyAvg = (uint32_t)(Node_Stats[node].latencySum / Node_Stats[node].forwardCnt);
+    }
+
+    Stats_AddFrame(STATS_NODE_INDEX_ID, node);
+    Stats_AddFrame(STATS_NODE_LATENCY_AVG_ID, MID_Timer_TicksToUs(latencyAvg));
+    Stats_AddFrame(STATS_NODE_LATENCY_MAX_ID, MID_Timer_TicksToUs(Node_Stats[node].latencyMax));
+    Stats_AddFrame(STATS_NODE_JITTER_ID, MID_Timer_TicksToUs(Node_Stats[node].jitter));
+    Stats_AddFrame(STATS_NODE_FORWARD_CNT_ID, Node_Stats[node].forwardCnt);
+    Stats_AddFrame(STATS_NODE_SUPPRESSED_CNT_ID, Node_Stats[node].suppressedCnt);
+
+    /* Start a new interval */
+    Node_Stats[node].forwardCnt = 0u;
+    Node_Stats[node].suppressedCnt = 0u;
+    Node_Stats[node].latencySum = 0u;
+    Node_Stats[node].latencyMax = 0u;
+}
+
+/**
+  * @brief      Compose the receive loss totals of the sensor bus
+  * @param[in]  None
+  * @retval     None
+  */
+static void Stats_ComposeLoss(void)
+{
+    uint8_t mb = 0u;
+    uint32_t overrun = 0u;
+    uint32_t busy = 0u;
+    uint32_t overrunTotal = 0u;
+    uint32_t busyTotal = 0u;
+
+    for (mb = 0u; mb < CAN_MAILBOX_COUNT; mb++)
+    {
+        MID_CAN_BusGetMailboxLoss(CAN_SENSOR_BUS, mb, &overrun, &busy);
+        overrunTotal += overrun;
+        busyTotal += busy;
+    }
+
+    Stats_AddFrame(STATS_RX_OVERRUN_CNT_ID, overrunTotal);
+    Stats_AddFrame(STATS_RX_BUSY_CNT_ID, busyTotal);
+}
+
+/**
+  * @brief      Compose the overruns of one receive mailbox, nothing if it lost no frame
+  * @param[in]  mb: Mailbox of the sensor bus
+  * @retval     None
+  */
+static void Stats_ComposeLossMb(uint8_t mb)
+{
+    uint32_t overrun = 0u;
+    uint32_t busy = 0u;
+
+    MID_CAN_BusGetMailboxLoss(CAN_SENSOR_BUS, mb, &overrun, &busy);
+    if (overrun != 0u)
+    {
+        Stats_AddFrame(STATS_RX_LOSS_MB_ID, mb);
+        Stats_AddFrame(STATS_RX_LOSS_MB_CNT_ID, overrun);
+    }
+    else
+    {
+        /* Do nothing */
+    }
+}
+
+/**
+  * @brief      Compose the transmit counters of the sensor bus
+  * @param[in]  None
+  * @retval     None
+  */
+static void Stats_ComposeTx(void)
+{
+    CAN_TxStats_t txStats = {0u};
+
+    MID_CAN_GetTxStats(&txStats);
+
+    Stats_AddFrame(STATS_TX_SENT_CNT_ID, txStats.SentCnt);
+    Stats_AddFrame(STATS_TX_EXPIRED_CNT_ID, txStats.ExpiredCnt);
+    Stats_AddFrame(STATS_TX_REPLACED_CNT_ID, txStats.ReplacedCnt);
+    Stats_AddFrame(STATS_TX_LATENCY_AVG_ID, txStats.LatencyAvgUs);
+    Stats_AddFrame(STATS_TX_LATENCY_MAX_ID, txStats.LatencyMaxUs);
+    Stats_AddFrame(STATS_TX_BLOCKED_CNT_ID, txStats.BlockedCnt);
+}
+
+/**
+  * @brief      Compose the CPU load of the interval and start a new interval
+  * @param[in]  None
+  * @retval     None
+  */
+static void Stats_ComposeCpu(void)
+{
+    uint32_t wakeupCnt = 0u;
+    uint32_t load = MID_Notification_GetCpuLoad(&wakeupCnt);
+
+    Stats_AddFrame(STATS_CPU_LOAD_ID, load);
+    Stats_AddFrame(STATS_CPU_WAKEUP_CNT_ID, wakeupCnt);
+}
+
+/**
+  * @brief      Compose the execution statistics of one scheduler task
+  * @param[in]  task: it can be a value of @defgroup Task slot
+  * @retval     None
+  */
+static void Stats_ComposeTask(uint8_t task)
+{
+    uint32_t runCnt = 0u;
+    uint32_t execAvgUs = 0u;
+    uint32_t execMaxUs = 0u;
+
+    App_Scheduler_GetTaskStats(task, &runCnt, &execAvgUs, &execMaxUs);
+
+    Stats_AddFrame(TASK_INDEX_ID, task);
+    Stats_AddFrame(TASK_RUN_CNT_ID, runCnt);
+    Stats_AddFrame(TASK_EXEC_AVG_ID, execAvgUs);
+    Stats_AddFrame(TASK_EXEC_MAX_ID, execMaxUs);
+}
@@ -27,6 +27,14 @@
 #define FLEXCAN_PSEG2_MAX   (7U)    /* maximum numbers of time quanta for phase segment 2*/
 #define FLEXCAN_RJW_MAX     (3U)    /* maximum numbers of time quanta for RJW*/
 
+/* Bit timing defaults, used when the configuration leaves the field at 0 */
+#define FLEXCAN_SAMPLE_POINT_DEFAULT (80U)  /* sample point in percent of the bit time */
+#define FLEXCAN_SJW_AUTO             (0U)   /* largest SJW allowed by phase segment 1 */
+
+/* Transmit arbitration start delay, reset value of CTRL2[TASD] */
+#define FLEXCAN_TASD_DEFAULT         (22U)
+#define FLEXCAN_TASD_MAX             (31U)
+
 /* FLEXCAN_Mb_Masks FLEXCAN Message Buffer Masks */
 #define FLEXCAN_MB_ID_STD_MASK  (0x1FFC0000U)
 #define FLEXCAN_MB_ID_STD_SHIFT (18U)
@@ -36,15 +44,33 @@
 #define FLEXCAN_MB_ID_EXT_SHIFT (0U)
 #define FLEXCAN_MB_ID_EXT_WIDTH (18U)
 
+/* Local priority of a TX MB, arbitrated ahead of the ID when MCR[LPRIOEN] is set (0 goes first) */
+#define FLEXCAN_MB_PRIO_MASK    (0xE0000000U)
+#define FLEXCAN_MB_PRIO_SHIFT   (29U)
+#define FLEXCAN_MB_PRIO_WIDTH   (3U)
+#define FLEXCAN_MB_PRIO(x)      (((uint32_t)((uint32_t)(x) << FLEXCAN_MB_PRIO_SHIFT)) & (FLEXCAN_MB_PRIO_MASK))
+#define FLEXCAN_MB_PRIO_MAX     (7U)
+
+/* A 29-bit extended identifier spans both the standard and the extended ID fields */
+#define FLEXCAN_MB_ID_EXT_FULL_MASK  (FLEXCAN_MB_ID_STD_MASK | FLEXCAN_MB_ID_EXT_MASK)
+
 #define FLEXCAN_MB_IDE_MASK     (0x200000U)
 #define FLEXCAN_MB_IDE_SHIFT    (21U)
 #define FLEXCAN_MB_IDE_WIDTH    (1U)
 
+#define FLEXCAN_MB_RTR_MASK     (0x100000U)
+#define FLEXCAN_MB_RTR_SHIFT    (20U)
+#define FLEXCAN_MB_RTR_WIDTH    (1U)
+
 #define FLEXCAN_MB_DLC_MASK     (0xF0000U)
 #define FLEXCAN_MB_DLC_SHIFT    (16U)
 #define FLEXCAN_MB_DLC_WIDTH    (4U)
 #define FLEXCAN_MB_DLC(x)       (((uint32_t)((uint32_t)(x) << FLEXCAN_MB_DLC_SHIFT)) & (FLEXCAN_MB_DLC_MASK))
 
+#define FLEXCAN_MB_TIME_STAMP_MASK  (0xFFFFU)
+#define FLEXCAN_MB_TIME_STAMP_SHIFT (0U)
+#define FLEXCAN_MB_TIME_STAMP_WIDTH (16U)
+
 #define FLEXCAN_MB_CODE_MASK    (0xF000000U)
 #define FLEXCAN_MB_CODE_SHIFT   (24U)
 #define FLEXCAN_MB_CODE_WIDTH   (4U)
@@ -107,6 +133,24 @@ typedef struct
     uint32_t phaseSeg2;
 } flexcan_time_segment_t;
 
+/* Result of DRV_FLEXCAN_AbortTxMb() */
+typedef enum
+{
+    FLEXCAN_ABORT_IDLE    = 0U,     /* No frame was pending, the MB is free */
+    FLEXCAN_ABORT_DONE    = 1U,     /* The frame was withdrawn, the MB is free */
+    FLEXCAN_ABORT_SENT    = 2U,     /* The frame went out before the abort took effect, the MB is free */
+    FLEXCAN_ABORT_PENDING = 3U      /* The MB still holds the frame (transmission, bus-off, freeze), call again */
+} flexcan_abort_status_t;
+
+/* Precomputed bit timing for one clock/bitrate/sample point combination */
+typedef struct
+{
+    uint32_t clkFreq;       /* FlexCAN protocol engine clock (Hz) */
+    uint32_t bitrate;       /* Bitrate (bit/s) */
+    uint32_t samplePoint;   /* Requested sample point (percent) */
+    flexcan_time_segment_t timeSeg; /* Register values, rJumpWidth is the largest allowed SJW */
+} flexcan_bit_timing_t;
+
 /*FlexCAN Clock Source*/
 typedef enum
 {
@@ -140,11 +184,44 @@ typedef struct
 {
     uint32_t cs;          /* Control and Status Word */
     uint32_t code;        /* CODE field of message buffer */
-    uint32_t msgId;       /* ID of message */
-    uint32_t data[2];     /* Data */
-    uint32_t dataLength;  /* Data length */
+    uint32_t msgId;       /* ID of message (11-bit standard or 29-bit extended, refer to idType) */
+    flexcan_mb_id_type_t idType; /* ID type of the received message, decoded from the IDE bit */
+    uint32_t data[2];     /* Data, byte 0 of the frame is the most significant byte of data[0] */
+    uint32_t dataLength;  /* Data length (DLC), also applied to the frame on transmit */
+    uint32_t timeStamp;   /* Free running timer value captured when the frame was received */
 } flexcan_mb_t;
 
+/* Snapshot of a message buffer: its four words as read from the FlexCAN RAM, decoded on demand */
+typedef struct
+{
+    uint32_t cs;          /* Control and Status Word: CODE, IDE, DLC and TIME_STAMP */
+    uint32_t id;          /* ID word, standard ID in bits 28..18 */
+    uint32_t data[2];     /* Data, byte 0 of the frame is the most significant byte of data[0] */
+} flexcan_frame_t;
+
+#define FLEXCAN_FRAME_CODE(frame)       (((frame)->cs & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT)
+#define FLEXCAN_FRAME_DLC(frame)        (((frame)->cs & FLEXCAN_MB_DLC_MASK) >> FLEXCAN_MB_DLC_SHIFT)
+#define FLEXCAN_FRAME_TIME_STAMP(frame) (((frame)->cs & FLEXCAN_MB_TIME_STAMP_MASK) >> FLEXCAN_MB_TIME_STAMP_SHIFT)
+#define FLEXCAN_FRAME_IS_EXT(frame)     (((frame)->cs & FLEXCAN_MB_IDE_MASK) != 0U)
+#define FLEXCAN_FRAME_ID(frame)         (FLEXCAN_FRAME_IS_EXT(frame) ?                                        \
+                                         (((frame)->id & FLEXCAN_MB_ID_EXT_FULL_MASK) >> FLEXCAN_MB_ID_EXT_SHIFT) : \
+                                         (((frame)->id & FLEXCAN_MB_ID_STD_MASK) >> FLEXCAN_MB_ID_STD_SHIFT))
+
+/* FlexCAN fault confinement state */
+typedef enum
+{
+    FLEXCAN_ERROR_ACTIVE,
+    FLEXCAN_ERROR_PASSIVE,
+    FLEXCAN_BUS_OFF
+} flexcan_fault_state_t;
+
+/* FlexCAN bus-off recovery mode */
+typedef enum
+{
+    FLEXCAN_BUSOFF_RECOVERY_AUTO,   /* Module rejoins the bus by itself after 128 x 11 recessive bits */
+    FLEXCAN_BUSOFF_RECOVERY_MANUAL  /* Module stays in bus-off until DRV_FLEXCAN_RecoverBusOff() is called */
+} flexcan_busoff_recovery_t;
+
 /* FlexCAN Interrupt Enable/ Disable*/
 typedef enum
 {
@@ -158,16 +235,26 @@ typedef struct
     flexcan_clock_source_t clkSrc;
     uint32_t flexcanClkFreq;
     uint32_t bitrate;
+    uint32_t samplePoint;   /* Sample point in percent, 0 selects FLEXCAN_SAMPLE_POINT_DEFAULT */
+    uint32_t rJumpWidth;    /* SJW in time quanta (1..4), FLEXCAN_SJW_AUTO selects the largest allowed */
     flexcan_operation_modes_t flexcanMode;
     flexcan_rx_mask_type_t rxMaskType;
+    uint8_t localPriority;     /* 1: the PRIO field of TX MBs takes part in the internal arbitration (MCR[LPRIOEN]) */
+    uint8_t txArbStartDelay;   /* CTRL2[TASD] (0..FLEXCAN_TASD_MAX), FLEXCAN_TASD_DEFAULT is the reset value */
+    uint8_t selfReception;     /* 1: frames sent are also received by matching RX MBs, always on in loopback */
 } flexcan_module_config_t;
 
 /* FlexCAN Handle Structure */
 typedef struct
 {
-    flexcan_mb_t * mbs[FLEXCAN_MAX_MB_NUM];
+    flexcan_frame_t frames[FLEXCAN_MAX_MB_NUM];  /* Last frame read from each MB */
     void (*mb_callback)(void);
     void (*bus_off_callback)(void);
+    void (*error_state_callback)(void);
+    flexcan_busoff_recovery_t busOffRecovery;
+    uint8_t selfReception;                      /* Kept from the configuration for DRV_FLEXCAN_SetOperationMode() */
+    uint32_t mbOverrunCnt[FLEXCAN_MAX_MB_NUM];  /* Reads that found CODE = OVERRUN, one or more frames were lost */
+    uint32_t mbBusyCnt[FLEXCAN_MAX_MB_NUM];     /* Reads that found BUSY set and waited for the move-in */
 } flexcan_handle_t;
 
 /*******************************************************************************
@@ -192,6 +279,35 @@ void DRV_FLEXCAN_EnableMbInt(uint8_t instance, uint8_t mbIdx);
  */
 void DRV_FLEXCAN_DisableMbInt(uint8_t instance, uint8_t mbIdx);
 
+/**
+ * @brief       Deactivate a message buffer: interrupt disabled, flag cleared and CODE set inactive.
+ * @param[in]   instance: Identifies which FlexCAN module
+ * @param[in]   mbIdx:    Message buffer index.
+ * @retval      None
+ */
+void DRV_FLEXCAN_DeactivateMb(uint8_t instance, uint8_t mbIdx);
+
+/**
+ * @brief       Get the number of message buffers of a FlexCAN module.
+ * @param[in]   instance: Identifies which FlexCAN module
+ * @retval      Number of message buffers.
+ */
+uint8_t DRV_FLEXCAN_GetMbCount(uint8_t instance);
+
+/**
+ * @brief       Enter freeze mode, the module leaves the bus once the current frame is done.
+ * @param[in]   instance: Identifies which FlexCAN module
+ * @retval      None
+ */
+void DRV_FLEXCAN_EnterFreeze(uint8_t instance);
+
+/**
+ * @brief       Exit freeze mode and rejoin the bus.
+ * @param[in]   instance: Identifies which FlexCAN module
+ * @retval      None
+ */
+void DRV_FLEXCAN_ExitFreeze(uint8_t instance);
+
 /**
  * @brief       Checks the interrupt flag for the specified message buffer index and returns its status.
  * @param[in]   instance:  Identifies which FlexCAN module
@@ -217,6 +333,24 @@ void DRV_FLEXCAN_ClearMbIntFlag(uint8_t instance, uint8_t mbIdx);
  */
 void DRV_FLEXCAN_Init(uint8_t instance, flexcan_module_config_t *config, flexcan_handle_t *handle);
 
+/**
+ * @brief       Change the bitrate of an initialized FLEXCAN module.
+ * @param[in]   instance: Identifies which FlexCAN module
+ * @param[in]   config:   Pointer to the configuration, only clock frequency, bitrate,
+ *                        sample point and SJW are used.
+ * @retval      None
+ */
+void DRV_FLEXCAN_ChangeBitrate(uint8_t instance, const flexcan_module_config_t *config);
+
+/**
+ * @brief       Switch an initialized FLEXCAN module between normal, listen-only and loopback mode.
+ * @note        Self reception is enabled in loopback mode, in the other modes as configured at init.
+ * @param[in]   instance:    Identifies which FlexCAN module
+ * @param[in]   flexcanMode: FLEXCAN_NORMAL_MODE, FLEXCAN_LISTEN_ONLY_MODE or FLEXCAN_LOOPBACK_MODE
+ * @retval      None
+ */
+void DRV_FLEXCAN_SetOperationMode(uint8_t instance, flexcan_operation_modes_t flexcanMode);
+
 /**
  * @brief       Configures the global mask for RX message buffers.
  * @param[in]   instance:  Identifies which FlexCAN module
@@ -257,12 +391,32 @@ void DRV_FLEXCAN_Receive(uint8_t instance, uint8_t mbIdx, flexcan_mb_t *data);
 
 /**
   * @brief      Receive a CAN message using interrupt
+  * @note       The frame is kept in the handle until the next read of the same MB.
+  *             Its CODE is FLEXCAN_RX_OVERRUN when frames were overwritten before this read.
   * @param[in]  instance: Identifies which FlexCAN module
   * @param[in]  mbIdx:  Message buffer index
-  * @param[out] data: Pointer to received message structure
+  * @retval     Read-only view of the received frame, decoded with the FLEXCAN_FRAME_* macros
+  */
+const flexcan_frame_t *DRV_FLEXCAN_ReceiveInt(uint8_t instance, uint8_t mbIdx);
+
+/**
+  * @brief      Read the loss counters of a receive message buffer, counted since initialization
+  * @note       An overrun only tells that at least one frame was lost, not how many
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  mbIdx:  Message buffer index
+  * @param[out] overrunCnt: Number of reads that found the MB overrun
+  * @param[out] busyCnt: Number of reads that found the MB busy
   * @retval     None
   */
-void DRV_FLEXCAN_ReceiveInt(uint8_t instance, uint8_t mbIdx, flexcan_mb_t *data);
+void DRV_FLEXCAN_GetMbLossCounters(uint8_t instance, uint8_t mbIdx, uint32_t *overrunCnt, uint32_t *busyCnt);
+
+/**
+  * @brief      Read the free running timer, it counts one tick per CAN bit time
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @retval     Current 16-bit timer value
+  * @note       Reading the timer also unlocks any locked message buffer
+  */
+uint16_t DRV_FLEXCAN_GetTimer(uint8_t instance);
 
 /**
   * @brief      Configure a Transmit Message Buffer
@@ -274,6 +428,17 @@ void DRV_FLEXCAN_ReceiveInt(uint8_t instance, uint8_t mbIdx, flexcan_mb_t *data)
   */
 void DRV_FLEXCAN_ConfigTxMb(uint8_t instance, uint8_t mbIdx, flexcan_mb_config_t *tx_mb, uint32_t mb_id);
 
+/**
+  * @brief      Set the local priority of a Transmit Message Buffer
+  * @note       Used when the module is initialized with localPriority = 1. The MB must not hold a
+  *             pending frame. DRV_FLEXCAN_ConfigTxMb() resets the priority to 0.
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  mbIdx: Message buffer index
+  * @param[in]  priority: 0 (arbitrated first) .. FLEXCAN_MB_PRIO_MAX
+  * @retval     None
+  */
+void DRV_FLEXCAN_SetTxMbPriority(uint8_t instance, uint8_t mbIdx, uint8_t priority);
+
 /**
   * @brief      Transmit a CAN message
   * @param[in]  instance: Identifies which FlexCAN module
@@ -283,6 +448,67 @@ void DRV_FLEXCAN_ConfigTxMb(uint8_t instance, uint8_t mbIdx, flexcan_mb_config_t
   */
 void DRV_FLEXCAN_Transmit(uint8_t instance, uint8_t mbIdx, flexcan_mb_t *data);
 
+/**
+  * @brief      Transmit a CAN message with the ID carried by the message instead of the configured one
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  mbIdx: Mailbox index
+  * @param[in]  data: Pointer to message structure to transmit, msgId and idType are used
+  * @retval     None
+  */
+void DRV_FLEXCAN_TransmitId(uint8_t instance, uint8_t mbIdx, flexcan_mb_t *data);
+
+/**
+  * @brief      Configure a message buffer that answers remote request frames in hardware
+  * @note       A remote frame with the MB ID is answered with a data frame carrying data,
+  *             without interrupt nor CPU work. Needs CTRL2[RRS] = 0 (reset value).
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  mbIdx: Message buffer index
+  * @param[in]  tx_mb: Pointer to message buffer configuration structure
+  * @param[in]  mb_id: ID of the remote request and of the answer
+  * @param[in]  data: Pointer to the answer, data and dataLength are used
+  * @retval     None
+  */
+void DRV_FLEXCAN_ConfigRemoteAnswerMb(uint8_t instance, uint8_t mbIdx, flexcan_mb_config_t *tx_mb, uint32_t mb_id, const flexcan_mb_t *data);
+
+/**
+  * @brief      Transmit a remote request frame with the ID configured in the message buffer
+  * @note       Once sent, the MB turns into an empty receive MB with the same ID and
+  *             catches the answer like any received frame.
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  mbIdx: Message buffer index
+  * @param[in]  dataLength: Data length requested from the answering node
+  * @retval     None
+  */
+void DRV_FLEXCAN_TransmitRemote(uint8_t instance, uint8_t mbIdx, uint32_t dataLength);
+
+/**
+  * @brief      Withdraw the frame pending in a transmit message buffer (MCR[AEN] = 1)
+  * @note       The first call requests the abort and returns at once. A frame in transmission
+  *             completes first, a controller in bus-off or freeze holds the MB: the call
+  *             returns FLEXCAN_ABORT_PENDING and is repeated until the MB is free.
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  mbIdx: Mailbox index
+  * @retval     It can be a value of flexcan_abort_status_t
+  */
+flexcan_abort_status_t DRV_FLEXCAN_AbortTxMb(uint8_t instance, uint8_t mbIdx);
+
+/**
+  * @brief      Read the time stamp of a message buffer, captured at the last transmission or reception
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  mbIdx: Mailbox index
+  * @retval     Free running timer value (CAN bit times)
+  */
+uint16_t DRV_FLEXCAN_GetMbTimeStamp(uint8_t instance, uint8_t mbIdx);
+
+/**
+  * @brief      Check whether a transmit message buffer still holds a frame waiting for the bus
+  * @note       A frame whose abort is requested but not done yet is still pending
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  mbIdx: Mailbox index
+  * @retval     1 if a transmission is pending, 0 otherwise
+  */
+uint8_t DRV_FLEXCAN_IsTxMbPending(uint8_t instance, uint8_t mbIdx);
+
 /**
   * @brief      Register Message Buffer Callback Function
   * @param[in]  instance: Identifies which FlexCAN module
@@ -299,4 +525,60 @@ void DRV_FLEXCAN_RegisterMbCallback(uint8_t instance, void (*cb_ptr)(void));
   */
 void DRV_FLEXCAN_RegisterBusOffCallback(uint8_t instance, void (*cb_ptr)(void));
 
+/**
+  * @brief      Register Error State Callback Function, called on TX/RX warning and bus-off recovery done
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  cb_ptr: Pointer to callback function
+  * @retval     None
+  */
+void DRV_FLEXCAN_RegisterErrorStateCallback(uint8_t instance, void (*cb_ptr)(void));
+
+/**
+  * @brief      Arm the bus error interrupt (ESR1[ERRINT]) for one error, the error state callback
+  *             runs on the next bus error and the interrupt masks itself again
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @retval     None
+  */
+void DRV_FLEXCAN_EnableErrorInt(uint8_t instance);
+
+/**
+  * @brief      Get the fault confinement state of the module
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @retval     Error active, error passive or bus off
+  */
+flexcan_fault_state_t DRV_FLEXCAN_GetFaultState(uint8_t instance);
+
+/**
+  * @brief      Get the transmit and receive error counters
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[out] txErrCnt: Transmit error counter
+  * @param[out] rxErrCnt: Receive error counter
+  * @retval     None
+  */
+void DRV_FLEXCAN_GetErrorCounters(uint8_t instance, uint8_t *txErrCnt, uint8_t *rxErrCnt);
+
+/**
+  * @brief      Get and clear the receive error flags (stuff, form and CRC errors)
+  * @note       The flags are cleared by the read of ESR1, they collect the errors seen since the previous call.
+  *             In listen-only mode the error counters are frozen, these flags still report the errors.
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @retval     Flags set among FLEXCAN_ESR1_STFERR_MASK, FLEXCAN_ESR1_FRMERR_MASK and FLEXCAN_ESR1_CRCERR_MASK
+  */
+uint32_t DRV_FLEXCAN_GetRxErrorFlags(uint8_t instance);
+
+/**
+  * @brief      Select how the module leaves the bus-off state
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  mode: Automatic or manual recovery
+  * @retval     None
+  */
+void DRV_FLEXCAN_SetBusOffRecovery(uint8_t instance, flexcan_busoff_recovery_t mode);
+
+/**
+  * @brief      Start the bus-off recovery sequence when manual recovery is selected
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @retval     None
+  */
+void DRV_FLEXCAN_RecoverBusOff(uint8_t instance);
+
 #endif /* DRV_S32K144_FLEXCAN_H_ */
@@ -7,7 +7,8 @@
 /*******************************************************************************
  * Prototypes
  ******************************************************************************/
-static void FLEXCAN_BitrateToTimeSeg(uint32_t bitrate, uint32_t clkFreq, flexcan_time_segment_t *timeSeg);
+static void FLEXCAN_BitrateToTimeSeg(uint32_t bitrate, uint32_t clkFreq, uint32_t samplePoint, flexcan_time_segment_t *timeSeg);
+static void FLEXCAN_GetBitTiming(const flexcan_module_config_t *config, flexcan_time_segment_t *timeSeg);
 static flexcan_freeze_mode_status_t FLEXCAN_GetFreezeMode(uint8_t instance);
 static void FLEXCAN_EnterFreezeMode(uint8_t instance);
 static void FLEXCAN_ExitFreezeMode(uint8_t instance);
@@ -22,6 +23,10 @@ static void FLEXCAN_ConfigRxMaskType(uint8_t instance, flexcan_rx_mask_type_t rx
 static void FLEXCAN_SetOperationModes(uint8_t instance, flexcan_operation_modes_t flexcanMode);
 static void FLEXCAN_Mb_IRQHandler(uint8_t instance);
 static void FLEXCAN_BusOff_IRQHandler(uint8_t instance);
+static void FLEXCAN_Error_IRQHandler(uint8_t instance);
+static uint32_t FLEXCAN_EncodeId(flexcan_mb_id_type_t idType, uint32_t id);
+static void FLEXCAN_DecodeId(uint32_t cs, uint32_t idWord, flexcan_mb_t *data);
+static uint32_t FLEXCAN_ReadMbCs(uint8_t instance, uint8_t mbIdx);
 
 /*******************************************************************************
  * Variables
@@ -33,6 +38,42 @@ FLEXCAN_Type *g_flexcanBase[FLEXCAN_INSTANCE_COUNT] = IP_FLEXCAN_BASE_PTRS;
 /* Pointer to runtime handle structure.*/
 flexcan_handle_t *g_flexcanHandle[FLEXCAN_INSTANCE_COUNT] = {NULL};
 
+/* Bit timing precomputed with FLEXCAN_BitrateToTimeSeg() for the clocks the board can feed the
+ * protocol engine: SYS_CLK 80 MHz (FLEXCAN_CLK_SRC_PERIPH) and SOSCDIV2 8 MHz (FLEXCAN_CLK_SRC_OSC).
+ * Time segment columns are register values: PRESDIV, RJW, PROPSEG, PSEG1, PSEG2.
+ * SP 87 stands for the 87.5% recommended by CiA, the search works in whole percent.
+ * Comments give the resulting bit time and the sample point actually reached, sim/test/Test_BitTiming.c
+ * checks both against the search. 8 MHz at 1 Mbit/s has 8 tq, 87.5% is out of reach there. */
+static const flexcan_bit_timing_t g_flexcanBitTimingTable[] =
+{
+    /* clkFreq     bitrate   SP   PRESDIV RJW PROP PSEG1 PSEG2 */
+    { 80000000U,   125000U, 75U, {31U, 3U, 7U, 5U, 4U}}, /* 20 tq, 75.0% */
+    { 80000000U,   125000U, 80U, {31U, 3U, 7U, 6U, 3U}}, /* 20 tq, 80.0% */
+    { 80000000U,   125000U, 87U, {39U, 1U, 7U, 4U, 1U}}, /* 16 tq, 87.5% */
+    { 80000000U,   250000U, 75U, {15U, 3U, 7U, 5U, 4U}}, /* 20 tq, 75.0% */
+    { 80000000U,   250000U, 80U, {15U, 3U, 7U, 6U, 3U}}, /* 20 tq, 80.0% */
+    { 80000000U,   250000U, 87U, {19U, 1U, 7U, 4U, 1U}}, /* 16 tq, 87.5% */
+    { 80000000U,   500000U, 75U, { 7U, 3U, 7U, 5U, 4U}}, /* 20 tq, 75.0% */
+    { 80000000U,   500000U, 80U, { 7U, 3U, 7U, 6U, 3U}}, /* 20 tq, 80.0% */
+    { 80000000U,   500000U, 87U, { 9U, 1U, 7U, 4U, 1U}}, /* 16 tq, 87.5% */
+    { 80000000U,  1000000U, 75U, { 3U, 3U, 7U, 5U, 4U}}, /* 20 tq, 75.0% */
+    { 80000000U,  1000000U, 80U, { 3U, 3U, 7U, 6U, 3U}}, /* 20 tq, 80.0% */
+    { 80000000U,  1000000U, 87U, { 4U, 1U, 7U, 4U, 1U}}, /* 16 tq, 87.5% */
+    {  8000000U,   125000U, 75U, { 3U, 3U, 6U, 3U, 3U}}, /* 16 tq, 75.0% */
+    {  8000000U,   125000U, 80U, { 3U, 2U, 7U, 3U, 2U}}, /* 16 tq, 81.2% */
+    {  8000000U,   125000U, 87U, { 3U, 1U, 7U, 4U, 1U}}, /* 16 tq, 87.5% */
+    {  8000000U,   250000U, 75U, { 1U, 3U, 6U, 3U, 3U}}, /* 16 tq, 75.0% */
+    {  8000000U,   250000U, 80U, { 1U, 2U, 7U, 3U, 2U}}, /* 16 tq, 81.2% */
+    {  8000000U,   250000U, 87U, { 1U, 1U, 7U, 4U, 1U}}, /* 16 tq, 87.5% */
+    {  8000000U,   500000U, 75U, { 0U, 3U, 6U, 3U, 3U}}, /* 16 tq, 75.0% */
+    {  8000000U,   500000U, 80U, { 0U, 2U, 7U, 3U, 2U}}, /* 16 tq, 81.2% */
+    {  8000000U,   500000U, 87U, { 0U, 1U, 7U, 4U, 1U}}, /* 16 tq, 87.5% */
+    {  8000000U,  1000000U, 75U, { 0U, 1U, 2U, 1U, 1U}}, /*  8 tq, 75.0% */
+    {  8000000U,  1000000U, 80U, { 0U, 1U, 2U, 1U, 1U}}, /*  8 tq, 75.0% */
+};
+
+#define FLEXCAN_BIT_TIMING_TABLE_SIZE   (sizeof(g_flexcanBitTimingTable) / sizeof(g_flexcanBitTimingTable[0]))
+
 /*******************************************************************************
  * Code
  ******************************************************************************/
@@ -41,15 +82,17 @@ flexcan_handle_t *g_flexcanHandle[FLEXCAN_INSTANCE_COUNT] = {NULL};
 
 /**
   * @brief      Calculate the CAN bit timing segments based on bitrate and clock frequency
+  * @note       Fallback for combinations missing in g_flexcanBitTimingTable
   * @param[in]  bitrate: Desired bitrate for CAN communication
   * @param[in]  clkFreq: The clock frequency provided to the FlexCAN module
+  * @param[in]  samplePoint: Desired sample point percentage
   * @param[out] timeSeg: Pointer to a structure that will hold the computed time segment values.
   * @retval     None
   */
-static void FLEXCAN_BitrateToTimeSeg(uint32_t bitrate, uint32_t clkFreq, flexcan_time_segment_t *timeSeg)
+static void FLEXCAN_BitrateToTimeSeg(uint32_t bitrate, uint32_t clkFreq, uint32_t samplePoint, flexcan_time_segment_t *timeSeg)
 {
     uint32_t tmpBitrate = 0U, dBitrate = 0U, tmpSample = 0U, dSample = 0U, tmpPhaseSeg1 = 0U, tmpPhaseSeg2 = 0U, tmpPropSeg = 0U, tmpPresdiv = 0U, tSeg1 = 0U, tSeg2 = 0U, numTq = 0U;
-    uint32_t dBitrateMin = 1000000U, dSampleMin = 100U, samplePoint = 80U; /* Desired sample point percentage */
+    uint32_t dBitrateMin = 1000000U, dSampleMin = 100U;
     uint32_t presDiv = 0U, propSeg = 0U, phaseSeg1 = 0U, phaseSeg2 = 0U;
     uint8_t proceedFlag = 1U; /* Flag to determine if the current configuration is valid */
     uint8_t exitFlag = 1U;    /* Flag to exit the loop when the best configuration is found */
@@ -59,12 +102,13 @@ static void FLEXCAN_BitrateToTimeSeg(uint32_t bitrate, uint32_t clkFreq, flexcan
         proceedFlag = 1U;
         /* Calculate the number of time quanta (Tq) for the given prescaler value */
         numTq = (clkFreq) / ((bitrate) * (tmpPresdiv + 1U));
-        /* Compute temporary bitrate based on the current prescaler and numTq */
-        tmpBitrate = (clkFreq) / ((numTq) * (tmpPresdiv + 1U));
         /* Check if the number of Tq is within the allowed range */
         if (numTq >= FLEXCAN_NUM_TQ_MIN && numTq <= FLEXCAN_NUM_TQ_MAX)
         {
-            tSeg1 = (numTq * samplePoint / 100U) - 1U;
+            /* Compute temporary bitrate based on the current prescaler and numTq */
+            tmpBitrate = (clkFreq) / ((numTq) * (tmpPresdiv + 1U));
+            /* Nearest sample point the time quanta allow, truncating lost up to one time quantum */
+            tSeg1 = (((numTq * samplePoint) + 50U) / 100U) - 1U;
             tSeg2 = numTq - tSeg1 - 1U;
             /* Adjust TSEG1 and TSEG2 to ensure they are within the valid range */
             while (tSeg1 > FLEXCAN_TSEG1_MAX || tSeg2 < FLEXCAN_TSEG2_MIN)
@@ -117,9 +161,10 @@ static void FLEXCAN_BitrateToTimeSeg(uint32_t bitrate, uint32_t clkFreq, flexcan
     timeSeg->propSeg = propSeg;
     timeSeg->phaseSeg1 = phaseSeg1;
     timeSeg->phaseSeg2 = phaseSeg2;
-    if (phaseSeg1 < FLEXCAN_RJW_MAX)
+    /* SJW may not exceed either phase segment */
+    if ((phaseSeg1 < FLEXCAN_RJW_MAX) || (phaseSeg2 < FLEXCAN_RJW_MAX))
     {
-        timeSeg->rJumpWidth = phaseSeg1;
+        timeSeg->rJumpWidth = (phaseSeg1 < phaseSeg2) ? phaseSeg1 : phaseSeg2;
     }
     else
     {
@@ -127,6 +172,39 @@ static void FLEXCAN_BitrateToTimeSeg(uint32_t bitrate, uint32_t clkFreq, flexcan
     }
 }
 
+/**
+  * @brief      Select the bit timing for a configuration, from the precomputed table when the
+  *             clock/bitrate/sample point combination is listed, from the runtime search otherwise
+  * @param[in]  config: Pointer to the FLEXCAN configuration structure
+  * @param[out] timeSeg: Pointer to a structure that will hold the time segment values.
+  * @retval     None
+  */
+static void FLEXCAN_GetBitTiming(const flexcan_module_config_t *config, flexcan_time_segment_t *timeSeg)
+{
+    uint32_t samplePoint = (config->samplePoint != 0U) ? config->samplePoint : FLEXCAN_SAMPLE_POINT_DEFAULT;
+    uint8_t found = 0U;
+    uint8_t i = 0U;
+    for (i = 0U; (i < FLEXCAN_BIT_TIMING_TABLE_SIZE) && (found == 0U); i++)
+    {
+        if ((g_flexcanBitTimingTable[i].clkFreq == config->flexcanClkFreq) &&
+            (g_flexcanBitTimingTable[i].bitrate == config->bitrate) &&
+            (g_flexcanBitTimingTable[i].samplePoint == samplePoint))
+        {
+            *timeSeg = g_flexcanBitTimingTable[i].timeSeg;
+            found = 1U;
+        }
+    }
+    if (found == 0U)
+    {
+        FLEXCAN_BitrateToTimeSeg(config->bitrate, config->flexcanClkFreq, samplePoint, timeSeg);
+    }
+    /* rJumpWidth holds the largest SJW allowed, narrow it down to the requested one */
+    if ((config->rJumpWidth != FLEXCAN_SJW_AUTO) && ((config->rJumpWidth - 1U) < timeSeg->rJumpWidth))
+    {
+        timeSeg->rJumpWidth = config->rJumpWidth - 1U;
+    }
+}
+
 /**
   * @brief      Check the current state whether module is in Freezw Mode or not.
   * @param[in]  instance: Identifies which FlexCAN module
@@ -311,6 +389,8 @@ static void FLEXCAN_InitMb(uint8_t instance)
         base->RAMn[i * MESSAGE_BUFFER_SIZE + 2U] = 0x0; /* Data word 1 */
         base->RAMn[i * MESSAGE_BUFFER_SIZE + 3U] = 0x0; /* Data word 2 */
     }
+    /* Let all MBs of the instance take part in matching and arbitration (reset value covers MB 0..15 only) */
+    base->MCR = (base->MCR & ~(FLEXCAN_MCR_MAXMB_MASK)) | FLEXCAN_MCR_MAXMB((uint32_t)maxMB - 1U);
 }
 
 /**
@@ -344,6 +424,50 @@ static void FLEXCAN_ConfigRxMaskType(uint8_t instance, flexcan_rx_mask_type_t rx
     }
 }
 
+/**
+ * @brief       Converts an identifier into the layout of an ID word (message buffer or mask register).
+ * @param[in]   idType: ID type (standard or extended).
+ * @param[in]   id:     11-bit standard or 29-bit extended identifier.
+ * @retval      Value to be written into the ID word
+ */
+static uint32_t FLEXCAN_EncodeId(flexcan_mb_id_type_t idType, uint32_t id)
+{
+    uint32_t idWord = 0U;
+    if (idType == FLEXCAN_MB_ID_STD)
+    {
+        idWord = ((uint32_t)((uint32_t)(id << FLEXCAN_MB_ID_STD_SHIFT)) & (FLEXCAN_MB_ID_STD_MASK));
+    }
+    else if (idType == FLEXCAN_MB_ID_EXT)
+    {
+        idWord = ((uint32_t)((uint32_t)(id << FLEXCAN_MB_ID_EXT_SHIFT)) & (FLEXCAN_MB_ID_EXT_FULL_MASK));
+    }
+    else
+    {
+    }
+    return idWord;
+}
+
+/**
+ * @brief       Extracts the identifier of a received message, standard or extended depending on the IDE bit.
+ * @param[in]   cs:     Control and Status word of the message buffer.
+ * @param[in]   idWord: ID word of the message buffer.
+ * @param[out]  data:   Message structure to store the ID and ID type.
+ * @retval      None
+ */
+static void FLEXCAN_DecodeId(uint32_t cs, uint32_t idWord, flexcan_mb_t *data)
+{
+    if ((cs & FLEXCAN_MB_IDE_MASK) != 0U)
+    {
+        data->idType = FLEXCAN_MB_ID_EXT;
+        data->msgId = ((idWord & FLEXCAN_MB_ID_EXT_FULL_MASK) >> FLEXCAN_MB_ID_EXT_SHIFT);
+    }
+    else
+    {
+        data->idType = FLEXCAN_MB_ID_STD;
+        data->msgId = ((idWord & FLEXCAN_MB_ID_STD_MASK) >> FLEXCAN_MB_ID_STD_SHIFT);
+    }
+}
+
 /**
  * @brief       Configures the operation mode of the FLEXCAN module
  * @param[in]   instance: Identifies which FlexCAN module
@@ -403,6 +527,58 @@ void DRV_FLEXCAN_DisableMbInt(uint8_t instance, uint8_t mbIdx)
     base->IMASK1 = ((base->IMASK1) & (~tmp));
 }
 
+/**
+ * @brief       Deactivate a message buffer: interrupt disabled, flag cleared and CODE set inactive.
+ * @param[in]   instance: Identifies which FlexCAN module
+ * @param[in]   mbIdx:    Message buffer index.
+ * @retval      None
+ */
+void DRV_FLEXCAN_DeactivateMb(uint8_t instance, uint8_t mbIdx)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    DRV_FLEXCAN_DisableMbInt(instance, mbIdx);
+    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = FLEXCAN_MB_CODE(FLEXCAN_RX_INACTIVE);
+    DRV_FLEXCAN_ClearMbIntFlag(instance, mbIdx);
+}
+
+/**
+ * @brief       Get the number of message buffers of a FlexCAN module.
+ * @param[in]   instance: Identifies which FlexCAN module
+ * @retval      Number of message buffers.
+ */
+uint8_t DRV_FLEXCAN_GetMbCount(uint8_t instance)
+{
+    return FLEXCAN_GetMaxMbNum(instance);
+}
+
+/**
+ * @brief       Enter freeze mode, the module leaves the bus once the current frame is done.
+ * @param[in]   instance: Identifies which FlexCAN module
+ * @retval      None
+ */
+void DRV_FLEXCAN_EnterFreeze(uint8_t instance)
+{
+    if (FLEXCAN_GetFreezeMode(instance) == FLEXCAN_OUT_FREEZE_MODE)
+    {
+        FLEXCAN_EnterFreezeMode(instance);
+    }
+    else {}
+}
+
+/**
+ * @brief       Exit freeze mode and rejoin the bus.
+ * @param[in]   instance: Identifies which FlexCAN module
+ * @retval      None
+ */
+void DRV_FLEXCAN_ExitFreeze(uint8_t instance)
+{
+    if (FLEXCAN_GetFreezeMode(instance) == FLEXCAN_IN_FREEZE_MODE)
+    {
+        FLEXCAN_ExitFreezeMode(instance);
+    }
+    else {}
+}
+
 /**
  * @brief       Initializes the FLEXCAN module with the specified configuration.
  *              This function performs the following initialization steps:
@@ -437,12 +613,21 @@ void DRV_FLEXCAN_Init(uint8_t instance, flexcan_module_config_t *config, flexcan
         FLEXCAN_EnterFreezeMode(instance);
     }
     FLEXCAN_ConfigRxMaskType(instance, config->rxMaskType);
-    if (config->flexcanMode != FLEXCAN_LOOPBACK_MODE)
+    if ((config->flexcanMode != FLEXCAN_LOOPBACK_MODE) && (config->selfReception == 0U))
     {
         base->MCR = (base->MCR & ~(FLEXCAN_MCR_SRXDIS_MASK)) | FLEXCAN_MCR_SRXDIS(1U);
     }
+    else
+    {
+        base->MCR = (base->MCR & ~(FLEXCAN_MCR_SRXDIS_MASK)) | FLEXCAN_MCR_SRXDIS(0U);
+    }
+    /* Pending TX MBs are arbitrated on PRIO and ID when local priority is enabled, on ID only otherwise */
+    base->MCR = (base->MCR & ~(FLEXCAN_MCR_LPRIOEN_MASK)) | FLEXCAN_MCR_LPRIOEN(config->localPriority);
+    base->CTRL2 = (base->CTRL2 & ~(FLEXCAN_CTRL2_TASD_MASK)) | FLEXCAN_CTRL2_TASD(config->txArbStartDelay);
+    /* Enable the abort mechanism, pending transmissions can be withdrawn safely */
+    base->MCR = (base->MCR & ~(FLEXCAN_MCR_AEN_MASK)) | FLEXCAN_MCR_AEN(1U);
     /*Set bitrate*/
-    FLEXCAN_BitrateToTimeSeg(config->bitrate, config->flexcanClkFreq, &timeSeg);
+    FLEXCAN_GetBitTiming(config, &timeSeg);
     FLEXCAN_SetBitrate(instance, &timeSeg);
 
     /* Initialize MBs to inactive */
@@ -459,14 +644,58 @@ void DRV_FLEXCAN_Init(uint8_t instance, flexcan_module_config_t *config, flexcan
 
     for (i = 0U; i < flexcanMaxMBNum; i++)
     {
-        handle->mbs[i] = NULL;
+        handle->frames[i].cs = 0U;
+        handle->mbOverrunCnt[i] = 0U;
+        handle->mbBusyCnt[i] = 0U;
     }
     /* Prepare for callback */
     handle->mb_callback = NULL;
     handle->bus_off_callback = NULL;
+    handle->error_state_callback = NULL;
+    handle->busOffRecovery = FLEXCAN_BUSOFF_RECOVERY_AUTO;
+    handle->selfReception = config->selfReception;
     g_flexcanHandle[instance] = handle;
 }
 
+/**
+ * @brief       Change the bitrate of an initialized FLEXCAN module.
+ * @param[in]   instance: Identifies which FlexCAN module
+ * @param[in]   config:   Pointer to the configuration, only clock frequency, bitrate,
+ *                        sample point and SJW are used.
+ * @retval      None
+ */
+void DRV_FLEXCAN_ChangeBitrate(uint8_t instance, const flexcan_module_config_t *config)
+{
+    flexcan_time_segment_t timeSeg;
+    FLEXCAN_GetBitTiming(config, &timeSeg);
+    FLEXCAN_SetBitrate(instance, &timeSeg);
+}
+
+/**
+ * @brief       Switch an initialized FLEXCAN module between normal, listen-only and loopback mode.
+ * @note        Self reception is enabled in loopback mode, in the other modes as configured at init.
+ * @param[in]   instance:    Identifies which FlexCAN module
+ * @param[in]   flexcanMode: FLEXCAN_NORMAL_MODE, FLEXCAN_LISTEN_ONLY_MODE or FLEXCAN_LOOPBACK_MODE
+ * @retval      None
+ */
+void DRV_FLEXCAN_SetOperationMode(uint8_t instance, flexcan_operation_modes_t flexcanMode)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    flexcan_freeze_mode_status_t freeze = FLEXCAN_GetFreezeMode(instance);
+    if (freeze == FLEXCAN_OUT_FREEZE_MODE)
+    {
+        FLEXCAN_EnterFreezeMode(instance);
+    }
+    /* Leave the previous mode before entering the new one */
+    base->CTRL1 = base->CTRL1 & ~(FLEXCAN_CTRL1_LPB_MASK | FLEXCAN_CTRL1_LOM_MASK);
+    base->MCR = (base->MCR & ~(FLEXCAN_MCR_SRXDIS_MASK)) | FLEXCAN_MCR_SRXDIS((g_flexcanHandle[instance]->selfReception != 0U) ? 0U : 1U);
+    FLEXCAN_SetOperationModes(instance, flexcanMode);
+    if (freeze == FLEXCAN_OUT_FREEZE_MODE)
+    {
+        FLEXCAN_ExitFreezeMode(instance);
+    }
+}
+
 /* RECEIVE */
 /**
  * @brief       Configures the global mask for RX message buffers.
@@ -483,17 +712,7 @@ void DRV_FLEXCAN_SetRxMbGlobalMask(uint8_t instance, flexcan_mb_id_type_t idType
     {
         FLEXCAN_EnterFreezeMode(instance);
     }
-    if (idType == FLEXCAN_MB_ID_STD)
-    {
-        base->RXMGMASK = ((uint32_t)((uint32_t)(mask << FLEXCAN_MB_ID_STD_SHIFT)) & (FLEXCAN_MB_ID_STD_MASK));
-    }
-    else if (idType == FLEXCAN_MB_ID_EXT)
-    {
-        base->RXMGMASK = ((uint32_t)((uint32_t)(mask << FLEXCAN_MB_ID_STD_SHIFT)) & (FLEXCAN_MB_ID_STD_MASK | FLEXCAN_MB_ID_EXT_MASK));
-    }
-    else
-    {
-    }
+    base->RXMGMASK = FLEXCAN_EncodeId(idType, mask);
     if (freeze == FLEXCAN_OUT_FREEZE_MODE)
     {
         FLEXCAN_ExitFreezeMode(instance);
@@ -516,17 +735,7 @@ void DRV_FLEXCAN_SetRxMbIndividualMask(uint8_t instance, flexcan_mb_id_type_t id
     {
         FLEXCAN_EnterFreezeMode(instance);
     }
-    if (idType == FLEXCAN_MB_ID_STD)
-    {
-        base->RXIMR[mbIdx] = ((uint32_t)((uint32_t)(mask << FLEXCAN_MB_ID_STD_SHIFT)) & (FLEXCAN_MB_ID_STD_MASK));
-    }
-    else if (idType == FLEXCAN_MB_ID_EXT)
-    {
-        base->RXIMR[mbIdx] = ((uint32_t)((uint32_t)(mask << FLEXCAN_MB_ID_STD_SHIFT)) & (FLEXCAN_MB_ID_STD_MASK | FLEXCAN_MB_ID_EXT_MASK));
-    }
-    else
-    {
-    }
+    base->RXIMR[mbIdx] = FLEXCAN_EncodeId(idType, mask);
     if (freeze == FLEXCAN_OUT_FREEZE_MODE)
     {
         FLEXCAN_ExitFreezeMode(instance);
@@ -587,17 +796,7 @@ void DRV_FLEXCAN_ConfigRxMb(uint8_t instance, uint8_t mbIdx, flexcan_mb_config_t
     /* Config data length */
     base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] & ~(FLEXCAN_MB_DLC_MASK)) | FLEXCAN_MB_DLC(rx_mb->dataLength);
     /* Config ID */
-    if (rx_mb->idType == FLEXCAN_MB_ID_STD)
-    {
-        base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 1U] = ((uint32_t)((uint32_t)(mb_id << FLEXCAN_MB_ID_STD_SHIFT)) & (FLEXCAN_MB_ID_STD_MASK));
-    }
-    else if (rx_mb->idType == FLEXCAN_MB_ID_EXT)
-    {
-        base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 1U] = ((uint32_t)((uint32_t)(mb_id << FLEXCAN_MB_ID_EXT_SHIFT)) & (FLEXCAN_MB_ID_EXT_MASK));
-    }
-    else
-    {
-    }
+    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 1U] = FLEXCAN_EncodeId(rx_mb->idType, mb_id);
     /* Write EMPTY code to active mailbox */
     base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] & ~(FLEXCAN_MB_CODE_MASK)) | FLEXCAN_MB_CODE(FLEXCAN_RX_EMPTY);
 }
@@ -612,17 +811,13 @@ void DRV_FLEXCAN_ConfigRxMb(uint8_t instance, uint8_t mbIdx, flexcan_mb_config_t
 void DRV_FLEXCAN_Receive(uint8_t instance, uint8_t mbIdx, flexcan_mb_t *data)
 {
     FLEXCAN_Type *base = g_flexcanBase[instance];
-    /* Check BUSY by checking CODE field. if EMPTY == BUSY deasserted */
-    data->cs = base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0];
+    /* Wait for BUSY to be deasserted and lock the MB */
+    data->cs = FLEXCAN_ReadMbCs(instance, mbIdx);
     data->code = ((data->cs & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT);
-    while (data->code == FLEXCAN_RX_BUSY)
-    {
-        data->cs = base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0];
-        data->code = ((data->cs & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT);
-    }
     /*Read content of the mail box*/
-    data->msgId = ((base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 1U] & FLEXCAN_MB_ID_STD_MASK) >> FLEXCAN_MB_ID_STD_SHIFT);
+    FLEXCAN_DecodeId(data->cs, base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 1U], data);
     data->dataLength = ((data->cs & FLEXCAN_MB_DLC_MASK) >> FLEXCAN_MB_DLC_SHIFT);
+    data->timeStamp = ((data->cs & FLEXCAN_MB_TIME_STAMP_MASK) >> FLEXCAN_MB_TIME_STAMP_SHIFT);
     data->data[0U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 2U]);
     data->data[1U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 3U]);
     /*Clear flag*/
@@ -633,28 +828,91 @@ void DRV_FLEXCAN_Receive(uint8_t instance, uint8_t mbIdx, flexcan_mb_t *data)
 
 /**
   * @brief      Receive a CAN message using interrupt
+  * @note       The frame is kept in the handle until the next read of the same MB.
+  *             Its CODE is FLEXCAN_RX_OVERRUN when frames were overwritten before this read.
   * @param[in]  instance: Identifies which FlexCAN module
   * @param[in]  mbIdx:  Message buffer index
-  * @param[out] data: Pointer to received message structure
-  * @retval     None
+  * @retval     Read-only view of the received frame, decoded with the FLEXCAN_FRAME_* macros
   */
-void DRV_FLEXCAN_ReceiveInt(uint8_t instance, uint8_t mbIdx, flexcan_mb_t *data)
+const flexcan_frame_t *DRV_FLEXCAN_ReceiveInt(uint8_t instance, uint8_t mbIdx)
 {
     FLEXCAN_Type *base = g_flexcanBase[instance];
-    flexcan_handle_t *handle = g_flexcanHandle[instance];
-    handle->mbs[mbIdx] = data;
+    flexcan_frame_t *frame = &g_flexcanHandle[instance]->frames[mbIdx];
+    const volatile uint32_t *mb = &base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE];
 
-    /* Lock MB by reading it */
-    volatile uint32_t *flexcan_mb = &(base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE]);
-    (void)*flexcan_mb;
-    /*Read content of the mail box*/
-    handle->mbs[mbIdx]->cs = base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U];
-    handle->mbs[mbIdx]->msgId = ((base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 1U] & FLEXCAN_MB_ID_STD_MASK) >> FLEXCAN_MB_ID_STD_SHIFT);
-    handle->mbs[mbIdx]->dataLength = ((handle->mbs[mbIdx]->cs & FLEXCAN_MB_DLC_MASK) >> FLEXCAN_MB_DLC_SHIFT);
-    handle->mbs[mbIdx]->data[0U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 2U]);
-    handle->mbs[mbIdx]->data[1U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 3U]);
+    /* Wait for BUSY to be deasserted and lock the MB, then copy the other three words */
+    frame->cs = FLEXCAN_ReadMbCs(instance, mbIdx);
+    frame->id = mb[1U];
+    frame->data[0U] = mb[2U];
+    frame->data[1U] = mb[3U];
     /* Unlock MB by reading Free Running Timer*/
     (void)base->TIMER;
+
+    return frame;
+}
+
+/**
+  * @brief      Read the loss counters of a receive message buffer, counted since initialization
+  * @note       An overrun only tells that at least one frame was lost, not how many
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  mbIdx:  Message buffer index
+  * @param[out] overrunCnt: Number of reads that found the MB overrun
+  * @param[out] busyCnt: Number of reads that found the MB busy
+  * @retval     None
+  */
+void DRV_FLEXCAN_GetMbLossCounters(uint8_t instance, uint8_t mbIdx, uint32_t *overrunCnt, uint32_t *busyCnt)
+{
+    flexcan_handle_t *handle = g_flexcanHandle[instance];
+    *overrunCnt = handle->mbOverrunCnt[mbIdx];
+    *busyCnt = handle->mbBusyCnt[mbIdx];
+}
+
+/**
+  * @brief      Read the control and status word of a receive message buffer
+  * @note       The read locks the MB. While BUSY is set the move-in is still writing
+  *             the MB, the word is read again until it is deasserted. Busy and overrun
+  *             reads are counted in the handle.
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  mbIdx:  Message buffer index
+  * @retval     Control and status word
+  */
+static uint32_t FLEXCAN_ReadMbCs(uint8_t instance, uint8_t mbIdx)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    flexcan_handle_t *handle = g_flexcanHandle[instance];
+    uint32_t cs = base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U];
+    uint32_t code = ((cs & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT);
+
+    if ((code & (uint32_t)FLEXCAN_RX_BUSY) != 0U)
+    {
+        handle->mbBusyCnt[mbIdx]++;
+        while ((code & (uint32_t)FLEXCAN_RX_BUSY) != 0U)
+        {
+            cs = base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U];
+            code = ((cs & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT);
+        }
+    }
+    else {}
+
+    if (code == (uint32_t)FLEXCAN_RX_OVERRUN)
+    {
+        handle->mbOverrunCnt[mbIdx]++;
+    }
+    else {}
+
+    return cs;
+}
+
+/**
+  * @brief      Read the free running timer, it counts one tick per CAN bit time
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @retval     Current 16-bit timer value
+  * @note       Reading the timer also unlocks any locked message buffer
+  */
+uint16_t DRV_FLEXCAN_GetTimer(uint8_t instance)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    return (uint16_t)((base->TIMER & FLEXCAN_TIMER_TIMER_MASK) >> FLEXCAN_TIMER_TIMER_SHIFT);
 }
 
 /**
@@ -700,21 +958,26 @@ void DRV_FLEXCAN_ConfigTxMb(uint8_t instance, uint8_t mbIdx, flexcan_mb_config_t
     /* Config data length */
     base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] & ~(FLEXCAN_MB_DLC_MASK)) | FLEXCAN_MB_DLC(tx_mb->dataLength);
     /* Config ID */
-    if (tx_mb->idType == FLEXCAN_MB_ID_STD)
-    {
-        base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 1U] = ((uint32_t)((uint32_t)(mb_id << FLEXCAN_MB_ID_STD_SHIFT)) & (FLEXCAN_MB_ID_STD_MASK));
-    }
-    else if (tx_mb->idType == FLEXCAN_MB_ID_EXT)
-    {
-        base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 1U] = ((uint32_t)((uint32_t)(mb_id << FLEXCAN_MB_ID_EXT_SHIFT)) & (FLEXCAN_MB_ID_EXT_MASK));
-    }
-    else
-    {
-    }
+    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 1U] = FLEXCAN_EncodeId(tx_mb->idType, mb_id);
     /* Write EMPTY code to active mailbox */
     base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] & ~(FLEXCAN_MB_CODE_MASK)) | FLEXCAN_MB_CODE(FLEXCAN_TX_INACTIVE);
 }
 
+/**
+  * @brief      Set the local priority of a Transmit Message Buffer
+  * @note       Used when the module is initialized with localPriority = 1. The MB must not hold a
+  *             pending frame. DRV_FLEXCAN_ConfigTxMb() resets the priority to 0.
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  mbIdx: Message buffer index
+  * @param[in]  priority: 0 (arbitrated first) .. FLEXCAN_MB_PRIO_MAX
+  * @retval     None
+  */
+void DRV_FLEXCAN_SetTxMbPriority(uint8_t instance, uint8_t mbIdx, uint8_t priority)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 1U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 1U] & ~(FLEXCAN_MB_PRIO_MASK)) | FLEXCAN_MB_PRIO(priority);
+}
+
 /**
   * @brief      Transmit a CAN message
   * @param[in]  instance: Identifies which FlexCAN module
@@ -730,8 +993,157 @@ void DRV_FLEXCAN_Transmit(uint8_t instance, uint8_t mbIdx, flexcan_mb_t *data)
     /*Prepare content of the mail box*/
     base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 2U] = data->data[0];
     base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 3U] = data->data[1];
-    /* Write TX_DATA code to transmit */
-    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] & ~(FLEXCAN_MB_CODE_MASK)) | FLEXCAN_MB_CODE(FLEXCAN_TX_DATA);
+    /* Write data length and TX_DATA code to transmit */
+    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] & ~(FLEXCAN_MB_CODE_MASK | FLEXCAN_MB_DLC_MASK)) | FLEXCAN_MB_DLC(data->dataLength) | FLEXCAN_MB_CODE(FLEXCAN_TX_DATA);
+}
+
+/**
+  * @brief      Transmit a CAN message with the ID carried by the message instead of the configured one
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  mbIdx: Mailbox index
+  * @param[in]  data: Pointer to message structure to transmit, msgId and idType are used
+  * @retval     None
+  */
+void DRV_FLEXCAN_TransmitId(uint8_t instance, uint8_t mbIdx, flexcan_mb_t *data)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    uint32_t ide = (data->idType == FLEXCAN_MB_ID_EXT) ? FLEXCAN_MB_IDE_MASK : 0U;
+    /*Clear flag*/
+    DRV_FLEXCAN_ClearMbIntFlag(instance, mbIdx);
+    /*Prepare content of the mail box, the local priority is kept*/
+    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 1U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 1U] & FLEXCAN_MB_PRIO_MASK) | FLEXCAN_EncodeId(data->idType, data->msgId);
+    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 2U] = data->data[0];
+    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 3U] = data->data[1];
+    /* Write IDE, data length and TX_DATA code to transmit */
+    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] & ~(FLEXCAN_MB_CODE_MASK | FLEXCAN_MB_DLC_MASK | FLEXCAN_MB_IDE_MASK)) | ide | FLEXCAN_MB_DLC(data->dataLength) | FLEXCAN_MB_CODE(FLEXCAN_TX_DATA);
+}
+
+/**
+  * @brief      Configure a message buffer that answers remote request frames in hardware
+  * @note       A remote frame with the MB ID is answered with a data frame carrying data,
+  *             without interrupt nor CPU work. Needs CTRL2[RRS] = 0 (reset value).
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  mbIdx: Message buffer index
+  * @param[in]  tx_mb: Pointer to message buffer configuration structure
+  * @param[in]  mb_id: ID of the remote request and of the answer
+  * @param[in]  data: Pointer to the answer, data and dataLength are used
+  * @retval     None
+  */
+void DRV_FLEXCAN_ConfigRemoteAnswerMb(uint8_t instance, uint8_t mbIdx, flexcan_mb_config_t *tx_mb, uint32_t mb_id, const flexcan_mb_t *data)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    uint32_t ide = (tx_mb->idType == FLEXCAN_MB_ID_EXT) ? FLEXCAN_MB_IDE_MASK : 0U;
+    DRV_FLEXCAN_ClearMbIntFlag(instance, mbIdx);
+    /* Deactivate the MB while its content is updated */
+    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = FLEXCAN_MB_CODE(FLEXCAN_TX_INACTIVE);
+    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 1U] = FLEXCAN_EncodeId(tx_mb->idType, mb_id);
+    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 2U] = data->data[0];
+    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 3U] = data->data[1];
+    /* Write RANSWER code to arm the automatic answer */
+    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = ide | FLEXCAN_MB_DLC(data->dataLength) | FLEXCAN_MB_CODE(FLEXCAN_RX_RANSWER);
+}
+
+/**
+  * @brief      Transmit a remote request frame with the ID configured in the message buffer
+  * @note       Once sent, the MB turns into an empty receive MB with the same ID and
+  *             catches the answer like any received frame.
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  mbIdx: Message buffer index
+  * @param[in]  dataLength: Data length requested from the answering node
+  * @retval     None
+  */
+void DRV_FLEXCAN_TransmitRemote(uint8_t instance, uint8_t mbIdx, uint32_t dataLength)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    /*Clear flag*/
+    DRV_FLEXCAN_ClearMbIntFlag(instance, mbIdx);
+    /* Write RTR, data length and TX_DATA code to transmit, IDE and ID are kept */
+    base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] & ~(FLEXCAN_MB_CODE_MASK | FLEXCAN_MB_DLC_MASK | FLEXCAN_MB_TIME_STAMP_MASK)) | FLEXCAN_MB_RTR_MASK | FLEXCAN_MB_DLC(dataLength) | FLEXCAN_MB_CODE(FLEXCAN_TX_DATA);
+}
+
+/**
+  * @brief      Check whether a transmit message buffer still holds a frame waiting for the bus
+  * @note       A frame whose abort is requested but not done yet is still pending
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  mbIdx: Mailbox index
+  * @retval     1 if a transmission is pending, 0 otherwise
+  */
+uint8_t DRV_FLEXCAN_IsTxMbPending(uint8_t instance, uint8_t mbIdx)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    uint32_t code = ((base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT);
+    uint8_t pending = 0U;
+    if (code == (uint32_t)FLEXCAN_TX_DATA)
+    {
+        pending = 1U;
+    }
+    else if ((code == (uint32_t)FLEXCAN_TX_ABORT) && ((base->IFLAG1 & (1U << (uint32_t)mbIdx)) == 0U))
+    {
+        pending = 1U;
+    }
+    else {}
+    return pending;
+}
+
+/**
+  * @brief      Withdraw the frame pending in a transmit message buffer (MCR[AEN] = 1)
+  * @note       The first call requests the abort and returns at once. A frame in transmission
+  *             completes first, a controller in bus-off or freeze holds the MB: the call
+  *             returns FLEXCAN_ABORT_PENDING and is repeated until the MB is free.
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  mbIdx: Mailbox index
+  * @retval     It can be a value of flexcan_abort_status_t
+  */
+flexcan_abort_status_t DRV_FLEXCAN_AbortTxMb(uint8_t instance, uint8_t mbIdx)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    uint32_t flag = 1U << (uint32_t)mbIdx;
+    uint32_t code = ((base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT);
+    flexcan_abort_status_t status = FLEXCAN_ABORT_IDLE;
+
+    if (code == (uint32_t)FLEXCAN_TX_DATA)
+    {
+        DRV_FLEXCAN_ClearMbIntFlag(instance, mbIdx);
+        base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] & ~(FLEXCAN_MB_CODE_MASK)) | FLEXCAN_MB_CODE(FLEXCAN_TX_ABORT);
+        code = (uint32_t)FLEXCAN_TX_ABORT;
+    }
+    else {}
+
+    /* The flag is set once the MB is aborted (CODE stays ABORT) or its transmission is done (CODE is INACTIVE).
+     * Until then CODE reads back the ABORT written above. */
+    if ((base->IFLAG1 & flag) == 0U)
+    {
+        status = (code == (uint32_t)FLEXCAN_TX_ABORT) ? FLEXCAN_ABORT_PENDING : FLEXCAN_ABORT_IDLE;
+    }
+    else
+    {
+        code = ((base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] & FLEXCAN_MB_CODE_MASK) >> FLEXCAN_MB_CODE_SHIFT);
+        if (code == (uint32_t)FLEXCAN_TX_ABORT)
+        {
+            /* Leave the MB inactive, an ABORT code without flag would read as pending */
+            base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] = (base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] & ~(FLEXCAN_MB_CODE_MASK)) | FLEXCAN_MB_CODE(FLEXCAN_TX_INACTIVE);
+            status = FLEXCAN_ABORT_DONE;
+        }
+        else
+        {
+            status = FLEXCAN_ABORT_SENT;
+        }
+        DRV_FLEXCAN_ClearMbIntFlag(instance, mbIdx);
+    }
+
+    return status;
+}
+
+/**
+  * @brief      Read the time stamp of a message buffer, captured at the last transmission or reception
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  mbIdx: Mailbox index
+  * @retval     Free running timer value (CAN bit times)
+  */
+uint16_t DRV_FLEXCAN_GetMbTimeStamp(uint8_t instance, uint8_t mbIdx)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    return (uint16_t)((base->RAMn[mbIdx * MESSAGE_BUFFER_SIZE + 0U] & FLEXCAN_MB_TIME_STAMP_MASK) >> FLEXCAN_MB_TIME_STAMP_SHIFT);
 }
 
 /*BUSOFF*/
@@ -750,18 +1162,55 @@ static void FLEXCAN_ClearBusOffIntFlag(uint8_t instance)
 }
 
 /**
-  * @brief      Bus-Off Interrupt Handler
+  * @brief      Bus-Off Interrupt Handler, also serves TX/RX warning and bus-off done interrupts
   * @param[in]  instance: Identifies which FlexCAN module
   * @retval     None
   */
 static void FLEXCAN_BusOff_IRQHandler(uint8_t instance)
 {
+    FLEXCAN_Type *base = g_flexcanBase[instance];
     flexcan_handle_t *handle = g_flexcanHandle[instance];
-    if (handle->bus_off_callback != NULL)
+    uint32_t status = base->ESR1 & (FLEXCAN_ESR1_TWRNINT_MASK | FLEXCAN_ESR1_RWRNINT_MASK | FLEXCAN_ESR1_BOFFDONEINT_MASK);
+    if (((base->ESR1 & FLEXCAN_ESR1_BOFFINT_MASK) != 0U) && (handle->bus_off_callback != NULL))
     {
         handle->bus_off_callback();
     }
     FLEXCAN_ClearBusOffIntFlag(instance);
+    if (status != 0U)
+    {
+        /* Block the next automatic recovery again once the manual one is completed */
+        if (((status & FLEXCAN_ESR1_BOFFDONEINT_MASK) != 0U) && (handle->busOffRecovery == FLEXCAN_BUSOFF_RECOVERY_MANUAL))
+        {
+            base->CTRL1 = (base->CTRL1) | (FLEXCAN_CTRL1_BOFFREC_MASK);
+        }
+        /* Clear the handled flags (write 1 to clear) */
+        base->ESR1 = status;
+        if (handle->error_state_callback != NULL)
+        {
+            handle->error_state_callback();
+        }
+    }
+}
+
+/**
+  * @brief      Bus error interrupt: masked again after one error, the error state callback reads the new state
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @retval     None
+  */
+static void FLEXCAN_Error_IRQHandler(uint8_t instance)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    flexcan_handle_t *handle = g_flexcanHandle[instance];
+    if ((base->ESR1 & FLEXCAN_ESR1_ERRINT_MASK) != 0U)
+    {
+        /* One shot: every erroneous frame sets ERRINT again */
+        base->CTRL1 = (base->CTRL1) & ~(FLEXCAN_CTRL1_ERRMSK_MASK);
+        base->ESR1 = FLEXCAN_ESR1_ERRINT_MASK;
+        if (handle->error_state_callback != NULL)
+        {
+            handle->error_state_callback();
+        }
+    }
 }
 
 /* REGISTER CALL BACK FUNCTION */
@@ -808,6 +1257,142 @@ void DRV_FLEXCAN_RegisterBusOffCallback(uint8_t instance, void (*cb_ptr)(void))
     }
 }
 
+/**
+  * @brief      Register Error State Callback Function, called on TX/RX warning and bus-off recovery done
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  cb_ptr: Pointer to callback function
+  * @retval     None
+  */
+void DRV_FLEXCAN_RegisterErrorStateCallback(uint8_t instance, void (*cb_ptr)(void))
+{
+    flexcan_freeze_mode_status_t freeze = FLEXCAN_GetFreezeMode(instance);
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    flexcan_handle_t *handle = g_flexcanHandle[instance];
+    handle->error_state_callback = cb_ptr;
+    if (freeze == FLEXCAN_OUT_FREEZE_MODE)
+    {
+        FLEXCAN_EnterFreezeMode(instance);
+    }
+    /* enable warning and bus-off done interrupts if the callback function exists */
+    if (cb_ptr != NULL)
+    {
+        base->MCR = (base->MCR & ~(FLEXCAN_MCR_WRNEN_MASK)) | FLEXCAN_MCR_WRNEN(1U);
+        base->CTRL1 = (base->CTRL1) | (FLEXCAN_CTRL1_TWRNMSK_MASK | FLEXCAN_CTRL1_RWRNMSK_MASK);
+        base->CTRL2 = (base->CTRL2) | (FLEXCAN_CTRL2_BOFFDONEMSK_MASK);
+    }
+    else
+    {
+        base->CTRL1 = (base->CTRL1) & ~(FLEXCAN_CTRL1_TWRNMSK_MASK | FLEXCAN_CTRL1_RWRNMSK_MASK);
+        base->CTRL2 = (base->CTRL2) & ~(FLEXCAN_CTRL2_BOFFDONEMSK_MASK);
+    }
+    if (freeze == FLEXCAN_OUT_FREEZE_MODE)
+    {
+        FLEXCAN_ExitFreezeMode(instance);
+    }
+}
+
+/**
+  * @brief      Arm the bus error interrupt (ESR1[ERRINT]) for one error, the error state callback
+  *             runs on the next bus error and the interrupt masks itself again
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @retval     None
+  */
+void DRV_FLEXCAN_EnableErrorInt(uint8_t instance)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    /* Drop the errors seen while masked, ERRMSK is writable outside freeze mode */
+    base->ESR1 = FLEXCAN_ESR1_ERRINT_MASK;
+    base->CTRL1 = (base->CTRL1) | (FLEXCAN_CTRL1_ERRMSK_MASK);
+}
+
+/* ERROR STATE */
+/**
+  * @brief      Get the fault confinement state of the module
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @retval     Error active, error passive or bus off
+  */
+flexcan_fault_state_t DRV_FLEXCAN_GetFaultState(uint8_t instance)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    uint32_t fltConf = ((base->ESR1 & FLEXCAN_ESR1_FLTCONF_MASK) >> FLEXCAN_ESR1_FLTCONF_SHIFT);
+    flexcan_fault_state_t retVal = FLEXCAN_ERROR_ACTIVE;
+    /* FLTCONF: 00 error active, 01 error passive, 1x bus off */
+    if (fltConf >= 2U)
+    {
+        retVal = FLEXCAN_BUS_OFF;
+    }
+    else if (fltConf == 1U)
+    {
+        retVal = FLEXCAN_ERROR_PASSIVE;
+    }
+    else
+    {
+    }
+    return retVal;
+}
+
+/**
+  * @brief      Get the transmit and receive error counters
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[out] txErrCnt: Transmit error counter
+  * @param[out] rxErrCnt: Receive error counter
+  * @retval     None
+  */
+void DRV_FLEXCAN_GetErrorCounters(uint8_t instance, uint8_t *txErrCnt, uint8_t *rxErrCnt)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    uint32_t ecr = base->ECR;
+    *txErrCnt = (uint8_t)((ecr & FLEXCAN_ECR_TXERRCNT_MASK) >> FLEXCAN_ECR_TXERRCNT_SHIFT);
+    *rxErrCnt = (uint8_t)((ecr & FLEXCAN_ECR_RXERRCNT_MASK) >> FLEXCAN_ECR_RXERRCNT_SHIFT);
+}
+
+/**
+  * @brief      Get and clear the receive error flags (stuff, form and CRC errors)
+  * @note       The flags are cleared by the read of ESR1, they collect the errors seen since the previous call.
+  *             In listen-only mode the error counters are frozen, these flags still report the errors.
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @retval     Flags set among FLEXCAN_ESR1_STFERR_MASK, FLEXCAN_ESR1_FRMERR_MASK and FLEXCAN_ESR1_CRCERR_MASK
+  */
+uint32_t DRV_FLEXCAN_GetRxErrorFlags(uint8_t instance)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    return base->ESR1 & (FLEXCAN_ESR1_STFERR_MASK | FLEXCAN_ESR1_FRMERR_MASK | FLEXCAN_ESR1_CRCERR_MASK);
+}
+
+/**
+  * @brief      Select how the module leaves the bus-off state
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @param[in]  mode: Automatic or manual recovery
+  * @retval     None
+  */
+void DRV_FLEXCAN_SetBusOffRecovery(uint8_t instance, flexcan_busoff_recovery_t mode)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    flexcan_handle_t *handle = g_flexcanHandle[instance];
+    handle->busOffRecovery = mode;
+    if (mode == FLEXCAN_BUSOFF_RECOVERY_MANUAL)
+    {
+        base->CTRL1 = (base->CTRL1 & ~(FLEXCAN_CTRL1_BOFFREC_MASK)) | FLEXCAN_CTRL1_BOFFREC(1U);
+    }
+    else
+    {
+        base->CTRL1 = (base->CTRL1 & ~(FLEXCAN_CTRL1_BOFFREC_MASK)) | FLEXCAN_CTRL1_BOFFREC(0U);
+    }
+}
+
+/**
+  * @brief      Start the bus-off recovery sequence when manual recovery is selected
+  * @note       Negating BOFFREC while in bus-off starts the recovery (128 x 11 recessive bits),
+  *             it is asserted again by the interrupt handler once recovery is done.
+  * @param[in]  instance: Identifies which FlexCAN module
+  * @retval     None
+  */
+void DRV_FLEXCAN_RecoverBusOff(uint8_t instance)
+{
+    FLEXCAN_Type *base = g_flexcanBase[instance];
+    base->CTRL1 = (base->CTRL1 & ~(FLEXCAN_CTRL1_BOFFREC_MASK)) | FLEXCAN_CTRL1_BOFFREC(0U);
+}
+
 /* REAL HANDLER */
 void CAN0_ORed_0_15_MB_IRQHandler(void)
 {
@@ -824,6 +1409,11 @@ void CAN0_ORed_IRQHandler(void)
     FLEXCAN_BusOff_IRQHandler(0U);
 }
 
+void CAN0_Error_IRQHandler(void)
+{
+    FLEXCAN_Error_IRQHandler(0U);
+}
+
 void CAN1_ORed_0_15_MB_IRQHandler(void)
 {
     FLEXCAN_Mb_IRQHandler(1U);
@@ -834,6 +1424,11 @@ void CAN1_ORed_IRQHandler(void)
     FLEXCAN_BusOff_IRQHandler(1U);
 }
 
+void CAN1_Error_IRQHandler(void)
+{
+    FLEXCAN_Error_IRQHandler(1U);
+}
+
 void CAN2_ORed_0_15_MB_IRQHandler(void)
 {
     FLEXCAN_Mb_IRQHandler(2U);
@@ -843,3 +1438,8 @@ void CAN2_ORed_IRQHandler(void)
 {
     FLEXCAN_BusOff_IRQHandler(2U);
 }
+
+void CAN2_Error_IRQHandler(void)
+{
+    FLEXCAN_Error_IRQHandler(2U);
+}
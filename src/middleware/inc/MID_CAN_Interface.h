@@ -9,31 +9,174 @@
  * Definition
  ******************************************************************************/
 
-#define FLEXCAN_INSTANCE        0u
+/** @defgroup CAN bus
+  * @brief  One bus per FlexCAN module, the bus index is the FlexCAN instance.
+  * @{
+  */
+#define CAN_BUS_0               0u  /* FLEXCAN0, TX PTE5 / RX PTE4, 32 mailboxes */
+#define CAN_BUS_1               1u  /* FLEXCAN1, TX PTA13 / RX PTA12, 16 mailboxes */
+#define CAN_BUS_2               2u  /* FLEXCAN2, TX PTC17 / RX PTC16, 16 mailboxes */
+#define CAN_BUS_COUNT           3u
+
+/* Bus the sensor nodes are connected to, served by the single bus API below */
+#define CAN_SENSOR_BUS          CAN_BUS_0
+#define FLEXCAN_INSTANCE        CAN_SENSOR_BUS
+
+/** @defgroup Auto-baud
+  * @brief  At startup every bus listens (listen-only, nothing is sent) at each candidate bitrate
+  *         until a frame is received without receive errors, then enters normal mode at that rate.
+  *         The locked rate is kept in the .noinit section, which the startup code clears on
+  *         power-on and low-voltage resets only, and tried first after any other reset.
+  *         A silent bus keeps the cached rate, or the configured one.
+  * @{
+  */
+#define CAN_AUTOBAUD_ENABLE         1u          /* 0: use the configured bitrate of every bus */
+#define CAN_AUTOBAUD_WINDOW_BITS    10000u      /* Listening time per candidate (10 ms at 1 Mbit/s, 80 ms at 125 kbit/s) */
+#define CAN_AUTOBAUD_PROBE_STD_MB   0u          /* Accept-all mailboxes used while listening */
+#define CAN_AUTOBAUD_PROBE_EXT_MB   1u
+
+/** @defgroup CAN gateway
+  * @brief  Frames matching a route are forwarded from the interrupt of the source bus,
+  *         with the same ID or remapped to a new one. Routed mailboxes are not seen by
+  *         the receive callbacks.
+  * @{
+  */
+#define CAN_GATEWAY_ENABLE      0u              /* 1: bring up CAN_BUS_1/CAN_BUS_2 and the routing table */
+#define CAN_GATEWAY_KEEP_ID     0xFFFFFFFFu     /* Destination ID of a route forwarding the source ID */
+
+/* Routes of the routing table */
+#define CAN_GW_SEG1_DIAG_ID         0x700u      /* Diagnostic range 0x700..0x70F of bus 1 */
+#define CAN_GW_SEG1_DIAG_MASK       0x7F0u
+#define CAN_GW_SEG1_DIAG_RX_MB      0u          /* on CAN_BUS_1 */
+#define CAN_GW_SEG1_DIAG_TX_MB      8u          /* on CAN_BUS_2 */
+
+#define CAN_GW_SEG2_CMD_ID          0x710u      /* Command of bus 2 ... */
+#define CAN_GW_SEG2_CMD_REMAP_ID    0x711u      /* ... seen on bus 1 under this ID */
+#define CAN_GW_SEG2_CMD_RX_MB       0u          /* on CAN_BUS_2 */
+#define CAN_GW_SEG2_CMD_TX_MB       8u          /* on CAN_BUS_1 */
+
+/* One route of the gateway */
+typedef struct
+{
+    uint8_t  SrcBus;    /* Bus the frame is received on, it can be a value of @defgroup CAN bus */
+    uint8_t  SrcMb;     /* Receive mailbox owned by the route on the source bus */
+    uint32_t SrcId;     /* Accepted ID */
+    uint32_t SrcMask;   /* ID bits compared (1) or ignored (0) */
+    uint8_t  DstBus;    /* Bus the frame is sent on, it can be a value of @defgroup CAN bus */
+    uint8_t  DstMb;     /* Transmit mailbox owned by the route on the destination bus */
+    uint32_t DstId;     /* New ID, or CAN_GATEWAY_KEEP_ID */
+} CAN_Route_t;
+
+/** @defgroup CAN identifier format
+  * @{
+  */
+#define CAN_ID_STANDARD         0u  /* 11-bit identifiers, the message type is the whole ID */
+#define CAN_ID_EXTENDED         1u  /* 29-bit identifiers, node address and message type are packed in the ID */
+
+/* Identifier format used on the bus, it can be a value of @defgroup CAN identifier format */
+#ifndef CAN_ID_FORMAT
+#define CAN_ID_FORMAT           CAN_ID_STANDARD
+#endif
 
-/** @defgroup Initialize Connection Message ID
+/** @defgroup Extended identifier layout
+  * @brief  | 28..16: reserved (0) | 15..12: node class | 11..8: node instance | 7..0: message type |
+  *         Clearing the instance bits of a mask lets one filter accept a whole node class.
+  * @{
+  */
+#define CAN_EXT_MSG_TYPE_SHIFT      0u
+#define CAN_EXT_MSG_TYPE_MASK       0x000000FFu
+#define CAN_EXT_NODE_INST_SHIFT     8u
+#define CAN_EXT_NODE_INST_MASK      0x00000F00u
+#define CAN_EXT_NODE_CLASS_SHIFT    12u
+#define CAN_EXT_NODE_CLASS_MASK     0x0000F000u
+
+#define CAN_EXT_ID(nodeClass, nodeInst, msgType)                                    \
+    ((((uint32_t)(nodeClass) << CAN_EXT_NODE_CLASS_SHIFT) & CAN_EXT_NODE_CLASS_MASK) | \
+     (((uint32_t)(nodeInst)  << CAN_EXT_NODE_INST_SHIFT)  & CAN_EXT_NODE_INST_MASK)  | \
+     (((uint32_t)(msgType)   << CAN_EXT_MSG_TYPE_SHIFT)   & CAN_EXT_MSG_TYPE_MASK))
+
+#define CAN_EXT_GET_MSG_TYPE(id)    (((uint32_t)(id) & CAN_EXT_MSG_TYPE_MASK) >> CAN_EXT_MSG_TYPE_SHIFT)
+#define CAN_EXT_GET_NODE_CLASS(id)  (((uint32_t)(id) & CAN_EXT_NODE_CLASS_MASK) >> CAN_EXT_NODE_CLASS_SHIFT)
+#define CAN_EXT_GET_NODE_INST(id)   (((uint32_t)(id) & CAN_EXT_NODE_INST_MASK) >> CAN_EXT_NODE_INST_SHIFT)
+
+/* Mask accepting every message type of every instance of one node class */
+#define CAN_EXT_NODE_CLASS_FILTER   (CAN_EXT_NODE_CLASS_MASK)
+
+/** @defgroup Node addressing
+  * @brief  A node is a class and an instance. In extended format both are packed in the ID, the
+  *         instances of a class share its message types and differ by CAN_NODE_INST_STEP. In
+  *         standard format the ID is the message type alone, one node per class.
   * @{
   */
-#define TX_RQ_CONNECT_DISTANCE_NODE_ID    0xE0
-#define TX_RQ_CONNECT_ROTATION_NODE_ID    0xF0
+#define CAN_NODE_CLASS_DISTANCE     0x1u
+#define CAN_NODE_CLASS_ROTATION     0x2u
+#define CAN_NODE_CLASS_FORWARDER    0x3u
+#define CAN_NODE_INST_DEFAULT       0x1u    /* Instance of the first node of a class */
+#define CAN_NODE_INST_MAX           (CAN_EXT_NODE_INST_MASK >> CAN_EXT_NODE_INST_SHIFT)
+
+#if (CAN_ID_FORMAT == CAN_ID_EXTENDED)
+#define CAN_NODE_ID(nodeClass, nodeInst, msgType)   CAN_EXT_ID((nodeClass), (nodeInst), (msgType))
+#define CAN_NODE_INST_STEP          (1u << CAN_EXT_NODE_INST_SHIFT)
+#define CAN_NODE_GROUP_MASK         (CAN_EXT_NODE_CLASS_MASK | CAN_EXT_MSG_TYPE_MASK)
+#else
+#define CAN_NODE_ID(nodeClass, nodeInst, msgType)   ((uint32_t)(msgType))
+#define CAN_NODE_INST_STEP          0u
+#define CAN_NODE_GROUP_MASK         IMASK_FILTER_ALL_ID
+#endif
+
+/* ID of a message of the default instance of a class */
+#define CAN_MSG_ID(nodeClass, msgType)  CAN_NODE_ID((nodeClass), CAN_NODE_INST_DEFAULT, (msgType))
+
+/** @defgroup Initialize Connection Message type
+  * @brief  Message types of the sensor nodes, CAN_NODE_ID() gives the ID of one node
+  * @{
+  */
+#define TX_RQ_CONNECT_DISTANCE_NODE_TYPE    0xE0u
+#define TX_RQ_CONNECT_ROTATION_NODE_TYPE    0xF0u
 
-#define RX_CONFIRM_FROM_DISTANCE_NODE_ID  0xE1
-#define RX_CONFIRM_FROM_ROTATION_NODE_ID  0xF1
+#define RX_CONFIRM_FROM_DISTANCE_NODE_TYPE  0xE1u
+#define RX_CONFIRM_FROM_ROTATION_NODE_TYPE  0xF1u
 
-#define TX_STOPOPR_DISTANCE_NODE_ID       0x30
-#define TX_STOPOPR_ROTATION_NODE_ID       0x40
+#define TX_STOPOPR_DISTANCE_NODE_TYPE       0x30u
+#define TX_STOPOPR_ROTATION_NODE_TYPE       0x40u
 
-#define RX_CONFIRM_STOPOPR_DNODE_ID       0x31
-#define RX_CONFIRM_STOPOPR_RNODE_ID       0x41
+#define RX_CONFIRM_STOPOPR_DNODE_TYPE       0x31u
+#define RX_CONFIRM_STOPOPR_RNODE_TYPE       0x41u
 
-/** @defgroup Ping Message ID
+/** @defgroup Ping Message type
   * @{
   */
-#define TX_PING_DISTANCE_NODE_ID          0x50
-#define TX_PING_ROTATION_NODE_ID          0x60
+#define TX_PING_DISTANCE_NODE_TYPE          0x50u
+#define TX_PING_ROTATION_NODE_TYPE          0x60u
+
+#define RX_CONFIRM_PING_DISTANCE_NODE_TYPE  0x51u
+#define RX_CONFIRM_PING_ROTATION_NODE_TYPE  0x61u
+
+/** @defgroup Ping mode
+  * @brief  CAN_PING_SOFTWARE: the forwarder sends TX_PING_*_TYPE, the sensor software replies with
+  *         RX_CONFIRM_PING_*_TYPE.
+  *         CAN_PING_REMOTE: the forwarder sends a remote request frame (RTR = 1, DLC =
+  *         CAN_PING_ANSWER_LENGTH) with the RX_CONFIRM_PING_*_TYPE ID of the node from
+  *         RX_CONFIRM_PING_*_MB. The sensor keeps a mailbox in RANSWER state on the same ID, its
+  *         controller answers in hardware with a data frame: same ID, DLC CAN_PING_ANSWER_LENGTH,
+  *         the current sensor value in bytes 2..3 (legacy single-value layout). The sensor software
+  *         only refreshes the answer data when its value changes. The answer lands in
+  *         RX_CONFIRM_PING_*_MB and is handled as the software reply. The mailbox is shared by the
+  *         nodes of a class, one remote request of the class is in flight at a time.
+  *         In both modes the forwarder answers remote requests with ID CAN_FW_LIVENESS_ID from
+  *         CAN_FW_LIVENESS_MB: DLC CAN_FW_LIVENESS_LENGTH, bytes 0..1 CAN_FW_LIVENESS_VERSION,
+  *         bytes 2..3 reserved (0).
+  * @{
+  */
+#define CAN_PING_SOFTWARE           0u
+#define CAN_PING_REMOTE             1u
+#define CAN_PING_MODE               CAN_PING_SOFTWARE
+
+#define CAN_PING_ANSWER_LENGTH      CAN_LEGACY_DATA_LENGTH
 
-#define RX_CONFIRM_PING_DISTANCE_NODE_ID  0x51
-#define RX_CONFIRM_PING_ROTATION_NODE_ID  0x61
+#define CAN_FW_LIVENESS_ID          CAN_MSG_ID(CAN_NODE_CLASS_FORWARDER, 0x70)
+#define CAN_FW_LIVENESS_LENGTH      4u
+#define CAN_FW_LIVENESS_VERSION     0x0001u
 
 /** @defgroup Check Connection Message Data
   * @{
@@ -41,47 +184,119 @@
 #define TX_MSG_REQUEST_DATA    0x10
 #define TX_MSG_CONFIRM_DATA    0xFF
 
-/** @defgroup Data Message
+/** @defgroup Data Message type
   * @{
   */
-#define RX_DISTANCE_DATA_ID  0x20
-#define RX_ROTATION_DATA_ID  0x10
+#define RX_DISTANCE_DATA_TYPE           0x20u
+#define RX_ROTATION_DATA_TYPE           0x10u
 
-#define TX_CONFIRM_ROTATION_DATA_ID  0x11
-#define TX_CONFIRM_DISTANCE_DATA_ID  0x21
+#define TX_CONFIRM_ROTATION_DATA_TYPE   0x11u
+#define TX_CONFIRM_DISTANCE_DATA_TYPE   0x21u
 
 #define TX_STOPOPR_DATA   0x10
 #define TX_WAKEUP_DATA    0xFF
 
-/** @defgroup Allocate Tx mailboxs
+/** @defgroup Mailboxes of the sensor bus
+  * @brief  Logical mailboxes used by the single bus API. The message buffer behind each one is
+  *         allocated by MID_CAN_MailboxConfigure() from a descriptor table: the position of
+  *         the descriptor in the table is the message buffer number. Reordering the table
+  *         tunes the layout, e.g. for the transmit arbitration between buffers holding the
+  *         same ID or for the order in which receive buffers are matched.
+  *         The mailboxes of a node class serve all of its nodes: the receive ones accept the
+  *         message type of every instance (CAN_NODE_GROUP_MASK), the transmit ones send with
+  *         the ID of the addressed node, refer to MID_CAN_SendCANMessageToId().
   * @{
   */
-#define TX_CONFIRM_DISTANCE_DATA_MB      0u
-#define TX_CONFIRM_ROTATION_DATA_MB      1u
-
-#define TX_RQ_CONNECT_DISTANCE_NODE_MB   2u
-#define TX_RQ_CONNECT_ROTATION_NODE_MB   3u
-
-#define TX_STOPOPR_DISTANCE_NODE_MB      4u
-#define TX_STOPOPR_ROTATION_NODE_MB      5u
-
-#define TX_PING_DISTANCE_NODE_MB         6u
-#define TX_PING_ROTATION_NODE_MB         7u
-
-/** @defgroup Allocate Rx mailboxs
+typedef enum
+{
+    /* Transmit */
+    TX_CONFIRM_DISTANCE_DATA_MB = 0u,
+    TX_CONFIRM_ROTATION_DATA_MB,
+    TX_RQ_CONNECT_DISTANCE_NODE_MB,
+    TX_RQ_CONNECT_ROTATION_NODE_MB,
+    TX_STOPOPR_DISTANCE_NODE_MB,
+    TX_STOPOPR_ROTATION_NODE_MB,
+    TX_PING_DISTANCE_NODE_MB,
+    TX_PING_ROTATION_NODE_MB,
+    SELFTEST_DISTANCE_TX_MB,            /* Synthetic distance frames of the loopback self-test */
+    SELFTEST_ROTATION_TX_MB,            /* Synthetic rotation frames of the loopback self-test */
+
+    /* Receive */
+    RX_CONFIRM_STOPOPR_DNODE_MB,        /* Not in the default table, the application does not wait for it */
+    RX_CONFIRM_STOPOPR_RNODE_MB,        /* Not in the default table, the application does not wait for it */
+    RX_DISTANCE_DATA_MB,
+    RX_ROTATION_DATA_MB,
+    RX_CONFIRM_FROM_DISTANCE_NODE_MB,
+    RX_CONFIRM_FROM_ROTATION_NODE_MB,
+    RX_CONFIRM_PING_DISTANCE_NODE_MB,
+    RX_CONFIRM_PING_ROTATION_NODE_MB,
+
+    /* Remote answer */
+    CAN_FW_LIVENESS_MB,
+
+    CAN_MB_NUM
+} CAN_Mailbox_t;
+
+#define CAN_MAILBOX_COUNT       32u     /* Message buffers of the sensor bus (FlexCAN0) */
+#define CAN_MB_NONE             0xFFu   /* Logical mailbox without message buffer */
+
+/** @defgroup Mailbox type
   * @{
   */
-#define RX_CONFIRM_STOPOPR_DNODE_MB         8u
-#define RX_CONFIRM_STOPOPR_RNODE_MB         9u
+#define CAN_MB_TYPE_TX              0u  /* Transmit, Id is the ID of the sent frames */
+#define CAN_MB_TYPE_RX              1u  /* Receive with interrupt, accepts Id on the bits set in Mask */
+#define CAN_MB_TYPE_REMOTE_ANSWER   2u  /* Answers remote requests for Id with Payload, refer to @defgroup Ping mode */
 
-#define RX_DISTANCE_DATA_MB                 10u
-#define RX_ROTATION_DATA_MB                 11u
+/** @defgroup Local transmit priority
+  * @brief  Order in which pending transmit mailboxes of the sensor bus compete for the bus,
+  *         lower first, then lower ID. It is local to the forwarder and not sent on the bus.
+  * @{
+  */
+#define CAN_TX_PRIO_COMMAND         0u  /* Ping, stop and connection requests */
+#define CAN_TX_PRIO_CONFIRM         3u  /* Data confirmations */
+#define CAN_TX_PRIO_BACKGROUND      7u  /* Self-test traffic, lowest */
 
-#define RX_CONFIRM_FROM_DISTANCE_NODE_MB    12u
-#define RX_CONFIRM_FROM_ROTATION_NODE_MB    13u
+/* Descriptor of one message buffer */
+typedef struct
+{
+    uint8_t        Mailbox;     /* Logical mailbox, it can be a value of @defgroup Mailboxes of the sensor bus */
+    uint8_t        Type;        /* it can be a value of @defgroup Mailbox type */
+    uint32_t       Id;          /* Transmitted, accepted or answered ID */
+    uint32_t       Mask;        /* CAN_MB_TYPE_RX: ID bits compared (1) or ignored (0) */
+    const uint8_t *Payload;     /* CAN_MB_TYPE_REMOTE_ANSWER: answer data */
+    uint8_t        Length;      /* CAN_MB_TYPE_REMOTE_ANSWER: answer length */
+    uint8_t        Priority;    /* CAN_MB_TYPE_TX: it can be a value of @defgroup Local transmit priority */
+} CAN_MailboxDesc_t;
+
+/** @defgroup Transmit deadline
+  * @brief  A frame of the sensor bus sent with a deadline is aborted by MID_CAN_ProcessTxDeadlines()
+  *         once it is still pending DeadlineUs after the request. The deadlines are checked when a
+  *         transmit mailbox completes (NOTIFY_EVENT_CAN_TX), at the alarm set to the earliest one
+  *         (NOTIFY_EVENT_ALARM) and every TIMER_TICK_MS, never by polling. A frame still pending when a
+  *         newer one with the same ID is sent from the same mailbox is aborted and replaced by the
+  *         newer payload, the bus only carries current data. An abort the controller cannot grant
+  *         at once (frame on the bus, bus-off, freeze) completes on a later pass, a newer frame
+  *         meanwhile is dropped and counted in BlockedCnt.
+  *         A frame for another ID of a busy mailbox, e.g. another node of the class, waits in the
+  *         transmit queue and is handed to the mailbox once it is free, in request order. A queued
+  *         frame replaces the queued one of the same mailbox and ID, it expires in the queue as in
+  *         the mailbox. A full queue drops the frame and counts it in BlockedCnt.
+  * @{
+  */
+#define CAN_TX_DEADLINE_NONE        0u          /* The frame never expires */
+#define CAN_TX_CONFIRM_DEADLINE_US  10000u      /* Data confirmations are obsolete after 10 ms */
+#define CAN_TX_QUEUE_SIZE           32u         /* Frames waiting for a busy mailbox, two per node of TIMEOUT_NODE_MAX */
 
-#define RX_CONFIRM_PING_DISTANCE_NODE_MB    14u
-#define RX_CONFIRM_PING_ROTATION_NODE_MB    15u
+/* Transmit counters of the sensor bus, counted since initialization */
+typedef struct
+{
+    uint32_t SentCnt;       /* Frames transmitted */
+    uint32_t ExpiredCnt;    /* Frames aborted at their deadline */
+    uint32_t ReplacedCnt;   /* Pending frames aborted for a newer payload */
+    uint32_t BlockedCnt;    /* Frames dropped, their mailbox was still held by a frame being aborted or the queue was full */
+    uint32_t LatencyAvgUs;  /* Average time from request to transmission (us) */
+    uint32_t LatencyMaxUs;  /* Worst time from request to transmission (us) */
+} CAN_TxStats_t;
 
 /** @defgroup New comming message state
   * @{
@@ -95,11 +310,77 @@
 #define GMASK_FILTER_ALL_ID     0x1FFFFFFF
 #define IMASK_FILTER_ALL_ID     0xFFFFFFFF
 
+/** @defgroup Acceptance filter
+  * @brief  A receive mailbox accepts a frame when the frame ID equals Id on every bit set in Mask,
+  *         bits cleared in Mask are don't care. A whole node class is one filter, refer to
+  *         CAN_EXT_NODE_CLASS_FILTER. An ID range is split into aligned power-of-two blocks,
+  *         each block is one (Id, Mask) pair held by one mailbox, e.g. 0x100..0x12F gives
+  *         (0x100, 0x7E0) and (0x120, 0x7F0). Non matching frames are rejected by the controller.
+  * @{
+  */
+#if (CAN_ID_FORMAT == CAN_ID_EXTENDED)
+#define CAN_ID_MASK             0x1FFFFFFFu
+#else
+#define CAN_ID_MASK             0x7FFu
+#endif
+
+#define CAN_FILTER_MAX          8u  /* Largest number of mailboxes taken by one range */
+
+/* One acceptance filter */
+typedef struct
+{
+    uint32_t Id;    /* Accepted ID */
+    uint32_t Mask;  /* ID bits compared (1) or ignored (0) */
+} CAN_Filter_t;
+
+/** @defgroup CAN error state
+  * @{
+  */
+#define CAN_ERROR_ACTIVE        0u  /* Both error counters below the warning limit */
+#define CAN_ERROR_WARNING       1u  /* Error active, one error counter reached the warning limit */
+#define CAN_ERROR_PASSIVE       2u  /* One error counter above 127 */
+#define CAN_BUS_OFF             3u  /* Transmit error counter above 255, node is off the bus */
+
+#define CAN_ERROR_WARNING_LIMIT 96u
+
+/** @defgroup Bus-off recovery mode
+  * @{
+  */
+#define CAN_BUSOFF_RECOVERY_AUTO    0u  /* Controller rejoins the bus by itself */
+#define CAN_BUSOFF_RECOVERY_MANUAL  1u  /* Controller waits for MID_CAN_RecoverBusOff() */
+
+/** @defgroup CAN operation mode
+  * @{
+  */
+#define CAN_MODE_NORMAL         0u  /* Take part in bus traffic */
+#define CAN_MODE_LISTEN_ONLY    1u  /* Receive only, no ACK and no error frames sent */
+#define CAN_MODE_LOOPBACK       2u  /* Transmitted frames are received internally, the bus is not driven */
+
+/** @defgroup Data payload layout
+  * @brief  Frames carry up to 8 bytes, byte 0 is the first byte on the bus.
+  *         Multi-signal frames pack 16-bit signals big-endian in consecutive byte pairs,
+  *         starting at a per-message start byte: signal k is in bytes (start + 2k, start + 2k + 1).
+  *         Legacy single-value frames (DLC 4, value in data word 0) are read with start byte 2.
+  * @{
+  */
+#define CAN_MAX_DATA_LENGTH             8u
+#define CAN_SIGNAL_SIZE                 2u
+#define CAN_MAX_SIGNALS                 (CAN_MAX_DATA_LENGTH / CAN_SIGNAL_SIZE)
+#define CAN_LEGACY_DATA_LENGTH          4u
+#define CAN_LEGACY_SIGNAL_START_BYTE    2u
+#define CAN_PACKED_SIGNAL_START_BYTE    0u
+
 /* Comming Message Struct */
 typedef struct MID_CAN_Interface
 {
     uint32_t ID;        /* ID of message, it can be a value of @defgroup *_ID */
-    uint32_t Data;      /* Data of message, it can be a value of @defgroup *_DATA */
+    uint32_t Data;      /* Data of message (data word 0), it can be a value of @defgroup *_DATA */
+    uint8_t  IdType;    /* Format of ID, it can be a value of @defgroup CAN identifier format */
+    uint8_t  Length;    /* Data length code of the received frame (0..8) */
+    uint8_t  Payload[CAN_MAX_DATA_LENGTH]; /* All data bytes, refer to @defgroup Data payload layout */
+    uint16_t TimeStamp; /* Free running timer value (CAN bit times) captured by hardware on reception */
+    uint32_t AgeUs;     /* Time elapsed between the hardware capture and the read of the mailbox (us) */
+    uint8_t  Overrun;   /* 1 if frames were overwritten in the mailbox before this one was read */
 } Data_Typedef;
 
 /*******************************************************************************
@@ -114,13 +395,123 @@ typedef struct MID_CAN_Interface
 void MID_CAN_Init(void);
 
 /**
-  * @brief      Initialize all Message Buffers for CAN communication
+  * @brief      Initialize the pins and the FlexCAN module of a CAN bus, all mailboxes inactive
+  * @note       Detects the bitrate first when CAN_AUTOBAUD_ENABLE is 1u
+  * @param[in]  Bus: CAN bus, it can be a value of @defgroup CAN bus
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_BusInit(uint8_t Bus);
+
+/**
+  * @brief      Get the bitrate a CAN bus runs at, refer to @defgroup Auto-baud
+  * @param[in]  Bus: CAN bus, it can be a value of @defgroup CAN bus
+  * @param[out] None
+  * @retval     Bitrate (bit/s)
+  */
+uint32_t MID_CAN_GetBitrate(uint8_t Bus);
+
+/**
+  * @brief      Configure a transmit mailbox of a CAN bus
+  * @param[in]  Bus: CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Mb:  Index of the mailbox
+  * @param[in]  Id:  ID of the frames sent from the mailbox
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_BusConfigTxMailbox(uint8_t Bus, uint8_t Mb, uint32_t Id);
+
+/**
+  * @brief      Set the local priority of a transmit mailbox of a CAN bus
+  * @note       The mailbox must not hold a pending frame
+  * @param[in]  Bus: CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Mb:  Index of the mailbox
+  * @param[in]  Priority: it can be a value of @defgroup Local transmit priority
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_BusSetTxPriority(uint8_t Bus, uint8_t Mb, uint8_t Priority);
+
+/**
+  * @brief      Set the local priority of a transmit mailbox of the sensor bus
+  * @note       The mailbox must not hold a pending frame, refer to MID_CAN_IsTxMailboxBusy()
+  * @param[in]  Tx_Mb: it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Priority: it can be a value of @defgroup Local transmit priority
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_SetTxPriority(uint8_t Tx_Mb, uint8_t Priority);
+
+/**
+  * @brief      Configure a receive mailbox of a CAN bus and enable its interrupt
+  * @param[in]  Bus:  CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Mb:   Index of the mailbox
+  * @param[in]  Id:   ID accepted by the mailbox
+  * @param[in]  Mask: ID bits compared (1) or ignored (0), IMASK_FILTER_ALL_ID for an exact match
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_BusConfigRxMailbox(uint8_t Bus, uint8_t Mb, uint32_t Id, uint32_t Mask);
+
+/**
+  * @brief      Split an ID range into acceptance filters, refer to @defgroup Acceptance filter
+  * @param[in]  FirstId    First accepted ID
+  * @param[in]  LastId     Last accepted ID
+  * @param[out] Filters    Filters covering exactly the range
+  * @param[in]  MaxFilters Size of Filters
+  * @retval     Number of filters, 0 if the range is empty or needs more than MaxFilters
+  */
+uint8_t MID_CAN_RangeToFilters(uint32_t FirstId, uint32_t LastId, CAN_Filter_t *Filters, uint8_t MaxFilters);
+
+/**
+  * @brief      Configure consecutive receive mailboxes of a CAN bus to accept an ID range
+  * @param[in]  Bus     CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  FirstMb Index of the first mailbox
+  * @param[in]  MbCount Number of mailboxes available from FirstMb
+  * @param[in]  FirstId First accepted ID
+  * @param[in]  LastId  Last accepted ID
+  * @param[out] None
+  * @retval     Number of mailboxes configured, 0 if the range does not fit (no mailbox touched)
+  */
+uint8_t MID_CAN_BusConfigRxRange(uint8_t Bus, uint8_t FirstMb, uint8_t MbCount, uint32_t FirstId, uint32_t LastId);
+
+/**
+  * @brief      Initialize all Message Buffers for CAN communication from the default table
   * @param[in]  None
   * @param[out] None
   * @retval     None
   */
 void MID_CAN_MailboxInit(void);
 
+/**
+  * @brief      Allocate the message buffers of the sensor bus from a descriptor table
+  * @note       Runs in freeze mode, may be called at runtime: every message buffer is
+  *             deactivated, then descriptor k configures message buffer k. Logical
+  *             mailboxes missing from the table are left without message buffer.
+  * @param[in]  Table Descriptors, in message buffer order
+  * @param[in]  Count Number of descriptors (up to CAN_MAILBOX_COUNT)
+  * @param[out] None
+  * @retval     Number of message buffers allocated, 0 if the table does not fit (nothing changed)
+  */
+uint8_t MID_CAN_MailboxConfigure(const CAN_MailboxDesc_t *Table, uint8_t Count);
+
+/**
+  * @brief      Get the message buffer allocated to a logical mailbox of the sensor bus
+  * @param[in]  Mailbox it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[out] None
+  * @retval     Message buffer index, CAN_MB_NONE if not allocated
+  */
+uint8_t MID_CAN_GetMailboxIndex(uint8_t Mailbox);
+
+/**
+  * @brief      Switch the operation mode of a CAN bus
+  * @param[in]  Bus:  CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Mode: it can be a value of @defgroup CAN operation mode
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_BusSetMode(uint8_t Bus, uint8_t Mode);
+
 /**
   * @brief      Register a callback function for receiving CAN messages
   * @param[in]  cb_ptr: Pointer to the callback function
@@ -129,6 +520,15 @@ void MID_CAN_MailboxInit(void);
   */
 void MID_CAN_RegisterRxNotificationCallback(void (*cb_ptr)(void));
 
+/**
+  * @brief      Register a callback function for receiving CAN messages on a CAN bus
+  * @param[in]  Bus:    CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  cb_ptr: Pointer to the callback function
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_BusRegisterRxNotificationCallback(uint8_t Bus, void (*cb_ptr)(void));
+
 /**
   * @brief      Register a callback function for the CAN bus-off event
   * @param[in]  cb_ptr: Pointer to the callback function
@@ -137,37 +537,278 @@ void MID_CAN_RegisterRxNotificationCallback(void (*cb_ptr)(void));
   */
 void MID_CAN_RegisterBusOffNotificationCallback(void (*cb_ptr)(void));
 
+/**
+  * @brief      Register a callback function for error warning and bus-off recovery done events
+  * @param[in]  cb_ptr: Pointer to the callback function
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_RegisterErrorStateNotificationCallback(void (*cb_ptr)(void));
+
+/**
+  * @brief      Run the error state notification once more on the next bus error
+  * @note       The error interrupt masks itself after one error, an erroneous frame
+  *             repeated on the bus would raise it at every attempt otherwise.
+  * @param[in]  None
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_EnableErrorNotification(void);
+
+/**
+  * @brief      Get the current error state of the CAN controller
+  * @param[in]  None
+  * @param[out] None
+  * @retval     Error state, it can be a value of @defgroup CAN error state
+  */
+uint8_t MID_CAN_GetErrorState(void);
+
+/**
+  * @brief      Get the transmit and receive error counters
+  * @param[in]  None
+  * @param[out] TxErrCnt: Transmit error counter
+  * @param[out] RxErrCnt: Receive error counter
+  * @retval     None
+  */
+void MID_CAN_GetErrorCounters(uint8_t *TxErrCnt, uint8_t *RxErrCnt);
+
+/**
+  * @brief      Select how the CAN controller leaves the bus-off state
+  * @param[in]  Mode: it can be a value of @defgroup Bus-off recovery mode
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_SetBusOffRecovery(uint8_t Mode);
+
+/**
+  * @brief      Start the bus-off recovery when manual recovery is selected
+  * @param[in]  None
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_RecoverBusOff(void);
+
 /**
   * @brief      Receive a CAN message from the specified mailbox
-  * @param[in]  mbIdx: Index of the mailbox to receive from
+  * @param[in]  mbIdx: Mailbox to receive from, it can be a value of @defgroup Mailboxes of the sensor bus
   * @param[out] data: Pointer to the data structure to store received message
   * @retval     None
   */
 void MID_CAN_ReceiveMessage(uint8_t mbIdx, Data_Typedef *data);
 
+/**
+  * @brief      Receive a CAN message from the specified mailbox of a CAN bus
+  * @param[in]  Bus:   CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  mbIdx: Index of the mailbox to receive from
+  * @param[out] data:  Pointer to the data structure to store received message
+  * @retval     None
+  */
+void MID_CAN_BusReceiveMessage(uint8_t Bus, uint8_t mbIdx, Data_Typedef *data);
+
+/**
+  * @brief      Read the loss counters of a receive mailbox of a CAN bus, counted since initialization
+  * @note       An overrun means at least one frame was overwritten before the mailbox was read,
+  *             a busy read means the mailbox was read while a frame was moving in
+  * @param[in]  Bus     CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Mb      Index of the mailbox
+  * @param[out] Overrun Number of overruns
+  * @param[out] Busy    Number of busy reads
+  * @retval     None
+  */
+void MID_CAN_BusGetMailboxLoss(uint8_t Bus, uint8_t Mb, uint32_t *Overrun, uint32_t *Busy);
+
 /**
   * @brief      Send a CAN message from the specified mailbox
-  * @param[in]  Tx_Mb: Index of the transmit mailbox
+  * @param[in]  Tx_Mb: Transmit mailbox, it can be a value of @defgroup Mailboxes of the sensor bus
   * @param[in]  Data:  Data to be sent
   * @param[out] None
   * @retval     None
   */
 void MID_CAN_SendCANMessage(uint8_t Tx_Mb, int16_t Data);
 
+/**
+  * @brief      Send a CAN frame with an explicit payload and data length
+  * @param[in]  Tx_Mb:   Transmit mailbox, it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Payload: Pointer to the data bytes, byte 0 is sent first
+  * @param[in]  Length:  Number of data bytes (0..8)
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_SendCANFrame(uint8_t Tx_Mb, const uint8_t *Payload, uint8_t Length);
+
+/**
+  * @brief      Send a CAN message that becomes obsolete after a deadline, refer to @defgroup Transmit deadline
+  * @param[in]  Tx_Mb:      Transmit mailbox, it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Data:       Data to be sent
+  * @param[in]  DeadlineUs: Time the frame may wait for the bus (us), CAN_TX_DEADLINE_NONE for no limit
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_SendCANMessageDeadline(uint8_t Tx_Mb, int16_t Data, uint32_t DeadlineUs);
+
+/**
+  * @brief      Send a CAN frame that becomes obsolete after a deadline, refer to @defgroup Transmit deadline
+  * @param[in]  Tx_Mb:      Transmit mailbox, it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Payload:    Pointer to the data bytes, byte 0 is sent first
+  * @param[in]  Length:     Number of data bytes (0..8)
+  * @param[in]  DeadlineUs: Time the frame may wait for the bus (us), CAN_TX_DEADLINE_NONE for no limit
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_SendCANFrameDeadline(uint8_t Tx_Mb, const uint8_t *Payload, uint8_t Length, uint32_t DeadlineUs);
+
+/**
+  * @brief      Send a CAN message with the ID of a node from a mailbox of its class, refer to @defgroup Transmit deadline
+  * @param[in]  Tx_Mb:      Transmit mailbox, it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Id:         ID of the frame, e.g. CAN_NODE_ID() of the addressed node
+  * @param[in]  Data:       Data to be sent
+  * @param[in]  DeadlineUs: Time the frame may wait for the bus (us), CAN_TX_DEADLINE_NONE for no limit
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_SendCANMessageToId(uint8_t Tx_Mb, uint32_t Id, int16_t Data, uint32_t DeadlineUs);
+
+/**
+  * @brief      Send a CAN frame with the ID of a node from a mailbox of its class, refer to @defgroup Transmit deadline
+  * @param[in]  Tx_Mb:      Transmit mailbox, it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Id:         ID of the frame, e.g. CAN_NODE_ID() of the addressed node
+  * @param[in]  Payload:    Pointer to the data bytes, byte 0 is sent first
+  * @param[in]  Length:     Number of data bytes (0..8)
+  * @param[in]  DeadlineUs: Time the frame may wait for the bus (us), CAN_TX_DEADLINE_NONE for no limit
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_SendCANFrameToId(uint8_t Tx_Mb, uint32_t Id, const uint8_t *Payload, uint8_t Length, uint32_t DeadlineUs);
+
+/**
+  * @brief      Account for sent frames and abort the expired ones, called from the main loop
+  * @note       Runs on NOTIFY_EVENT_CAN_TX, NOTIFY_EVENT_ALARM and every TIMER_TICK_MS, the alarm
+  *             is set to the earliest deadline left.
+  * @param[in]  None
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_ProcessTxDeadlines(void);
+
+/**
+  * @brief      Get the transmit counters of the sensor bus
+  * @param[in]  None
+  * @param[out] Stats Transmit counters
+  * @retval     None
+  */
+void MID_CAN_GetTxStats(CAN_TxStats_t *Stats);
+
+/**
+  * @brief      Send a CAN frame with an explicit payload and data length on a CAN bus
+  * @param[in]  Bus:     CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Tx_Mb:   Index of the transmit mailbox
+  * @param[in]  Payload: Pointer to the data bytes, byte 0 is sent first
+  * @param[in]  Length:  Number of data bytes (0..8)
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_BusSendCANFrame(uint8_t Bus, uint8_t Tx_Mb, const uint8_t *Payload, uint8_t Length);
+
+/**
+  * @brief      Send a remote request frame from a mailbox of the sensor bus, refer to @defgroup Ping mode
+  * @note       The mailbox is set to receive on Id before the request, the answer is received in it
+  * @param[in]  Mb     Mailbox, it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Id     ID of the request and of the answer, e.g. CAN_NODE_ID() of the addressed node
+  * @param[in]  Length Data length requested from the answering node
+  * @param[out] None
+  * @retval     1 if the request is sent, 0 if the mailbox still waits for an answer or holds an unread one
+  */
+uint8_t MID_CAN_SendRemoteRequest(uint8_t Mb, uint32_t Id, uint8_t Length);
+
+/**
+  * @brief      Configure a mailbox of a CAN bus answering remote request frames in hardware
+  * @param[in]  Bus     CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Mb      Index of the mailbox
+  * @param[in]  Id      ID of the remote request and of the answer
+  * @param[in]  Payload Answer data bytes
+  * @param[in]  Length  Number of bytes (limited to CAN_MAX_DATA_LENGTH)
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_BusConfigRemoteAnswer(uint8_t Bus, uint8_t Mb, uint32_t Id, const uint8_t *Payload, uint8_t Length);
+
+/**
+  * @brief      Check whether a transmit mailbox of the sensor bus still waits for the bus
+  * @param[in]  Tx_Mb Transmit mailbox, it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[out] None
+  * @retval     1 if the previous frame is not sent yet, 0 otherwise
+  */
+uint8_t MID_CAN_IsTxMailboxBusy(uint8_t Tx_Mb);
+
+/**
+  * @brief      Check whether a transmit mailbox of a CAN bus still waits for the bus
+  * @param[in]  Bus:   CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Tx_Mb: Index of the transmit mailbox
+  * @param[out] None
+  * @retval     1 if the previous frame is not sent yet, 0 otherwise
+  */
+uint8_t MID_CAN_BusIsTxMailboxBusy(uint8_t Bus, uint8_t Tx_Mb);
+
+/**
+  * @brief      Pack 16-bit signals into a payload, refer to @defgroup Data payload layout
+  * @param[in]  Signals: Pointer to the signal values
+  * @param[in]  Count:   Number of signals (limited to CAN_MAX_SIGNALS)
+  * @param[out] Payload: Pointer to the payload buffer (CAN_MAX_DATA_LENGTH bytes)
+  * @retval     Data length of the packed frame
+  */
+uint8_t MID_CAN_PackSignals(const uint16_t *Signals, uint8_t Count, uint8_t *Payload);
+
+/**
+  * @brief      Unpack 16-bit signals from a payload, refer to @defgroup Data payload layout
+  * @param[in]  Payload:   Pointer to the data bytes
+  * @param[in]  Length:    Data length of the frame
+  * @param[in]  StartByte: Byte offset of the first signal
+  * @param[out] Signals:   Pointer to the signal buffer (CAN_MAX_SIGNALS entries)
+  * @retval     Number of complete signals found in the frame
+  */
+uint8_t MID_CAN_UnpackSignals(const uint8_t *Payload, uint8_t Length, uint8_t StartByte, uint16_t *Signals);
+
 /**
   * @brief      Clear message event for a specific mailbox
-  * @param[in]  Mailbox: Index of the mailbox
+  * @param[in]  Mailbox: Mailbox, it can be a value of @defgroup Mailboxes of the sensor bus
   * @param[out] None
   * @retval     None
   */
 void MID_ClearMessageCommingEvent(uint8_t Mailbox);
 
 /**
-  * @brief      Check if a message event occurred in the specified mailbox
+  * @brief      Clear message event for a specific mailbox of a CAN bus
+  * @param[in]  Bus:     CAN bus, it can be a value of @defgroup CAN bus
   * @param[in]  Mailbox: Index of the mailbox
   * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_BusClearMessageCommingEvent(uint8_t Bus, uint8_t Mailbox);
+
+/**
+  * @brief      Check if a message event occurred in the specified mailbox
+  * @param[in]  Mailbox: Mailbox, it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[out] None
   * @retval     Status of the message event (1 if occurred, 0 otherwise)
   */
 uint8_t MID_CheckCommingMessageEvent(uint8_t Mailbox);
 
+/**
+  * @brief      Check if a message event occurred in the specified mailbox of a CAN bus
+  * @param[in]  Bus:     CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Mailbox: Index of the mailbox
+  * @param[out] None
+  * @retval     Status of the message event (1 if occurred, 0 otherwise)
+  */
+uint8_t MID_CAN_BusCheckCommingMessageEvent(uint8_t Bus, uint8_t Mailbox);
+
+/**
+  * @brief      Get the gateway counters
+  * @param[in]  None
+  * @param[out] Forwarded: Number of frames forwarded between buses
+  * @param[out] Dropped:   Number of frames dropped because the destination mailbox was still busy
+  * @retval     None
+  */
+void MID_CAN_GetGatewayCounters(uint32_t *Forwarded, uint32_t *Dropped);
+
 #endif /* MID_CAN_INTERFACE_H_ */
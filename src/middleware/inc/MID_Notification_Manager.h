@@ -4,11 +4,24 @@
 /*******************************************************************************
  * Include
  ******************************************************************************/
+#include <stdint.h>
 
 /*******************************************************************************
  * Definition
  ******************************************************************************/
 
+/** @defgroup Pending work event
+  * @brief  Raised from the interrupts, taken by the main loop. The main loop sleeps while none is pending.
+  * @{
+  */
+#define NOTIFY_EVENT_RECEIVE        (1u << 0u)  /* A frame was put into the receive queue */
+#define NOTIFY_EVENT_TIMEOUT        (1u << 1u)  /* A timeout event is set */
+#define NOTIFY_EVENT_CAN_STATUS     (1u << 2u)  /* CAN error state changed or bus-off */
+#define NOTIFY_EVENT_TICK           (1u << 3u)  /* Timeout counter tick, every TIMER_TICK_MS */
+#define NOTIFY_EVENT_CAN_TX         (1u << 4u)  /* A transmit mailbox completed or its abort is done */
+#define NOTIFY_EVENT_ALARM          (1u << 5u)  /* The alarm of MID_Timer_SetAlarm() expired */
+#define NOTIFY_EVENT_UART_ROOM      (1u << 6u)  /* The UART transmit queue drained to the level the bulk senders resume at */
+
 /*******************************************************************************
  * API
  ******************************************************************************/
@@ -21,4 +34,53 @@
   */
 void MID_EnableNotification(void);
 
+/**
+  * @brief      Mark work as pending, callable from interrupts and from the main loop
+  * @param[in]  Events: it can be a combination of @defgroup Pending work event
+  * @param[out] None
+  * @retval     None
+  */
+void MID_Notification_Raise(uint32_t Events);
+
+/**
+  * @brief      Fetch and clear the pending work
+  * @param[in]  None
+  * @param[out] None
+  * @retval     Pending events, a combination of @defgroup Pending work event
+  */
+uint32_t MID_Notification_Take(void);
+
+/**
+  * @brief      Sleep until the next interrupt, unless work is already pending
+  * @note       The time spent sleeping is accounted for MID_Notification_GetCpuLoad().
+  * @param[in]  None
+  * @param[out] None
+  * @retval     None
+  */
+void MID_Notification_WaitForEvent(void);
+
+/**
+  * @brief      Get the CPU load since the previous call and start a new interval
+  * @param[in]  None
+  * @param[out] WakeupCnt: Number of wake-ups from sleep in the interval
+  * @retval     Time not spent sleeping, in per mille of the interval
+  */
+uint32_t MID_Notification_GetCpuLoad(uint32_t *WakeupCnt);
+
+/**
+  * @brief      Mask the interrupts, for the data an interrupt handler shares with the main loop
+  * @param[in]  None
+  * @param[out] None
+  * @retval     PRIMASK before masking, to be given to MID_Notification_ExitCritical()
+  */
+uint32_t MID_Notification_EnterCritical(void);
+
+/**
+  * @brief      Unmask the interrupts, unless they were masked by the caller already
+  * @param[in]  primask: Value returned by MID_Notification_EnterCritical()
+  * @param[out] None
+  * @retval     None
+  */
+void MID_Notification_ExitCritical(uint32_t primask);
+
 #endif /* MID_NOTIFICATION_MANAGER_H_ */
@@ -15,33 +15,35 @@
   */
 #define LPIT_INSTANCE     0u
 #define TIMEOUT_COUNTER_CHANNEL  LPIT_CH0
+#define TIMESTAMP_CHANNEL        LPIT_CH1   /* Free running 32-bit time base for timestamps */
+#define ALARM_CHANNEL            LPIT_CH2   /* One shot alarm, refer to MID_Timer_SetAlarm() */
+#define TIMER_TICK_MS            100u       /* Period of the timeout counter channel */
+
+/** @defgroup Timeout slot
+  * @brief  Each slot has a counter, a gate and an event sharing its index. Every sensor node owns
+  *         two slots: its incoming data and its answer to a ping.
+  * @{
+  */
+#define TIMEOUT_NODE_MAX                    16u     /* Sensor nodes with timeout slots */
+#define TIMEOUT_SLOT_NUM                    (1u + (2u * TIMEOUT_NODE_MAX))
+
+#define NODE_COMMINGDATA_SLOT(node)         (1u + (2u * (node)))    /* Incoming data of a sensor node */
+#define NODE_RESPONDCONNECTION_SLOT(node)   (2u + (2u * (node)))    /* Ping answer of a sensor node */
 
 /** @defgroup Counter for Timeout counting process
   * @{
   */
-#define D_NODE_COMMINGDATA_CNT          0u  /* Counter for incoming data from Distance Sensor Node */
-#define R_NODE_COMMINGDATA_CNT          1u  /* Counter for incoming data from Rotation Sensor Node */
-#define D_NODE_RESPONDCONNECTION_CNT    2u  /* Counter for Distance Sensor Node connection response */
-#define R_NODE_RESPONDCONNECTION_CNT    3u  /* Counter for Rotation Sensor Node connection response */
-#define PC_RESPOND_DATA_CNT             4u  /* Counter for respond message of data from Pc Tool */
+#define PC_RESPOND_DATA_CNT             0u  /* Counter for respond message of data from Pc Tool */
 
 /** @defgroup Gate controller for Timeout Counter
   * @{
   */
-#define D_NODE_COMMINGDATA_GATE          0u  /* Gate control for Distance Sensor Node incoming data */
-#define R_NODE_COMMINGDATA_GATE          1u  /* Gate control for Rotation Sensor Node incoming data */
-#define D_NODE_RESPONDCONNECTION_GATE    2u  /* Gate control for Rotation Sensor Node response */
-#define R_NODE_RESPONDCONNECTION_GATE    3u  /* Gate control for Rotation Sensor Node response */
-#define PC_RESPOND_DATA_GATE             4u  /* Gate control for respond message from Pc Tool */
+#define PC_RESPOND_DATA_GATE             0u  /* Gate control for respond message from Pc Tool */
 
 /** @defgroup Flag represent to Timeout Event
   * @{
   */
-#define D_NODE_TIMEOUT_EVENT                  0u  /* Timeout event for Distance Sensor Node */
-#define R_NODE_TIMEOUT_EVENT                  1u  /* Timeout event for Rotation Sensor Node */
-#define D_NODE_RESPOND_TIMEOUT_EVENT          2u  /* Timeout event for Distance Sensor Node response */
-#define R_NODE_RESPOND_TIMEOUT_EVENT          3u  /* Timeout event for Rotation Sensor Node response */
-#define PC_RESPOND_DATA_TIMEOUT_EVENT         4u  /* Timeout event for respond message from Pc Tool */
+#define PC_RESPOND_DATA_TIMEOUT_EVENT         0u  /* Timeout event for respond message from Pc Tool */
 
 typedef enum
 {
@@ -78,7 +80,7 @@ void MID_Timer_StopTimer(void);
   * @brief     Writes a timeout event for a specific instance.
   *
   * @param[in] instance: The instance index for which the event is being set.
-  *            this parameter can be a value of @defgroup Flag represent to Timeout Event
+  *            this parameter can be a value of @defgroup Flag represent to Timeout Event or @defgroup Timeout slot
   * @param[in] event:    The event type to be set (e.g., EVENT_SET, EVENT_NONE).
   * @retval    None
   */
@@ -88,7 +90,7 @@ void MID_TimeoutService_WriteEvent(uint8_t instance, Event_Typedef event);
   * @brief     Get a timeout event for a specific instance.
   *
   * @param[in] instance: The instance index for which the event is being set.
-  *            this parameter can be a value of @defgroup Flag represent to Timeout Event
+  *            this parameter can be a value of @defgroup Flag represent to Timeout Event or @defgroup Timeout slot
   * @retval    event:    The event type to be return (e.g., EVENT_SET, EVENT_NONE).
   */
 Event_Typedef MID_TimeoutService_GetEvent(uint8_t instance);
@@ -97,7 +99,7 @@ Event_Typedef MID_TimeoutService_GetEvent(uint8_t instance);
   * @brief     Resets the timeout counter for a specific instance.
   *
   * @param[in] instance The instance index whose timeout counter needs to be reset.
-  *            this parameter can be a value of @defgroup Counter for Timeout counting process
+  *            this parameter can be a value of @defgroup Counter for Timeout counting process or @defgroup Timeout slot
   * @retval    None
   */
 void MID_TimeoutService_ResetCounter(uint8_t instance);
@@ -106,10 +108,41 @@ void MID_TimeoutService_ResetCounter(uint8_t instance);
   * @brief     Enables or disables the counter gate for a specific instance.
   *
   * @param[in] instance: The instance index whose timeout counter needs to be reset.
-  *            this parameter can be a value of @defgroup Gate controller for Timeout Counter
+  *            this parameter can be a value of @defgroup Gate controller for Timeout Counter or @defgroup Timeout slot
   * @param[in] state: The desired state of the counter gate (ENABLE or DISABLE).
   * @retval    None
   */
 void MID_TimeoutService_CounterCmd(uint8_t instance, Functional_State state);
 
+/**
+  * @brief     Get the current value of the free running time base.
+  *
+  * @note      The time base counts LPIT clock ticks and wraps modulo 2^32,
+  *            the difference of two timestamps is valid across a wrap.
+  * @param     None
+  * @retval    Current timestamp in LPIT ticks
+  */
+uint32_t MID_Timer_GetTimestamp(void);
+
+/**
+  * @brief     Convert a duration in LPIT ticks to microseconds.
+  * @param[in] ticks: Duration in LPIT ticks.
+  * @retval    Duration in microseconds
+  */
+uint32_t MID_Timer_TicksToUs(uint32_t ticks);
+
+/**
+  * @brief     Convert a duration in microseconds to LPIT ticks.
+  * @param[in] us: Duration in microseconds.
+  * @retval    Duration in LPIT ticks
+  */
+uint32_t MID_Timer_UsToTicks(uint32_t us);
+
+/**
+  * @brief     Raise NOTIFY_EVENT_ALARM once after a delay, replacing the alarm set before.
+  * @param[in] ticks: Delay in LPIT ticks.
+  * @retval    None
+  */
+void MID_Timer_SetAlarm(uint32_t ticks);
+
 #endif /* MID_TIMER_INTERFACE_H_ */
@@ -30,6 +30,15 @@ void MID_Transmit_Queue_Init(void);
   */
 QueueCheckOperation_t MID_Transmit_Enqueue(const uint8_t data);
 
+/**
+  * @brief  Adds a block of data bytes to the transmit queue, all or none of them.
+  * @param[in] pData  Pointer to the data bytes to enqueue.
+  * @param[in] length Number of data bytes.
+  * @retval QUEUE_DONE_SUCCESS if enqueue operation is successful.
+  * @retval QUEUE_DONE_FAILED if the queue has not room for the whole block.
+  */
+QueueCheckOperation_t MID_Transmit_EnqueueBlock(const uint8_t *pData, uint16_t length);
+
 /**
   * @brief  Retrieves and removes the data byte from the front of the queue.
   * @param[out] data Pointer to store dequeued data.
@@ -38,4 +47,11 @@ QueueCheckOperation_t MID_Transmit_Enqueue(const uint8_t data);
   */
 QueueCheckOperation_t MID_Transmit_Dequeue(uint8_t * pOutData);
 
+/**
+  * @brief  Gets the number of data bytes waiting in the transmit queue.
+  * @param  None
+  * @retval Bytes queued.
+  */
+uint16_t MID_Transmit_GetCount(void);
+
 #endif /* MID_TRANSMITQUEUE_INTERFACE_H_ */
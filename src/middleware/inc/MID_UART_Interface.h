@@ -15,18 +15,136 @@
 #define PC_CONNECT_DISTANCE_SENSOR_ID   0xA1
 #define PC_CONNECT_ROTATION_SENSOR_ID   0xA2
 
+/* Instance of the node class the next connection request or report-on-change setting applies to,
+ * data: 0 for the first node of the class. The forwarder sends it before the reply of a node other
+ * than the first one. A selection is used by one command only. */
+#define PC_SELECT_NODE_ID               0xAC
+
 #define REQUEST_CONNECTION_DATA         0x10
 #define CONFIRM_CONNECTION_DATA         0xFF
 
 /** @defgroup Data Message ID
   * @{
   */
-#define ROTATION_DATA_ID   0xC0
-#define DISTANCE_DATA_ID   0xD0
+#define ROTATION_DATA_ID   0xC0     /* First rotation node, the next ones use 0xC1, 0xC2 ... */
+#define DISTANCE_DATA_ID   0xD0     /* First distance node, the next ones use 0xD1, 0xD2 ... */
 
 #define CONFIRM_SENSOR_DATA      0xFFFF
 #define SENSOR_DISCONNECT_DATA   0xFFFF
 
+/** @defgroup Self-test Message ID
+  * @{
+  */
+#define PC_START_SELFTEST_ID             0xA3  /* PC Tool starts the loopback self-test, data: frames per second (0: default) */
+
+#define SELFTEST_FPS_ID                  0xA4  /* Frames per second forwarded to UART during the self-test */
+#define SELFTEST_DROP_CNT_ID             0xA5  /* Frames generated but never forwarded */
+#define SELFTEST_LATENCY_AVG_ID          0xA6  /* Average bus-to-UART latency during the self-test (us) */
+#define SELFTEST_LATENCY_MAX_ID          0xA7  /* Worst bus-to-UART latency during the self-test (us) */
+
+/** @defgroup Report-on-change Message ID
+  * @brief  A sample is forwarded when it differs from the last forwarded one by the deadband or more,
+  *         or when the last forwarded one is older than the maximum silent interval. The forwarder
+  *         answers with the same ID and the value applied.
+  * @{
+  */
+#define PC_SET_DISTANCE_DEADBAND_ID      0xA8  /* Deadband of the distance samples, 0: every sample, 1: on change */
+#define PC_SET_ROTATION_DEADBAND_ID      0xA9  /* Deadband of the rotation samples */
+#define PC_SET_DISTANCE_MAX_SILENT_ID    0xAA  /* Maximum silent interval of the distance samples (ms) */
+#define PC_SET_ROTATION_MAX_SILENT_ID    0xAB  /* Maximum silent interval of the rotation samples (ms) */
+
+/** @defgroup Statistics Message ID
+  * @{
+  */
+#define PC_REQUEST_STATISTICS_ID         0xB0  /* PC Tool requests a statistics report */
+
+/* Statistics of one sensor node: STATS_NODE_INDEX_ID with the node index, refer to @defgroup Sensor node
+ * index, followed by the values of the node */
+#define STATS_NODE_INDEX_ID              0xB1  /* Sensor node of the values that follow */
+#define STATS_NODE_LATENCY_AVG_ID        0xB2  /* Average bus-to-UART latency of the node data (us) */
+#define STATS_NODE_LATENCY_MAX_ID        0xB3  /* Worst bus-to-UART latency of the node data (us) */
+#define STATS_NODE_JITTER_ID             0xB4  /* Inter-arrival jitter of the node data frames (us) */
+#define STATS_NODE_FORWARD_CNT_ID        0xB5  /* Number of node samples forwarded */
+#define STATS_NODE_SUPPRESSED_CNT_ID     0xB6  /* Number of node samples held back by the deadband */
+
+/** @defgroup CAN Health Message ID
+  * @{
+  */
+#define CAN_HEALTH_STATE_ID              0xB9  /* CAN error state, refer to @defgroup CAN error state */
+#define CAN_HEALTH_TX_ERR_CNT_ID         0xBA  /* Transmit error counter (TEC) */
+#define CAN_HEALTH_RX_ERR_CNT_ID         0xBB  /* Receive error counter (REC) */
+#define CAN_HEALTH_WARNING_CNT_ID        0xBC  /* Number of entries into error warning */
+#define CAN_HEALTH_PASSIVE_CNT_ID        0xBD  /* Number of entries into error passive */
+#define CAN_HEALTH_BUS_OFF_CNT_ID        0xBE  /* Number of bus-off events */
+#define CAN_HEALTH_RECOVERY_TIME_ID      0xBF  /* Duration of the last bus-off, from detection to rejoin (us) */
+
+/** @defgroup Receive Loss Message ID
+  * @brief  Counted since power-up. Each loss entry is a pair of frames: the mailbox or CAN ID,
+  *         then its count. Only mailboxes and IDs with losses are reported.
+  * @{
+  */
+#define STATS_RX_OVERRUN_CNT_ID          0xE0  /* Overruns of all receive mailboxes of the sensor bus */
+#define STATS_RX_BUSY_CNT_ID             0xE1  /* Mailbox reads that waited for a frame moving in */
+#define STATS_RX_LOSS_MB_ID              0xE2  /* Mailbox index ... */
+#define STATS_RX_LOSS_MB_CNT_ID          0xE3  /* ... its number of overruns */
+#define STATS_RX_LOSS_CAN_ID             0xE4  /* CAN ID, STATS_LOSS_ID_OTHER for IDs beyond the table ... */
+#define STATS_RX_LOSS_CAN_ID_CNT_ID      0xE5  /* ... its number of overruns */
+
+/** @defgroup Transmit Message ID
+  * @brief  Sensor bus transmit counters, counted since power-up
+  * @{
+  */
+#define STATS_TX_SENT_CNT_ID             0xE6  /* Frames transmitted */
+#define STATS_TX_EXPIRED_CNT_ID          0xE7  /* Frames aborted at their deadline */
+#define STATS_TX_REPLACED_CNT_ID         0xE8  /* Pending frames aborted for a newer payload */
+#define STATS_TX_LATENCY_AVG_ID          0xE9  /* Average time from request to transmission (us) */
+#define STATS_TX_LATENCY_MAX_ID          0xEA  /* Worst time from request to transmission (us) */
+#define STATS_TX_BLOCKED_CNT_ID          0xEF  /* Frames dropped, their mailbox was still held by a frame being aborted */
+
+/** @defgroup CPU Load Message ID
+  * @brief  Measured over the statistics interval from the time the main loop sleeps
+  * @{
+  */
+#define STATS_CPU_LOAD_ID                0xEB  /* Time not spent sleeping (per mille) */
+#define STATS_CPU_WAKEUP_CNT_ID          0xEC  /* Number of wake-ups from sleep */
+
+/** @defgroup Dispatch Message ID
+  * @brief  The PC Tool discovers the message IDs the forwarder handles: the count, then one frame per ID
+  * @{
+  */
+#define PC_REQUEST_DISPATCH_TABLE_ID     0x90  /* PC Tool requests the list of handled message IDs */
+#define DISPATCH_COUNT_ID                0x91  /* Number of handled message IDs */
+#define DISPATCH_MSG_ID                  0x92  /* One handled message ID, CAN identifier or UART frame ID */
+
+/** @defgroup Task Message ID
+  * @brief  Sent with the statistics report, four frames per scheduler task in priority order
+  * @{
+  */
+#define TASK_INDEX_ID                    0x93  /* Task slot ... */
+#define TASK_RUN_CNT_ID                  0x94  /* ... its number of runs in the interval */
+#define TASK_EXEC_AVG_ID                 0x95  /* ... its average execution time (us) */
+#define TASK_EXEC_MAX_ID                 0x96  /* ... its worst execution time (us) */
+
+/** @defgroup Benchmark Message ID
+  * @brief  Sent once at startup when UART_ITOA_BENCHMARK or UART_PARSER_BENCHMARK is enabled
+  * @{
+  */
+#define BENCH_ITOA_LEGACY_CYCLES_ID      0x97  /* Cycles of the former integer to text conversion */
+#define BENCH_ITOA_FAST_CYCLES_ID        0x98  /* Cycles of the digit pair integer to text conversion */
+#define BENCH_PARSER_LEGACY_CYCLES_ID    0x99  /* Cycles of the former UART frame parser */
+#define BENCH_PARSER_FAST_CYCLES_ID      0x9A  /* Cycles of the word at a time UART frame parser */
+
+/** @defgroup Capture Message ID
+  * @brief  The PC Tool reads the capture of the ingress traffic: the lost records, the size, then the
+  *         records as 32-bit big-endian words, the last one padded with 0. Refer to @defgroup Capture record.
+  * @{
+  */
+#define PC_REQUEST_CAPTURE_ID            0x9B  /* PC Tool stops the capture and requests it */
+#define PC_START_CAPTURE_ID              0x9C  /* PC Tool clears the capture and restarts it */
+#define CAPTURE_LOST_ID                  0x9D  /* Records overwritten since the capture started */
+#define CAPTURE_SIZE_ID                  0x9E  /* Size of the capture (bytes) */
+#define CAPTURE_DATA_ID                  0x9F  /* Four bytes of the capture */
+
 /*******************************************************************************
  * API
  ******************************************************************************/
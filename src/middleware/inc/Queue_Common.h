@@ -14,6 +14,7 @@
 
 #define QUEUE_RECEIVE_SIZE   22u
 #define TRANSMIT_QUEUE_SIZE  500u
+#define QUEUE_PAYLOAD_SIZE   8u   /* Classic CAN payload size */
 
 /*******************************************************************************
  * Typedef structs
@@ -27,8 +28,11 @@ typedef enum
 /* Structure of a element in  receive Queue */
 typedef struct
 {
-    uint8_t  ID;
+    uint32_t ID;        /* 11-bit/29-bit CAN identifier or UART frame ID */
     uint16_t Data;
+    uint8_t  Length;    /* Number of valid bytes in Payload (CAN frames only) */
+    uint8_t  Payload[QUEUE_PAYLOAD_SIZE];
+    uint32_t TimeStamp; /* Arrival time in time base ticks (bus capture for CAN, end of frame for UART) */
 } ReceiveFrame_t;
 
 /* Circular queue for receiving frames */
@@ -2,67 +2,398 @@
 #include "DRV_S32K144_FLEXCAN.h"
 #include "DRV_S32K144_MCU.h"
 #include "MID_CAN_Interface.h"
+#include "MID_Timer_Interface.h"
+#include "MID_Notification_Manager.h"
 
 /*******************************************************************************
  * Definition
  ******************************************************************************/
 
-#define FLEXCAN_BITRATE     (500000u)
-#define FLEXCAN_D_LENGTH    (4u)
+#define FLEXCAN_BITRATE      (500000u)
+#define FLEXCAN_SAMPLE_POINT (80u)     /* percent, served from the precomputed bit timing table */
+#define FLEXCAN_D_LENGTH     (4u)
+
+/* Bitrate of the gateway buses */
+#define FLEXCAN_BUS1_BITRATE (500000u)
+#define FLEXCAN_BUS2_BITRATE (500000u)
+
+#define FLEXCAN_BYTES_PER_WORD  (4u)
+
+/* The free running timer counts CAN bit times, convert a number of bits to microseconds */
+#define FLEXCAN_BITS_TO_US(bits, bitrate)    ((((uint32_t)(bits)) * 1000u) / ((bitrate) / 1000u))
+
+/* Auto-baud cache, valid when Magic matches and Check is the complement of Bitrate */
+#define FLEXCAN_BAUD_CACHE_MAGIC    (0x42415544u)   /* "BAUD" */
+
+/* Result of listening at one candidate bitrate */
+#define FLEXCAN_LISTEN_LOCKED       (0u)    /* Frame received without errors */
+#define FLEXCAN_LISTEN_ERROR        (1u)    /* Receive errors, wrong bitrate */
+#define FLEXCAN_LISTEN_SILENT       (2u)    /* Nothing seen in the window */
+
+/* Static configuration of one CAN bus */
+typedef struct
+{
+    virtual_pin_id_t TxPin;
+    virtual_pin_id_t RxPin;
+    port_mux_t       Mux;
+    clock_names_t    ClkName;
+    uint32_t         Bitrate;
+} FLEXCAN_BusConfig_t;
+
+/* Bitrate locked by the auto-baud of a bus */
+typedef struct
+{
+    uint32_t Magic;
+    uint32_t Bitrate;
+    uint32_t Check;
+} FLEXCAN_BaudCache_t;
+
+/* Frame handed to a transmit mailbox of the sensor bus, refer to @defgroup Transmit deadline */
+typedef struct
+{
+    uint32_t Id;            /* ID the frame is sent with */
+    uint32_t Deadline;      /* Time base value the frame expires at */
+    uint16_t RequestTime;   /* FlexCAN timer at the request (CAN bit times) */
+    uint8_t  Pending;       /* 1 until the transmission or the abort is accounted for */
+    uint8_t  HasDeadline;   /* 1 if Deadline applies */
+    uint8_t  Abort;         /* Reason of an abort still in progress, refer to @defgroup Transmit abort */
+} FLEXCAN_TxTrack_t;
+
+/* Frame waiting in the transmit queue for its mailbox, refer to @defgroup Transmit deadline */
+typedef struct
+{
+    uint32_t Id;                            /* ID the frame is sent with */
+    uint32_t Deadline;                      /* Time base value the frame expires at */
+    uint16_t RequestTime;                   /* FlexCAN timer at the request (CAN bit times) */
+    uint8_t  Mailbox;                       /* Logical mailbox of the sensor bus */
+    uint8_t  Length;                        /* Number of data bytes */
+    uint8_t  HasDeadline;                   /* 1 if Deadline applies */
+    uint8_t  Data[CAN_MAX_DATA_LENGTH];     /* Data bytes, byte 0 is sent first */
+} FLEXCAN_TxFrame_t;
+
+/** @defgroup Transmit abort
+  * @brief  An abort is requested once and completed on a later call when the message buffer is
+  *         busy. A new frame waits at most CAN_TX_ABORT_WAIT_BITS for the previous one to leave.
+  * @{
+  */
+#define TX_ABORT_NONE               0u
+#define TX_ABORT_EXPIRED            1u      /* Deadline reached */
+#define TX_ABORT_REPLACED           2u      /* Newer payload for the mailbox */
+
+#define CAN_TX_ABORT_WAIT_BITS      160u    /* Longest frame with stuff bits, the one on the bus completes within it */
+/**
+  * @}
+  */
 
 /*******************************************************************************
  * Prototypes
  ******************************************************************************/
 /**
-  * @brief      Initialize the pins for FLEXCAN0
-  * @param[in]  None
+  * @brief      Initialize the pins of a CAN bus
+  * @param[in]  Bus: CAN bus, it can be a value of @defgroup CAN bus
+  * @param[out] None
+  * @retval     None
+  */
+static void FLEXCAN_Pin_Init(uint8_t Bus);
+
+/**
+  * @brief      Initialize the FlexCAN module of a CAN bus
+  * @param[in]  Bus: CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Bitrate: Bitrate (bit/s)
+  * @param[in]  Mode: FLEXCAN_NORMAL_MODE or FLEXCAN_LISTEN_ONLY_MODE
+  * @param[out] None
+  * @retval     None
+  */
+static void FLEXCAN_ParamConfig(uint8_t Bus, uint32_t Bitrate, flexcan_operation_modes_t Mode);
+
+#if (CAN_AUTOBAUD_ENABLE == 1u)
+/**
+  * @brief      Find the bitrate of a CAN bus, refer to @defgroup Auto-baud
+  * @param[in]  Bus: CAN bus, it can be a value of @defgroup CAN bus
+  * @param[out] None
+  * @retval     Locked bitrate, the cached or configured one if the bus stays silent
+  */
+static uint32_t FLEXCAN_AutoBaud(uint8_t Bus);
+
+/**
+  * @brief      Listen to a CAN bus at one candidate bitrate
+  * @param[in]  Bus: CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Bitrate: Candidate bitrate (bit/s)
+  * @param[out] None
+  * @retval     FLEXCAN_LISTEN_LOCKED, FLEXCAN_LISTEN_ERROR or FLEXCAN_LISTEN_SILENT
+  */
+static uint8_t FLEXCAN_AutoBaudListen(uint8_t Bus, uint32_t Bitrate);
+#endif
+
+/**
+  * @brief      Get the message buffer of a logical mailbox of the sensor bus
+  * @param[in]  Mailbox: it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[out] None
+  * @retval     Message buffer index, CAN_MB_NONE if not allocated
+  */
+static uint8_t FLEXCAN_MailboxToMb(uint8_t Mailbox);
+
+/**
+  * @brief      Get the ID configured for a logical mailbox of the sensor bus
+  * @param[in]  Mailbox: it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[out] None
+  * @retval     ID of the mailbox descriptor, 0 if not allocated
+  */
+static uint32_t FLEXCAN_MailboxToId(uint8_t Mailbox);
+
+/**
+  * @brief      Hand a frame to a transmit mailbox of the sensor bus or queue it, refer to @defgroup Transmit deadline
+  * @param[in]  Frame: Frame to send, RequestTime and Deadline already set
+  * @param[out] None
+  * @retval     None
+  */
+static void FLEXCAN_TxRequest(const FLEXCAN_TxFrame_t *Frame);
+
+/**
+  * @brief      Write a frame to a free transmit mailbox of the sensor bus and start tracking it
+  * @param[in]  Mb:    Message buffer of the mailbox
+  * @param[in]  Frame: Frame to send
+  * @param[out] None
+  * @retval     None
+  */
+static void FLEXCAN_TxStart(uint8_t Mb, const FLEXCAN_TxFrame_t *Frame);
+
+/**
+  * @brief      Put a frame in the transmit queue, it replaces the queued one of the same mailbox and ID
+  * @param[in]  Frame: Frame to queue
+  * @param[out] None
+  * @retval     None
+  */
+static void FLEXCAN_TxQueuePut(const FLEXCAN_TxFrame_t *Frame);
+
+/**
+  * @brief      Drop the expired frames of the transmit queue and hand the oldest frame of every
+  *             free mailbox to it
+  * @param[in]  Now: Time base value
+  * @param[out] None
+  * @retval     None
+  */
+static void FLEXCAN_TxQueueService(uint32_t Now);
+
+/**
+  * @brief      Make a transmit mailbox of the sensor bus free for a new frame
+  * @note       A pending frame is aborted and counted as replaced, unless it went out meanwhile
+  * @param[in]  Mailbox: it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Mb:      Message buffer of the mailbox
+  * @param[out] None
+  * @retval     1 if the message buffer is free, 0 if the abort is still in progress
+  */
+static uint8_t FLEXCAN_TxRelease(uint8_t Mailbox, uint8_t Mb);
+
+/**
+  * @brief      Request or complete the abort of the frame in a transmit mailbox of the sensor bus
+  * @param[in]  Mailbox: it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Mb:      Message buffer of the mailbox
+  * @param[in]  Reason:  it can be a value of @defgroup Transmit abort, kept from the first request
+  * @param[out] None
+  * @retval     1 if the message buffer is free, 0 if the abort is still in progress
+  */
+static uint8_t FLEXCAN_TxAbort(uint8_t Mailbox, uint8_t Mb, uint8_t Reason);
+
+/**
+  * @brief      Account for a frame that went out on the bus
+  * @param[in]  Mailbox: it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Mb:      Message buffer of the mailbox
+  * @param[out] None
+  * @retval     None
+  */
+static void FLEXCAN_TxSent(uint8_t Mailbox, uint8_t Mb);
+
+/**
+  * @brief      Set the alarm to the earliest deadline of the tracked and queued frames
+  * @param[in]  Now: Time base value
+  * @param[out] None
+  * @retval     None
+  */
+static void FLEXCAN_TxSetAlarm(uint32_t Now);
+
+/**
+  * @brief      Convert the data words of a message buffer to frame bytes
+  * @param[in]  Words: Data words, byte 0 is the most significant byte of word 0
+  * @param[out] Bytes: Frame bytes (CAN_MAX_DATA_LENGTH)
+  * @retval     None
+  */
+static void FLEXCAN_WordsToBytes(const uint32_t *Words, uint8_t *Bytes);
+
+/**
+  * @brief      Convert frame bytes to the data words of a message buffer
+  * @param[in]  Bytes:  Frame bytes
+  * @param[in]  Length: Number of valid bytes, the remaining ones are sent as 0
+  * @param[out] Words:  Data words, byte 0 is the most significant byte of word 0
+  * @retval     None
+  */
+static void FLEXCAN_BytesToWords(const uint8_t *Bytes, uint8_t Length, uint32_t *Words);
+
+/**
+  * @brief      Message buffer notification of one bus, serves the routes then the user callback
+  * @param[in]  Bus: CAN bus, it can be a value of @defgroup CAN bus
   * @param[out] None
   * @retval     None
   */
-static void FLEXCAN_Pin_Init(void);
+static void FLEXCAN_BusNotification(uint8_t Bus);
 
 /**
-  * @brief      Initialize FLEXCAN0
+  * @brief      Hand the completed transmit mailboxes of the sensor bus to the main loop
   * @param[in]  None
   * @param[out] None
   * @retval     None
   */
-static void FLEXCAN_ParamConfig(void);
+static void FLEXCAN_TxNotification(void);
 
 /**
-  * @brief      Initialize the transmit message buffers for CAN communication
+  * @brief      Driver callbacks of each bus, they only carry the bus to FLEXCAN_BusNotification()
   * @param[in]  None
   * @param[out] None
   * @retval     None
   */
-static void FLEXCAN_Tx_Mb_Init(void);
+static void FLEXCAN_Bus0_Notification(void);
+static void FLEXCAN_Bus1_Notification(void);
+static void FLEXCAN_Bus2_Notification(void);
 
+#if (CAN_GATEWAY_ENABLE == 1u)
 /**
-  * @brief      Initialize the receive message buffers for CAN communication
+  * @brief      Bring up the gateway buses and the mailboxes of every route
   * @param[in]  None
   * @param[out] None
   * @retval     None
   */
-static void FLEXCAN_Rx_Mb_Init(void);
+static void FLEXCAN_Gateway_Init(void);
+
+/**
+  * @brief      Forward the frames received on one bus according to the routing table
+  * @param[in]  Bus: CAN bus, it can be a value of @defgroup CAN bus
+  * @param[out] None
+  * @retval     None
+  */
+static void FLEXCAN_Gateway_Process(uint8_t Bus);
+#endif
 
 /*******************************************************************************
  * Variables
  ******************************************************************************/
 
+/* Pins, clock and bitrate of every bus */
+static const FLEXCAN_BusConfig_t Bus_Config[CAN_BUS_COUNT] =
+{
+    [CAN_BUS_0] = { .TxPin = PTE5,  .RxPin = PTE4,  .Mux = PORT_MUX_ALT5, .ClkName = FlexCAN0_CLK, .Bitrate = FLEXCAN_BITRATE      },
+    [CAN_BUS_1] = { .TxPin = PTA13, .RxPin = PTA12, .Mux = PORT_MUX_ALT3, .ClkName = FlexCAN1_CLK, .Bitrate = FLEXCAN_BUS1_BITRATE },
+    [CAN_BUS_2] = { .TxPin = PTC17, .RxPin = PTC16, .Mux = PORT_MUX_ALT3, .ClkName = FlexCAN2_CLK, .Bitrate = FLEXCAN_BUS2_BITRATE }
+};
+
+/* Bitrate every bus runs at */
+static uint32_t Bus_Bitrate[CAN_BUS_COUNT] = {FLEXCAN_BITRATE, FLEXCAN_BUS1_BITRATE, FLEXCAN_BUS2_BITRATE};
+
+#if (CAN_AUTOBAUD_ENABLE == 1u)
+/* Candidates of the auto-baud, fastest first */
+static const uint32_t AutoBaud_Bitrate[] = {1000000u, 500000u, 250000u, 125000u};
+
+#define AUTOBAUD_BITRATE_COUNT  (sizeof(AutoBaud_Bitrate) / sizeof(AutoBaud_Bitrate[0]))
+
+/* Locked bitrate of every bus, kept across resets other than power-on and low-voltage */
+static FLEXCAN_BaudCache_t Baud_Cache[CAN_BUS_COUNT] __attribute__((section(".noinit")));
+#endif
+
+/* Driver callback of every bus */
+static void (* const Bus_Notification[CAN_BUS_COUNT])(void) =
+{
+    FLEXCAN_Bus0_Notification,
+    FLEXCAN_Bus1_Notification,
+    FLEXCAN_Bus2_Notification
+};
 
-/* Static variable to store the handle for the FlexCAN module */
-static flexcan_handle_t handle;
+/* Handle of the FlexCAN module of every bus */
+static flexcan_handle_t handle[CAN_BUS_COUNT];
 
 /* It holds the necessary data and control information for transmitting a CAN message */
-static flexcan_mb_t Transmit_Message;
+static flexcan_mb_t Transmit_Message[CAN_BUS_COUNT];
+
+/* User receive callback of every bus */
+static void (*Rx_Callback[CAN_BUS_COUNT])(void) = {NULL};
+
+/* Answer of the forwarder to liveness remote requests, refer to @defgroup Ping mode */
+static const uint8_t Liveness_Answer[CAN_FW_LIVENESS_LENGTH] =
+{
+    (uint8_t)(CAN_FW_LIVENESS_VERSION >> 8u), (uint8_t)CAN_FW_LIVENESS_VERSION, 0u, 0u
+};
+
+/* Default layout of the sensor bus, descriptor k owns message buffer k: transmit buffers
+ * 0..9, the liveness answer 10 and receive buffers 11..16. CAN0_ORed_0_15_MB serves all of
+ * them but the rotation ping confirm in 16, served by CAN0_ORed_16_31_MB. */
+static const CAN_MailboxDesc_t Default_Mailbox_Table[] =
+{
+    { .Mailbox = TX_CONFIRM_DISTANCE_DATA_MB,      .Type = CAN_MB_TYPE_TX, .Id = CAN_MSG_ID(CAN_NODE_CLASS_DISTANCE, TX_CONFIRM_DISTANCE_DATA_TYPE),        .Priority = CAN_TX_PRIO_CONFIRM },
+    { .Mailbox = TX_CONFIRM_ROTATION_DATA_MB,      .Type = CAN_MB_TYPE_TX, .Id = CAN_MSG_ID(CAN_NODE_CLASS_ROTATION, TX_CONFIRM_ROTATION_DATA_TYPE),        .Priority = CAN_TX_PRIO_CONFIRM },
+    { .Mailbox = TX_RQ_CONNECT_DISTANCE_NODE_MB,   .Type = CAN_MB_TYPE_TX, .Id = CAN_MSG_ID(CAN_NODE_CLASS_DISTANCE, TX_RQ_CONNECT_DISTANCE_NODE_TYPE),     .Priority = CAN_TX_PRIO_COMMAND },
+    { .Mailbox = TX_RQ_CONNECT_ROTATION_NODE_MB,   .Type = CAN_MB_TYPE_TX, .Id = CAN_MSG_ID(CAN_NODE_CLASS_ROTATION, TX_RQ_CONNECT_ROTATION_NODE_TYPE),     .Priority = CAN_TX_PRIO_COMMAND },
+    { .Mailbox = TX_STOPOPR_DISTANCE_NODE_MB,      .Type = CAN_MB_TYPE_TX, .Id = CAN_MSG_ID(CAN_NODE_CLASS_DISTANCE, TX_STOPOPR_DISTANCE_NODE_TYPE),        .Priority = CAN_TX_PRIO_COMMAND },
+    { .Mailbox = TX_STOPOPR_ROTATION_NODE_MB,      .Type = CAN_MB_TYPE_TX, .Id = CAN_MSG_ID(CAN_NODE_CLASS_ROTATION, TX_STOPOPR_ROTATION_NODE_TYPE),        .Priority = CAN_TX_PRIO_COMMAND },
+    { .Mailbox = TX_PING_DISTANCE_NODE_MB,         .Type = CAN_MB_TYPE_TX, .Id = CAN_MSG_ID(CAN_NODE_CLASS_DISTANCE, TX_PING_DISTANCE_NODE_TYPE),           .Priority = CAN_TX_PRIO_COMMAND },
+    { .Mailbox = TX_PING_ROTATION_NODE_MB,         .Type = CAN_MB_TYPE_TX, .Id = CAN_MSG_ID(CAN_NODE_CLASS_ROTATION, TX_PING_ROTATION_NODE_TYPE),           .Priority = CAN_TX_PRIO_COMMAND },
+    { .Mailbox = SELFTEST_DISTANCE_TX_MB,          .Type = CAN_MB_TYPE_TX, .Id = CAN_MSG_ID(CAN_NODE_CLASS_DISTANCE, RX_DISTANCE_DATA_TYPE),                .Priority = CAN_TX_PRIO_BACKGROUND },
+    { .Mailbox = SELFTEST_ROTATION_TX_MB,          .Type = CAN_MB_TYPE_TX, .Id = CAN_MSG_ID(CAN_NODE_CLASS_ROTATION, RX_ROTATION_DATA_TYPE),                .Priority = CAN_TX_PRIO_BACKGROUND },
+
+    { .Mailbox = CAN_FW_LIVENESS_MB,               .Type = CAN_MB_TYPE_REMOTE_ANSWER, .Id = CAN_FW_LIVENESS_ID,
+      .Payload = Liveness_Answer, .Length = CAN_FW_LIVENESS_LENGTH },
 
-/* This structure is used to store the received message from the CAN bus */
-static flexcan_mb_t Receive_Message;
+    { .Mailbox = RX_DISTANCE_DATA_MB,              .Type = CAN_MB_TYPE_RX, .Id = CAN_MSG_ID(CAN_NODE_CLASS_DISTANCE, RX_DISTANCE_DATA_TYPE),                .Mask = CAN_NODE_GROUP_MASK },
+    { .Mailbox = RX_ROTATION_DATA_MB,              .Type = CAN_MB_TYPE_RX, .Id = CAN_MSG_ID(CAN_NODE_CLASS_ROTATION, RX_ROTATION_DATA_TYPE),                .Mask = CAN_NODE_GROUP_MASK },
+    { .Mailbox = RX_CONFIRM_FROM_DISTANCE_NODE_MB, .Type = CAN_MB_TYPE_RX, .Id = CAN_MSG_ID(CAN_NODE_CLASS_DISTANCE, RX_CONFIRM_FROM_DISTANCE_NODE_TYPE),   .Mask = CAN_NODE_GROUP_MASK },
+    { .Mailbox = RX_CONFIRM_FROM_ROTATION_NODE_MB, .Type = CAN_MB_TYPE_RX, .Id = CAN_MSG_ID(CAN_NODE_CLASS_ROTATION, RX_CONFIRM_FROM_ROTATION_NODE_TYPE),   .Mask = CAN_NODE_GROUP_MASK },
+    { .Mailbox = RX_CONFIRM_PING_DISTANCE_NODE_MB, .Type = CAN_MB_TYPE_RX, .Id = CAN_MSG_ID(CAN_NODE_CLASS_DISTANCE, RX_CONFIRM_PING_DISTANCE_NODE_TYPE),   .Mask = CAN_NODE_GROUP_MASK },
+    { .Mailbox = RX_CONFIRM_PING_ROTATION_NODE_MB, .Type = CAN_MB_TYPE_RX, .Id = CAN_MSG_ID(CAN_NODE_CLASS_ROTATION, RX_CONFIRM_PING_ROTATION_NODE_TYPE),   .Mask = CAN_NODE_GROUP_MASK }
+};
+
+/* Message buffer of every logical mailbox of the sensor bus and the ID of its descriptor */
+static uint8_t  Mailbox_Map[CAN_MB_NUM];
+static uint32_t Mailbox_Id[CAN_MB_NUM];
+
+/* Frame in every logical mailbox of the sensor bus and transmit counters */
+static FLEXCAN_TxTrack_t Tx_Track[CAN_MB_NUM];
+static FLEXCAN_TxFrame_t Tx_Queue[CAN_TX_QUEUE_SIZE];     /* Request order */
+static uint8_t  Tx_Queue_Num    = 0u;
+static uint32_t Tx_Sent_Cnt     = 0u;
+static uint32_t Tx_Expired_Cnt  = 0u;
+static uint32_t Tx_Replaced_Cnt = 0u;
+static uint32_t Tx_Blocked_Cnt  = 0u;
+static uint64_t Tx_Latency_Sum  = 0u;     /* CAN bit times */
+static uint32_t Tx_Latency_Max  = 0u;     /* CAN bit times */
+
+#if (CAN_GATEWAY_ENABLE == 1u)
+/* Routing table, each route owns one RX mailbox on its source bus and one TX mailbox on its
+ * destination bus. CAN1 and CAN2 only have mailboxes 0..15. */
+static const CAN_Route_t Routing_Table[] =
+{
+    /* Diagnostic range of segment 1 mirrored onto segment 2 unchanged */
+    { .SrcBus = CAN_BUS_1, .SrcMb = CAN_GW_SEG1_DIAG_RX_MB, .SrcId = CAN_GW_SEG1_DIAG_ID, .SrcMask = CAN_GW_SEG1_DIAG_MASK,
+      .DstBus = CAN_BUS_2, .DstMb = CAN_GW_SEG1_DIAG_TX_MB, .DstId = CAN_GATEWAY_KEEP_ID },
+    /* Segment 2 command forwarded onto segment 1 under the ID segment 1 nodes listen to */
+    { .SrcBus = CAN_BUS_2, .SrcMb = CAN_GW_SEG2_CMD_RX_MB, .SrcId = CAN_GW_SEG2_CMD_ID, .SrcMask = IMASK_FILTER_ALL_ID,
+      .DstBus = CAN_BUS_1, .DstMb = CAN_GW_SEG2_CMD_TX_MB, .DstId = CAN_GW_SEG2_CMD_REMAP_ID }
+};
+
+#define ROUTE_COUNT     (sizeof(Routing_Table) / sizeof(Routing_Table[0]))
+
+/* Frame carried from the source to the destination mailbox */
+static flexcan_mb_t Gateway_Message;
+
+/* Gateway counters */
+static uint32_t Gateway_Forward_Cnt = 0u;
+static uint32_t Gateway_Drop_Cnt    = 0u;
+#endif
 
 /* This structure is used to configure a message buffer for transmit or receive operation */
 flexcan_mb_config_t mbCfg =
 {
+#if (CAN_ID_FORMAT == CAN_ID_EXTENDED)
+    .idType = FLEXCAN_MB_ID_EXT,  /* Extended ID (29-bit) */
+#else
     .idType = FLEXCAN_MB_ID_STD,  /* Standard ID (11-bit) */
+#endif
     .dataLength = FLEXCAN_D_LENGTH  /* 8 bytes */
 };
 
@@ -71,19 +402,19 @@ flexcan_mb_config_t mbCfg =
  * Code
  ******************************************************************************/
 /**
-  * @brief      Initialize the pins for FLEXCAN0
-  * @param[in]  None
+  * @brief      Initialize the pins of a CAN bus
+  * @param[in]  Bus: CAN bus, it can be a value of @defgroup CAN bus
   * @param[out] None
   * @retval     None
   */
-static void FLEXCAN_Pin_Init(void)
+static void FLEXCAN_Pin_Init(uint8_t Bus)
 {
-    virtual_pin_id_t Flexcan_Tx_Pin = PTE5;
-    virtual_pin_id_t Flexcan_Rx_Pin = PTE4;
+    virtual_pin_id_t Flexcan_Tx_Pin = Bus_Config[Bus].TxPin;
+    virtual_pin_id_t Flexcan_Rx_Pin = Bus_Config[Bus].RxPin;
 
     const PortConfig_t  PortConfigCAN =
     {
-        .Mux         =  PORT_MUX_ALT5,                    /* Configure the pin mux mode as CAN          */
+        .Mux         =  Bus_Config[Bus].Mux,              /* Configure the pin mux mode as CAN          */
         .Interrupt   =  PORT_INT_DISABLED,                /* Disable interrupt for the pin              */
         .Pull        =  PORT_INTERNAL_PULL_NOT_ENABLED    /* Disable internal pull resistor for the pin */
     };
@@ -92,12 +423,14 @@ static void FLEXCAN_Pin_Init(void)
 }
 
 /**
-  * @brief      Initialize FLEXCAN0
-  * @param[in]  None
+  * @brief      Initialize the FlexCAN module of a CAN bus
+  * @param[in]  Bus: CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Bitrate: Bitrate (bit/s)
+  * @param[in]  Mode: FLEXCAN_NORMAL_MODE or FLEXCAN_LISTEN_ONLY_MODE
   * @param[out] None
   * @retval     None
   */
-static void FLEXCAN_ParamConfig(void)
+static void FLEXCAN_ParamConfig(uint8_t Bus, uint32_t Bitrate, flexcan_operation_modes_t Mode)
 {
     uint32_t CAN_ClkFreq = 0u;
 
@@ -105,14 +438,19 @@ static void FLEXCAN_ParamConfig(void)
     {
         .clkSrc = FLEXCAN_CLK_SRC_PERIPH,
         .flexcanClkFreq = CAN_ClkFreq,
-        .bitrate = FLEXCAN_BITRATE,
+        .bitrate = Bitrate,
+        .samplePoint = FLEXCAN_SAMPLE_POINT,
+        .rJumpWidth = FLEXCAN_SJW_AUTO,
         .rxMaskType = FLEXCAN_RX_MASK_INDIVIDUAL,
-        .flexcanMode = FLEXCAN_NORMAL_MODE
+        .flexcanMode = Mode,
+        .localPriority = 1u,                        /* Commands overtake confirmations, refer to @defgroup Local transmit priority */
+        .txArbStartDelay = FLEXCAN_TASD_DEFAULT,
+        .selfReception = 0u
     };
 
     if(moduleCfg.clkSrc == FLEXCAN_CLK_SRC_PERIPH)
     {
-        DRV_Clock_GetFrequency(FlexCAN0_CLK, &CAN_ClkFreq);
+        DRV_Clock_GetFrequency(Bus_Config[Bus].ClkName, &CAN_ClkFreq);
     }
     else
     {
@@ -124,72 +462,191 @@ static void FLEXCAN_ParamConfig(void)
         moduleCfg.flexcanClkFreq = CAN_ClkFreq;
     }
 
-    DRV_FLEXCAN_Init(FLEXCAN_INSTANCE, &moduleCfg, &handle);
+    DRV_FLEXCAN_Init(Bus, &moduleCfg, &handle[Bus]);
+    DRV_FLEXCAN_RegisterMbCallback(Bus, Bus_Notification[Bus]);
 }
 
+#if (CAN_AUTOBAUD_ENABLE == 1u)
 /**
-  * @brief      Initialize the transmit message buffers for CAN communication
-  * @param[in]  None
+  * @brief      Find the bitrate of a CAN bus, refer to @defgroup Auto-baud
+  * @param[in]  Bus: CAN bus, it can be a value of @defgroup CAN bus
   * @param[out] None
-  * @retval     None
+  * @retval     Locked bitrate, the cached or configured one if the bus stays silent
+  */
+static uint32_t FLEXCAN_AutoBaud(uint8_t Bus)
+{
+    FLEXCAN_BaudCache_t *cache = &Baud_Cache[Bus];
+    uint32_t bitrate = Bus_Config[Bus].Bitrate;
+    uint8_t cached = 0u;
+    uint8_t result = FLEXCAN_LISTEN_SILENT;
+    uint8_t index = 0u;
+
+    if ((cache->Magic == FLEXCAN_BAUD_CACHE_MAGIC) && (cache->Check == ~cache->Bitrate))
+    {
+        cached = 1u;
+        bitrate = cache->Bitrate;
+        /* The rate of the previous boot is the most likely one */
+        result = FLEXCAN_AutoBaudListen(Bus, bitrate);
+    }
+
+    for (index = 0u; (result != FLEXCAN_LISTEN_LOCKED) && (index < AUTOBAUD_BITRATE_COUNT); index++)
+    {
+        if ((cached == 0u) || (AutoBaud_Bitrate[index] != cache->Bitrate))
+        {
+            result = FLEXCAN_AutoBaudListen(Bus, AutoBaud_Bitrate[index]);
+            if (result == FLEXCAN_LISTEN_LOCKED)
+            {
+                bitrate = AutoBaud_Bitrate[index];
+            }
+        }
+    }
+
+    if (result == FLEXCAN_LISTEN_LOCKED)
+    {
+        cache->Magic = FLEXCAN_BAUD_CACHE_MAGIC;
+        cache->Bitrate = bitrate;
+        cache->Check = ~bitrate;
+    }
+    else
+    {
+        /* Do nothing */
+    }
+
+    return bitrate;
+}
+
+/**
+  * @brief      Listen to a CAN bus at one candidate bitrate
+  * @note       The window is counted in bit times on the FlexCAN free running timer,
+  *             it ends early on the first frame or receive error.
+  * @param[in]  Bus: CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Bitrate: Candidate bitrate (bit/s)
+  * @param[out] None
+  * @retval     FLEXCAN_LISTEN_LOCKED, FLEXCAN_LISTEN_ERROR or FLEXCAN_LISTEN_SILENT
   */
-static void FLEXCAN_Tx_Mb_Init(void)
+static uint8_t FLEXCAN_AutoBaudListen(uint8_t Bus, uint32_t Bitrate)
 {
-    /* Initialize Tx Message buffer to send confirm distance data to CAN Bus */
-    DRV_FLEXCAN_ConfigTxMb(FLEXCAN_INSTANCE, TX_CONFIRM_DISTANCE_DATA_MB, &mbCfg, TX_CONFIRM_DISTANCE_DATA_ID);
+    flexcan_mb_config_t probeCfg = { .idType = FLEXCAN_MB_ID_STD, .dataLength = FLEXCAN_D_LENGTH };
+    uint8_t result = FLEXCAN_LISTEN_SILENT;
+    uint32_t elapsed = 0u;
+    uint16_t last = 0u;
+    uint16_t now = 0u;
 
-    /* Initialize Tx Message buffer to send confirm rotation data to CAN Bus */
-    DRV_FLEXCAN_ConfigTxMb(FLEXCAN_INSTANCE, TX_CONFIRM_ROTATION_DATA_MB, &mbCfg, TX_CONFIRM_ROTATION_DATA_ID);
+    FLEXCAN_ParamConfig(Bus, Bitrate, FLEXCAN_LISTEN_ONLY_MODE);
 
-    /* Initialize Tx Message buffer to request connection state from Distance Node */
-    DRV_FLEXCAN_ConfigTxMb(FLEXCAN_INSTANCE, TX_RQ_CONNECT_DISTANCE_NODE_MB, &mbCfg, TX_RQ_CONNECT_DISTANCE_NODE_ID);
+    /* The IDE bit is always compared, one accept-all mailbox per ID format */
+    DRV_FLEXCAN_SetRxMbIndividualMask(Bus, FLEXCAN_MB_ID_STD, CAN_AUTOBAUD_PROBE_STD_MB, 0u);
+    DRV_FLEXCAN_ConfigRxMb(Bus, CAN_AUTOBAUD_PROBE_STD_MB, &probeCfg, 0u);
+    DRV_FLEXCAN_EnableMbInt(Bus, CAN_AUTOBAUD_PROBE_STD_MB);
+    probeCfg.idType = FLEXCAN_MB_ID_EXT;
+    DRV_FLEXCAN_SetRxMbIndividualMask(Bus, FLEXCAN_MB_ID_EXT, CAN_AUTOBAUD_PROBE_EXT_MB, 0u);
+    DRV_FLEXCAN_ConfigRxMb(Bus, CAN_AUTOBAUD_PROBE_EXT_MB, &probeCfg, 0u);
+    DRV_FLEXCAN_EnableMbInt(Bus, CAN_AUTOBAUD_PROBE_EXT_MB);
 
-    /* Initialize Tx Message buffer to request connection state from Rotation Node */
-    DRV_FLEXCAN_ConfigTxMb(FLEXCAN_INSTANCE, TX_RQ_CONNECT_ROTATION_NODE_MB, &mbCfg, TX_RQ_CONNECT_ROTATION_NODE_ID);
+    /* Drop the errors seen while the controller synchronized to the bus */
+    (void)DRV_FLEXCAN_GetRxErrorFlags(Bus);
+    last = DRV_FLEXCAN_GetTimer(Bus);
 
-    /* Initialize Tx Message buffer to send stop operation to Distance Node */
-    DRV_FLEXCAN_ConfigTxMb(FLEXCAN_INSTANCE, TX_STOPOPR_DISTANCE_NODE_MB, &mbCfg, TX_STOPOPR_DISTANCE_NODE_ID);
+    while ((result == FLEXCAN_LISTEN_SILENT) && (elapsed < CAN_AUTOBAUD_WINDOW_BITS))
+    {
+        if (DRV_FLEXCAN_GetRxErrorFlags(Bus) != 0u)
+        {
+            result = FLEXCAN_LISTEN_ERROR;
+        }
+        else if ((DRV_FLEXCAN_GetMbIntFlag(Bus, CAN_AUTOBAUD_PROBE_STD_MB) != 0u) ||
+                 (DRV_FLEXCAN_GetMbIntFlag(Bus, CAN_AUTOBAUD_PROBE_EXT_MB) != 0u))
+        {
+            result = FLEXCAN_LISTEN_LOCKED;
+        }
+        else
+        {
+            /* Do nothing */
+        }
 
-    /* Initialize Tx Message buffer to send stop operation to Rotation Node */
-    DRV_FLEXCAN_ConfigTxMb(FLEXCAN_INSTANCE, TX_STOPOPR_ROTATION_NODE_MB, &mbCfg, TX_STOPOPR_ROTATION_NODE_ID);
+        now = DRV_FLEXCAN_GetTimer(Bus);
+        elapsed += (uint16_t)(now - last);
+        last = now;
+    }
 
-    /* Initialize Tx Message buffer to send ping message to distance node to CAN Bus */
-    DRV_FLEXCAN_ConfigTxMb(FLEXCAN_INSTANCE, TX_PING_DISTANCE_NODE_MB, &mbCfg, TX_PING_DISTANCE_NODE_ID);
+    DRV_FLEXCAN_DisableMbInt(Bus, CAN_AUTOBAUD_PROBE_STD_MB);
+    DRV_FLEXCAN_DisableMbInt(Bus, CAN_AUTOBAUD_PROBE_EXT_MB);
+    DRV_FLEXCAN_ClearMbIntFlag(Bus, CAN_AUTOBAUD_PROBE_STD_MB);
+    DRV_FLEXCAN_ClearMbIntFlag(Bus, CAN_AUTOBAUD_PROBE_EXT_MB);
 
-    /* Initialize Tx Message buffer to send ping message to rotation node to CAN Bus */
-    DRV_FLEXCAN_ConfigTxMb(FLEXCAN_INSTANCE, TX_PING_ROTATION_NODE_MB, &mbCfg, TX_PING_ROTATION_NODE_ID);
+    return result;
 }
+#endif
 
 /**
-  * @brief      Initialize the receive message buffers for CAN communication
-  * @param[in]  None
+  * @brief      Get the message buffer of a logical mailbox of the sensor bus
+  * @param[in]  Mailbox: it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[out] None
+  * @retval     Message buffer index, CAN_MB_NONE if not allocated
+  */
+static uint8_t FLEXCAN_MailboxToMb(uint8_t Mailbox)
+{
+    uint8_t mb = CAN_MB_NONE;
+
+    if (Mailbox < CAN_MB_NUM)
+    {
+        mb = Mailbox_Map[Mailbox];
+    }
+
+    return mb;
+}
+
+/**
+  * @brief      Get the ID configured for a logical mailbox of the sensor bus
+  * @param[in]  Mailbox: it can be a value of @defgroup Mailboxes of the sensor bus
   * @param[out] None
+  * @retval     ID of the mailbox descriptor, 0 if not allocated
+  */
+static uint32_t FLEXCAN_MailboxToId(uint8_t Mailbox)
+{
+    uint32_t id = 0u;
+
+    if (Mailbox < CAN_MB_NUM)
+    {
+        id = Mailbox_Id[Mailbox];
+    }
+
+    return id;
+}
+
+/**
+  * @brief      Convert the data words of a message buffer to frame bytes
+  * @param[in]  Words: Data words, byte 0 is the most significant byte of word 0
+  * @param[out] Bytes: Frame bytes (CAN_MAX_DATA_LENGTH)
   * @retval     None
   */
-static void FLEXCAN_Rx_Mb_Init(void)
+static void FLEXCAN_WordsToBytes(const uint32_t *Words, uint8_t *Bytes)
 {
-    DRV_FLEXCAN_SetRxMbGlobalMask(FLEXCAN_INSTANCE, FLEXCAN_MB_ID_STD, GMASK_FILTER_ALL_ID);
+    uint8_t index = 0u;
+
+    for (index = 0u; index < CAN_MAX_DATA_LENGTH; index++)
+    {
+        Bytes[index] = (uint8_t)(Words[index / FLEXCAN_BYTES_PER_WORD] >> (24u - (8u * (index % FLEXCAN_BYTES_PER_WORD))));
+    }
+}
 
-    DRV_FLEXCAN_SetRxMbIndividualMask(FLEXCAN_INSTANCE, FLEXCAN_MB_ID_STD, RX_DISTANCE_DATA_MB, IMASK_FILTER_ALL_ID);
-    DRV_FLEXCAN_SetRxMbIndividualMask(FLEXCAN_INSTANCE, FLEXCAN_MB_ID_STD, RX_ROTATION_DATA_MB, IMASK_FILTER_ALL_ID);
-    DRV_FLEXCAN_SetRxMbIndividualMask(FLEXCAN_INSTANCE, FLEXCAN_MB_ID_STD, RX_CONFIRM_FROM_DISTANCE_NODE_MB, IMASK_FILTER_ALL_ID);
-    DRV_FLEXCAN_SetRxMbIndividualMask(FLEXCAN_INSTANCE, FLEXCAN_MB_ID_STD, RX_CONFIRM_FROM_ROTATION_NODE_MB, IMASK_FILTER_ALL_ID);
-    DRV_FLEXCAN_SetRxMbIndividualMask(FLEXCAN_INSTANCE, FLEXCAN_MB_ID_STD, RX_CONFIRM_PING_DISTANCE_NODE_MB, IMASK_FILTER_ALL_ID);
-    DRV_FLEXCAN_SetRxMbIndividualMask(FLEXCAN_INSTANCE, FLEXCAN_MB_ID_STD, RX_CONFIRM_PING_ROTATION_NODE_MB, IMASK_FILTER_ALL_ID);
+/**
+  * @brief      Convert frame bytes to the data words of a message buffer
+  * @param[in]  Bytes:  Frame bytes
+  * @param[in]  Length: Number of valid bytes, the remaining ones are sent as 0
+  * @param[out] Words:  Data words, byte 0 is the most significant byte of word 0
+  * @retval     None
+  */
+static void FLEXCAN_BytesToWords(const uint8_t *Bytes, uint8_t Length, uint32_t *Words)
+{
+    uint8_t index = 0u;
 
-    DRV_FLEXCAN_ConfigRxMb(FLEXCAN_INSTANCE, RX_DISTANCE_DATA_MB, &mbCfg, RX_DISTANCE_DATA_ID);
-    DRV_FLEXCAN_ConfigRxMb(FLEXCAN_INSTANCE, RX_ROTATION_DATA_MB, &mbCfg, RX_ROTATION_DATA_ID);
-    DRV_FLEXCAN_ConfigRxMb(FLEXCAN_INSTANCE, RX_CONFIRM_FROM_DISTANCE_NODE_MB, &mbCfg, RX_CONFIRM_FROM_DISTANCE_NODE_ID);
-    DRV_FLEXCAN_ConfigRxMb(FLEXCAN_INSTANCE, RX_CONFIRM_FROM_ROTATION_NODE_MB, &mbCfg, RX_CONFIRM_FROM_ROTATION_NODE_ID);
-    DRV_FLEXCAN_ConfigRxMb(FLEXCAN_INSTANCE, RX_CONFIRM_PING_DISTANCE_NODE_MB, &mbCfg, RX_CONFIRM_PING_DISTANCE_NODE_ID);
-    DRV_FLEXCAN_ConfigRxMb(FLEXCAN_INSTANCE, RX_CONFIRM_PING_ROTATION_NODE_MB, &mbCfg, RX_CONFIRM_PING_ROTATION_NODE_ID);
+    Words[0] = 0u;
+    Words[1] = 0u;
 
-    DRV_FLEXCAN_EnableMbInt(FLEXCAN_INSTANCE, RX_DISTANCE_DATA_MB);
-    DRV_FLEXCAN_EnableMbInt(FLEXCAN_INSTANCE, RX_ROTATION_DATA_MB);
-    DRV_FLEXCAN_EnableMbInt(FLEXCAN_INSTANCE, RX_CONFIRM_FROM_DISTANCE_NODE_MB);
-    DRV_FLEXCAN_EnableMbInt(FLEXCAN_INSTANCE, RX_CONFIRM_FROM_ROTATION_NODE_MB);
-    DRV_FLEXCAN_EnableMbInt(FLEXCAN_INSTANCE, RX_CONFIRM_PING_DISTANCE_NODE_MB);
-    DRV_FLEXCAN_EnableMbInt(FLEXCAN_INSTANCE, RX_CONFIRM_PING_ROTATION_NODE_MB);
+    for (index = 0u; index < Length; index++)
+    {
+        Words[index / FLEXCAN_BYTES_PER_WORD] |= ((uint32_t)Bytes[index] << (24u - (8u * (index % FLEXCAN_BYTES_PER_WORD))));
+    }
 }
 
 /**
@@ -200,92 +657,1361 @@ static void FLEXCAN_Rx_Mb_Init(void)
   */
 void MID_CAN_Init(void)
 {
-    FLEXCAN_Pin_Init();
-    FLEXCAN_ParamConfig();
-    FLEXCAN_Tx_Mb_Init();
-    FLEXCAN_Rx_Mb_Init();
+    MID_CAN_BusInit(CAN_SENSOR_BUS);
+    MID_CAN_MailboxInit();
+
+#if (CAN_GATEWAY_ENABLE == 1u)
+    FLEXCAN_Gateway_Init();
+#endif
 }
 
 /**
-  * @brief      Initialize all Message Buffers for CAN communication
-  * @param[in]  None
+  * @brief      Initialize the pins and the FlexCAN module of a CAN bus, all mailboxes inactive
+  * @note       Detects the bitrate first when CAN_AUTOBAUD_ENABLE is 1u
+  * @param[in]  Bus CAN bus, it can be a value of @defgroup CAN bus
   * @param[out] None
   * @retval     None
   */
-void MID_CAN_MailboxInit(void)
+void MID_CAN_BusInit(uint8_t Bus)
 {
-    FLEXCAN_Tx_Mb_Init();
-    FLEXCAN_Rx_Mb_Init();
+    FLEXCAN_Pin_Init(Bus);
+#if (CAN_AUTOBAUD_ENABLE == 1u)
+    Bus_Bitrate[Bus] = FLEXCAN_AutoBaud(Bus);
+#else
+    Bus_Bitrate[Bus] = Bus_Config[Bus].Bitrate;
+#endif
+    FLEXCAN_ParamConfig(Bus, Bus_Bitrate[Bus], FLEXCAN_NORMAL_MODE);
 }
 
 /**
-  * @brief      Register a callback function for receiving CAN messages
-  * @param[in]  cb_ptr Pointer to the callback function
+  * @brief      Get the bitrate a CAN bus runs at, refer to @defgroup Auto-baud
+  * @param[in]  Bus: CAN bus, it can be a value of @defgroup CAN bus
+  * @param[out] None
+  * @retval     Bitrate (bit/s)
+  */
+uint32_t MID_CAN_GetBitrate(uint8_t Bus)
+{
+    return Bus_Bitrate[Bus];
+}
+
+/**
+  * @brief      Configure a transmit mailbox of a CAN bus
+  * @param[in]  Bus CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Mb  Index of the mailbox
+  * @param[in]  Id  ID of the frames sent from the mailbox
   * @param[out] None
   * @retval     None
   */
-void MID_CAN_RegisterRxNotificationCallback(void (*cb_ptr)(void))
+void MID_CAN_BusConfigTxMailbox(uint8_t Bus, uint8_t Mb, uint32_t Id)
 {
-    DRV_FLEXCAN_RegisterMbCallback(FLEXCAN_INSTANCE, cb_ptr);
+    DRV_FLEXCAN_ConfigTxMb(Bus, Mb, &mbCfg, Id);
 }
 
 /**
-  * @brief      Register a callback function for the CAN bus-off event
-  * @param[in]  cb_ptr Pointer to the callback function
+  * @brief      Set the local priority of a transmit mailbox of a CAN bus
+  * @note       The mailbox must not hold a pending frame
+  * @param[in]  Bus CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Mb  Index of the mailbox
+  * @param[in]  Priority it can be a value of @defgroup Local transmit priority
   * @param[out] None
   * @retval     None
   */
-void MID_CAN_RegisterBusOffNotificationCallback(void (*cb_ptr)(void))
+void MID_CAN_BusSetTxPriority(uint8_t Bus, uint8_t Mb, uint8_t Priority)
 {
-    DRV_FLEXCAN_RegisterBusOffCallback(FLEXCAN_INSTANCE, cb_ptr);
+    DRV_FLEXCAN_SetTxMbPriority(Bus, Mb, Priority);
 }
 
 /**
-  * @brief      Receive a CAN message from the specified mailbox
-  * @param[in]  mbIdx Index of the mailbox to receive from
-  * @param[out] data Pointer to the data structure to store received message
+  * @brief      Set the local priority of a transmit mailbox of the sensor bus
+  * @note       The mailbox must not hold a pending frame, refer to MID_CAN_IsTxMailboxBusy()
+  * @param[in]  Tx_Mb it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Priority it can be a value of @defgroup Local transmit priority
+  * @param[out] None
   * @retval     None
   */
-void MID_CAN_ReceiveMessage(uint8_t mbIdx, Data_Typedef *data)
+void MID_CAN_SetTxPriority(uint8_t Tx_Mb, uint8_t Priority)
 {
-    DRV_FLEXCAN_ReceiveInt(FLEXCAN_INSTANCE, mbIdx, &Receive_Message);
+    uint8_t mb = FLEXCAN_MailboxToMb(Tx_Mb);
 
-    data->ID = Receive_Message.msgId;
-    data->Data = Receive_Message.data[0];
+    if (mb != CAN_MB_NONE)
+    {
+        MID_CAN_BusSetTxPriority(CAN_SENSOR_BUS, mb, Priority);
+    }
+    else
+    {
+        /* Do nothing */
+    }
 }
 
 /**
-  * @brief      Send a CAN message from the specified mailbox
-  * @param[in]  Tx_Mb Index of the transmit mailbox
-  * @param[in]  Data  Data to be sent
+  * @brief      Configure a receive mailbox of a CAN bus and enable its interrupt
+  * @param[in]  Bus  CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Mb   Index of the mailbox
+  * @param[in]  Id   ID accepted by the mailbox
+  * @param[in]  Mask ID bits compared (1) or ignored (0), IMASK_FILTER_ALL_ID for an exact match
   * @param[out] None
   * @retval     None
   */
-void MID_CAN_SendCANMessage(uint8_t Tx_Mb, int16_t Data)
+void MID_CAN_BusConfigRxMailbox(uint8_t Bus, uint8_t Mb, uint32_t Id, uint32_t Mask)
+{
+    DRV_FLEXCAN_SetRxMbIndividualMask(Bus, mbCfg.idType, Mb, Mask);
+    DRV_FLEXCAN_ConfigRxMb(Bus, Mb, &mbCfg, Id);
+    DRV_FLEXCAN_EnableMbInt(Bus, Mb);
+}
+
+/**
+  * @brief      Split an ID range into acceptance filters, refer to @defgroup Acceptance filter
+  * @param[in]  FirstId    First accepted ID
+  * @param[in]  LastId     Last accepted ID
+  * @param[out] Filters    Filters covering exactly the range
+  * @param[in]  MaxFilters Size of Filters
+  * @retval     Number of filters, 0 if the range is empty or needs more than MaxFilters
+  */
+uint8_t MID_CAN_RangeToFilters(uint32_t FirstId, uint32_t LastId, CAN_Filter_t *Filters, uint8_t MaxFilters)
 {
-    Transmit_Message.data[0] = Data;
+    uint8_t count = 0u;
+    uint32_t id = FirstId;
+    uint32_t blockSize = 0u;
+    uint8_t done = 0u;
+
+    if ((FirstId > LastId) || (LastId > CAN_ID_MASK))
+    {
+        done = 1u;
+    }
+
+    while (done == 0u)
+    {
+        /* Largest block aligned on id that does not run past LastId */
+        blockSize = (id == 0u) ? (CAN_ID_MASK + 1u) : (id & (~id + 1u));
+        while ((blockSize - 1u) > (LastId - id))
+        {
+            blockSize >>= 1u;
+        }
 
-    DRV_FLEXCAN_Transmit(FLEXCAN_INSTANCE, Tx_Mb, &Transmit_Message);
+        if (count < MaxFilters)
+        {
+            Filters[count].Id = id;
+            Filters[count].Mask = CAN_ID_MASK & ~(blockSize - 1u);
+            count++;
+        }
+        else
+        {
+            count = 0u;
+            done = 1u;
+        }
+
+        if (done == 0u)
+        {
+            if ((LastId - id) == (blockSize - 1u))
+            {
+                done = 1u;
+            }
+            else
+            {
+                id += blockSize;
+            }
+        }
+    }
+
+    return count;
 }
 
 /**
-  * @brief      Clear message event for a specific mailbox
-  * @param[in]  Mailbox Index of the mailbox
+  * @brief      Configure consecutive receive mailboxes of a CAN bus to accept an ID range
+  * @param[in]  Bus     CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  FirstMb Index of the first mailbox
+  * @param[in]  MbCount Number of mailboxes available from FirstMb
+  * @param[in]  FirstId First accepted ID
+  * @param[in]  LastId  Last accepted ID
+  * @param[out] None
+  * @retval     Number of mailboxes configured, 0 if the range does not fit (no mailbox touched)
+  */
+uint8_t MID_CAN_BusConfigRxRange(uint8_t Bus, uint8_t FirstMb, uint8_t MbCount, uint32_t FirstId, uint32_t LastId)
+{
+    CAN_Filter_t filters[CAN_FILTER_MAX];
+    uint8_t count = 0u;
+    uint8_t index = 0u;
+
+    if (MbCount > CAN_FILTER_MAX)
+    {
+        MbCount = CAN_FILTER_MAX;
+    }
+
+    count = MID_CAN_RangeToFilters(FirstId, LastId, filters, MbCount);
+
+    for (index = 0u; index < count; index++)
+    {
+        MID_CAN_BusConfigRxMailbox(Bus, (uint8_t)(FirstMb + index), filters[index].Id, filters[index].Mask);
+    }
+
+    return count;
+}
+
+/**
+  * @brief      Initialize all Message Buffers for CAN communication from the default table
+  * @param[in]  None
   * @param[out] None
   * @retval     None
   */
-void MID_ClearMessageCommingEvent(uint8_t Mailbox)
+void MID_CAN_MailboxInit(void)
 {
-    DRV_FLEXCAN_ClearMbIntFlag(FLEXCAN_INSTANCE, Mailbox);
+    (void)MID_CAN_MailboxConfigure(Default_Mailbox_Table, (uint8_t)(sizeof(Default_Mailbox_Table) / sizeof(Default_Mailbox_Table[0])));
 }
 
 /**
-  * @brief      Check if a message event occurred in the specified mailbox
-  * @param[in]  Mailbox Index of the mailbox
+  * @brief      Allocate the message buffers of the sensor bus from a descriptor table
+  * @note       Runs in freeze mode, may be called at runtime: every message buffer is
+  *             deactivated, then descriptor k configures message buffer k. Logical
+  *             mailboxes missing from the table are left without message buffer.
+  * @param[in]  Table Descriptors, in message buffer order
+  * @param[in]  Count Number of descriptors (up to CAN_MAILBOX_COUNT)
   * @param[out] None
-  * @retval     Status of the message event (1 if occurred, 0 otherwise)
+  * @retval     Number of message buffers allocated, 0 if the table does not fit (nothing changed)
   */
-uint8_t MID_CheckCommingMessageEvent(uint8_t Mailbox)
+uint8_t MID_CAN_MailboxConfigure(const CAN_MailboxDesc_t *Table, uint8_t Count)
 {
-    return DRV_FLEXCAN_GetMbIntFlag(FLEXCAN_INSTANCE, Mailbox);
+    uint8_t mb = 0u;
+    uint8_t mbCount = DRV_FLEXCAN_GetMbCount(CAN_SENSOR_BUS);
+    uint8_t index = 0u;
+    uint8_t allocated = 0u;
+    const CAN_MailboxDesc_t *desc = NULL;
+
+    if (Count <= mbCount)
+    {
+        DRV_FLEXCAN_EnterFreeze(CAN_SENSOR_BUS);
+
+        for (mb = 0u; mb < mbCount; mb++)
+        {
+            DRV_FLEXCAN_DeactivateMb(CAN_SENSOR_BUS, mb);
+        }
+
+        for (index = 0u; index < CAN_MB_NUM; index++)
+        {
+            Mailbox_Map[index] = CAN_MB_NONE;
+            Mailbox_Id[index] = 0u;
+            Tx_Track[index].Pending = 0u;
+            Tx_Track[index].Abort = TX_ABORT_NONE;
+        }
+        Tx_Queue_Num = 0u;
+
+        DRV_FLEXCAN_SetRxMbGlobalMask(CAN_SENSOR_BUS, mbCfg.idType, GMASK_FILTER_ALL_ID);
+
+        for (mb = 0u; mb < Count; mb++)
+        {
+            desc = &Table[mb];
+
+            if (desc->Mailbox < CAN_MB_NUM)
+            {
+                if (desc->Type == CAN_MB_TYPE_TX)
+                {
+                    MID_CAN_BusConfigTxMailbox(CAN_SENSOR_BUS, mb, desc->Id);
+                    MID_CAN_BusSetTxPriority(CAN_SENSOR_BUS, mb, desc->Priority);
+                }
+                else if (desc->Type == CAN_MB_TYPE_RX)
+                {
+                    MID_CAN_BusConfigRxMailbox(CAN_SENSOR_BUS, mb, desc->Id, desc->Mask);
+                }
+                else
+                {
+                    MID_CAN_BusConfigRemoteAnswer(CAN_SENSOR_BUS, mb, desc->Id, desc->Payload, desc->Length);
+                }
+
+                Mailbox_Map[desc->Mailbox] = mb;
+                Mailbox_Id[desc->Mailbox] = desc->Id;
+                allocated++;
+            }
+            else
+            {
+                /* Do nothing */
+            }
+        }
+
+        DRV_FLEXCAN_ExitFreeze(CAN_SENSOR_BUS);
+    }
+
+    return allocated;
+}
+
+/**
+  * @brief      Get the message buffer allocated to a logical mailbox of the sensor bus
+  * @param[in]  Mailbox it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[out] None
+  * @retval     Message buffer index, CAN_MB_NONE if not allocated
+  */
+uint8_t MID_CAN_GetMailboxIndex(uint8_t Mailbox)
+{
+    return FLEXCAN_MailboxToMb(Mailbox);
+}
+
+/**
+  * @brief      Switch the operation mode of a CAN bus
+  * @param[in]  Bus  CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Mode it can be a value of @defgroup CAN operation mode
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_BusSetMode(uint8_t Bus, uint8_t Mode)
+{
+    switch (Mode)
+    {
+    case CAN_MODE_LISTEN_ONLY:
+        DRV_FLEXCAN_SetOperationMode(Bus, FLEXCAN_LISTEN_ONLY_MODE);
+        break;
+
+    case CAN_MODE_LOOPBACK:
+        DRV_FLEXCAN_SetOperationMode(Bus, FLEXCAN_LOOPBACK_MODE);
+        break;
+
+    default:
+        DRV_FLEXCAN_SetOperationMode(Bus, FLEXCAN_NORMAL_MODE);
+        break;
+    }
+}
+
+/**
+  * @brief      Register a callback function for receiving CAN messages
+  * @param[in]  cb_ptr Pointer to the callback function
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_RegisterRxNotificationCallback(void (*cb_ptr)(void))
+{
+    MID_CAN_BusRegisterRxNotificationCallback(CAN_SENSOR_BUS, cb_ptr);
+}
+
+/**
+  * @brief      Register a callback function for receiving CAN messages on a CAN bus
+  * @param[in]  Bus    CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  cb_ptr Pointer to the callback function
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_BusRegisterRxNotificationCallback(uint8_t Bus, void (*cb_ptr)(void))
+{
+    Rx_Callback[Bus] = cb_ptr;
+}
+
+/**
+  * @brief      Register a callback function for the CAN bus-off event
+  * @param[in]  cb_ptr Pointer to the callback function
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_RegisterBusOffNotificationCallback(void (*cb_ptr)(void))
+{
+    DRV_FLEXCAN_RegisterBusOffCallback(FLEXCAN_INSTANCE, cb_ptr);
+}
+
+/**
+  * @brief      Register a callback function for error warning and bus-off recovery done events
+  * @param[in]  cb_ptr Pointer to the callback function
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_RegisterErrorStateNotificationCallback(void (*cb_ptr)(void))
+{
+    DRV_FLEXCAN_RegisterErrorStateCallback(FLEXCAN_INSTANCE, cb_ptr);
+}
+
+/**
+  * @brief      Run the error state notification once more on the next bus error
+  * @note       The error interrupt masks itself after one error, an erroneous frame
+  *             repeated on the bus would raise it at every attempt otherwise.
+  * @param[in]  None
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_EnableErrorNotification(void)
+{
+    DRV_FLEXCAN_EnableErrorInt(FLEXCAN_INSTANCE);
+}
+
+/**
+  * @brief      Get the current error state of the CAN controller
+  * @param[in]  None
+  * @param[out] None
+  * @retval     Error state, it can be a value of @defgroup CAN error state
+  */
+uint8_t MID_CAN_GetErrorState(void)
+{
+    uint8_t retVal = CAN_ERROR_ACTIVE;
+    uint8_t txErrCnt = 0u;
+    uint8_t rxErrCnt = 0u;
+
+    switch (DRV_FLEXCAN_GetFaultState(FLEXCAN_INSTANCE))
+    {
+    case FLEXCAN_BUS_OFF:
+        retVal = CAN_BUS_OFF;
+        break;
+
+    case FLEXCAN_ERROR_PASSIVE:
+        retVal = CAN_ERROR_PASSIVE;
+        break;
+
+    default:
+        /* Warning is not a fault confinement state, derive it from the counters */
+        DRV_FLEXCAN_GetErrorCounters(FLEXCAN_INSTANCE, &txErrCnt, &rxErrCnt);
+        if ((txErrCnt >= CAN_ERROR_WARNING_LIMIT) || (rxErrCnt >= CAN_ERROR_WARNING_LIMIT))
+        {
+            retVal = CAN_ERROR_WARNING;
+        }
+        break;
+    }
+
+    return retVal;
+}
+
+/**
+  * @brief      Get the transmit and receive error counters
+  * @param[in]  None
+  * @param[out] TxErrCnt Transmit error counter
+  * @param[out] RxErrCnt Receive error counter
+  * @retval     None
+  */
+void MID_CAN_GetErrorCounters(uint8_t *TxErrCnt, uint8_t *RxErrCnt)
+{
+    DRV_FLEXCAN_GetErrorCounters(FLEXCAN_INSTANCE, TxErrCnt, RxErrCnt);
+}
+
+/**
+  * @brief      Select how the CAN controller leaves the bus-off state
+  * @param[in]  Mode it can be a value of @defgroup Bus-off recovery mode
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_SetBusOffRecovery(uint8_t Mode)
+{
+    if (Mode == CAN_BUSOFF_RECOVERY_MANUAL)
+    {
+        DRV_FLEXCAN_SetBusOffRecovery(FLEXCAN_INSTANCE, FLEXCAN_BUSOFF_RECOVERY_MANUAL);
+    }
+    else
+    {
+        DRV_FLEXCAN_SetBusOffRecovery(FLEXCAN_INSTANCE, FLEXCAN_BUSOFF_RECOVERY_AUTO);
+    }
+}
+
+/**
+  * @brief      Start the bus-off recovery when manual recovery is selected
+  * @param[in]  None
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_RecoverBusOff(void)
+{
+    DRV_FLEXCAN_RecoverBusOff(FLEXCAN_INSTANCE);
+}
+
+/**
+  * @brief      Receive a CAN message from the specified mailbox
+  * @param[in]  mbIdx Mailbox to receive from, it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[out] data Pointer to the data structure to store received message
+  * @retval     None
+  */
+void MID_CAN_ReceiveMessage(uint8_t mbIdx, Data_Typedef *data)
+{
+    uint8_t mb = FLEXCAN_MailboxToMb(mbIdx);
+
+    if (mb != CAN_MB_NONE)
+    {
+        MID_CAN_BusReceiveMessage(CAN_SENSOR_BUS, mb, data);
+    }
+}
+
+/**
+  * @brief      Receive a CAN message from the specified mailbox of a CAN bus
+  * @param[in]  Bus   CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  mbIdx Index of the mailbox to receive from
+  * @param[out] data  Pointer to the data structure to store received message
+  * @retval     None
+  */
+void MID_CAN_BusReceiveMessage(uint8_t Bus, uint8_t mbIdx, Data_Typedef *data)
+{
+    const flexcan_frame_t *frame = DRV_FLEXCAN_ReceiveInt(Bus, mbIdx);
+    uint32_t length = FLEXCAN_FRAME_DLC(frame);
+
+    data->ID = FLEXCAN_FRAME_ID(frame);
+    data->Data = frame->data[0];
+    data->IdType = FLEXCAN_FRAME_IS_EXT(frame) ? CAN_ID_EXTENDED : CAN_ID_STANDARD;
+    data->Length = (length > CAN_MAX_DATA_LENGTH) ? CAN_MAX_DATA_LENGTH : (uint8_t)length;
+
+    FLEXCAN_WordsToBytes(frame->data, data->Payload);
+
+    /* The 16-bit capture wraps every 65536 bit times, a mailbox is always read well within that */
+    data->TimeStamp = (uint16_t)FLEXCAN_FRAME_TIME_STAMP(frame);
+    data->AgeUs = FLEXCAN_BITS_TO_US((uint16_t)(DRV_FLEXCAN_GetTimer(Bus) - data->TimeStamp), Bus_Bitrate[Bus]);
+    data->Overrun = (FLEXCAN_FRAME_CODE(frame) == FLEXCAN_RX_OVERRUN) ? 1u : 0u;
+}
+
+/**
+  * @brief      Read the loss counters of a receive mailbox of a CAN bus, counted since initialization
+  * @note       An overrun means at least one frame was overwritten before the mailbox was read,
+  *             a busy read means the mailbox was read while a frame was moving in
+  * @param[in]  Bus     CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Mb      Index of the mailbox
+  * @param[out] Overrun Number of overruns
+  * @param[out] Busy    Number of busy reads
+  * @retval     None
+  */
+void MID_CAN_BusGetMailboxLoss(uint8_t Bus, uint8_t Mb, uint32_t *Overrun, uint32_t *Busy)
+{
+    DRV_FLEXCAN_GetMbLossCounters(Bus, Mb, Overrun, Busy);
+}
+
+/**
+  * @brief      Send a CAN message from the specified mailbox
+  * @param[in]  Tx_Mb Transmit mailbox, it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Data  Data to be sent
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_SendCANMessage(uint8_t Tx_Mb, int16_t Data)
+{
+    MID_CAN_SendCANMessageDeadline(Tx_Mb, Data, CAN_TX_DEADLINE_NONE);
+}
+
+/**
+  * @brief      Send a CAN message that becomes obsolete after a deadline, refer to @defgroup Transmit deadline
+  * @param[in]  Tx_Mb      Transmit mailbox, it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Data       Data to be sent
+  * @param[in]  DeadlineUs Time the frame may wait for the bus (us), CAN_TX_DEADLINE_NONE for no limit
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_SendCANMessageDeadline(uint8_t Tx_Mb, int16_t Data, uint32_t DeadlineUs)
+{
+    MID_CAN_SendCANMessageToId(Tx_Mb, FLEXCAN_MailboxToId(Tx_Mb), Data, DeadlineUs);
+}
+
+/**
+  * @brief      Send a CAN message with the ID of a node from a mailbox of its class, refer to @defgroup Transmit deadline
+  * @note       The legacy layout: Data in word 0 of the message buffer, word 1 cleared, FLEXCAN_D_LENGTH bytes
+  * @param[in]  Tx_Mb      Transmit mailbox, it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Id         ID of the frame
+  * @param[in]  Data       Data to be sent
+  * @param[in]  DeadlineUs Time the frame may wait for the bus (us), CAN_TX_DEADLINE_NONE for no limit
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_SendCANMessageToId(uint8_t Tx_Mb, uint32_t Id, int16_t Data, uint32_t DeadlineUs)
+{
+    uint32_t words[2] = {(uint32_t)Data, 0u};
+    uint8_t payload[CAN_MAX_DATA_LENGTH] = {0u};
+
+    FLEXCAN_WordsToBytes(words, payload);
+    MID_CAN_SendCANFrameToId(Tx_Mb, Id, payload, FLEXCAN_D_LENGTH, DeadlineUs);
+}
+
+/**
+  * @brief      Send a CAN frame with an explicit payload and data length
+  * @param[in]  Tx_Mb   Transmit mailbox, it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Payload Pointer to the data bytes, byte 0 is sent first
+  * @param[in]  Length  Number of data bytes (0..8)
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_SendCANFrame(uint8_t Tx_Mb, const uint8_t *Payload, uint8_t Length)
+{
+    MID_CAN_SendCANFrameDeadline(Tx_Mb, Payload, Length, CAN_TX_DEADLINE_NONE);
+}
+
+/**
+  * @brief      Send a CAN frame that becomes obsolete after a deadline, refer to @defgroup Transmit deadline
+  * @param[in]  Tx_Mb      Transmit mailbox, it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Payload    Pointer to the data bytes, byte 0 is sent first
+  * @param[in]  Length     Number of data bytes (0..8)
+  * @param[in]  DeadlineUs Time the frame may wait for the bus (us), CAN_TX_DEADLINE_NONE for no limit
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_SendCANFrameDeadline(uint8_t Tx_Mb, const uint8_t *Payload, uint8_t Length, uint32_t DeadlineUs)
+{
+    MID_CAN_SendCANFrameToId(Tx_Mb, FLEXCAN_MailboxToId(Tx_Mb), Payload, Length, DeadlineUs);
+}
+
+/**
+  * @brief      Send a CAN frame with the ID of a node from a mailbox of its class, refer to @defgroup Transmit deadline
+  * @param[in]  Tx_Mb      Transmit mailbox, it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Id         ID of the frame
+  * @param[in]  Payload    Pointer to the data bytes, byte 0 is sent first
+  * @param[in]  Length     Number of data bytes (0..8)
+  * @param[in]  DeadlineUs Time the frame may wait for the bus (us), CAN_TX_DEADLINE_NONE for no limit
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_SendCANFrameToId(uint8_t Tx_Mb, uint32_t Id, const uint8_t *Payload, uint8_t Length, uint32_t DeadlineUs)
+{
+    FLEXCAN_TxFrame_t frame = {0u};
+    uint8_t index = 0u;
+
+    if (Length > CAN_MAX_DATA_LENGTH)
+    {
+        Length = CAN_MAX_DATA_LENGTH;
+    }
+
+    frame.Id          = Id;
+    frame.Mailbox     = Tx_Mb;
+    frame.Length      = Length;
+    frame.RequestTime = DRV_FLEXCAN_GetTimer(CAN_SENSOR_BUS);
+    frame.Deadline    = MID_Timer_GetTimestamp() + MID_Timer_UsToTicks(DeadlineUs);
+    frame.HasDeadline = (DeadlineUs != CAN_TX_DEADLINE_NONE) ? 1u : 0u;
+
+    for (index = 0u; index < Length; index++)
+    {
+        frame.Data[index] = Payload[index];
+    }
+
+    FLEXCAN_TxRequest(&frame);
+}
+
+/**
+  * @brief      Account for sent frames and abort the expired ones, called from the main loop
+  * @note       Runs on NOTIFY_EVENT_CAN_TX, NOTIFY_EVENT_ALARM and every TIMER_TICK_MS, the alarm
+  *             is set to the earliest deadline left.
+  * @param[in]  None
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_ProcessTxDeadlines(void)
+{
+    uint8_t mailbox = 0u;
+    uint8_t mb = CAN_MB_NONE;
+    uint32_t now = MID_Timer_GetTimestamp();
+
+    for (mailbox = 0u; mailbox < CAN_MB_NUM; mailbox++)
+    {
+        mb = Mailbox_Map[mailbox];
+
+        if ((Tx_Track[mailbox].Pending == 1u) && (mb != CAN_MB_NONE))
+        {
+            if (Tx_Track[mailbox].Abort != TX_ABORT_NONE)
+            {
+                /* Requested on an earlier pass while the message buffer was busy */
+                (void)FLEXCAN_TxAbort(mailbox, mb, Tx_Track[mailbox].Abort);
+            }
+            else if (DRV_FLEXCAN_IsTxMbPending(CAN_SENSOR_BUS, mb) == 0u)
+            {
+                FLEXCAN_TxSent(mailbox, mb);
+            }
+            else if ((Tx_Track[mailbox].HasDeadline == 1u) && ((int32_t)(now - Tx_Track[mailbox].Deadline) >= 0))
+            {
+                (void)FLEXCAN_TxAbort(mailbox, mb, TX_ABORT_EXPIRED);
+            }
+            else
+            {
+                /* Do nothing */
+            }
+        }
+    }
+
+    FLEXCAN_TxQueueService(now);
+    FLEXCAN_TxSetAlarm(now);
+}
+
+/**
+  * @brief      Get the transmit counters of the sensor bus
+  * @param[in]  None
+  * @param[out] Stats Transmit counters
+  * @retval     None
+  */
+void MID_CAN_GetTxStats(CAN_TxStats_t *Stats)
+{
+    uint32_t bitrate = Bus_Bitrate[CAN_SENSOR_BUS];
+
+    Stats->SentCnt      = Tx_Sent_Cnt;
+    Stats->ExpiredCnt   = Tx_Expired_Cnt;
+    Stats->ReplacedCnt  = Tx_Replaced_Cnt;
+    Stats->BlockedCnt   = Tx_Blocked_Cnt;
+    Stats->LatencyAvgUs = 0u;
+    if (Tx_Sent_Cnt != 0u)
+    {
+        Stats->LatencyAvgUs = FLEXCAN_BITS_TO_US((uint32_t)(Tx_Latency_Sum / Tx_Sent_Cnt), bitrate);
+    }
+    Stats->LatencyMaxUs = FLEXCAN_BITS_TO_US(Tx_Latency_Max, bitrate);
+}
+
+/**
+  * @brief      Make a transmit mailbox of the sensor bus free for a new frame
+  * @note       A pending frame is aborted and counted as replaced, unless it went out meanwhile.
+  *             The wait for a frame on the bus is bounded by CAN_TX_ABORT_WAIT_BITS, a longer
+  *             one means bus-off or freeze: the new frame is dropped and counted as blocked.
+  * @param[in]  Mailbox: it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Mb:      Message buffer of the mailbox
+  * @param[out] None
+  * @retval     1 if the message buffer is free, 0 if the abort is still in progress
+  */
+static uint8_t FLEXCAN_TxRelease(uint8_t Mailbox, uint8_t Mb)
+{
+    uint32_t start = MID_Timer_GetTimestamp();
+    uint32_t wait = MID_Timer_UsToTicks(FLEXCAN_BITS_TO_US(CAN_TX_ABORT_WAIT_BITS, Bus_Bitrate[CAN_SENSOR_BUS]));
+    uint8_t released = FLEXCAN_TxAbort(Mailbox, Mb, TX_ABORT_REPLACED);
+
+    while ((released == 0u) && ((MID_Timer_GetTimestamp() - start) < wait))
+    {
+        released = FLEXCAN_TxAbort(Mailbox, Mb, TX_ABORT_REPLACED);
+    }
+
+    if (released == 0u)
+    {
+        Tx_Blocked_Cnt++;
+    }
+    else
+    {
+        /* Do nothing */
+    }
+
+    return released;
+}
+
+/**
+  * @brief      Request or complete the abort of the frame in a transmit mailbox of the sensor bus
+  * @note       Frames sent without tracking, e.g. through the bus API, are withdrawn silently
+  * @param[in]  Mailbox: it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Mb:      Message buffer of the mailbox
+  * @param[in]  Reason:  it can be a value of @defgroup Transmit abort, kept from the first request
+  * @param[out] None
+  * @retval     1 if the message buffer is free, 0 if the abort is still in progress
+  */
+static uint8_t FLEXCAN_TxAbort(uint8_t Mailbox, uint8_t Mb, uint8_t Reason)
+{
+    flexcan_abort_status_t status = DRV_FLEXCAN_AbortTxMb(CAN_SENSOR_BUS, Mb);
+    FLEXCAN_TxTrack_t *track = &Tx_Track[Mailbox];
+
+    if (track->Pending == 1u)
+    {
+        if (track->Abort == TX_ABORT_NONE)
+        {
+            track->Abort = Reason;
+        }
+
+        if (status == FLEXCAN_ABORT_DONE)
+        {
+            if (track->Abort == TX_ABORT_EXPIRED)
+            {
+                Tx_Expired_Cnt++;
+            }
+            else
+            {
+                Tx_Replaced_Cnt++;
+            }
+            track->Pending = 0u;
+            track->Abort = TX_ABORT_NONE;
+        }
+        else if (status != FLEXCAN_ABORT_PENDING)
+        {
+            FLEXCAN_TxSent(Mailbox, Mb);
+            track->Abort = TX_ABORT_NONE;
+        }
+        else
+        {
+            /* The abort request cleared the flag, the end of the abort raises the interrupt again */
+            DRV_FLEXCAN_EnableMbInt(CAN_SENSOR_BUS, Mb);
+        }
+    }
+    else
+    {
+        /* Do nothing */
+    }
+
+    return (status != FLEXCAN_ABORT_PENDING) ? 1u : 0u;
+}
+
+/**
+  * @brief      Hand a frame to a transmit mailbox of the sensor bus or queue it, refer to @defgroup Transmit deadline
+  * @note       A frame with the ID of the pending one replaces it. A frame for another ID waits in
+  *             the queue while the mailbox is busy, and behind the queued frames of the mailbox.
+  * @param[in]  Frame: Frame to send, RequestTime and Deadline already set
+  * @param[out] None
+  * @retval     None
+  */
+static void FLEXCAN_TxRequest(const FLEXCAN_TxFrame_t *Frame)
+{
+    FLEXCAN_TxTrack_t *track = NULL;
+    uint8_t mb = FLEXCAN_MailboxToMb(Frame->Mailbox);
+    uint8_t queued = 0u;
+    uint8_t index = 0u;
+
+    if (mb != CAN_MB_NONE)
+    {
+        track = &Tx_Track[Frame->Mailbox];
+
+        /* Account for a frame that went out since the last pass */
+        if ((track->Pending == 1u) && (track->Abort == TX_ABORT_NONE) && (DRV_FLEXCAN_IsTxMbPending(CAN_SENSOR_BUS, mb) == 0u))
+        {
+            FLEXCAN_TxSent(Frame->Mailbox, mb);
+        }
+
+        for (index = 0u; (index < Tx_Queue_Num) && (queued == 0u); index++)
+        {
+            queued = (Tx_Queue[index].Mailbox == Frame->Mailbox) ? 1u : 0u;
+        }
+
+        if ((queued == 1u) || ((track->Pending == 1u) && (track->Id != Frame->Id)))
+        {
+            FLEXCAN_TxQueuePut(Frame);
+            FLEXCAN_TxQueueService(MID_Timer_GetTimestamp());
+        }
+        else if (FLEXCAN_TxRelease(Frame->Mailbox, mb) == 1u)
+        {
+            FLEXCAN_TxStart(mb, Frame);
+        }
+        else
+        {
+            /* Do nothing */
+        }
+
+        if (Frame->HasDeadline == 1u)
+        {
+            FLEXCAN_TxSetAlarm(MID_Timer_GetTimestamp());
+        }
+        else
+        {
+            /* Do nothing */
+        }
+    }
+}
+
+/**
+  * @brief      Write a frame to a free transmit mailbox of the sensor bus and start tracking it
+  * @param[in]  Mb:    Message buffer of the mailbox
+  * @param[in]  Frame: Frame to send
+  * @param[out] None
+  * @retval     None
+  */
+static void FLEXCAN_TxStart(uint8_t Mb, const FLEXCAN_TxFrame_t *Frame)
+{
+    flexcan_mb_t *message = &Transmit_Message[CAN_SENSOR_BUS];
+    FLEXCAN_TxTrack_t *track = &Tx_Track[Frame->Mailbox];
+
+    message->msgId = Frame->Id;
+    message->idType = mbCfg.idType;
+    message->dataLength = Frame->Length;
+    FLEXCAN_BytesToWords(Frame->Data, Frame->Length, message->data);
+
+    DRV_FLEXCAN_TransmitId(CAN_SENSOR_BUS, Mb, message);
+
+    track->Id          = Frame->Id;
+    track->RequestTime = Frame->RequestTime;
+    track->Deadline    = Frame->Deadline;
+    track->HasDeadline = Frame->HasDeadline;
+    track->Abort       = TX_ABORT_NONE;
+    track->Pending     = 1u;
+
+    /* Completion raises NOTIFY_EVENT_CAN_TX once, refer to FLEXCAN_TxNotification() */
+    DRV_FLEXCAN_EnableMbInt(CAN_SENSOR_BUS, Mb);
+}
+
+/**
+  * @brief      Put a frame in the transmit queue, it replaces the queued one of the same mailbox and ID
+  * @note       A full queue drops the frame, it is counted as blocked
+  * @param[in]  Frame: Frame to queue
+  * @param[out] None
+  * @retval     None
+  */
+static void FLEXCAN_TxQueuePut(const FLEXCAN_TxFrame_t *Frame)
+{
+    uint8_t index = 0u;
+
+    while ((index < Tx_Queue_Num) && ((Tx_Queue[index].Mailbox != Frame->Mailbox) || (Tx_Queue[index].Id != Frame->Id)))
+    {
+        index++;
+    }
+
+    if (index < Tx_Queue_Num)
+    {
+        Tx_Queue[index] = *Frame;
+        Tx_Replaced_Cnt++;
+    }
+    else if (Tx_Queue_Num < CAN_TX_QUEUE_SIZE)
+    {
+        Tx_Queue[Tx_Queue_Num] = *Frame;
+        Tx_Queue_Num++;
+    }
+    else
+    {
+        Tx_Blocked_Cnt++;
+    }
+}
+
+/**
+  * @brief      Drop the expired frames of the transmit queue and hand the oldest frame of every
+  *             free mailbox to it
+  * @param[in]  Now: Time base value
+  * @param[out] None
+  * @retval     None
+  */
+static void FLEXCAN_TxQueueService(uint32_t Now)
+{
+    const FLEXCAN_TxFrame_t *frame = NULL;
+    uint8_t index = 0u;
+    uint8_t kept = 0u;
+    uint8_t mb = CAN_MB_NONE;
+
+    for (index = 0u; index < Tx_Queue_Num; index++)
+    {
+        frame = &Tx_Queue[index];
+        mb = FLEXCAN_MailboxToMb(frame->Mailbox);
+
+        if ((frame->HasDeadline == 1u) && ((int32_t)(Now - frame->Deadline) >= 0))
+        {
+            Tx_Expired_Cnt++;
+        }
+        else if ((Tx_Track[frame->Mailbox].Pending == 0u) && (DRV_FLEXCAN_IsTxMbPending(CAN_SENSOR_BUS, mb) == 0u))
+        {
+            /* The mailbox is pending from now on, its next frames keep waiting */
+            FLEXCAN_TxStart(mb, frame);
+        }
+        else
+        {
+            Tx_Queue[kept] = *frame;
+            kept++;
+        }
+    }
+
+    Tx_Queue_Num = kept;
+}
+
+/**
+  * @brief      Account for a frame that went out on the bus
+  * @note       The latency uses the time stamp captured by the controller at transmission,
+  *             it is valid for frames sent within 65536 bit times of the request
+  * @param[in]  Mailbox: it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Mb:      Message buffer of the mailbox
+  * @param[out] None
+  * @retval     None
+  */
+static void FLEXCAN_TxSent(uint8_t Mailbox, uint8_t Mb)
+{
+    uint16_t latency = (uint16_t)(DRV_FLEXCAN_GetMbTimeStamp(CAN_SENSOR_BUS, Mb) - Tx_Track[Mailbox].RequestTime);
+
+    Tx_Sent_Cnt++;
+    Tx_Latency_Sum += latency;
+    if (latency > Tx_Latency_Max)
+    {
+        Tx_Latency_Max = latency;
+    }
+
+    Tx_Track[Mailbox].Pending = 0u;
+}
+
+/**
+  * @brief      Set the alarm to the earliest deadline of the tracked and queued frames
+  * @note       The alarm wakes MID_CAN_ProcessTxDeadlines() up for a deadline shorter than
+  *             TIMER_TICK_MS, no alarm is set while no frame has a deadline.
+  * @param[in]  Now: Time base value
+  * @param[out] None
+  * @retval     None
+  */
+static void FLEXCAN_TxSetAlarm(uint32_t Now)
+{
+    uint32_t left = 0xFFFFFFFFu;
+    uint32_t remaining = 0u;
+    uint8_t found = 0u;
+    uint8_t index = 0u;
+
+    for (index = 0u; index < CAN_MB_NUM; index++)
+    {
+        if ((Tx_Track[index].Pending == 1u) && (Tx_Track[index].HasDeadline == 1u) && (Tx_Track[index].Abort == TX_ABORT_NONE))
+        {
+            remaining = ((int32_t)(Tx_Track[index].Deadline - Now) > 0) ? (Tx_Track[index].Deadline - Now) : 0u;
+            left = (remaining < left) ? remaining : left;
+            found = 1u;
+        }
+    }
+
+    for (index = 0u; index < Tx_Queue_Num; index++)
+    {
+        if (Tx_Queue[index].HasDeadline == 1u)
+        {
+            remaining = ((int32_t)(Tx_Queue[index].Deadline - Now) > 0) ? (Tx_Queue[index].Deadline - Now) : 0u;
+            left = (remaining < left) ? remaining : left;
+            found = 1u;
+        }
+    }
+
+    if (found == 1u)
+    {
+        MID_Timer_SetAlarm(left);
+    }
+    else
+    {
+        /* Do nothing */
+    }
+}
+
+/**
+  * @brief      Check whether a transmit mailbox of the sensor bus still waits for the bus
+  * @param[in]  Tx_Mb Transmit mailbox, it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[out] None
+  * @retval     1 if the previous frame is not sent yet, 0 otherwise
+  */
+uint8_t MID_CAN_IsTxMailboxBusy(uint8_t Tx_Mb)
+{
+    uint8_t mb = FLEXCAN_MailboxToMb(Tx_Mb);
+    uint8_t busy = 0u;
+
+    if (mb != CAN_MB_NONE)
+    {
+        busy = MID_CAN_BusIsTxMailboxBusy(CAN_SENSOR_BUS, mb);
+    }
+
+    return busy;
+}
+
+/**
+  * @brief      Send a CAN frame with an explicit payload and data length on a CAN bus
+  * @param[in]  Bus     CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Tx_Mb   Index of the transmit mailbox
+  * @param[in]  Payload Pointer to the data bytes, byte 0 is sent first
+  * @param[in]  Length  Number of data bytes (0..8)
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_BusSendCANFrame(uint8_t Bus, uint8_t Tx_Mb, const uint8_t *Payload, uint8_t Length)
+{
+    flexcan_mb_t *message = &Transmit_Message[Bus];
+
+    if (Length > CAN_MAX_DATA_LENGTH)
+    {
+        Length = CAN_MAX_DATA_LENGTH;
+    }
+
+    FLEXCAN_BytesToWords(Payload, Length, message->data);
+    message->dataLength = Length;
+
+    DRV_FLEXCAN_Transmit(Bus, Tx_Mb, message);
+}
+
+/**
+  * @brief      Send a remote request frame from a mailbox of the sensor bus, refer to @defgroup Ping mode
+  * @note       The mailbox is set to receive on Id before the request, the answer is received in it
+  * @param[in]  Mb     Mailbox, it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[in]  Id     ID of the request and of the answer
+  * @param[in]  Length Data length requested from the answering node
+  * @param[out] None
+  * @retval     1 if the request is sent, 0 if the mailbox still waits for an answer or holds an unread one
+  */
+uint8_t MID_CAN_SendRemoteRequest(uint8_t Mb, uint32_t Id, uint8_t Length)
+{
+    uint8_t mb = FLEXCAN_MailboxToMb(Mb);
+    uint8_t sent = 0u;
+
+    if ((mb != CAN_MB_NONE) &&
+        (DRV_FLEXCAN_IsTxMbPending(CAN_SENSOR_BUS, mb) == 0u) &&
+        (DRV_FLEXCAN_GetMbIntFlag(CAN_SENSOR_BUS, mb) == 0u))
+    {
+        /* The individual mask of the mailbox is kept, the answer of any node it accepts is received */
+        DRV_FLEXCAN_ConfigRxMb(CAN_SENSOR_BUS, mb, &mbCfg, Id);
+        DRV_FLEXCAN_TransmitRemote(CAN_SENSOR_BUS, mb, Length);
+        sent = 1u;
+    }
+    else
+    {
+        /* Do nothing */
+    }
+
+    return sent;
+}
+
+/**
+  * @brief      Configure a mailbox of a CAN bus answering remote request frames in hardware
+  * @param[in]  Bus     CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Mb      Index of the mailbox
+  * @param[in]  Id      ID of the remote request and of the answer
+  * @param[in]  Payload Answer data bytes
+  * @param[in]  Length  Number of bytes (limited to CAN_MAX_DATA_LENGTH)
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_BusConfigRemoteAnswer(uint8_t Bus, uint8_t Mb, uint32_t Id, const uint8_t *Payload, uint8_t Length)
+{
+    flexcan_mb_t answer = {0u};
+
+    if (Length > CAN_MAX_DATA_LENGTH)
+    {
+        Length = CAN_MAX_DATA_LENGTH;
+    }
+
+    FLEXCAN_BytesToWords(Payload, Length, answer.data);
+    answer.dataLength = Length;
+
+    DRV_FLEXCAN_ConfigRemoteAnswerMb(Bus, Mb, &mbCfg, Id, &answer);
+}
+
+/**
+  * @brief      Check whether a transmit mailbox of a CAN bus still waits for the bus
+  * @param[in]  Bus   CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Tx_Mb Index of the transmit mailbox
+  * @param[out] None
+  * @retval     1 if the previous frame is not sent yet, 0 otherwise
+  */
+uint8_t MID_CAN_BusIsTxMailboxBusy(uint8_t Bus, uint8_t Tx_Mb)
+{
+    return DRV_FLEXCAN_IsTxMbPending(Bus, Tx_Mb);
+}
+
+/**
+  * @brief      Pack 16-bit signals into a payload, refer to @defgroup Data payload layout
+  * @param[in]  Signals Pointer to the signal values
+  * @param[in]  Count   Number of signals (limited to CAN_MAX_SIGNALS)
+  * @param[out] Payload Pointer to the payload buffer (CAN_MAX_DATA_LENGTH bytes)
+  * @retval     Data length of the packed frame
+  */
+uint8_t MID_CAN_PackSignals(const uint16_t *Signals, uint8_t Count, uint8_t *Payload)
+{
+    uint8_t index = 0u;
+
+    if (Count > CAN_MAX_SIGNALS)
+    {
+        Count = CAN_MAX_SIGNALS;
+    }
+
+    for (index = 0u; index < Count; index++)
+    {
+        Payload[(index * CAN_SIGNAL_SIZE) + 0u] = (uint8_t)(Signals[index] >> 8u);
+        Payload[(index * CAN_SIGNAL_SIZE) + 1u] = (uint8_t)(Signals[index]);
+    }
+
+    return (uint8_t)(Count * CAN_SIGNAL_SIZE);
+}
+
+/**
+  * @brief      Unpack 16-bit signals from a payload, refer to @defgroup Data payload layout
+  * @param[in]  Payload   Pointer to the data bytes
+  * @param[in]  Length    Data length of the frame
+  * @param[in]  StartByte Byte offset of the first signal
+  * @param[out] Signals   Pointer to the signal buffer (CAN_MAX_SIGNALS entries)
+  * @retval     Number of complete signals found in the frame
+  */
+uint8_t MID_CAN_UnpackSignals(const uint8_t *Payload, uint8_t Length, uint8_t StartByte, uint16_t *Signals)
+{
+    uint8_t count = 0u;
+
+    while ((StartByte + CAN_SIGNAL_SIZE) <= Length)
+    {
+        Signals[count] = (uint16_t)(((uint16_t)Payload[StartByte] << 8u) | Payload[StartByte + 1u]);
+        StartByte += CAN_SIGNAL_SIZE;
+        count++;
+    }
+
+    return count;
+}
+
+/**
+  * @brief      Clear message event for a specific mailbox
+  * @param[in]  Mailbox Mailbox, it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[out] None
+  * @retval     None
+  */
+void MID_ClearMessageCommingEvent(uint8_t Mailbox)
+{
+    uint8_t mb = FLEXCAN_MailboxToMb(Mailbox);
+
+    if (mb != CAN_MB_NONE)
+    {
+        MID_CAN_BusClearMessageCommingEvent(CAN_SENSOR_BUS, mb);
+    }
+}
+
+/**
+  * @brief      Clear message event for a specific mailbox of a CAN bus
+  * @param[in]  Bus     CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Mailbox Index of the mailbox
+  * @param[out] None
+  * @retval     None
+  */
+void MID_CAN_BusClearMessageCommingEvent(uint8_t Bus, uint8_t Mailbox)
+{
+    DRV_FLEXCAN_ClearMbIntFlag(Bus, Mailbox);
+}
+
+/**
+  * @brief      Check if a message event occurred in the specified mailbox
+  * @param[in]  Mailbox Mailbox, it can be a value of @defgroup Mailboxes of the sensor bus
+  * @param[out] None
+  * @retval     Status of the message event (1 if occurred, 0 otherwise)
+  */
+uint8_t MID_CheckCommingMessageEvent(uint8_t Mailbox)
+{
+    uint8_t mb = FLEXCAN_MailboxToMb(Mailbox);
+    uint8_t event = CAN_MSG_NO_RECEIVED;
+
+    if (mb != CAN_MB_NONE)
+    {
+        event = MID_CAN_BusCheckCommingMessageEvent(CAN_SENSOR_BUS, mb);
+    }
+
+    return event;
+}
+
+/**
+  * @brief      Check if a message event occurred in the specified mailbox of a CAN bus
+  * @param[in]  Bus     CAN bus, it can be a value of @defgroup CAN bus
+  * @param[in]  Mailbox Index of the mailbox
+  * @param[out] None
+  * @retval     Status of the message event (1 if occurred, 0 otherwise)
+  */
+uint8_t MID_CAN_BusCheckCommingMessageEvent(uint8_t Bus, uint8_t Mailbox)
+{
+    return DRV_FLEXCAN_GetMbIntFlag(Bus, Mailbox);
+}
+
+/**
+  * @brief      Get the gateway counters
+  * @param[in]  None
+  * @param[out] Forwarded Number of frames forwarded between buses
+  * @param[out] Dropped   Number of frames dropped because the destination mailbox was still busy
+  * @retval     None
+  */
+void MID_CAN_GetGatewayCounters(uint32_t *Forwarded, uint32_t *Dropped)
+{
+#if (CAN_GATEWAY_ENABLE == 1u)
+    *Forwarded = Gateway_Forward_Cnt;
+    *Dropped   = Gateway_Drop_Cnt;
+#else
+    *Forwarded = 0u;
+    *Dropped   = 0u;
+#endif
+}
+
+/**
+  * @brief      Message buffer notification of one bus, serves the routes then the user callback
+  * @param[in]  Bus CAN bus, it can be a value of @defgroup CAN bus
+  * @param[out] None
+  * @retval     None
+  */
+static void FLEXCAN_BusNotification(uint8_t Bus)
+{
+#if (CAN_GATEWAY_ENABLE == 1u)
+    /* Routed frames first, they are forwarded straight from the interrupt */
+    FLEXCAN_Gateway_Process(Bus);
+#endif
+
+    if (Bus == CAN_SENSOR_BUS)
+    {
+        FLEXCAN_TxNotification();
+    }
+
+    if (Rx_Callback[Bus] != NULL)
+    {
+        Rx_Callback[Bus]();
+    }
+}
+
+/**
+  * @brief      Hand the completed transmit mailboxes of the sensor bus to the main loop
+  * @note       The interrupt of the message buffer is disabled until its next frame or abort. The
+  *             flag is left set, MID_CAN_ProcessTxDeadlines() tells a done abort from a sent frame by it.
+  * @param[in]  None
+  * @param[out] None
+  * @retval     None
+  */
+static void FLEXCAN_TxNotification(void)
+{
+    uint8_t mailbox = 0u;
+    uint8_t mb = CAN_MB_NONE;
+    uint8_t done = 0u;
+
+    for (mailbox = 0u; mailbox < CAN_MB_NUM; mailbox++)
+    {
+        mb = Mailbox_Map[mailbox];
+
+        if ((Tx_Track[mailbox].Pending == 1u) && (mb != CAN_MB_NONE) && (DRV_FLEXCAN_GetMbIntFlag(CAN_SENSOR_BUS, mb) != 0u))
+        {
+            DRV_FLEXCAN_DisableMbInt(CAN_SENSOR_BUS, mb);
+            done = 1u;
+        }
+    }
+
+    if (done == 1u)
+    {
+        MID_Notification_Raise(NOTIFY_EVENT_CAN_TX);
+    }
+    else
+    {
+        /* Do nothing */
+    }
+}
+
+/**
+  * @brief      Driver callbacks of each bus, they only carry the bus to FLEXCAN_BusNotification()
+  * @param[in]  None
+  * @param[out] None
+  * @retval     None
+  */
+static void FLEXCAN_Bus0_Notification(void)
+{
+    FLEXCAN_BusNotification(CAN_BUS_0);
+}
+
+static void FLEXCAN_Bus1_Notification(void)
+{
+    FLEXCAN_BusNotification(CAN_BUS_1);
+}
+
+static void FLEXCAN_Bus2_Notification(void)
+{
+    FLEXCAN_BusNotification(CAN_BUS_2);
+}
+
+#if (CAN_GATEWAY_ENABLE == 1u)
+/**
+  * @brief      Bring up the gateway buses and the mailboxes of every route
+  * @param[in]  None
+  * @param[out] None
+  * @retval     None
+  */
+static void FLEXCAN_Gateway_Init(void)
+{
+    uint8_t index = 0u;
+
+    MID_CAN_BusInit(CAN_BUS_1);
+    MID_CAN_BusInit(CAN_BUS_2);
+
+    for (index = 0u; index < ROUTE_COUNT; index++)
+    {
+        MID_CAN_BusConfigRxMailbox(Routing_Table[index].SrcBus, Routing_Table[index].SrcMb, Routing_Table[index].SrcId, Routing_Table[index].SrcMask);
+        MID_CAN_BusConfigTxMailbox(Routing_Table[index].DstBus, Routing_Table[index].DstMb, Routing_Table[index].DstId);
+    }
+}
+
+/**
+  * @brief      Forward the frames received on one bus according to the routing table
+  * @note       The frame is copied word by word from mailbox to mailbox, without byte conversion.
+  * @param[in]  Bus CAN bus, it can be a value of @defgroup CAN bus
+  * @param[out] None
+  * @retval     None
+  */
+static void FLEXCAN_Gateway_Process(uint8_t Bus)
+{
+    uint8_t index = 0u;
+    const CAN_Route_t *route = NULL;
+    const flexcan_frame_t *frame = NULL;
+
+    for (index = 0u; index < ROUTE_COUNT; index++)
+    {
+        route = &Routing_Table[index];
+
+        if ((route->SrcBus == Bus) && (DRV_FLEXCAN_GetMbIntFlag(Bus, route->SrcMb) != 0u))
+        {
+            frame = DRV_FLEXCAN_ReceiveInt(Bus, route->SrcMb);
+            DRV_FLEXCAN_ClearMbIntFlag(Bus, route->SrcMb);
+
+            if (DRV_FLEXCAN_IsTxMbPending(route->DstBus, route->DstMb) != 0u)
+            {
+                Gateway_Drop_Cnt++;
+            }
+            else
+            {
+                Gateway_Message.msgId = (route->DstId != CAN_GATEWAY_KEEP_ID) ? route->DstId : FLEXCAN_FRAME_ID(frame);
+                Gateway_Message.idType = FLEXCAN_FRAME_IS_EXT(frame) ? FLEXCAN_MB_ID_EXT : FLEXCAN_MB_ID_STD;
+                Gateway_Message.data[0] = frame->data[0];
+                Gateway_Message.data[1] = frame->data[1];
+                Gateway_Message.dataLength = FLEXCAN_FRAME_DLC(frame);
+                DRV_FLEXCAN_TransmitId(route->DstBus, route->DstMb, &Gateway_Message);
+                Gateway_Forward_Cnt++;
+            }
+        }
+    }
 }
+#endif
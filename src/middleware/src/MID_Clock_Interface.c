@@ -5,7 +5,7 @@
  * Definition
  ******************************************************************************/
 
-#define NUM_OF_PERIPHERAL_CLOCKS_0     (6U)
+#define NUM_OF_PERIPHERAL_CLOCKS_0     (9U)
 #define CLOCK_SOURCE_NONE              (0U)
 
 /*******************************************************************************
@@ -27,6 +27,12 @@ void MID_Clock_Init(void)
 {
     peripheral_clk_config_t peripheralClockConfig0[NUM_OF_PERIPHERAL_CLOCKS_0] =
     {
+        {
+            .clockName   = PORTA_CLK,
+            .enableClock = true,
+            .clkSrc      = CLOCK_SOURCE_NONE
+        }
+        ,
         {
             .clockName   = PORTC_CLK,
             .enableClock = true,
@@ -51,6 +57,18 @@ void MID_Clock_Init(void)
             .clkSrc      = CLOCK_SOURCE_NONE
         }
         ,
+        {
+            .clockName   = FlexCAN1_CLK,
+            .enableClock = true,
+            .clkSrc      = CLOCK_SOURCE_NONE
+        }
+        ,
+        {
+            .clockName   = FlexCAN2_CLK,
+            .enableClock = true,
+            .clkSrc      = CLOCK_SOURCE_NONE
+        }
+        ,
         {
             .clockName   = LPUART1_CLK,
             .enableClock = true,
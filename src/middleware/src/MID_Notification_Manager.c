@@ -1,9 +1,18 @@
+#include "s32_core_cm4.h"
 #include "DRV_S32K144_NVIC.h"
 #include "MID_Notification_Manager.h"
+#include "MID_CAN_Interface.h"
+#include "MID_Timer_Interface.h"
 
 /*******************************************************************************
  * Definition
  ******************************************************************************/
+#define CPU_LOAD_FULL_SCALE     1000u   /* CPU load is given in per mille */
+
+/* Read PRIMASK, the host build of the simulator provides its own in s32_core_cm4.h */
+#ifndef GET_PRIMASK
+#define GET_PRIMASK(primask)    __asm volatile ("mrs %0, primask" : "=r" (primask))
+#endif
 
 /*******************************************************************************
  * Prototypes
@@ -13,6 +22,17 @@
  * Variables
  ******************************************************************************/
 
+/* Work raised by the interrupts and not yet taken by the main loop */
+static volatile uint32_t Pending_Events = 0u;
+
+/* Time base value at the end of the last sleep or at the start of the interval */
+static uint32_t Busy_Start = 0u;
+
+/* Time spent awake and asleep in the current interval (LPIT ticks) */
+static uint64_t Busy_Ticks = 0u;
+static uint64_t Sleep_Ticks = 0u;
+static uint32_t Wakeup_Cnt = 0u;
+
 /*******************************************************************************
  * Code
  ******************************************************************************/
@@ -27,5 +47,147 @@ void MID_EnableNotification(void)
 {
     NVIC_EnableIRQ(LPUART1_RxTx_IRQn);
     NVIC_EnableIRQ(LPIT0_Ch0_IRQn);
+    NVIC_EnableIRQ(LPIT0_Ch2_IRQn);
     NVIC_EnableIRQ(CAN0_ORed_0_15_MB_IRQn);
+    NVIC_EnableIRQ(CAN0_ORed_16_31_MB_IRQn);
+    NVIC_EnableIRQ(CAN0_ORed_IRQn);
+    NVIC_EnableIRQ(CAN0_Error_IRQn);
+
+#if (CAN_GATEWAY_ENABLE == 1u)
+    NVIC_EnableIRQ(CAN1_ORed_0_15_MB_IRQn);
+    NVIC_EnableIRQ(CAN2_ORed_0_15_MB_IRQn);
+#endif
+
+    Busy_Start = MID_Timer_GetTimestamp();
+}
+
+/**
+  * @brief      Mark work as pending, callable from interrupts and from the main loop
+  * @param[in]  Events: it can be a combination of @defgroup Pending work event
+  * @param[out] None
+  * @retval     None
+  */
+void MID_Notification_Raise(uint32_t Events)
+{
+    uint32_t primask = MID_Notification_EnterCritical();
+
+    Pending_Events |= Events;
+
+    MID_Notification_ExitCritical(primask);
+}
+
+/**
+  * @brief      Fetch and clear the pending work
+  * @param[in]  None
+  * @param[out] None
+  * @retval     Pending events, a combination of @defgroup Pending work event
+  */
+uint32_t MID_Notification_Take(void)
+{
+    uint32_t events = 0u;
+    uint32_t primask = MID_Notification_EnterCritical();
+
+    events = Pending_Events;
+    Pending_Events = 0u;
+
+    MID_Notification_ExitCritical(primask);
+
+    return events;
+}
+
+/**
+  * @brief      Sleep until the next interrupt, unless work is already pending
+  * @note       Interrupts are masked from the check to the WFI, an event raised meanwhile
+  *             stays pending in the NVIC and ends the WFI at once. The interrupt runs
+  *             after the sleep time is taken.
+  * @param[in]  None
+  * @param[out] None
+  * @retval     None
+  */
+void MID_Notification_WaitForEvent(void)
+{
+    uint32_t sleepStart = 0u;
+    uint32_t sleepEnd = 0u;
+
+    DISABLE_INTERRUPTS();
+
+    if (Pending_Events == 0u)
+    {
+        sleepStart = MID_Timer_GetTimestamp();
+        STANDBY();
+        sleepEnd = MID_Timer_GetTimestamp();
+
+        Busy_Ticks  += (uint32_t)(sleepStart - Busy_Start);
+        Sleep_Ticks += (uint32_t)(sleepEnd - sleepStart);
+        Busy_Start   = sleepEnd;
+        Wakeup_Cnt++;
+    }
+    else
+    {
+        /* Do nothing */
+    }
+
+    ENABLE_INTERRUPTS();
+}
+
+/**
+  * @brief      Get the CPU load since the previous call and start a new interval
+  * @param[in]  None
+  * @param[out] WakeupCnt: Number of wake-ups from sleep in the interval
+  * @retval     Time not spent sleeping, in per mille of the interval
+  */
+uint32_t MID_Notification_GetCpuLoad(uint32_t *WakeupCnt)
+{
+    uint32_t now = MID_Timer_GetTimestamp();
+    uint32_t load = CPU_LOAD_FULL_SCALE;
+    uint64_t busy = Busy_Ticks + (uint32_t)(now - Busy_Start);
+
+    if ((busy + Sleep_Ticks) != 0u)
+    {
+        load = (uint32_t)((busy * CPU_LOAD_FULL_SCALE) / (busy + Sleep_Ticks));
+    }
+
+    *WakeupCnt = Wakeup_Cnt;
+
+    /* Start a new interval */
+    Busy_Start  = now;
+    Busy_Ticks  = 0u;
+    Sleep_Ticks = 0u;
+    Wakeup_Cnt  = 0u;
+
+    return load;
+}
+
+/**
+  * @brief      Mask the interrupts, for the data an interrupt handler shares with the main loop
+  * @param[in]  None
+  * @param[out] None
+  * @retval     PRIMASK before masking, to be given to MID_Notification_ExitCritical()
+  */
+uint32_t MID_Notification_EnterCritical(void)
+{
+    uint32_t primask = 0u;
+
+    GET_PRIMASK(primask);
+    DISABLE_INTERRUPTS();
+
+    return primask;
+}
+
+/**
+  * @brief      Unmask the interrupts, unless they were masked by the caller already
+  * @param[in]  primask: Value returned by MID_Notification_EnterCritical()
+  * @param[out] None
+  * @retval     None
+  */
+void MID_Notification_ExitCritical(uint32_t primask)
+{
+    if (primask == 0u)
+    {
+        ENABLE_INTERRUPTS();
+    }
+    else
+    {
+        /* Do nothing */
+    }
 }
@@ -2,6 +2,7 @@
  * Includes
  ******************************************************************************/
 #include "MID_ReceiveQueue_Interface.h"
+#include "MID_Notification_Manager.h"
 
 /*******************************************************************************
  * Definition
@@ -46,6 +47,7 @@ void MID_Receive_Queue_Init( void )
     {
         receiveQueue.queueArray[index].ID   = 0u;
         receiveQueue.queueArray[index].Data = 0u;
+        receiveQueue.queueArray[index].Length = 0u;
     }
 }
 
@@ -75,6 +77,9 @@ QueueCheckOperation_t MID_Receive_EnQueue( const ReceiveFrame_t *const pInData )
             receiveQueue.queueArray[receiveQueue.rear] = *pInData;
             (receiveQueue.capacity)++;
             status = QUEUE_DONE_SUCCESS;
+
+            /* Wake the main loop up to dispatch the frame */
+            MID_Notification_Raise(NOTIFY_EVENT_RECEIVE);
         }
         else
         {
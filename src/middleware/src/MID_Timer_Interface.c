@@ -1,32 +1,40 @@
 #include "DRV_S32K144_LPIT.h"
 #include "DRV_S32K144_MCU.h"
 #include "MID_Timer_Interface.h"
+#include "MID_Notification_Manager.h"
 
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
-#define RELOAD_PERIOD_MS   100u  /* Timer period in milliseconds */
+#define RELOAD_PERIOD_MS   TIMER_TICK_MS  /* Timer period in milliseconds */
 #define MS_TO_SECOND       1000u /* Conversion factor from milliseconds to seconds */
+#define US_TO_SECOND       1000000u /* Conversion factor from microseconds to seconds */
+
+#define TIMESTAMP_RELOAD   0u    /* Reload value 0 gives TVAL = 0xFFFFFFFF, a full 32-bit period */
+#define TIMESTAMP_MAX      0xFFFFFFFFu
 
 #define TIMEOUT_THRESHOLD    10u /* Timeout threshold for triggering events */
-#define COUNTER_INSTANCE     5u
 
 /*******************************************************************************
  * Prototypes
  ******************************************************************************/
 static void TimeoutCounter_Notification(void);
+static void Alarm_Notification(void);
 
 /*******************************************************************************
  * Variables
  ******************************************************************************/
 /* Array contain timeout counter of all instance */
-static volatile uint8_t Timeout_Counter[COUNTER_INSTANCE] = {0u};
+static volatile uint8_t Timeout_Counter[TIMEOUT_SLOT_NUM] = {0u};
 
 /* Array contain counter gate of all instance */
-static volatile Functional_State Counter_Gate[COUNTER_INSTANCE] = {DISABLE};
+static volatile Functional_State Counter_Gate[TIMEOUT_SLOT_NUM] = {DISABLE};
 
 /* Array contain timeout event of all instance */
-static volatile Event_Typedef Timeout_Event[COUNTER_INSTANCE] = {EVENT_NONE};
+static volatile Event_Typedef Timeout_Event[TIMEOUT_SLOT_NUM] = {EVENT_NONE};
+
+/* Number of LPIT ticks per microsecond, used to convert timestamps */
+static uint32_t Ticks_Per_Us = 1u;
 
 /*******************************************************************************
  * Code
@@ -76,6 +84,30 @@ void MID_Timer_Init(void)
 
     /* Register the callback for timer expiration */
     DRV_LPIT0_RegisterIntCallback(TIMEOUT_COUNTER_CHANNEL, TimeoutCounter_Notification);
+
+    /* Configure the free running time base, no interrupt is needed */
+    DRV_LPIT_StopTimerChannel(LPIT_INSTANCE, TIMESTAMP_CHANNEL);
+
+    LPIT_InitStructure.LPIT_Interupt = DISABLE;
+
+    DRV_LPIT_Init(LPIT_INSTANCE, TIMESTAMP_CHANNEL, &LPIT_InitStructure);
+    DRV_LPIT_SetReloadValue(LPIT_INSTANCE, TIMESTAMP_CHANNEL, TIMESTAMP_RELOAD);
+
+    /* Configure the alarm, started by MID_Timer_SetAlarm() and stopped at its first time-out */
+    DRV_LPIT_StopTimerChannel(LPIT_INSTANCE, ALARM_CHANNEL);
+
+    LPIT_InitStructure.LPIT_Interupt = ENABLE;
+
+    DRV_LPIT_Init(LPIT_INSTANCE, ALARM_CHANNEL, &LPIT_InitStructure);
+    DRV_LPIT0_RegisterIntCallback(ALARM_CHANNEL, Alarm_Notification);
+
+    if ((LPIT_Freq / US_TO_SECOND) != 0U)
+    {
+        Ticks_Per_Us = LPIT_Freq / US_TO_SECOND;
+    }
+
+    /* Timestamps are valid from initialization on */
+    DRV_LPIT_StartTimerChannel(LPIT_INSTANCE, TIMESTAMP_CHANNEL);
 }
 
 /**
@@ -108,8 +140,11 @@ static void TimeoutCounter_Notification(void)
 {
     uint8_t index = 0u;
 
+    /* Time driven work of the main loop */
+    MID_Notification_Raise(NOTIFY_EVENT_TICK);
+
     /* Increment counters if the respective gates are enabled */
-    for(index = 0u; index < COUNTER_INSTANCE; index++)
+    for(index = 0u; index < TIMEOUT_SLOT_NUM; index++)
     {
         if(Counter_Gate[index] == ENABLE)
         {
@@ -119,21 +154,40 @@ static void TimeoutCounter_Notification(void)
     }
 
     /* Check and set timeout events if thresholds are exceeded */
-    for(index = 0u; index < COUNTER_INSTANCE; index++)
+    for(index = 0u; index < TIMEOUT_SLOT_NUM; index++)
     {
         if(Timeout_Counter[index] > TIMEOUT_THRESHOLD)
         {
             /* Raise event */
             Timeout_Event[index] = EVENT_SET;
         }
+
+        if(Timeout_Event[index] == EVENT_SET)
+        {
+            /* Wake the main loop up while an event waits for handling */
+            MID_Notification_Raise(NOTIFY_EVENT_TIMEOUT);
+        }
     }
 }
 
+/**
+  * @brief  Callback function triggered when the alarm expires, the alarm only fires once.
+  *
+  * @param  None
+  * @retval None
+  */
+static void Alarm_Notification(void)
+{
+    DRV_LPIT_StopTimerChannel(LPIT_INSTANCE, ALARM_CHANNEL);
+
+    MID_Notification_Raise(NOTIFY_EVENT_ALARM);
+}
+
 /**
   * @brief     Writes a timeout event for a specific instance.
   *
   * @param[in] instance: The instance index for which the event is being set.
-  *            this parameter can be a value of @defgroup Flag represent to Timeout Event
+  *            this parameter can be a value of @defgroup Flag represent to Timeout Event or @defgroup Timeout slot
   * @param[in] event:    The event type to be set (e.g., EVENT_SET, EVENT_NONE).
   * @retval    None
   */
@@ -146,7 +200,7 @@ void MID_TimeoutService_WriteEvent(uint8_t instance, Event_Typedef event)
   * @brief     Get a timeout event for a specific instance.
   *
   * @param[in] instance: The instance index for which the event is being set.
-  *            this parameter can be a value of @defgroup Flag represent to Timeout Event
+  *            this parameter can be a value of @defgroup Flag represent to Timeout Event or @defgroup Timeout slot
   * @retval    event:    The event type to be return (e.g., EVENT_SET, EVENT_NONE).
   */
 Event_Typedef MID_TimeoutService_GetEvent(uint8_t instance)
@@ -158,7 +212,7 @@ Event_Typedef MID_TimeoutService_GetEvent(uint8_t instance)
   * @brief     Resets the timeout counter for a specific instance.
   *
   * @param[in] instance The instance index whose timeout counter needs to be reset.
-  *            this parameter can be a value of @defgroup Counter for Timeout counting process
+  *            this parameter can be a value of @defgroup Counter for Timeout counting process or @defgroup Timeout slot
   * @retval    None
   */
 void MID_TimeoutService_ResetCounter(uint8_t instance)
@@ -170,7 +224,7 @@ void MID_TimeoutService_ResetCounter(uint8_t instance)
   * @brief     Enables or disables the counter gate for a specific instance.
   *
   * @param[in] instance: The instance index whose timeout counter needs to be reset.
-  *            this parameter can be a value of @defgroup Gate controller for Timeout Counter
+  *            this parameter can be a value of @defgroup Gate controller for Timeout Counter or @defgroup Timeout slot
   * @param[in] state: The desired state of the counter gate (ENABLE or DISABLE).
   * @retval    None
   */
@@ -179,3 +233,52 @@ void MID_TimeoutService_CounterCmd(uint8_t instance, Functional_State state)
     Counter_Gate[instance] = state;
     Timeout_Counter[instance] = 0u;
 }
+
+/**
+  * @brief     Get the current value of the free running time base.
+  *
+  * @note      The time base counts LPIT clock ticks and wraps modulo 2^32,
+  *            the difference of two timestamps is valid across a wrap.
+  * @param     None
+  * @retval    Current timestamp in LPIT ticks
+  */
+uint32_t MID_Timer_GetTimestamp(void)
+{
+    /* LPIT counts down, invert it to get an increasing time base */
+    return TIMESTAMP_MAX - DRV_LPIT_GetCurrentTimerCount(LPIT_INSTANCE, TIMESTAMP_CHANNEL);
+}
+
+/**
+  * @brief     Convert a duration in LPIT ticks to microseconds.
+  * @param[in] ticks: Duration in LPIT ticks.
+  * @retval    Duration in microseconds
+  */
+uint32_t MID_Timer_TicksToUs(uint32_t ticks)
+{
+    return ticks / Ticks_Per_Us;
+}
+
+/**
+  * @brief     Convert a duration in microseconds to LPIT ticks.
+  * @param[in] us: Duration in microseconds.
+  * @retval    Duration in LPIT ticks
+  */
+uint32_t MID_Timer_UsToTicks(uint32_t us)
+{
+    return us * Ticks_Per_Us;
+}
+
+/**
+  * @brief     Raise NOTIFY_EVENT_ALARM once after a delay, replacing the alarm set before.
+  * @param[in] ticks: Delay in LPIT ticks.
+  * @retval    None
+  */
+void MID_Timer_SetAlarm(uint32_t ticks)
+{
+    /* The channel times out after TVAL + 1 ticks, TVAL 0 would count a full 32-bit period */
+    uint32_t reloadValue = (ticks > 1u) ? (ticks - 1u) : 1u;
+
+    DRV_LPIT_StopTimerChannel(LPIT_INSTANCE, ALARM_CHANNEL);
+    DRV_LPIT_SetReloadValue(LPIT_INSTANCE, ALARM_CHANNEL, reloadValue);
+    DRV_LPIT_StartTimerChannel(LPIT_INSTANCE, ALARM_CHANNEL);
+}
@@ -1,4 +1,6 @@
+#include <string.h>
 #include "MID_TransmitQueue_Interface.h"
+#include "MID_Notification_Manager.h"
 
 /*******************************************************************************
  * Definition
@@ -55,6 +57,7 @@ void MID_Transmit_Queue_Init(void)
 QueueCheckOperation_t MID_Transmit_Enqueue(const uint8_t data)
 {
     QueueCheckOperation_t status = QUEUE_DONE_FAILED;
+    uint32_t primask = MID_Notification_EnterCritical();
 
     if ( !QueueTransmit_isFull(&transmitQueue) )
     {
@@ -76,6 +79,59 @@ QueueCheckOperation_t MID_Transmit_Enqueue(const uint8_t data)
         /* Do Nothing */
     }
 
+    MID_Notification_ExitCritical(primask);
+
+    return status;
+}
+
+/**
+  * @brief      Adds a block of data bytes to the transmit queue, all or none of them.
+  * @note       The block is copied in at most two parts, around the end of the buffer. The
+  *             transmit interrupt empties the queue meanwhile, it is masked from the room
+  *             check to the update of rear and capacity.
+  * @param[in]  pData  Pointer to the data bytes to enqueue.
+  * @param[in]  length Number of data bytes.
+  * @retval     QUEUE_DONE_SUCCESS if enqueue operation is successful.
+  * @retval     QUEUE_DONE_FAILED if the queue has not room for the whole block.
+  */
+QueueCheckOperation_t MID_Transmit_EnqueueBlock(const uint8_t *pData, uint16_t length)
+{
+    QueueCheckOperation_t status = QUEUE_DONE_FAILED;
+    uint16_t start = 0u;
+    uint16_t firstPart = 0u;
+    uint32_t primask = MID_Notification_EnterCritical();
+
+    if ((pData != NULL) && (length != 0u) && ((transmitQueue.capacity + length) <= transmitQueue.size))
+    {
+        if ( transmitQueue.front == -1 )
+        {
+            transmitQueue.front = 0;
+        }
+        else
+        {
+            /* Do Nothing */
+        }
+        start = (uint16_t)(((transmitQueue.rear) + 1) % (transmitQueue.size));
+        firstPart = (uint16_t)(transmitQueue.size - start);
+        if (firstPart > length)
+        {
+            firstPart = length;
+        }
+
+        memcpy(&transmitQueue.queueArray[start], pData, firstPart);
+        memcpy(&transmitQueue.queueArray[0], &pData[firstPart], length - firstPart);
+
+        transmitQueue.rear = (int16_t)((start + length - 1u) % (transmitQueue.size));
+        transmitQueue.capacity += length;
+        status = QUEUE_DONE_SUCCESS;
+    }
+    else
+    {
+        /* Do Nothing */
+    }
+
+    MID_Notification_ExitCritical(primask);
+
     return status;
 }
 
@@ -119,6 +175,16 @@ QueueCheckOperation_t MID_Transmit_Dequeue(uint8_t * pOutData)
     return status;
 }
 
+/**
+  * @brief  Gets the number of data bytes waiting in the transmit queue.
+  * @param  None
+  * @retval Bytes queued.
+  */
+uint16_t MID_Transmit_GetCount(void)
+{
+    return transmitQueue.capacity;
+}
+
 /**
   * @brief  Checks if the transmit queue is full.
   * @param  None